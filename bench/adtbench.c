@@ -0,0 +1,461 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Microbenchmarks of the priority queues and bitsets.
+ *
+ * Usage: adtbench
+ *
+ * Prints one line "adt-<workload> <container> <metric>_ms <value>" per
+ * measurement, with the minimum time of several runs.  The "sort" workload
+ * puts random priorities and pops them all, the "dijkstra" workload computes
+ * shortest paths on a random graph, where pqueue and radixheap queue nodes
+ * again on every improvement and skip stale entries, while heap changes the
+ * priority of the queued entry.
+ *
+ * The bitset workloads compare the raw bitset operations with plain loops
+ * over the elements ("words"), as they were before the vectorized kernels.
+ *
+ * The "closure" workload computes the reachability sets of a long chain of
+ * diamonds, as the liveness checks do for the control flow graph, once with
+ * a raw bitset per node ("words") and once with chunked bitsets.  It also
+ * reports the memory of the sets as "mem_kib".
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "cbitset.h"
+#include "firm.h"
+#include "heap.h"
+#include "pqueue.h"
+#include "radixheap.h"
+#include "raw_bitset.h"
+#include "xmalloc.h"
+
+#define N_ELEMS     (1 << 18)
+#define N_NODES     (1 << 16)
+#define N_EDGES     8
+#define MAX_WEIGHT  1000
+#define REPEAT      5
+#define N_BITS      4096
+#define N_BITSETS   64
+#define BITSET_ITER 100000
+#define N_DIAMONDS  5000
+#define N_CFG       (3 * N_DIAMONDS + 1)
+
+typedef struct node_t {
+	unsigned     dist;
+	unsigned     edges[N_EDGES];
+	unsigned     weights[N_EDGES];
+	heap_entry_t entry;
+} node_t;
+
+static int      *prios;
+static node_t   *nodes;
+static unsigned *bitsets[N_BITSETS];
+static unsigned *sparse[N_BITSETS];
+static unsigned  bitset_result;
+static size_t    closure_mem;
+static int       failed;
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void check(int const ok, char const *const what)
+{
+	if (!ok) {
+		fprintf(stderr, "adtbench: %s: wrong result\n", what);
+		failed = 1;
+	}
+}
+
+static void sort_pqueue(void)
+{
+	pqueue_t *const q = new_pqueue();
+	for (size_t i = 0; i < N_ELEMS; ++i)
+		pqueue_put(q, &prios[i], prios[i]);
+	int last = INT_MAX;
+	while (!pqueue_empty(q)) {
+		int const p = *(int*)pqueue_pop_front(q);
+		check(p <= last, "sort pqueue");
+		last = p;
+	}
+	del_pqueue(q);
+}
+
+static void sort_heap(void)
+{
+	heap_entry_t *const entries = XMALLOCN(heap_entry_t, N_ELEMS);
+	heap_t q;
+	heap_init(&q);
+	for (size_t i = 0; i < N_ELEMS; ++i) {
+		heap_entry_init(&entries[i]);
+		heap_insert(&q, &entries[i], prios[i]);
+	}
+	int last = INT_MAX;
+	while (!heap_empty(&q)) {
+		int const p = prios[heap_pop_max(&q) - entries];
+		check(p <= last, "sort heap");
+		last = p;
+	}
+	heap_free(&q);
+	free(entries);
+}
+
+static void sort_radixheap(void)
+{
+	radixheap_t q;
+	radixheap_init(&q);
+	for (size_t i = 0; i < N_ELEMS; ++i)
+		radixheap_put(&q, &prios[i], (uint32_t)prios[i]);
+	int last = 0;
+	while (!radixheap_empty(&q)) {
+		int const p = *(int*)radixheap_pop_min(&q);
+		check(p >= last, "sort radixheap");
+		last = p;
+	}
+	radixheap_free(&q);
+}
+
+static void reset_dists(void)
+{
+	for (size_t i = 0; i < N_NODES; ++i) {
+		nodes[i].dist = UINT_MAX;
+		heap_entry_init(&nodes[i].entry);
+	}
+	nodes[0].dist = 0;
+}
+
+static void dijkstra_pqueue(void)
+{
+	reset_dists();
+	pqueue_t *const q = new_pqueue();
+	pqueue_put(q, (void*)(uintptr_t)0, 0);
+	while (!pqueue_empty(q)) {
+		/* the priority is not accessible, so stale entries are recognized
+		 * only by revisiting the edges */
+		node_t *const n = &nodes[(uintptr_t)pqueue_pop_front(q)];
+		for (unsigned e = 0; e < N_EDGES; ++e) {
+			node_t  *const succ = &nodes[n->edges[e]];
+			unsigned const dist = n->dist + n->weights[e];
+			if (dist < succ->dist) {
+				succ->dist = dist;
+				pqueue_put(q, (void*)(uintptr_t)(succ - nodes), -(int)dist);
+			}
+		}
+	}
+	del_pqueue(q);
+}
+
+static void dijkstra_heap(void)
+{
+	reset_dists();
+	heap_t q;
+	heap_init(&q);
+	heap_insert(&q, &nodes[0].entry, 0);
+	while (!heap_empty(&q)) {
+		node_t *const n = heap_container(heap_pop_max(&q), node_t, entry);
+		for (unsigned e = 0; e < N_EDGES; ++e) {
+			node_t  *const succ = &nodes[n->edges[e]];
+			unsigned const dist = n->dist + n->weights[e];
+			if (dist < succ->dist) {
+				succ->dist = dist;
+				if (heap_contains(&succ->entry)) {
+					heap_set_priority(&q, &succ->entry, -(int)dist);
+				} else {
+					heap_insert(&q, &succ->entry, -(int)dist);
+				}
+			}
+		}
+	}
+	heap_free(&q);
+}
+
+static void dijkstra_radixheap(void)
+{
+	reset_dists();
+	radixheap_t q;
+	radixheap_init(&q);
+	radixheap_put(&q, &nodes[0], 0);
+	while (!radixheap_empty(&q)) {
+		node_t *const n = (node_t*)radixheap_pop_min(&q);
+		for (unsigned e = 0; e < N_EDGES; ++e) {
+			node_t  *const succ = &nodes[n->edges[e]];
+			unsigned const dist = n->dist + n->weights[e];
+			if (dist < succ->dist) {
+				succ->dist = dist;
+				radixheap_put(&q, succ, dist);
+			}
+		}
+	}
+	radixheap_free(&q);
+}
+
+static unsigned dist_checksum(void)
+{
+	unsigned sum = 0;
+	for (size_t i = 0; i < N_NODES; ++i)
+		sum = sum * 31 + nodes[i].dist;
+	return sum;
+}
+
+#define N_ELEMS_BITSET BITSET_SIZE_ELEMS(N_BITS)
+
+static void or_words(void)
+{
+	unsigned *dst = bitsets[0];
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		unsigned const *src = bitsets[1 + r % (N_BITSETS - 1)];
+		for (size_t i = 0; i < N_ELEMS_BITSET; ++i)
+			dst[i] |= src[i];
+	}
+}
+
+static void or_rbitset(void)
+{
+	unsigned *dst = bitsets[0];
+	for (unsigned r = 0; r < BITSET_ITER; ++r)
+		rbitset_or(dst, bitsets[1 + r % (N_BITSETS - 1)], N_BITS);
+}
+
+/* The fixed point step of a dataflow analysis: join and test for a change. */
+static void join_words(void)
+{
+	unsigned n_changed = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		unsigned       *dst = sparse[r % N_BITSETS];
+		unsigned const *src = sparse[(r + 1) % N_BITSETS];
+		bool changed = false;
+		for (size_t i = 0; i < N_ELEMS_BITSET; ++i) {
+			if ((src[i] & ~dst[i]) != 0) {
+				changed = true;
+				break;
+			}
+		}
+		if (changed) {
+			for (size_t i = 0; i < N_ELEMS_BITSET; ++i)
+				dst[i] |= src[i];
+			++n_changed;
+		}
+	}
+	bitset_result = n_changed;
+}
+
+static void join_rbitset(void)
+{
+	unsigned n_changed = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		unsigned       *dst = sparse[r % N_BITSETS];
+		unsigned const *src = sparse[(r + 1) % N_BITSETS];
+		n_changed += rbitset_or_changed(dst, src, N_BITS);
+	}
+	bitset_result = n_changed;
+}
+
+static void popcount_words(void)
+{
+	unsigned count = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		unsigned const *bs = bitsets[r % N_BITSETS];
+		for (size_t i = 0; i < N_ELEMS_BITSET; ++i)
+			count += popcount(bs[i]);
+	}
+	bitset_result = count;
+}
+
+static void popcount_rbitset(void)
+{
+	unsigned count = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r)
+		count += rbitset_popcount(bitsets[r % N_BITSETS], N_BITS);
+	bitset_result = count;
+}
+
+/* Iterates sets with a few bits, which are mostly zero words. */
+static void foreach_words(void)
+{
+	unsigned sum = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		unsigned const *bs = sparse[r % N_BITSETS];
+		for (size_t i = 0; i < N_ELEMS_BITSET; ++i) {
+			for (unsigned w = bs[i]; w != 0; w &= w - 1)
+				sum += i * BITS_PER_ELEM + ntz(w);
+		}
+	}
+	bitset_result = sum;
+}
+
+static void foreach_rbitset(void)
+{
+	unsigned sum = 0;
+	for (unsigned r = 0; r < BITSET_ITER; ++r) {
+		rbitset_foreach(sparse[r % N_BITSETS], N_BITS, elm) {
+			sum += elm;
+		}
+	}
+	bitset_result = sum;
+}
+
+/* Node i of a chain of diamonds numbered in dominator tree preorder: the head
+ * 3k branches to 3k+1 and 3k+2, which both continue at 3k+3. */
+static unsigned cfg_succs(unsigned const node, unsigned *const succs)
+{
+	if (node == N_CFG - 1)
+		return 0;
+	switch (node % 3) {
+	case 0:
+		succs[0] = node + 1;
+		succs[1] = node + 2;
+		return 2;
+	case 1:
+		succs[0] = node + 2;
+		return 1;
+	default:
+		succs[0] = node + 1;
+		return 1;
+	}
+}
+
+static void closure_words(void)
+{
+	unsigned **const reach = XMALLOCN(unsigned*, N_CFG);
+	for (unsigned i = N_CFG; i-- > 0;) {
+		unsigned succs[2];
+		unsigned n = cfg_succs(i, succs);
+		reach[i] = rbitset_malloc(N_CFG);
+		rbitset_set(reach[i], i);
+		for (unsigned s = 0; s < n; ++s)
+			rbitset_or(reach[i], reach[succs[s]], N_CFG);
+	}
+	unsigned count = 0;
+	for (unsigned i = 0; i < N_CFG; ++i) {
+		count += rbitset_popcount(reach[i], N_CFG);
+		free(reach[i]);
+	}
+	free(reach);
+	bitset_result = count;
+	closure_mem   = (size_t)N_CFG * BITSET_SIZE_BYTES(N_CFG);
+}
+
+static void closure_cbitset(void)
+{
+	cbitset_t *const reach = XMALLOCN(cbitset_t, N_CFG);
+	for (unsigned i = N_CFG; i-- > 0;) {
+		unsigned succs[2];
+		unsigned n = cfg_succs(i, succs);
+		cbitset_init(&reach[i]);
+		cbitset_set(&reach[i], i);
+		for (unsigned s = 0; s < n; ++s)
+			cbitset_or(&reach[i], &reach[succs[s]]);
+	}
+	unsigned count = 0;
+	size_t   mem   = 0;
+	for (unsigned i = 0; i < N_CFG; ++i) {
+		count += cbitset_popcount(&reach[i]);
+		mem   += cbitset_get_memory(&reach[i]);
+		cbitset_free(&reach[i]);
+	}
+	free(reach);
+	bitset_result = count;
+	closure_mem   = mem;
+}
+
+static void measure(char const *const workload, char const *const container,
+                    void (*const run)(void))
+{
+	double best = 0;
+	for (unsigned r = 0; r < REPEAT; ++r) {
+		double const start = now_ms();
+		run();
+		double const time = now_ms() - start;
+		if (r == 0 || time < best)
+			best = time;
+	}
+	printf("adt-%s %s time_ms %.3f\n", workload, container, best);
+}
+
+static void measure_bitset(char const *const workload,
+                           void (*const words)(void),
+                           void (*const rbitset)(void))
+{
+	measure(workload, "words", words);
+	unsigned const expected = bitset_result;
+	measure(workload, "rbitset", rbitset);
+	check(bitset_result == expected, workload);
+}
+
+static void fill_bitsets(void)
+{
+	for (size_t i = 0; i < N_BITSETS; ++i) {
+		bitsets[i] = rbitset_malloc(N_BITS);
+		sparse[i]  = rbitset_malloc(N_BITS);
+		for (size_t b = 0; b < N_BITS; ++b) {
+			if (rand() % 2 == 0)
+				rbitset_set(bitsets[i], b);
+			if (rand() % 256 == 0)
+				rbitset_set(sparse[i], b);
+		}
+	}
+}
+
+int main(void)
+{
+	srand(42);
+	prios = XMALLOCN(int, N_ELEMS);
+	for (size_t i = 0; i < N_ELEMS; ++i)
+		prios[i] = rand();
+
+	nodes = XMALLOCN(node_t, N_NODES);
+	for (size_t i = 0; i < N_NODES; ++i) {
+		for (unsigned e = 0; e < N_EDGES; ++e) {
+			nodes[i].edges[e]   = (unsigned)rand() % N_NODES;
+			nodes[i].weights[e] = 1 + (unsigned)rand() % MAX_WEIGHT;
+		}
+	}
+
+	measure("sort", "pqueue",    sort_pqueue);
+	measure("sort", "heap",      sort_heap);
+	measure("sort", "radixheap", sort_radixheap);
+
+	measure("dijkstra", "pqueue", dijkstra_pqueue);
+	unsigned const expected = dist_checksum();
+	measure("dijkstra", "heap", dijkstra_heap);
+	check(dist_checksum() == expected, "dijkstra heap");
+	measure("dijkstra", "radixheap", dijkstra_radixheap);
+	check(dist_checksum() == expected, "dijkstra radixheap");
+
+	ir_init();
+	fill_bitsets();
+	measure_bitset("bitset-or",       or_words,       or_rbitset);
+	measure_bitset("bitset-popcount", popcount_words, popcount_rbitset);
+	measure_bitset("bitset-foreach",  foreach_words,  foreach_rbitset);
+	/* last, as it changes the sparse sets */
+	measure_bitset("bitset-join",     join_words,     join_rbitset);
+
+	measure("closure", "words", closure_words);
+	printf("adt-closure words mem_kib %zu\n", closure_mem / 1024);
+	unsigned const reachable = bitset_result;
+	measure("closure", "cbitset", closure_cbitset);
+	printf("adt-closure cbitset mem_kib %zu\n", closure_mem / 1024);
+	check(bitset_result == reachable, "closure");
+	for (size_t i = 0; i < N_BITSETS; ++i) {
+		free(sparse[i]);
+		free(bitsets[i]);
+	}
+
+	free(nodes);
+	free(prios);
+	return failed;
+}
@@ -0,0 +1,199 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Graph construction helpers and the optimization pipeline shared by
+ *          the benchmark programs.
+ */
+#ifndef FIRM_BENCH_H
+#define FIRM_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "firm.h"
+
+static inline ir_type *prim(ir_mode *const mode)
+{
+	return new_type_primitive(mode);
+}
+
+static inline ir_type *new_method(unsigned const n_params,
+                                  ir_type *const *const params,
+                                  ir_type *const res)
+{
+	ir_type *const type = new_type_method(n_params, res != NULL, false,
+	                                      cc_cdecl_set, mtp_no_property);
+	for (unsigned i = 0; i < n_params; ++i)
+		set_method_param_type(type, i, params[i]);
+	if (res != NULL)
+		set_method_res_type(type, 0, res);
+	return type;
+}
+
+static inline ir_graph *begin_function(char const *const name,
+                                       ir_type *const type, int const n_locals)
+{
+	ir_entity *const entity = new_entity(get_glob_type(), new_id_from_str(name),
+	                                     type);
+	ir_graph  *const irg    = new_ir_graph(entity, n_locals);
+	set_current_ir_graph(irg);
+	return irg;
+}
+
+static inline void end_function(ir_graph *const irg, ir_node *res)
+{
+	ir_node *const ret = new_Return(get_store(), res != NULL, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_cur_block());
+	irg_finalize_cons(irg);
+}
+
+static inline ir_node *param(unsigned const n, ir_mode *const mode)
+{
+	return new_Proj(get_irg_args(current_ir_graph), mode, n);
+}
+
+static inline ir_node *iconst(ir_mode *const mode, long const value)
+{
+	return new_Const_long(mode, value);
+}
+
+/** Branches on @p cmp and continues in the true block.  The current block is
+ * not matured, as it might be a loop header.
+ * @return the false block */
+static inline ir_node *branch(ir_node *const cmp)
+{
+	ir_node *const cond = new_Cond(cmp);
+	ir_node *const t    = new_immBlock();
+	ir_node *const f    = new_immBlock();
+	add_immBlock_pred(t, new_Proj(cond, mode_X, pn_Cond_true));
+	add_immBlock_pred(f, new_Proj(cond, mode_X, pn_Cond_false));
+	mature_immBlock(t);
+	mature_immBlock(f);
+	set_cur_block(t);
+	return f;
+}
+
+/** Jumps from the current block and from @p other to a new block. */
+static inline void join(ir_node *const other)
+{
+	ir_node *const jmp  = new_Jmp();
+	ir_node *const next = new_immBlock();
+	add_immBlock_pred(next, jmp);
+	set_cur_block(other);
+	add_immBlock_pred(next, new_Jmp());
+	mature_immBlock(next);
+	set_cur_block(next);
+}
+
+/** Starts a loop: returns the loop header, which stays immature. */
+static inline ir_node *loop_begin(void)
+{
+	ir_node *const jmp    = new_Jmp();
+	ir_node *const header = new_immBlock();
+	add_immBlock_pred(header, jmp);
+	set_cur_block(header);
+	return header;
+}
+
+/** Closes a loop started by loop_begin(). The exit block becomes current. */
+static inline void loop_end(ir_node *const header, ir_node *const exit)
+{
+	add_immBlock_pred(header, new_Jmp());
+	mature_immBlock(header);
+	set_cur_block(exit);
+}
+
+static inline ir_node *element(ir_node *const base, ir_node *const index,
+                               unsigned const size)
+{
+	ir_mode *const mode   = get_reference_offset_mode(mode_P);
+	ir_node *const offset = new_Mul(new_Conv(index, mode), iconst(mode, size));
+	return new_Add(base, offset);
+}
+
+static inline ir_node *load(ir_node *const addr, ir_mode *const mode)
+{
+	ir_node *const ld = new_Load(get_store(), addr, mode, prim(mode), cons_none);
+	set_store(new_Proj(ld, mode_M, pn_Load_M));
+	return new_Proj(ld, mode, pn_Load_res);
+}
+
+static inline void store(ir_node *const addr, ir_node *const value)
+{
+	ir_type *const type = prim(get_irn_mode(value));
+	ir_node *const st   = new_Store(get_store(), addr, value, type, cons_none);
+	set_store(new_Proj(st, mode_M, pn_Store_M));
+}
+
+typedef void (*graph_pass_t)(ir_graph *irg);
+
+static inline void opt_osr_default(ir_graph *const irg)
+{
+	opt_osr(irg, osr_flag_default);
+}
+
+static inline void run_passes(ir_graph *const irg,
+                              graph_pass_t const *const passes,
+                              size_t const n_passes)
+{
+	for (size_t i = 0; i < n_passes; ++i)
+		passes[i](irg);
+}
+
+#define RUN_PASSES(irg, passes) \
+	run_passes((irg), (passes), sizeof(passes) / sizeof(*(passes)))
+
+/** Runs the standard optimizations on all graphs, roughly in the order cparser
+ * uses them at -O3.  The experimental do_gvn_pre and opt_ldst are left out.
+ *
+ * @param idioms             replace loop idioms
+ * @param prefetch_distance  insert prefetches this many bytes ahead, 0 for none
+ */
+static inline void bench_optimize(bool const idioms,
+                                  unsigned const prefetch_distance)
+{
+	static graph_pass_t const early[] = {
+		scalar_replacement_opt,
+		optimize_graph_df,
+		opt_tail_rec_irg,
+		optimize_cf,
+		opt_jumpthreading,
+		opt_bool,
+		combo,
+		optimize_load_store,
+		optimize_graph_df,
+		opt_osr_default,
+		optimize_graph_df,
+	};
+	static graph_pass_t const late[] = {
+		optimize_reassociation,
+		conv_opt,
+		optimize_cf,
+		opt_parallelize_mem,
+		occult_consts,
+	};
+
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		RUN_PASSES(irg, early);
+		if (idioms)
+			opt_loop_idioms(irg);
+		if (prefetch_distance > 0)
+			opt_prefetch(irg, prefetch_distance);
+		RUN_PASSES(irg, late);
+	}
+	inline_functions(750, 0, optimize_graph_df);
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		optimize_graph_df(irg);
+		optimize_cf(irg);
+	}
+	garbage_collect_entities();
+}
+
+#endif
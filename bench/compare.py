@@ -0,0 +1,151 @@
+#! /usr/bin/env python
+#
+# This file is part of libFirm.
+# Copyright (C) 2017 University of Karlsruhe.
+#
+# Compares compile time benchmark results against a baseline.
+#
+# Both files contain lines "<benchmark> <target> <metric> <value>".  A metric
+# measured several times is reduced to its minimum.  Exits with status 1 if a
+# metric got worse than the baseline by more than the threshold.
+#
+# With --against CONFIG a single results file is compared with itself: the
+# second field names a configuration and every configuration is reported
+# relative to CONFIG.  CONFIG may be a comma separated list, then the first
+# configuration measured for a benchmark and metric is the reference.
+import sys
+import optparse
+
+# Absolute changes below these are considered noise
+NOISE_FLOOR = {
+    "_ms": 2.0,
+    "rss_kib": 1024.0,
+}
+
+# Runtimes of generated code depend on code and data layout too much to fail
+# the comparison, they are only reported
+REPORT_ONLY_PREFIX = "kernels-"
+
+
+def read_results(name):
+    results = {}
+    order = []
+    for line in open(name):
+        fields = line.split()
+        if len(fields) != 4:
+            continue
+        try:
+            value = float(fields[3])
+        except ValueError:
+            continue
+        key = tuple(fields[:3])
+        if key in results:
+            results[key] = min(results[key], value)
+        else:
+            results[key] = value
+            order.append(key)
+    return results, order
+
+
+def noise_floor(metric):
+    for suffix, floor in NOISE_FLOOR.items():
+        if metric.endswith(suffix):
+            return floor
+    return 0.0
+
+
+def format_value(value):
+    if value == int(value):
+        return "%d" % value
+    return "%.3f" % value
+
+
+def write_results(name, results, order):
+    out = open(name, "w")
+    for key in order:
+        out.write("%s %s %s %s\n" % (key + (format_value(results[key]),)))
+    out.close()
+
+
+def compare_configs(results, order, against):
+    for key in order:
+        if key[1] in against:
+            continue
+        new = results[key]
+        old = None
+        for config in against:
+            old = results.get((key[0], config, key[2]))
+            if old is not None:
+                break
+        if old is None:
+            print("%-46s %12s -> %12s" %
+                  (" ".join(key), "", format_value(new)))
+            continue
+        change = (new - old) / old if old != 0 else 0.0
+        print("%-46s %12s -> %12s %+7.1f%%" %
+              (" ".join(key), format_value(old), format_value(new),
+               change * 100))
+
+
+def main():
+    parser = optparse.OptionParser(
+        usage="%prog [options] <results> [<baseline>]")
+    parser.add_option("-t", "--threshold", type="float", default=0.10,
+                      help="relative slowdown regarded as regression "
+                           "[default %default]")
+    parser.add_option("-w", "--write", metavar="FILE",
+                      help="write the reduced results to FILE")
+    parser.add_option("-q", "--quiet", action="store_true",
+                      help="only print regressions")
+    parser.add_option("-a", "--against", metavar="CONFIG",
+                      help="compare all configurations with CONFIG")
+    options, args = parser.parse_args()
+    if len(args) not in (1, 2):
+        parser.error("expected results and baseline file")
+
+    results, order = read_results(args[0])
+    if options.write:
+        write_results(options.write, results, order)
+    if options.against:
+        compare_configs(results, order, options.against.split(","))
+        return 0
+    if len(args) < 2:
+        return 0
+
+    baseline, _ = read_results(args[1])
+    regressions = 0
+    for key in order:
+        new = results[key]
+        old = baseline.get(key)
+        if old is None:
+            if not options.quiet:
+                print("%-46s %12s -> %12s   new" %
+                      (" ".join(key), "", format_value(new)))
+            continue
+        change = (new - old) / old if old != 0 else 0.0
+        regressed = new - old > noise_floor(key[2]) \
+            and change > options.threshold
+        note = ""
+        if regressed and key[0].startswith(REPORT_ONLY_PREFIX):
+            regressed = False
+            note = "   slower"
+        elif regressed:
+            regressions += 1
+            note = "   REGRESSION"
+        if note or not options.quiet:
+            print("%-46s %12s -> %12s %+7.1f%%%s" %
+                  (" ".join(key), format_value(old), format_value(new),
+                   change * 100, note))
+    for key in sorted(baseline):
+        if key not in results:
+            print("%-46s missing" % " ".join(key))
+
+    if regressions > 0:
+        print("%d regression(s) above %.0f%%" %
+              (regressions, options.threshold * 100))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
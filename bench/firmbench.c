@@ -0,0 +1,194 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Compile time benchmark driver.
+ *
+ * Usage: firmbench [options] <target triple> <input.ir>
+ *
+ * Imports an IR file, runs a standard optimization pipeline and the backend
+ * and prints one line "<benchmark> <target> <metric> <value>" per measured
+ * metric.  The benchmark name is the input file name without its directory,
+ * target suffix and extension.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+
+static bool     idioms = true;
+static bool     verbose;
+static unsigned prefetch_distance;
+
+static void lower(void)
+{
+	lower_highlevel();
+	be_lower_for_target();
+}
+
+static char *benchmark_name(char const *const path, char const *const target)
+{
+	char const *base = strrchr(path, '/');
+	base = base != NULL ? base + 1 : path;
+	size_t len = strlen(base);
+	if (len > 3 && strcmp(base + len - 3, ".ir") == 0)
+		len -= 3;
+	size_t const target_len = strlen(target);
+	if (len > target_len + 1 && base[len - target_len - 1] == '-'
+	    && strncmp(base + len - target_len, target, target_len) == 0)
+		len -= target_len + 1;
+
+	char *const name = malloc(len + 1);
+	memcpy(name, base, len);
+	name[len] = '\0';
+	return name;
+}
+
+static long peak_rss_kib(void)
+{
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+static void usage(char const *const argv0)
+{
+	fprintf(stderr,
+	        "Usage: %s [options] <target triple> <input.ir>\n"
+	        "  -o FILE            write the assembler output to FILE\n"
+	        "  -fprefetch[=N]     insert prefetches N bytes ahead\n"
+	        "  -fno-idioms        do not replace loop idioms\n"
+	        "  -mOPTION           pass OPTION to the target\n"
+	        "  -v                 print pass statistics to stderr\n",
+	        argv0);
+}
+
+int main(int argc, char **argv)
+{
+	char const *output = NULL;
+	char const *target = NULL;
+	char const *input  = NULL;
+
+	ir_init();
+	for (int i = 1; i < argc; ++i) {
+		char const *const arg = argv[i];
+		if (strcmp(arg, "-o") == 0 && i + 1 < argc) {
+			output = argv[++i];
+		} else if (strcmp(arg, "-fprefetch") == 0) {
+			prefetch_distance = 2048;
+		} else if (strncmp(arg, "-fprefetch=", 11) == 0) {
+			prefetch_distance = (unsigned)atoi(arg + 11);
+		} else if (strcmp(arg, "-fno-idioms") == 0) {
+			idioms = false;
+		} else if (strcmp(arg, "-v") == 0) {
+			verbose = true;
+		} else if (strncmp(arg, "-m", 2) == 0) {
+			/* handled after the target is set */
+		} else if (arg[0] == '-') {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		} else if (target == NULL) {
+			target = arg;
+		} else if (input == NULL) {
+			input = arg;
+		} else {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (input == NULL) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!ir_target_set(target)) {
+		fprintf(stderr, "%s: unknown target '%s'\n", argv[0], target);
+		return EXIT_FAILURE;
+	}
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-o") == 0) {
+			++i;
+		} else if (strncmp(argv[i], "-m", 2) == 0
+		           && !ir_target_option(argv[i] + 2)) {
+			fprintf(stderr, "%s: unknown target option '%s'\n", argv[0], argv[i]);
+			return EXIT_FAILURE;
+		}
+	}
+	ir_target_init();
+	ir_pass_stats_enable(verbose);
+
+	FILE *const out = output != NULL ? fopen(output, "w") : tmpfile();
+	if (out == NULL) {
+		perror(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	ir_timer_t *const t_total   = ir_timer_new();
+	ir_timer_t *const t_import  = ir_timer_new();
+	ir_timer_t *const t_opt     = ir_timer_new();
+	ir_timer_t *const t_lower   = ir_timer_new();
+	ir_timer_t *const t_backend = ir_timer_new();
+
+	ir_timer_start(t_total);
+
+	/* keep the graphs as they were written */
+	ir_timer_start(t_import);
+	set_optimize(0);
+	int const import_errors = ir_import(input);
+	set_optimize(1);
+	ir_timer_stop(t_import);
+	if (import_errors != 0) {
+		fprintf(stderr, "%s: could not import '%s'\n", argv[0], input);
+		return EXIT_FAILURE;
+	}
+
+	ir_timer_start(t_opt);
+	bench_optimize(idioms, prefetch_distance);
+	ir_timer_stop(t_opt);
+
+	ir_timer_start(t_lower);
+	lower();
+	ir_timer_stop(t_lower);
+
+	ir_timer_start(t_backend);
+	be_main(out, input);
+	ir_timer_stop(t_backend);
+
+	ir_timer_stop(t_total);
+
+	fflush(out);
+	long const asm_bytes = ftell(out);
+	fclose(out);
+
+	char *const name = benchmark_name(input, target);
+	printf("%s %s import_ms %.3f\n",  name, target, ir_timer_elapsed_usec(t_import)  / 1000.0);
+	printf("%s %s opt_ms %.3f\n",     name, target, ir_timer_elapsed_usec(t_opt)     / 1000.0);
+	printf("%s %s lower_ms %.3f\n",   name, target, ir_timer_elapsed_usec(t_lower)   / 1000.0);
+	printf("%s %s backend_ms %.3f\n", name, target, ir_timer_elapsed_usec(t_backend) / 1000.0);
+	printf("%s %s total_ms %.3f\n",   name, target, ir_timer_elapsed_usec(t_total)   / 1000.0);
+	printf("%s %s rss_kib %ld\n",     name, target, peak_rss_kib());
+	printf("%s %s asm_bytes %ld\n",   name, target, asm_bytes);
+	free(name);
+
+	if (verbose)
+		ir_pass_stats_print(stderr, false);
+
+	ir_timer_free(t_backend);
+	ir_timer_free(t_lower);
+	ir_timer_free(t_opt);
+	ir_timer_free(t_import);
+	ir_timer_free(t_total);
+	ir_finish();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,422 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Generates the IR files of the compile time benchmark corpus.
+ *
+ * Usage: gen_corpus <target triple> <benchmark> <output.ir>
+ *
+ * The graphs are built with local optimizations disabled, so the folding and
+ * simplification work is left to the optimization pipeline of firmbench.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+#define ARRAY_SIZE(a) (sizeof(a)/sizeof((a)[0]))
+
+static unsigned seed = 42;
+
+/** A small deterministic pseudo random number generator. */
+static unsigned rnd(unsigned const limit)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % limit;
+}
+
+/** Many small functions with a loop, a diamond and a call each.  Every tenth
+ * function is a leaf, the others call the preceding leaf. */
+static void gen_small(void)
+{
+	ir_type   *const it       = prim(mode_Is);
+	ir_type   *const params[] = { it, it };
+	ir_type   *const type     = new_method(2, params, it);
+	ir_entity       *leaf     = NULL;
+	for (int k = 0; k < 300; ++k) {
+		char name[32];
+		snprintf(name, sizeof(name), "small_%d", k);
+		ir_graph *const irg = begin_function(name, type, 2);
+		ir_node  *const a   = param(0, mode_Is);
+		ir_node  *const b   = param(1, mode_Is);
+
+		set_value(0, new_Add(new_Mul(a, iconst(mode_Is, k)), b));
+		ir_node *const other = branch(new_Cmp(get_value(0, mode_Is),
+		                                      iconst(mode_Is, k), ir_relation_greater));
+		set_value(0, new_Sub(get_value(0, mode_Is), b));
+		ir_node *const cur = get_cur_block();
+		set_cur_block(other);
+		set_value(0, new_Eor(get_value(0, mode_Is), a));
+		set_cur_block(cur);
+		join(other);
+
+		set_value(1, iconst(mode_Is, 0));
+		ir_node *const header = loop_begin();
+		ir_node *const i      = get_value(1, mode_Is);
+		ir_node *const exit   = branch(new_Cmp(i, b, ir_relation_less));
+		set_value(0, new_Add(get_value(0, mode_Is), new_Mul(i, iconst(mode_Is, k | 1))));
+		set_value(1, new_Add(i, iconst(mode_Is, 1)));
+		loop_end(header, exit);
+
+		ir_node *res = get_value(0, mode_Is);
+		if (k % 10 != 0) {
+			ir_node *const in[] = { res, b };
+			ir_node *const call = new_Call(get_store(), new_Address(leaf), 2, in,
+			                               type);
+			set_store(new_Proj(call, mode_M, pn_Call_M));
+			ir_node *const results = new_Proj(call, mode_T, pn_Call_T_result);
+			res = new_Add(res, new_Proj(results, mode_Is, 0));
+		}
+		end_function(irg, res);
+		if (k % 10 == 0)
+			leaf = get_irg_entity(irg);
+	}
+}
+
+/** One huge function: a long chain of diamonds over a few variables. */
+static void gen_large(void)
+{
+	enum { N_VARS = 8, N_STEPS = 1500 };
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const params[] = { it, it };
+	ir_graph *const irg      = begin_function("large", new_method(2, params, it),
+	                                          N_VARS);
+	ir_node  *const a        = param(0, mode_Is);
+	ir_node  *const b        = param(1, mode_Is);
+	for (int v = 0; v < N_VARS; ++v)
+		set_value(v, v & 1 ? new_Add(a, iconst(mode_Is, v)) : new_Sub(b, iconst(mode_Is, v)));
+
+	for (int s = 0; s < N_STEPS; ++s) {
+		int      const i    = rnd(N_VARS);
+		int      const j    = rnd(N_VARS);
+		ir_node *const test = new_And(get_value(i, mode_Is), iconst(mode_Is, 1 << (s % 13)));
+		ir_node *const other = branch(new_Cmp(test, iconst(mode_Is, 0), ir_relation_less_greater));
+		set_value(i, new_Add(new_Mul(get_value(i, mode_Is), iconst(mode_Is, 3)),
+		                     get_value(j, mode_Is)));
+		ir_node *const cur = get_cur_block();
+		set_cur_block(other);
+		set_value(j, new_Eor(new_Sub(get_value(j, mode_Is), get_value(i, mode_Is)),
+		                     iconst(mode_Is, s)));
+		set_cur_block(cur);
+		join(other);
+	}
+
+	ir_node *res = get_value(0, mode_Is);
+	for (int v = 1; v < N_VARS; ++v)
+		res = new_Add(res, get_value(v, mode_Is));
+	end_function(irg, res);
+}
+
+/** Many values live through a loop full of diamonds: stresses SSA
+ * construction, liveness and register allocation. */
+static void gen_phiweb(void)
+{
+	enum { N_VARS = 48, N_DIAMONDS = 200 };
+	ir_type  *const lt       = prim(mode_Ls);
+	ir_type  *const params[] = { new_type_pointer(lt), lt };
+	ir_graph *const irg      = begin_function("phiweb", new_method(2, params, lt),
+	                                          N_VARS + 1);
+	ir_node  *const p        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Ls);
+	for (int v = 0; v < N_VARS; ++v)
+		set_value(v, load(element(p, iconst(mode_Ls, v), 8), mode_Ls));
+	set_value(N_VARS, iconst(mode_Ls, 0));
+
+	ir_node *const header = loop_begin();
+	ir_node *const i      = get_value(N_VARS, mode_Ls);
+	ir_node *const exit   = branch(new_Cmp(i, n, ir_relation_less));
+	for (int d = 0; d < N_DIAMONDS; ++d) {
+		int      const c     = rnd(N_VARS);
+		ir_node *const other = branch(new_Cmp(get_value(c, mode_Ls), i, ir_relation_greater));
+		for (int u = 0; u < 3; ++u) {
+			int const x = rnd(N_VARS);
+			int const y = rnd(N_VARS);
+			set_value(x, new_Add(get_value(x, mode_Ls), get_value(y, mode_Ls)));
+		}
+		ir_node *const cur = get_cur_block();
+		set_cur_block(other);
+		int const x = rnd(N_VARS);
+		set_value(x, new_Sub(get_value(x, mode_Ls), i));
+		set_cur_block(cur);
+		join(other);
+	}
+	set_value(N_VARS, new_Add(i, iconst(mode_Ls, 1)));
+	loop_end(header, exit);
+
+	ir_node *res = iconst(mode_Ls, 0);
+	for (int v = 0; v < N_VARS; ++v) {
+		ir_node *const value = get_value(v, mode_Ls);
+		store(element(p, iconst(mode_Ls, v), 8), value);
+		res = new_Eor(res, value);
+	}
+	end_function(irg, res);
+}
+
+/** A deep loop nest. */
+static void gen_loopnest(void)
+{
+	enum { DEPTH = 10 };
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const params[] = { new_type_pointer(it), it };
+	ir_graph *const irg      = begin_function("loopnest", new_method(2, params, NULL),
+	                                          DEPTH);
+	ir_node  *const a        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Is);
+
+	ir_node *headers[DEPTH];
+	ir_node *exits[DEPTH];
+	for (int d = 0; d < DEPTH; ++d) {
+		set_value(d, iconst(mode_Is, 0));
+		headers[d] = loop_begin();
+		exits[d]   = branch(new_Cmp(get_value(d, mode_Is), n, ir_relation_less));
+	}
+	ir_node *index = get_value(0, mode_Is);
+	for (int d = 1; d < DEPTH; ++d)
+		index = new_Add(new_Mul(index, iconst(mode_Is, 3)), get_value(d, mode_Is));
+	ir_node *const addr = element(a, new_And(index, iconst(mode_Is, 1023)), 4);
+	store(addr, new_Add(load(addr, mode_Is), get_value(DEPTH - 1, mode_Is)));
+	for (int d = DEPTH; d-- > 0;) {
+		set_value(d, new_Add(get_value(d, mode_Is), iconst(mode_Is, 1)));
+		loop_end(headers[d], exits[d]);
+	}
+	end_function(irg, NULL);
+}
+
+/** Functions with large sparse switches. */
+static void gen_switches(void)
+{
+	enum { N_FUNCS = 12, N_CASES = 400, N_TARGETS = 40 };
+	ir_type *const it       = prim(mode_Is);
+	ir_type *const params[] = { it };
+	ir_type *const type     = new_method(1, params, it);
+	for (int k = 0; k < N_FUNCS; ++k) {
+		char name[32];
+		snprintf(name, sizeof(name), "switch_%d", k);
+		ir_graph *const irg = begin_function(name, type, 0);
+		ir_node  *const x   = param(0, mode_Is);
+
+		/* a dense cluster followed by sparse values */
+		ir_switch_table *const table = ir_new_switch_table(irg, N_CASES);
+		long value = -(long)rnd(100000);
+		for (unsigned c = 0; c < N_CASES; ++c) {
+			value += c < N_CASES / 4 ? 1 : 1 + (long)rnd(2000);
+			ir_tarval *const tv = new_tarval_from_long(value, mode_Is);
+			ir_switch_table_set(table, c, tv, tv, 1 + rnd(N_TARGETS));
+		}
+		ir_node *const sw = new_Switch(x, N_TARGETS + 1, table);
+		mature_immBlock(get_cur_block());
+		for (unsigned t = 0; t <= N_TARGETS; ++t) {
+			ir_node *const block = new_immBlock();
+			add_immBlock_pred(block, new_Proj(sw, mode_X, t));
+			mature_immBlock(block);
+			set_cur_block(block);
+			ir_node *res = new_Add(x, iconst(mode_Is, t * 7 + k));
+			ir_node *const ret = new_Return(get_store(), 1, &res);
+			add_immBlock_pred(get_irg_end_block(irg), ret);
+		}
+		irg_finalize_cons(irg);
+	}
+}
+
+static ir_node *random_operand(ir_node **const values, size_t const n_values,
+                               ir_mode *const mode)
+{
+	ir_node *const value = values[rnd(n_values)];
+	return get_irn_mode(value) == mode ? value : new_Conv(value, mode);
+}
+
+/** Large expressions over constants: exercises tarval arithmetic. */
+static void gen_constfold(void)
+{
+	enum { N_FUNCS = 8, N_OPS = 3000 };
+	static ir_mode *const *const modes[] = {
+		&mode_Ls, &mode_Lu, &mode_Is, &mode_Iu, &mode_Bu, &mode_D, &mode_F,
+	};
+	ir_type *const type = new_method(0, NULL, prim(mode_Ls));
+	for (int k = 0; k < N_FUNCS; ++k) {
+		char name[32];
+		snprintf(name, sizeof(name), "constfold_%d", k);
+		ir_graph *const irg = begin_function(name, type, 0);
+
+		ir_node **const values = malloc(N_OPS * sizeof(*values));
+		size_t          n      = 0;
+		for (; n < 16; ++n) {
+			ir_mode *const mode = *modes[rnd(ARRAY_SIZE(modes))];
+			values[n] = mode_is_float(mode)
+				? new_Const(new_tarval_from_double(rnd(100000) / 7.0 - 5000.0, mode))
+				: iconst(mode, (long)rnd(1u << 30) * (long)rnd(1u << 20) - (1L << 40));
+		}
+		for (; n < N_OPS; ++n) {
+			ir_mode *const mode = *modes[rnd(ARRAY_SIZE(modes))];
+			ir_node *const l    = random_operand(values, n, mode);
+			ir_node *const r    = random_operand(values, n, mode);
+			ir_node       *res;
+			unsigned const op   = rnd(mode_is_float(mode) ? 4 : 10);
+			switch (op) {
+			case 0: res = new_Add(l, r); break;
+			case 1: res = new_Sub(l, r); break;
+			case 2: res = new_Mul(l, r); break;
+			case 3: {
+				/* divide by a non-zero constant */
+				ir_node *const divisor = mode_is_float(mode)
+					? new_Const(new_tarval_from_double(rnd(1000) + 1.5, mode))
+					: iconst(mode, rnd(1000) + 1);
+				ir_node *const div = new_Div(get_store(), l, divisor, false);
+				set_store(new_Proj(div, mode_M, pn_Div_M));
+				res = new_Proj(div, mode, pn_Div_res);
+				break;
+			}
+			case 4: res = new_And(l, r); break;
+			case 5: res = new_Or(l, r); break;
+			case 6: res = new_Eor(l, r); break;
+			case 7: res = new_Shl(l, iconst(mode_Iu, rnd(get_mode_size_bits(mode)))); break;
+			case 8: res = new_Shrs(l, iconst(mode_Iu, rnd(get_mode_size_bits(mode)))); break;
+			default: res = new_Minus(l); break;
+			}
+			values[n] = res;
+		}
+
+		ir_node *res = iconst(mode_Ls, 0);
+		for (size_t i = n - 64; i < n; ++i)
+			res = new_Add(res, random_operand(values, i + 1, mode_Ls));
+		free(values);
+		end_function(irg, res);
+	}
+}
+
+/* Runtime kernels */
+
+/** long stream_sum(int *a, long n) / stride_sum: sums every stride-th int. */
+static void gen_sum(char const *const name, long const stride)
+{
+	ir_type  *const lt       = prim(mode_Ls);
+	ir_type  *const params[] = { new_type_pointer(prim(mode_Is)), lt };
+	ir_graph *const irg      = begin_function(name, new_method(2, params, lt), 2);
+	ir_node  *const a        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Ls);
+	set_value(0, iconst(mode_Ls, 0));
+	set_value(1, iconst(mode_Ls, 0));
+	ir_node *const header = loop_begin();
+	ir_node *const i      = get_value(0, mode_Ls);
+	ir_node *const exit   = branch(new_Cmp(i, n, ir_relation_less));
+	ir_node *const value  = load(element(a, i, 4 * stride), mode_Is);
+	set_value(1, new_Add(get_value(1, mode_Ls), new_Conv(value, mode_Ls)));
+	set_value(0, new_Add(i, iconst(mode_Ls, 1)));
+	loop_end(header, exit);
+	end_function(irg, get_value(1, mode_Ls));
+}
+
+/** void zero(int *a, int n) */
+static void gen_zero(void)
+{
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const params[] = { new_type_pointer(it), it };
+	ir_graph *const irg      = begin_function("zero", new_method(2, params, NULL), 1);
+	ir_node  *const a        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Is);
+	set_value(0, iconst(mode_Is, 0));
+	ir_node *const header = loop_begin();
+	ir_node *const i      = get_value(0, mode_Is);
+	ir_node *const exit   = branch(new_Cmp(i, n, ir_relation_less));
+	store(element(a, i, 4), iconst(mode_Is, 0));
+	set_value(0, new_Add(i, iconst(mode_Is, 1)));
+	loop_end(header, exit);
+	end_function(irg, NULL);
+}
+
+/** void copy(unsigned char *dst, unsigned char *src, int n) */
+static void gen_copy(void)
+{
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const pt       = new_type_pointer(prim(mode_Bu));
+	ir_type  *const params[] = { pt, pt, it };
+	ir_graph *const irg      = begin_function("copy", new_method(3, params, NULL), 1);
+	ir_node  *const dst      = param(0, mode_P);
+	ir_node  *const src      = param(1, mode_P);
+	ir_node  *const n        = param(2, mode_Is);
+	set_value(0, iconst(mode_Is, 0));
+	ir_node *const header = loop_begin();
+	ir_node *const i      = get_value(0, mode_Is);
+	ir_node *const exit   = branch(new_Cmp(i, n, ir_relation_less));
+	store(element(dst, i, 1), load(element(src, i, 1), mode_Bu));
+	set_value(0, new_Add(i, iconst(mode_Is, 1)));
+	loop_end(header, exit);
+	end_function(irg, NULL);
+}
+
+/** int len(char const *p) */
+static void gen_len(void)
+{
+	ir_type  *const params[] = { new_type_pointer(prim(mode_Bs)) };
+	ir_graph *const irg      = begin_function("len", new_method(1, params, prim(mode_Is)), 1);
+	ir_node  *const p        = param(0, mode_P);
+	ir_mode  *const offset   = get_reference_offset_mode(mode_P);
+	set_value(0, p);
+	ir_node *const header = loop_begin();
+	ir_node *const q      = get_value(0, mode_P);
+	ir_node *const c      = new_Conv(load(q, mode_Bs), mode_Is);
+	ir_node *const exit   = branch(new_Cmp(c, iconst(mode_Is, 0), ir_relation_less_greater));
+	set_value(0, new_Add(q, iconst(offset, 1)));
+	loop_end(header, exit);
+	end_function(irg, new_Conv(new_Sub(get_value(0, mode_P), p), mode_Is));
+}
+
+static void gen_kernels(void)
+{
+	gen_sum("stream_sum", 1);
+	gen_sum("stride_sum", 16);
+	gen_zero();
+	gen_copy();
+	gen_len();
+}
+
+typedef struct benchmark_t {
+	char const *name;
+	void      (*generate)(void);
+} benchmark_t;
+
+static benchmark_t const benchmarks[] = {
+	{ "small",     gen_small     },
+	{ "large",     gen_large     },
+	{ "phiweb",    gen_phiweb    },
+	{ "loopnest",  gen_loopnest  },
+	{ "switches",  gen_switches  },
+	{ "constfold", gen_constfold },
+	{ "kernels",   gen_kernels   },
+};
+
+int main(int argc, char **argv)
+{
+	if (argc != 4) {
+		fprintf(stderr, "Usage: %s <target triple> <benchmark> <output.ir>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	ir_init();
+	if (!ir_target_set(argv[1])) {
+		fprintf(stderr, "%s: unknown target '%s'\n", argv[0], argv[1]);
+		return EXIT_FAILURE;
+	}
+	ir_target_init();
+	set_optimize(0);
+
+	for (size_t b = 0; b < ARRAY_SIZE(benchmarks); ++b) {
+		if (strcmp(benchmarks[b].name, argv[2]) != 0)
+			continue;
+		benchmarks[b].generate();
+		for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i)
+			irg_verify(get_irp_irg(i));
+		if (ir_export(argv[3]) != 0) {
+			fprintf(stderr, "%s: could not write '%s'\n", argv[0], argv[3]);
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+	fprintf(stderr, "%s: unknown benchmark '%s'\n", argv[0], argv[2]);
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,465 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Generated code benchmark using the JIT.
+ *
+ * Usage: jitbench [-n config] [-mOPTION...]
+ *
+ * Builds a set of kernels as IR, optimizes them and compiles them with the
+ * ia32 JIT into memory.  Prints one line "<kernel> <config> <metric> <value>"
+ * per metric: the code size and, on i386 hosts where the code can be run
+ * in-process, the minimal number of cycles of a run.  Backend options like
+ * -mregalloc=pref are applied before the target is initialized, so every
+ * backend configuration needs its own process.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "jit.h"
+
+#if defined(__i386__) && defined(__linux__)
+#define JIT_EXECUTE
+#include <sys/mman.h>
+#include <x86intrin.h>
+#endif
+
+#define REPEAT 10
+
+/** unsigned fnv1a(unsigned char const *p, int n) */
+static void build_hash(void)
+{
+	ir_type  *const params[] = { new_type_pointer(prim(mode_Bu)), prim(mode_Is) };
+	ir_graph *const irg      = begin_function("fnv1a", new_method(2, params, prim(mode_Iu)), 2);
+	ir_node  *const p        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Is);
+	set_value(0, iconst(mode_Is, 0));
+	set_value(1, new_Conv(iconst(mode_Is, (int)0x811C9DC5), mode_Iu));
+	ir_node *const header = loop_begin();
+	ir_node *const i      = get_value(0, mode_Is);
+	ir_node *const exit   = branch(new_Cmp(i, n, ir_relation_less));
+	ir_node *const c      = new_Conv(load(element(p, i, 1), mode_Bu), mode_Iu);
+	ir_node *const h      = new_Eor(get_value(1, mode_Iu), c);
+	set_value(1, new_Mul(h, iconst(mode_Iu, 16777619)));
+	set_value(0, new_Add(i, iconst(mode_Is, 1)));
+	loop_end(header, exit);
+	end_function(irg, get_value(1, mode_Iu));
+}
+
+/** void isort(int *a, int n): insertion sort */
+static void build_sort(void)
+{
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const params[] = { new_type_pointer(it), it };
+	ir_graph *const irg      = begin_function("isort", new_method(2, params, NULL), 3);
+	ir_node  *const a        = param(0, mode_P);
+	ir_node  *const n        = param(1, mode_Is);
+	ir_node  *const one      = iconst(mode_Is, 1);
+	set_value(0, one);
+	ir_node *const outer      = loop_begin();
+	ir_node *const i          = get_value(0, mode_Is);
+	ir_node *const outer_exit = branch(new_Cmp(i, n, ir_relation_less));
+	ir_node *const v          = load(element(a, i, 4), mode_Is);
+	set_value(1, new_Sub(i, one));
+
+	ir_node *const inner   = loop_begin();
+	ir_node *const j       = get_value(1, mode_Is);
+	ir_node *const at_left = branch(new_Cmp(j, iconst(mode_Is, 0), ir_relation_greater_equal));
+	ir_node *const aj      = load(element(a, j, 4), mode_Is);
+	ir_node *const placed  = branch(new_Cmp(aj, v, ir_relation_greater));
+	store(element(a, new_Add(j, one), 4), aj);
+	set_value(1, new_Sub(j, one));
+	loop_end(inner, at_left);
+	join(placed);
+
+	store(element(a, new_Add(get_value(1, mode_Is), one), 4), v);
+	set_value(0, new_Add(i, one));
+	loop_end(outer, outer_exit);
+	end_function(irg, NULL);
+}
+
+/** void matmul(int *c, int const *a, int const *b, int n) */
+static void build_matrix(void)
+{
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const pt       = new_type_pointer(it);
+	ir_type  *const params[] = { pt, pt, pt, it };
+	ir_graph *const irg      = begin_function("matmul", new_method(4, params, NULL), 4);
+	ir_node  *const c        = param(0, mode_P);
+	ir_node  *const a        = param(1, mode_P);
+	ir_node  *const b        = param(2, mode_P);
+	ir_node  *const n        = param(3, mode_Is);
+	ir_node  *const zero     = iconst(mode_Is, 0);
+	ir_node  *const one      = iconst(mode_Is, 1);
+
+	set_value(0, zero);
+	ir_node *const hi = loop_begin();
+	ir_node *const i  = get_value(0, mode_Is);
+	ir_node *const ei = branch(new_Cmp(i, n, ir_relation_less));
+	set_value(1, zero);
+	ir_node *const hj = loop_begin();
+	ir_node *const j  = get_value(1, mode_Is);
+	ir_node *const ej = branch(new_Cmp(j, n, ir_relation_less));
+	set_value(2, zero);
+	set_value(3, zero);
+	ir_node *const hk = loop_begin();
+	ir_node *const k  = get_value(2, mode_Is);
+	ir_node *const ek = branch(new_Cmp(k, n, ir_relation_less));
+	ir_node *const x  = load(element(a, new_Add(new_Mul(i, n), k), 4), mode_Is);
+	ir_node *const y  = load(element(b, new_Add(new_Mul(k, n), j), 4), mode_Is);
+	set_value(3, new_Add(get_value(3, mode_Is), new_Mul(x, y)));
+	set_value(2, new_Add(k, one));
+	loop_end(hk, ek);
+	store(element(c, new_Add(new_Mul(i, n), j), 4), get_value(3, mode_Is));
+	set_value(1, new_Add(j, one));
+	loop_end(hj, ej);
+	set_value(0, new_Add(i, one));
+	loop_end(hi, ei);
+	end_function(irg, NULL);
+}
+
+enum {
+	OP_HALT, /**< return the accumulator */
+	OP_ADD,  /**< add the next byte to the accumulator */
+	OP_MUL,  /**< multiply the accumulator by 3 and add 1 */
+	OP_MIX,  /**< xor the accumulator with itself shifted right by 3 */
+	OP_LOOP, /**< decrement the counter, jump to the next byte if not zero */
+	OP_SET,  /**< set the counter to 64 times the next byte */
+	OP_LAST
+};
+
+/** int interp(unsigned char const *code, int x): a bytecode interpreter */
+static void build_interp(void)
+{
+	ir_type  *const it       = prim(mode_Is);
+	ir_type  *const params[] = { new_type_pointer(prim(mode_Bu)), it };
+	ir_graph *const irg      = begin_function("interp", new_method(2, params, it), 3);
+	ir_node  *const code     = param(0, mode_P);
+	set_value(0, iconst(mode_Is, 0));
+	set_value(1, param(1, mode_Is));
+	set_value(2, iconst(mode_Is, 0));
+
+	ir_node *const header = loop_begin();
+	ir_node *const pc     = get_value(0, mode_Is);
+	ir_node *const op     = new_Conv(load(element(code, pc, 1), mode_Bu), mode_Is);
+
+	ir_switch_table *const table = ir_new_switch_table(irg, OP_LAST);
+	for (unsigned o = 0; o < OP_LAST; ++o) {
+		ir_tarval *const tv = new_tarval_from_long(o, mode_Is);
+		ir_switch_table_set(table, o, tv, tv, o + 1);
+	}
+	ir_node *const sw   = new_Switch(op, OP_LAST + 1, table);
+	ir_node *const halt = new_immBlock();
+	add_immBlock_pred(halt, new_Proj(sw, mode_X, 0));
+	add_immBlock_pred(halt, new_Proj(sw, mode_X, OP_HALT + 1));
+	mature_immBlock(halt);
+
+	for (unsigned o = OP_ADD; o < OP_LAST; ++o) {
+		ir_node *const block = new_immBlock();
+		add_immBlock_pred(block, new_Proj(sw, mode_X, o + 1));
+		mature_immBlock(block);
+		set_cur_block(block);
+
+		ir_node *const acc  = get_value(1, mode_Is);
+		ir_node *const one  = iconst(mode_Is, 1);
+		ir_node *const two  = iconst(mode_Is, 2);
+		ir_node *const next = new_Add(pc, two);
+		switch (o) {
+		case OP_ADD: {
+			ir_node *const imm = new_Conv(load(element(code, new_Add(pc, one), 1), mode_Bu), mode_Is);
+			set_value(1, new_Add(acc, imm));
+			set_value(0, next);
+			break;
+		}
+		case OP_MUL:
+			set_value(1, new_Add(new_Mul(acc, iconst(mode_Is, 3)), one));
+			set_value(0, new_Add(pc, one));
+			break;
+		case OP_MIX:
+			set_value(1, new_Eor(acc, new_Shrs(acc, iconst(mode_Iu, 3))));
+			set_value(0, new_Add(pc, one));
+			break;
+		case OP_LOOP: {
+			ir_node *const cnt = new_Sub(get_value(2, mode_Is), one);
+			set_value(2, cnt);
+			ir_node *const done = branch(new_Cmp(cnt, iconst(mode_Is, 0), ir_relation_less_greater));
+			set_value(0, new_Conv(load(element(code, new_Add(pc, one), 1), mode_Bu), mode_Is));
+			add_immBlock_pred(header, new_Jmp());
+			set_cur_block(done);
+			set_value(0, next);
+			break;
+		}
+		case OP_SET: {
+			ir_node *const imm = new_Conv(load(element(code, new_Add(pc, one), 1), mode_Bu), mode_Is);
+			set_value(2, new_Mul(imm, iconst(mode_Is, 64)));
+			set_value(0, next);
+			break;
+		}
+		}
+		add_immBlock_pred(header, new_Jmp());
+	}
+	mature_immBlock(header);
+	set_cur_block(halt);
+	end_function(irg, get_value(1, mode_Is));
+}
+
+/** int upcase(char *s): converts s to upper case and returns its length */
+static void build_string(void)
+{
+	ir_type  *const params[] = { new_type_pointer(prim(mode_Bu)) };
+	ir_graph *const irg      = begin_function("upcase", new_method(1, params, prim(mode_Is)), 1);
+	ir_node  *const s        = param(0, mode_P);
+	ir_mode  *const offset   = get_reference_offset_mode(mode_P);
+	set_value(0, s);
+	ir_node *const header = loop_begin();
+	ir_node *const q      = get_value(0, mode_P);
+	ir_node *const c      = load(q, mode_Bu);
+	ir_node *const exit   = branch(new_Cmp(c, iconst(mode_Bu, 0), ir_relation_less_greater));
+	ir_node *const letter = new_Sub(new_Conv(c, mode_Iu), iconst(mode_Iu, 'a'));
+	ir_node *const other  = branch(new_Cmp(letter, iconst(mode_Iu, 26), ir_relation_less));
+	store(q, new_Sub(c, iconst(mode_Bu, 'a' - 'A')));
+	join(other);
+	set_value(0, new_Add(q, iconst(offset, 1)));
+	loop_end(header, exit);
+	end_function(irg, new_Conv(new_Sub(get_value(0, mode_P), s), mode_Is));
+}
+
+/* Reference implementations and inputs */
+
+static unsigned ref_fnv1a(unsigned char const *const p, int const n)
+{
+	unsigned h = 0x811C9DC5u;
+	for (int i = 0; i < n; ++i)
+		h = (h ^ p[i]) * 16777619u;
+	return h;
+}
+
+static int ref_interp(unsigned char const *const code, int acc)
+{
+	int pc  = 0;
+	int cnt = 0;
+	for (;;) {
+		switch (code[pc]) {
+		case OP_ADD:  acc += code[pc + 1];           pc += 2; break;
+		case OP_MUL:  acc  = (int)((unsigned)acc * 3 + 1); ++pc; break;
+		case OP_MIX:  acc ^= acc >> 3;               ++pc;    break;
+		case OP_LOOP: pc = --cnt != 0 ? code[pc + 1] : pc + 2; break;
+		case OP_SET:  cnt = code[pc + 1] * 64;       pc += 2; break;
+		default:      return acc;
+		}
+	}
+}
+
+static unsigned char const program[] = {
+	OP_SET, 250, OP_ADD, 7, OP_MUL, OP_MIX, OP_LOOP, 2, OP_HALT
+};
+
+#define N_BYTES  65536
+#define N_SORT   2000
+#define N_MATRIX 64
+
+typedef struct kernel_t {
+	char const *name;
+	char const *function; /**< name of the built function */
+	void      (*build)(void);
+	/** runs the compiled function, returns whether its result is correct */
+	bool      (*run)(void const *function);
+} kernel_t;
+
+static unsigned char bytes[N_BYTES];
+static int           sort_input[N_SORT];
+static int           matrix_a[N_MATRIX * N_MATRIX];
+static int           matrix_b[N_MATRIX * N_MATRIX];
+
+static bool run_hash(void const *const function)
+{
+	unsigned (*const f)(unsigned char const*, int) = (unsigned (*)(unsigned char const*, int))function;
+	return f(bytes, N_BYTES) == ref_fnv1a(bytes, N_BYTES);
+}
+
+static int compare_int(void const *const a, void const *const b)
+{
+	int const x = *(int const*)a;
+	int const y = *(int const*)b;
+	return x < y ? -1 : x > y;
+}
+
+static bool run_sort(void const *const function)
+{
+	void (*const f)(int*, int) = (void (*)(int*, int))function;
+	int a[N_SORT];
+	int ref[N_SORT];
+	memcpy(a, sort_input, sizeof(a));
+	memcpy(ref, sort_input, sizeof(ref));
+	f(a, N_SORT);
+	qsort(ref, N_SORT, sizeof(*ref), compare_int);
+	return memcmp(a, ref, sizeof(a)) == 0;
+}
+
+static bool run_matrix(void const *const function)
+{
+	void (*const f)(int*, int const*, int const*, int) = (void (*)(int*, int const*, int const*, int))function;
+	static int c[N_MATRIX * N_MATRIX];
+	f(c, matrix_a, matrix_b, N_MATRIX);
+	for (int i = 0; i < N_MATRIX; i += 7) {
+		for (int j = 0; j < N_MATRIX; j += 5) {
+			int sum = 0;
+			for (int k = 0; k < N_MATRIX; ++k)
+				sum += matrix_a[i * N_MATRIX + k] * matrix_b[k * N_MATRIX + j];
+			if (c[i * N_MATRIX + j] != sum)
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool run_interp(void const *const function)
+{
+	int (*const f)(unsigned char const*, int) = (int (*)(unsigned char const*, int))function;
+	return f(program, 42) == ref_interp(program, 42);
+}
+
+static bool run_string(void const *const function)
+{
+	int (*const f)(char*) = (int (*)(char*))function;
+	static char s[N_BYTES];
+	for (int i = 0; i < N_BYTES - 1; ++i)
+		s[i] = " abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"[bytes[i] % 63];
+	s[N_BYTES - 1] = '\0';
+	if (f(s) != N_BYTES - 1)
+		return false;
+	for (int i = 0; i < N_BYTES - 1; ++i) {
+		if (s[i] >= 'a' && s[i] <= 'z')
+			return false;
+	}
+	return true;
+}
+
+static kernel_t const kernels[] = {
+	{ "hash",   "fnv1a",  build_hash,   run_hash   },
+	{ "sort",   "isort",  build_sort,   run_sort   },
+	{ "matrix", "matmul", build_matrix, run_matrix },
+	{ "interp", "interp", build_interp, run_interp },
+	{ "string", "upcase", build_string, run_string },
+};
+
+static void init_inputs(void)
+{
+	unsigned seed = 42;
+	for (int i = 0; i < N_BYTES; ++i) {
+		seed     = seed * 1103515245 + 12345;
+		bytes[i] = (unsigned char)(seed >> 16);
+	}
+	for (int i = 0; i < N_SORT; ++i)
+		sort_input[i] = (int)(bytes[2 * i] << 8 | bytes[2 * i + 1]) - 32768;
+	for (int i = 0; i < N_MATRIX * N_MATRIX; ++i) {
+		matrix_a[i] = bytes[i] % 17 - 8;
+		matrix_b[i] = bytes[i + 1] % 13 - 6;
+	}
+}
+
+static ir_graph *find_graph(char const *const name)
+{
+	for (size_t i = 0, n = get_irp_n_irgs(); i < n; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		if (strcmp(get_entity_name(get_irg_entity(irg)), name) == 0)
+			return irg;
+	}
+	return NULL;
+}
+
+#ifdef JIT_EXECUTE
+/** Runs @p kernel REPEAT times and returns the minimal number of cycles. */
+static unsigned long long measure(kernel_t const *const kernel,
+                                  void const *const function, bool *const ok)
+{
+	unsigned long long best = ~0ULL;
+	*ok = true;
+	for (int r = 0; r < REPEAT; ++r) {
+		unsigned long long const start  = __rdtsc();
+		bool               const result = kernel->run(function);
+		unsigned long long const cycles = __rdtsc() - start;
+		*ok &= result;
+		if (cycles < best)
+			best = cycles;
+	}
+	return best;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+	char const *config = "default";
+
+	ir_init();
+	if (!ir_target_set("i686-linux-gnu")) {
+		fprintf(stderr, "%s: target i686-linux-gnu not available\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			config = argv[++i];
+		} else if (strncmp(argv[i], "-m", 2) == 0 && ir_target_option(argv[i] + 2) > 0) {
+			/* backend option */
+		} else {
+			fprintf(stderr, "Usage: %s [-n config] [-mOPTION...]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	ir_target_init();
+	init_inputs();
+
+	size_t const n_kernels = sizeof(kernels) / sizeof(*kernels);
+	for (size_t k = 0; k < n_kernels; ++k)
+		kernels[k].build();
+	bench_optimize(true, 0);
+	lower_highlevel();
+	be_lower_for_target();
+
+	ir_jit_segment_t *const segment = be_new_jit_segment();
+	int                     status  = EXIT_SUCCESS;
+	for (size_t k = 0; k < n_kernels; ++k) {
+		kernel_t          const *const kernel   = &kernels[k];
+		ir_graph                *const irg      = find_graph(kernel->function);
+		ir_jit_function_t       *const function = be_jit_compile(segment, irg);
+		if (function == NULL) {
+			fprintf(stderr, "%s: could not compile %s\n", argv[0], kernel->name);
+			return EXIT_FAILURE;
+		}
+		unsigned const size = be_get_function_size(function);
+		printf("%s %s code_bytes %u\n", kernel->name, config, size);
+
+#ifdef JIT_EXECUTE
+		void *const code = mmap(NULL, size, PROT_READ | PROT_WRITE | PROT_EXEC,
+		                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (code == MAP_FAILED) {
+			perror(argv[0]);
+			return EXIT_FAILURE;
+		}
+		be_emit_function(code, function);
+		bool                     ok;
+		unsigned long long const cycles = measure(kernel, code, &ok);
+		if (!ok) {
+			fprintf(stderr, "%s: %s computed a wrong result\n", argv[0], kernel->name);
+			status = EXIT_FAILURE;
+		}
+		printf("%s %s cycles %llu\n", kernel->name, config, cycles);
+		munmap(code, size);
+#else
+		/* the code cannot run here, but resolve its relocations anyway */
+		char *const code = malloc(size);
+		be_emit_function(code, function);
+		free(code);
+		(void)kernel->run;
+#endif
+	}
+	be_destroy_jit_segment(segment);
+	ir_finish();
+	return status;
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Runtime benchmark of the kernels benchmark.
+ *
+ * Linked with the assembler output of firmbench for the kernels benchmark.
+ * Checks the results of the kernels and prints one line
+ * "kernels-<variant> <target> <kernel>_ms <value>" per kernel.
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+long stream_sum(int *a, long n);
+long stride_sum(int *a, long n);
+void zero(int *a, int n);
+void copy(unsigned char *dst, unsigned char *src, int n);
+int  len(char const *p);
+
+#define N_INTS  (16 * 1024 * 1024)
+#define STRIDE  16
+#define REPEAT  5
+
+static char const *const names[] = {
+	"stream_sum", "stride_sum", "copy", "len", "zero"
+};
+#define N_KERNELS ((int)(sizeof(names) / sizeof(*names)))
+
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int failed;
+
+static void check(int const ok, char const *const kernel)
+{
+	if (!ok) {
+		fprintf(stderr, "kernel %s computed a wrong result\n", kernel);
+		failed = 1;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 3) {
+		fprintf(stderr, "Usage: %s <variant> <target triple>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	char const *const variant = argv[1];
+	char const *const target  = argv[2];
+
+	int           *const a   = malloc(N_INTS * sizeof(*a));
+	unsigned char *const src = malloc(N_INTS);
+	unsigned char *const dst = malloc(N_INTS);
+	char          *const str = malloc(N_INTS);
+	if (a == NULL || src == NULL || dst == NULL || str == NULL) {
+		perror(argv[0]);
+		return EXIT_FAILURE;
+	}
+	long expected_sum    = 0;
+	long expected_stride = 0;
+	for (long i = 0; i < N_INTS; ++i) {
+		a[i]             = (int)(i * 7 % 1000);
+		src[i]           = (unsigned char)(i * 3);
+		str[i]           = 'a' + i % 26;
+		expected_sum    += a[i];
+		if (i % STRIDE == 0)
+			expected_stride += a[i];
+	}
+	str[N_INTS - 1] = '\0';
+
+	double best[N_KERNELS];
+	for (int k = 0; k < N_KERNELS; ++k)
+		best[k] = 1e30;
+	for (int r = 0; r < REPEAT; ++r) {
+		double t = now_ms();
+		check(stream_sum(a, N_INTS) == expected_sum, "stream_sum");
+		double e = now_ms();
+		if (e - t < best[0])
+			best[0] = e - t;
+
+		t = now_ms();
+		check(stride_sum(a, N_INTS / STRIDE) == expected_stride, "stride_sum");
+		e = now_ms();
+		if (e - t < best[1])
+			best[1] = e - t;
+
+		t = now_ms();
+		copy(dst, src, N_INTS);
+		e = now_ms();
+		check(memcmp(dst, src, N_INTS) == 0, "copy");
+		if (e - t < best[2])
+			best[2] = e - t;
+
+		t = now_ms();
+		check(len(str) == N_INTS - 1, "len");
+		e = now_ms();
+		if (e - t < best[3])
+			best[3] = e - t;
+
+		t = now_ms();
+		zero(a, N_INTS);
+		e = now_ms();
+		check(a[0] == 0 && a[N_INTS / 2] == 0 && a[N_INTS - 1] == 0, "zero");
+		if (e - t < best[4])
+			best[4] = e - t;
+		/* restore the input of the sums */
+		for (long i = 0; i < N_INTS; ++i)
+			a[i] = (int)(i * 7 % 1000);
+	}
+
+	for (int k = 0; k < N_KERNELS; ++k)
+		printf("kernels-%s %s %s_ms %.3f\n", variant, target, names[k], best[k]);
+
+	free(str);
+	free(dst);
+	free(src);
+	free(a);
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -358,6 +358,8 @@ typedef void (dump_node_info_cb_t)(void *data, FILE *out, const ir_node *n);
  * @return A callback handle.
  *
  * @note This functionality is only available, if Firm hooks are enabled.
+ *       When libFirm is built with FIRM_NO_HOOKS (-DFIRM_HOOKS=Off for
+ *       cmake), the callbacks are never called.
  */
 FIRM_API hook_entry_t *dump_add_node_info_callback(dump_node_info_cb_t *cb, void *data);
 
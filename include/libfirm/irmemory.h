@@ -139,6 +139,21 @@ FIRM_API void set_irp_memory_disambiguator_options(ir_disambiguator_options opti
  */
 FIRM_API void mark_private_methods(void);
 
+/**
+ * Computes whole program points-to information for all graphs.
+ * Afterwards get_alias_relation() also reports accesses as not aliasing if
+ * their addresses may not point to the same objects.
+ * The information is conservative for nodes created later on, but it must be
+ * recomputed (or freed) after transformations that change which objects an
+ * existing address may point to.
+ */
+FIRM_API void compute_irp_points_to(void);
+
+/**
+ * Frees the points-to information computed by compute_irp_points_to().
+ */
+FIRM_API void free_irp_points_to(void);
+
 /** @} */
 
 #include "end.h"
@@ -300,6 +300,55 @@ FIRM_API void remove_phi_cycles(ir_graph *irg);
  */
 FIRM_API void proc_cloning(float threshold);
 
+/** A default growth budget for ipcp(), in nodes. */
+#define DEFAULT_IPCP_MAX_GROWTH 2000
+
+/**
+ * Interprocedural constant propagation. Propagates constants, addresses and
+ * value ranges of arguments along the call edges of the program.
+ * Parameters of methods whose callers are all known are replaced by their
+ * value if it is the same for all callers and comparisons of parameters
+ * with known ranges are folded.
+ * Calls passing constants that are not passed by all callers are redirected
+ * to a specialized copy of the callee if the weight of the constant arguments
+ * (see proc_cloning()) is at least threshold.
+ *
+ * @param threshold   the threshold for specializing a method
+ * @param max_growth  the maximum number of nodes added by specialized copies
+ */
+FIRM_API void ipcp(float threshold, unsigned max_growth);
+
+/**
+ * Speculative devirtualization. Computes the possible callees of all calls
+ * with cgana() and turns indirect calls with at most max_targets known
+ * callees into compares of the call address guarding direct calls of each
+ * callee.  If the callee set is not known to be complete, the original
+ * indirect call remains as fallback.  Calls which may throw exceptions are
+ * not converted.
+ *
+ * @param max_targets    the maximum number of callees of a converted call
+ * @param max_new_calls  the maximum number of calls added to the program
+ * @return the number of converted call sites
+ */
+FIRM_API unsigned devirtualize_calls(unsigned max_targets, unsigned max_new_calls);
+
+/**
+ * Prepares partial inlining of functions starting with an early exit like
+ * "if (fast_path) return x;" followed by a big slow path.
+ *
+ * Such a directly called function is split into its entry region and a
+ * call to an outlined, non-inlinable copy of the whole function on the slow
+ * path.  The entry region must not have side effects before the branch and
+ * must be taken at least as often as the slow path according to the
+ * Cond jump prediction or the estimated execution frequencies.
+ * Run inline_functions() afterwards to inline the entry regions.
+ *
+ * @param min_size        the minimum number of nodes of a split function
+ * @param max_entry_size  the maximum number of nodes in the entry region
+ * @return the number of split functions
+ */
+FIRM_API unsigned partial_inline(unsigned min_size, unsigned max_entry_size);
+
 /**
  * Reassociation.
  *
@@ -413,6 +462,28 @@ typedef void (*opt_ptr)(ir_graph *irg);
 FIRM_API void inline_functions(unsigned maxsize, int inline_threshold,
                                opt_ptr after_inline_opt);
 
+/**
+ * Heuristic inliner with a global growth budget. Works like
+ * inline_functions() but stops inlining (except for calls to always_inline
+ * functions) after the inlined callees added max_growth firm nodes to the
+ * program.
+ *
+ * The graphs are processed bottom-up by strongly connected components of the
+ * call graph, so the size summary of every callee is final when the calls to
+ * it are considered. Calls into a call graph cycle are treated as recursive.
+ *
+ * @param maxsize             Do not inline any calls if a method has more than
+ *                            maxsize firm nodes.  It may reach this limit by
+ *                            inlining.
+ * @param inline_threshold    inlining threshold
+ * @param max_growth          maximum number of nodes added by inlining
+ * @param after_inline_opt    optimizations performed immediately after inlining
+ *                            some calls
+ */
+FIRM_API void inline_functions_budget(unsigned maxsize, int inline_threshold,
+                                      unsigned max_growth,
+                                      opt_ptr after_inline_opt);
+
 /**
  * Combines congruent blocks into one.
  *
@@ -430,7 +501,10 @@ FIRM_API void do_loop_inversion(ir_graph *irg);
 /**
  * Perform loop unrolling on a given graph.
  * Loop unrolling multiplies the number loop completely by a number found
- * through a heuristic.
+ * through a heuristic.  The factor is bounded by the trip count, the code
+ * size, the estimated register pressure and the estimated execution frequency
+ * of the loop.  Loops with a small constant trip count are unrolled
+ * completely, cold loops are left alone.
  */
 FIRM_API void do_loop_unrolling(ir_graph *irg);
 
@@ -439,6 +513,33 @@ FIRM_API void do_loop_unrolling(ir_graph *irg);
  */
 FIRM_API void do_loop_peeling(ir_graph *irg);
 
+/**
+ * Replaces loops filling or copying arrays and loops searching the end of a
+ * string by calls to memset, memcpy and strlen.
+ *
+ * Only loops consisting of a header evaluating the loop condition and a single
+ * body block are recognized.  Copies of constant size become CopyB nodes.
+ *
+ * @param irg  the graph
+ */
+FIRM_API void opt_loop_idioms(ir_graph *irg);
+
+/**
+ * Inserts prefetches for strided memory accesses in innermost loops.
+ *
+ * Loads and Stores whose address advances by a constant stride per iteration
+ * are preceded by an ir_bk_prefetch Builtin for the address accessed
+ * @p distance bytes later.  Loops with a small constant trip count are
+ * skipped.  This should run after opt_osr() and the loop transformations,
+ * as the prefetches are memory operations which block further optimization
+ * of the accesses.
+ *
+ * @param irg       the graph
+ * @param distance  number of bytes to prefetch ahead, 256 or more for most
+ *                  memory bound loops
+ */
+FIRM_API void opt_prefetch(ir_graph *irg, unsigned distance);
+
 /**
  * Removes all entities which are unused.
  *
@@ -449,6 +550,19 @@ FIRM_API void do_loop_peeling(ir_graph *irg);
  */
 FIRM_API void garbage_collect_entities(void);
 
+/**
+ * Merges structurally identical functions.
+ *
+ * Graphs are grouped by a hash over their nodes and compared for
+ * isomorphism.  A duplicate which is only called directly in this
+ * compilation unit is removed and its calls are redirected.  Other
+ * duplicates are replaced by a thunk calling the remaining function, so
+ * their addresses stay distinct.  Weak functions are not merged.
+ *
+ * @return the number of merged functions
+ */
+FIRM_API unsigned merge_identical_functions(void);
+
 /**
  * Performs dead node elimination by copying the ir graph to a new obstack.
  *
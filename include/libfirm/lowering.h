@@ -80,7 +80,10 @@ FIRM_API void lower_CopyB(ir_graph *irg, unsigned max_small_size,
 
 /**
  * Lowers all Switches (Cond nodes with non-boolean mode) depending on spare_size.
- * They will either remain the same or be converted into if-cascades.
+ * Dense switches remain the same.  Other switches are partitioned into dense
+ * ranges, which become smaller Switches, narrow ranges, which are tested with
+ * bit masks, and single cases.  These are selected by a binary search tree
+ * balanced by the estimated execution frequencies of the cases.
  *
  * @param irg        The ir graph to be lowered.
  * @param small_switch  If switch has <= cases then change it to an if-cascade.
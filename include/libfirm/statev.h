@@ -62,6 +62,17 @@ FIRM_API void stat_ev(const char *name);
  */
 FIRM_API void stat_ev_begin(const char *filename_prefix, const char *filter);
 
+/**
+ * Initialize the stat ev machinery with a binary output stream.
+ * The stream is written to @p filename_prefix.evb and is considerably cheaper
+ * to produce than the textual format; support/statev_sql.py reads both.
+ * @param filename_prefix  The name of the file (.evb will be appended).
+ *                         File will be truncated!
+ * @param filter           See stat_ev_begin().
+ */
+FIRM_API void stat_ev_begin_binary(const char *filename_prefix,
+                                   const char *filter);
+
 /**
  * Shuts down stat ev machinery
  */
@@ -10,6 +10,8 @@
 #ifndef FIRM_TIMING_H
 #define FIRM_TIMING_H
 
+#include <stdio.h>
+
 #include "begin.h"
 
 /**
@@ -20,6 +22,18 @@
  */
 typedef struct ir_timer_t ir_timer_t;
 
+/**
+ * Hardware performance counters, which can be recorded by a timer in
+ * addition to the wallclock time.
+ */
+typedef enum ir_timer_counter_t {
+	IR_TIMER_INSTRUCTIONS,  /**< retired instructions */
+	IR_TIMER_CYCLES,        /**< CPU cycles */
+	IR_TIMER_CACHE_MISSES,  /**< last level cache misses */
+	IR_TIMER_BRANCH_MISSES, /**< mispredicted branches */
+	IR_TIMER_COUNTER_LAST = IR_TIMER_BRANCH_MISSES
+} ir_timer_counter_t;
+
 /**
  * Switch to real-time scheduling.
  * This shall make measurements more precise.
@@ -114,6 +128,65 @@ FIRM_API unsigned long ir_timer_elapsed_usec(const ir_timer_t *timer);
  */
 FIRM_API double ir_timer_elapsed_sec(const ir_timer_t *timer);
 
+/**
+ * Lets a timer record hardware performance counters while it is running.
+ * The counters are only available on Linux with perf events permitted
+ * (see perf_event_paranoid); otherwise the timer only measures time.
+ * Must be called while the timer is not running.
+ * @param timer The timer.
+ * @return non-zero if performance counters are available.
+ */
+FIRM_API int ir_timer_enable_counters(ir_timer_t *timer);
+
+/**
+ * Returns whether the performance counter @p counter could be opened.
+ */
+FIRM_API int ir_timer_counter_available(ir_timer_counter_t counter);
+
+/**
+ * Returns the value of a performance counter accumulated while the timer was
+ * running or 0 if the counter is not available.
+ */
+FIRM_API unsigned long long ir_timer_counter(const ir_timer_t *timer,
+                                             ir_timer_counter_t counter);
+
+/**
+ * Returns a short name for a performance counter, e.g. "instructions".
+ */
+FIRM_API const char *ir_timer_counter_name(ir_timer_counter_t counter);
+
+/**
+ * @defgroup pass_stats Pass Statistics
+ *
+ * Records wall clock time, CPU time, node count and obstack size for every
+ * run of an optimization or lowering pass.  Times are inclusive, i.e. a pass
+ * invoked by another pass is also accounted to the invoking pass.  Node counts
+ * are only determined for passes not nested into other passes.
+ * @{
+ */
+
+/** Enables or disables the recording of pass statistics. */
+FIRM_API void ir_pass_stats_enable(int enable);
+
+/** Discards all recorded pass statistics. */
+FIRM_API void ir_pass_stats_reset(void);
+
+/**
+ * Prints a table of the recorded pass statistics.
+ * @param out        the output file
+ * @param per_graph  if non-zero, print one line per pass and graph instead of
+ *                   one line per pass
+ */
+FIRM_API void ir_pass_stats_print(FILE *out, int per_graph);
+
+/**
+ * Writes the recorded pass runs as JSON in the Chrome trace event format,
+ * which can be viewed with chrome://tracing or Perfetto.
+ */
+FIRM_API void ir_pass_stats_dump_trace(FILE *out);
+
+/** @} */
+
 #include "end.h"
 
 #endif
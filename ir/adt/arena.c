@@ -0,0 +1,107 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Arena allocator with size-classed free lists.
+ */
+#include "arena.h"
+
+#include <string.h>
+
+#include "util.h"
+
+/** Bytes in use in all arenas */
+static size_t live_bytes;
+/** Maximum of live_bytes since the last arena_reset_peak() */
+static size_t peak_bytes;
+
+static unsigned get_size_class(size_t const size)
+{
+	unsigned c = 0;
+	while (c < ARENA_N_CLASSES && (size_t)ARENA_MIN_SIZE << c < size)
+		++c;
+	return c;
+}
+
+static size_t get_class_size(size_t const size)
+{
+	unsigned const c = get_size_class(size);
+	return c < ARENA_N_CLASSES ? (size_t)ARENA_MIN_SIZE << c : size;
+}
+
+void arena_init(arena_t *const arena)
+{
+	obstack_init(&arena->obst);
+	memset(arena->free_lists, 0, sizeof(arena->free_lists));
+	arena->in_use = 0;
+}
+
+void arena_destroy(arena_t *const arena)
+{
+	live_bytes -= arena->in_use;
+	obstack_free(&arena->obst, NULL);
+}
+
+void *arena_alloc(arena_t *const arena, size_t const size)
+{
+	unsigned const c     = get_size_class(size);
+	size_t   const bytes = get_class_size(size);
+	void          *res   = NULL;
+	if (c < ARENA_N_CLASSES) {
+		res = arena->free_lists[c];
+		if (res != NULL)
+			arena->free_lists[c] = *(void**)res;
+	}
+	if (res == NULL)
+		res = obstack_alloc(&arena->obst, bytes);
+
+	arena->in_use += bytes;
+	live_bytes    += bytes;
+	peak_bytes     = MAX(peak_bytes, live_bytes);
+	return res;
+}
+
+void *arena_zalloc(arena_t *const arena, size_t const size)
+{
+	return memset(arena_alloc(arena, size), 0, size);
+}
+
+void arena_free(arena_t *const arena, void *const ptr, size_t const size)
+{
+	unsigned const c     = get_size_class(size);
+	size_t   const bytes = get_class_size(size);
+	if (c < ARENA_N_CLASSES) {
+		*(void**)ptr         = arena->free_lists[c];
+		arena->free_lists[c] = ptr;
+	}
+	arena->in_use -= bytes;
+	live_bytes    -= bytes;
+}
+
+arena_mark_t arena_mark(arena_t *const arena)
+{
+	arena_mark_t const mark = { obstack_base(&arena->obst), arena->in_use };
+	return mark;
+}
+
+void arena_release(arena_t *const arena, arena_mark_t const mark)
+{
+	obstack_free(&arena->obst, mark.base);
+	/* The free lists may contain blocks allocated after the mark. */
+	memset(arena->free_lists, 0, sizeof(arena->free_lists));
+	live_bytes    -= arena->in_use - mark.in_use;
+	arena->in_use  = mark.in_use;
+}
+
+size_t arena_get_peak(void)
+{
+	return peak_bytes;
+}
+
+void arena_reset_peak(void)
+{
+	peak_bytes = live_bytes;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Arena allocator with size-classed free lists.
+ */
+#ifndef FIRM_ADT_ARENA_H
+#define FIRM_ADT_ARENA_H
+
+#include <stddef.h>
+
+#include "obst.h"
+
+/**
+ * @ingroup adt
+ * @defgroup arena Arena Allocator
+ * An obstack that can recycle single blocks.  Requests are rounded up to
+ * power of two size classes, so a block given back with arena_free() is
+ * handed out again by the next request of the same class.  This suits data
+ * that is resized or replaced while a phase runs, which an obstack would only
+ * release as a whole.  arena_mark() and arena_release() free everything
+ * allocated since the mark at once.
+ * @{
+ */
+
+/** Size of the smallest size class */
+#define ARENA_MIN_SIZE  16
+/** Number of size classes, larger requests are never recycled */
+#define ARENA_N_CLASSES 10
+
+typedef struct arena_t {
+	struct obstack obst;
+	void          *free_lists[ARENA_N_CLASSES];
+	size_t         in_use; /**< bytes handed out and not freed */
+} arena_t;
+
+/** A position in an arena, see arena_mark() */
+typedef struct arena_mark_t {
+	void  *base;
+	size_t in_use;
+} arena_mark_t;
+
+/** Initializes arena @p arena. */
+void arena_init(arena_t *arena);
+
+/** Frees all memory of arena @p arena. */
+void arena_destroy(arena_t *arena);
+
+/** Allocates @p size bytes on arena @p arena. */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/** Allocates @p size zeroed bytes on arena @p arena. */
+void *arena_zalloc(arena_t *arena, size_t size);
+
+/**
+ * Gives the block @p ptr of @p size bytes back to arena @p arena, so it can
+ * be reused by later allocations.  @p size must be the size requested when
+ * the block was allocated.
+ */
+void arena_free(arena_t *arena, void *ptr, size_t size);
+
+/** Returns the current position of arena @p arena. */
+arena_mark_t arena_mark(arena_t *arena);
+
+/**
+ * Frees all blocks allocated on arena @p arena since @p mark was taken.
+ * Blocks freed with arena_free() are not reused afterwards.
+ */
+void arena_release(arena_t *arena, arena_mark_t mark);
+
+/**
+ * Returns the maximal number of bytes in use in all arenas together since
+ * the last call of arena_reset_peak().
+ */
+size_t arena_get_peak(void);
+
+/** Restarts the peak measurement with the bytes currently in use. */
+void arena_reset_peak(void);
+
+/** Allocates an object of type @p type with a flexible array member. */
+#define ARENA_ALLOCF(arena, type, member, n) ((type*)arena_alloc((arena), offsetof(type, member) + sizeof(*((type*)0)->member) * (n)))
+
+/** Allocates a zeroed object of type @p type with a flexible array member. */
+#define ARENA_ALLOCFZ(arena, type, member, n) ((type*)arena_zalloc((arena), offsetof(type, member) + sizeof(*((type*)0)->member) * (n)))
+
+/** Allocates a zeroed object of type @p type. */
+#define ARENA_ALLOCZ(arena, type) ((type*)arena_zalloc((arena), sizeof(type)))
+
+/** @} */
+
+#endif
@@ -77,6 +77,54 @@ static inline unsigned ntz(uint32_t x)
 #endif
 }
 
+/**
+ * Compute the count of set bits in a 64-bit word.
+ * @param x A 64-bit word.
+ * @return The number of bits set in x.
+ */
+static inline unsigned popcount64(uint64_t x)
+{
+#if defined(__GNUC__) && __GNUC__ >= 4
+	return __builtin_popcountll(x);
+#else
+	return popcount((uint32_t)x) + popcount((uint32_t)(x >> 32));
+#endif
+}
+
+/**
+ * Compute the number of leading zeros in a 64-bit word.
+ * @param x The word.
+ * @return The number of leading (from the most significant bit) zeros.
+ */
+static inline unsigned nlz64(uint64_t x)
+{
+#if defined(__GNUC__) && __GNUC__ >= 4
+	if (x == 0)
+		return 64;
+	return __builtin_clzll(x);
+#else
+	uint32_t const high = (uint32_t)(x >> 32);
+	return high != 0 ? nlz(high) : 32 + nlz((uint32_t)x);
+#endif
+}
+
+/**
+ * Compute the number of trailing zeros in a 64-bit word.
+ * @param x The word.
+ * @return The number of trailing zeros.
+ */
+static inline unsigned ntz64(uint64_t x)
+{
+#if defined(__GNUC__) && __GNUC__ >= 4
+	if (x == 0)
+		return 64;
+	return __builtin_ctzll(x);
+#else
+	uint32_t const low = (uint32_t)x;
+	return low != 0 ? ntz(low) : 32 + ntz((uint32_t)(x >> 32));
+#endif
+}
+
 /**
  * Compute the greatest power of 2 smaller or equal to a value.
  * This is also known as the binary logarithm.
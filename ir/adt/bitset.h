@@ -374,6 +374,30 @@ static inline void bitset_or(bitset_t *tgt, bitset_t const *src)
 	rbitset_or(tgt->data, src->data, src->size);
 }
 
+/**
+ * Perform tgt = tgt & src operation and test whether tgt changed.
+ * @param tgt  The target bitset.
+ * @param src  The source bitset.
+ * @return true if a bit was removed from tgt.
+ */
+static inline bool bitset_and_changed(bitset_t *tgt, bitset_t const *src)
+{
+	assert(tgt->size == src->size);
+	return rbitset_and_changed(tgt->data, src->data, src->size);
+}
+
+/**
+ * Perform Union, tgt = tgt u src operation and test whether tgt changed.
+ * @param tgt  The target bitset.
+ * @param src  The source bitset.
+ * @return true if a bit was added to tgt.
+ */
+static inline bool bitset_or_changed(bitset_t *tgt, bitset_t const *src)
+{
+	assert(tgt->size == src->size);
+	return rbitset_or_changed(tgt->data, src->data, src->size);
+}
+
 /**
  * Perform tgt = tgt ^ src operation.
  * @param tgt  The target bitset.
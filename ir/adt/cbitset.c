@@ -0,0 +1,589 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Chunked bitsets for large, unevenly populated sets.
+ */
+#include "cbitset.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "array.h"
+#include "raw_bitset.h"
+#include "xmalloc.h"
+
+/** Number of words of a dense chunk */
+#define CHUNK_WORDS BITSET_SIZE_ELEMS(CBITSET_CHUNK_BITS)
+/** Size of the smallest array of a sparse chunk */
+#define SPARSE_MIN  4
+
+/** Returns the capacity of the offset array of a sparse chunk. */
+static size_t sparse_capacity(size_t const count)
+{
+	size_t cap = SPARSE_MIN;
+	while (cap < count)
+		cap *= 2;
+	return cap;
+}
+
+static void chunk_free(cbitset_chunk_t *const c)
+{
+	if (c->kind == CBITSET_SPARSE)
+		free(c->u.elems);
+	else if (c->kind == CBITSET_DENSE)
+		free(c->u.words);
+}
+
+static void chunk_init(cbitset_chunk_t *const c, uint32_t const key)
+{
+	c->key     = key;
+	c->count   = 0;
+	c->kind    = CBITSET_SPARSE;
+	c->u.elems = XMALLOCN(uint16_t, SPARSE_MIN);
+}
+
+static void chunk_copy(cbitset_chunk_t *const dst,
+                       cbitset_chunk_t const *const src)
+{
+	*dst = *src;
+	if (src->kind == CBITSET_SPARSE) {
+		size_t const cap = sparse_capacity(src->count);
+		dst->u.elems = XMALLOCN(uint16_t, cap);
+		memcpy(dst->u.elems, src->u.elems, src->count * sizeof(uint16_t));
+	} else if (src->kind == CBITSET_DENSE) {
+		dst->u.words = XMALLOCN(unsigned, CHUNK_WORDS);
+		rbitset_copy(dst->u.words, src->u.words, CBITSET_CHUNK_BITS);
+	}
+}
+
+/**
+ * Returns the position of @p off in the offsets of sparse chunk @p c or the
+ * position where it would be inserted.
+ */
+static size_t sparse_find(cbitset_chunk_t const *const c, unsigned const off)
+{
+	size_t lo = 0;
+	size_t hi = c->count;
+	while (lo < hi) {
+		size_t const mid = (lo + hi) / 2;
+		if (c->u.elems[mid] < off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/** Converts chunk @p c into a dense chunk. */
+static void chunk_make_dense(cbitset_chunk_t *const c)
+{
+	unsigned *const words = rbitset_malloc(CBITSET_CHUNK_BITS);
+	if (c->kind == CBITSET_SPARSE) {
+		for (size_t i = 0; i < c->count; ++i)
+			rbitset_set(words, c->u.elems[i]);
+		free(c->u.elems);
+	} else {
+		assert(c->kind == CBITSET_FULL);
+		rbitset_set_all(words, CBITSET_CHUNK_BITS);
+	}
+	c->kind    = CBITSET_DENSE;
+	c->u.words = words;
+}
+
+/**
+ * Chooses the representation of dense chunk @p c after its count changed.
+ * Dense chunks only become sparse again at half the sparse limit, so a chunk
+ * with a fluctuating number of members is not converted back and forth.
+ */
+static void dense_normalize(cbitset_chunk_t *const c)
+{
+	assert(c->kind == CBITSET_DENSE);
+	if (c->count == CBITSET_CHUNK_BITS) {
+		free(c->u.words);
+		c->kind = CBITSET_FULL;
+	} else if (c->count < CBITSET_SPARSE_MAX / 2) {
+		unsigned *const words = c->u.words;
+		uint16_t *const elems = XMALLOCN(uint16_t, sparse_capacity(c->count));
+		size_t          n     = 0;
+		rbitset_foreach(words, CBITSET_CHUNK_BITS, off) {
+			elems[n++] = (uint16_t)off;
+		}
+		assert(n == c->count);
+		free(words);
+		c->kind    = CBITSET_SPARSE;
+		c->u.elems = elems;
+	}
+}
+
+static bool chunk_is_set(cbitset_chunk_t const *const c, unsigned const off)
+{
+	switch ((cbitset_kind_t)c->kind) {
+	case CBITSET_SPARSE: {
+		size_t const pos = sparse_find(c, off);
+		return pos < c->count && c->u.elems[pos] == off;
+	}
+	case CBITSET_DENSE:
+		return rbitset_is_set(c->u.words, off);
+	case CBITSET_FULL:
+		return true;
+	}
+	return false;
+}
+
+/** Adds @p off to chunk @p c and returns whether it was not a member. */
+static bool chunk_set(cbitset_chunk_t *const c, unsigned const off)
+{
+	switch ((cbitset_kind_t)c->kind) {
+	case CBITSET_SPARSE: {
+		size_t const pos = sparse_find(c, off);
+		if (pos < c->count && c->u.elems[pos] == off)
+			return false;
+		if (c->count == CBITSET_SPARSE_MAX) {
+			chunk_make_dense(c);
+			return chunk_set(c, off);
+		}
+		size_t const cap = sparse_capacity(c->count);
+		if (c->count == cap)
+			c->u.elems = XREALLOC(c->u.elems, uint16_t, cap * 2);
+		memmove(&c->u.elems[pos + 1], &c->u.elems[pos],
+		        (c->count - pos) * sizeof(uint16_t));
+		c->u.elems[pos] = (uint16_t)off;
+		++c->count;
+		return true;
+	}
+	case CBITSET_DENSE:
+		if (rbitset_is_set(c->u.words, off))
+			return false;
+		rbitset_set(c->u.words, off);
+		++c->count;
+		if (c->count == CBITSET_CHUNK_BITS)
+			dense_normalize(c);
+		return true;
+	case CBITSET_FULL:
+		return false;
+	}
+	return false;
+}
+
+/** Removes @p off from chunk @p c. */
+static void chunk_clear(cbitset_chunk_t *const c, unsigned const off)
+{
+	switch ((cbitset_kind_t)c->kind) {
+	case CBITSET_SPARSE: {
+		size_t const pos = sparse_find(c, off);
+		if (pos == c->count || c->u.elems[pos] != off)
+			return;
+		--c->count;
+		memmove(&c->u.elems[pos], &c->u.elems[pos + 1],
+		        (c->count - pos) * sizeof(uint16_t));
+		return;
+	}
+	case CBITSET_FULL:
+		chunk_make_dense(c);
+		/* FALLTHROUGH */
+	case CBITSET_DENSE:
+		if (!rbitset_is_set(c->u.words, off))
+			return;
+		rbitset_clear(c->u.words, off);
+		--c->count;
+		dense_normalize(c);
+		return;
+	}
+}
+
+/**
+ * Returns the smallest member of chunk @p c, which is not smaller than
+ * @p off, or CBITSET_CHUNK_BITS.
+ */
+static unsigned chunk_next(cbitset_chunk_t const *const c, unsigned const off)
+{
+	switch ((cbitset_kind_t)c->kind) {
+	case CBITSET_SPARSE: {
+		size_t const pos = sparse_find(c, off);
+		return pos < c->count ? c->u.elems[pos] : CBITSET_CHUNK_BITS;
+	}
+	case CBITSET_DENSE: {
+		size_t const next = rbitset_next_max(c->u.words, off,
+		                                     CBITSET_CHUNK_BITS, true);
+		return next == (size_t)-1 ? CBITSET_CHUNK_BITS : (unsigned)next;
+	}
+	case CBITSET_FULL:
+		return off;
+	}
+	return CBITSET_CHUNK_BITS;
+}
+
+/** Merges the offsets of sparse chunk @p src into sparse chunk @p dst. */
+static bool sparse_or(cbitset_chunk_t *const dst,
+                      cbitset_chunk_t const *const src)
+{
+	uint16_t const *const s     = src->u.elems;
+	size_t          const n_dst = dst->count;
+	size_t          const n_src = src->count;
+
+	size_t n_new = 0;
+	for (size_t i = 0, j = 0; j < n_src; ++j) {
+		while (i < n_dst && dst->u.elems[i] < s[j])
+			++i;
+		if (i == n_dst || dst->u.elems[i] != s[j])
+			++n_new;
+	}
+	if (n_new == 0)
+		return false;
+
+	size_t const total = n_dst + n_new;
+	if (total > CBITSET_SPARSE_MAX) {
+		chunk_make_dense(dst);
+		for (size_t j = 0; j < n_src; ++j)
+			rbitset_set(dst->u.words, s[j]);
+		dst->count = total;
+		return true;
+	}
+
+	size_t const cap = sparse_capacity(total);
+	if (cap > sparse_capacity(n_dst))
+		dst->u.elems = XREALLOC(dst->u.elems, uint16_t, cap);
+	/* Merge from the back, so dst can be merged in place. */
+	uint16_t *const d   = dst->u.elems;
+	size_t          i   = n_dst;
+	size_t          j   = n_src;
+	size_t          out = total;
+	while (j > 0) {
+		if (i > 0 && d[i - 1] >= s[j - 1]) {
+			if (d[i - 1] == s[j - 1])
+				--j;
+			d[--out] = d[--i];
+		} else {
+			d[--out] = s[--j];
+		}
+	}
+	assert(out == i);
+	dst->count = total;
+	return true;
+}
+
+/** Adds the members of chunk @p src to chunk @p dst. */
+static bool chunk_or(cbitset_chunk_t *const dst,
+                     cbitset_chunk_t const *const src)
+{
+	if (dst->kind == CBITSET_FULL)
+		return false;
+	if (src->kind == CBITSET_FULL) {
+		chunk_free(dst);
+		dst->kind  = CBITSET_FULL;
+		dst->count = CBITSET_CHUNK_BITS;
+		return true;
+	}
+	if (src->kind == CBITSET_SPARSE && dst->kind == CBITSET_SPARSE)
+		return sparse_or(dst, src);
+	if (src->kind == CBITSET_SPARSE) {
+		bool changed = false;
+		for (size_t i = 0; i < src->count; ++i)
+			changed |= chunk_set(dst, src->u.elems[i]);
+		return changed;
+	}
+
+	if (dst->kind == CBITSET_SPARSE)
+		chunk_make_dense(dst);
+	if (!rbitset_or_changed(dst->u.words, src->u.words, CBITSET_CHUNK_BITS))
+		return false;
+	dst->count = rbitset_popcount(dst->u.words, CBITSET_CHUNK_BITS);
+	dense_normalize(dst);
+	return true;
+}
+
+/**
+ * Removes the members of chunk @p dst, which are not members of chunk @p src.
+ * The chunk may end up empty.
+ */
+static bool chunk_and(cbitset_chunk_t *const dst,
+                      cbitset_chunk_t const *const src)
+{
+	if (src->kind == CBITSET_FULL)
+		return false;
+	if (dst->kind == CBITSET_FULL) {
+		chunk_copy(dst, src);
+		return true;
+	}
+	if (dst->kind == CBITSET_SPARSE) {
+		size_t n = 0;
+		for (size_t i = 0; i < dst->count; ++i) {
+			uint16_t const off = dst->u.elems[i];
+			if (chunk_is_set(src, off))
+				dst->u.elems[n++] = off;
+		}
+		bool const changed = n != dst->count;
+		dst->count = n;
+		return changed;
+	}
+	if (src->kind == CBITSET_SPARSE) {
+		uint16_t *const elems = XMALLOCN(uint16_t, sparse_capacity(src->count));
+		size_t          n     = 0;
+		for (size_t i = 0; i < src->count; ++i) {
+			uint16_t const off = src->u.elems[i];
+			if (rbitset_is_set(dst->u.words, off))
+				elems[n++] = off;
+		}
+		free(dst->u.words);
+		dst->kind    = CBITSET_SPARSE;
+		dst->u.elems = elems;
+		dst->count   = n;
+		return true;
+	}
+
+	if (!rbitset_and_changed(dst->u.words, src->u.words, CBITSET_CHUNK_BITS))
+		return false;
+	dst->count = rbitset_popcount(dst->u.words, CBITSET_CHUNK_BITS);
+	dense_normalize(dst);
+	return true;
+}
+
+static bool chunk_intersect(cbitset_chunk_t const *const a,
+                            cbitset_chunk_t const *const b)
+{
+	if (a->kind == CBITSET_FULL || b->kind == CBITSET_FULL)
+		return true;
+	if (a->kind == CBITSET_DENSE && b->kind == CBITSET_DENSE)
+		return rbitsets_have_common(a->u.words, b->u.words, CBITSET_CHUNK_BITS);
+	cbitset_chunk_t const *const sparse = a->kind == CBITSET_SPARSE ? a : b;
+	cbitset_chunk_t const *const other  = sparse == a ? b : a;
+	for (size_t i = 0; i < sparse->count; ++i) {
+		if (chunk_is_set(other, sparse->u.elems[i]))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Returns the position of the chunk with key @p key in set @p set or the
+ * position where it would be inserted.
+ */
+static size_t find_chunk(cbitset_t const *const set, uint32_t const key)
+{
+	size_t lo = 0;
+	size_t hi = ARR_LEN(set->chunks);
+	while (lo < hi) {
+		size_t const mid = (lo + hi) / 2;
+		if (set->chunks[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/** Removes the chunk at position @p pos from set @p set. */
+static void remove_chunk(cbitset_t *const set, size_t const pos)
+{
+	size_t const len = ARR_LEN(set->chunks);
+	chunk_free(&set->chunks[pos]);
+	memmove(&set->chunks[pos], &set->chunks[pos + 1],
+	        (len - pos - 1) * sizeof(*set->chunks));
+	ARR_SHRINKLEN(set->chunks, len - 1);
+}
+
+void cbitset_init(cbitset_t *const set)
+{
+	set->chunks = NEW_ARR_F(cbitset_chunk_t, 0);
+}
+
+void cbitset_free(cbitset_t *const set)
+{
+	cbitset_clear_all(set);
+	DEL_ARR_F(set->chunks);
+	set->chunks = NULL;
+}
+
+void cbitset_clear_all(cbitset_t *const set)
+{
+	for (size_t i = 0, n = ARR_LEN(set->chunks); i < n; ++i)
+		chunk_free(&set->chunks[i]);
+	ARR_SHRINKLEN(set->chunks, 0);
+}
+
+void cbitset_set(cbitset_t *const set, size_t const bit)
+{
+	uint32_t const key = (uint32_t)(bit / CBITSET_CHUNK_BITS);
+	size_t   const pos = find_chunk(set, key);
+	size_t   const len = ARR_LEN(set->chunks);
+	if (pos == len || set->chunks[pos].key != key) {
+		ARR_RESIZE(cbitset_chunk_t, set->chunks, len + 1);
+		memmove(&set->chunks[pos + 1], &set->chunks[pos],
+		        (len - pos) * sizeof(*set->chunks));
+		chunk_init(&set->chunks[pos], key);
+	}
+	chunk_set(&set->chunks[pos], bit % CBITSET_CHUNK_BITS);
+}
+
+void cbitset_clear(cbitset_t *const set, size_t const bit)
+{
+	uint32_t const key = (uint32_t)(bit / CBITSET_CHUNK_BITS);
+	size_t   const pos = find_chunk(set, key);
+	if (pos == ARR_LEN(set->chunks) || set->chunks[pos].key != key)
+		return;
+	cbitset_chunk_t *const c = &set->chunks[pos];
+	chunk_clear(c, bit % CBITSET_CHUNK_BITS);
+	if (c->count == 0)
+		remove_chunk(set, pos);
+}
+
+bool cbitset_is_set(cbitset_t const *const set, size_t const bit)
+{
+	uint32_t const key = (uint32_t)(bit / CBITSET_CHUNK_BITS);
+	size_t   const pos = find_chunk(set, key);
+	return pos < ARR_LEN(set->chunks) && set->chunks[pos].key == key
+	    && chunk_is_set(&set->chunks[pos], bit % CBITSET_CHUNK_BITS);
+}
+
+bool cbitset_is_empty(cbitset_t const *const set)
+{
+	return ARR_LEN(set->chunks) == 0;
+}
+
+size_t cbitset_popcount(cbitset_t const *const set)
+{
+	size_t res = 0;
+	for (size_t i = 0, n = ARR_LEN(set->chunks); i < n; ++i)
+		res += set->chunks[i].count;
+	return res;
+}
+
+size_t cbitset_next(cbitset_t const *const set, size_t const pos)
+{
+	uint32_t const key = (uint32_t)(pos / CBITSET_CHUNK_BITS);
+	size_t   const n   = ARR_LEN(set->chunks);
+	size_t         i   = find_chunk(set, key);
+	if (i < n && set->chunks[i].key == key) {
+		cbitset_chunk_t const *const c   = &set->chunks[i];
+		unsigned               const off = chunk_next(c, pos % CBITSET_CHUNK_BITS);
+		if (off < CBITSET_CHUNK_BITS)
+			return (size_t)key * CBITSET_CHUNK_BITS + off;
+		++i;
+	}
+	if (i == n)
+		return (size_t)-1;
+	/* chunks are never empty */
+	cbitset_chunk_t const *const c = &set->chunks[i];
+	return (size_t)c->key * CBITSET_CHUNK_BITS + chunk_next(c, 0);
+}
+
+void cbitset_copy(cbitset_t *const dst, cbitset_t const *const src)
+{
+	size_t const n = ARR_LEN(src->chunks);
+	cbitset_clear_all(dst);
+	ARR_RESIZE(cbitset_chunk_t, dst->chunks, n);
+	for (size_t i = 0; i < n; ++i)
+		chunk_copy(&dst->chunks[i], &src->chunks[i]);
+}
+
+bool cbitset_or(cbitset_t *const dst, cbitset_t const *const src)
+{
+	cbitset_chunk_t const *const s_chunks = src->chunks;
+	size_t                 const n_src    = ARR_LEN(s_chunks);
+	size_t                 const n_dst    = ARR_LEN(dst->chunks);
+
+	/* Count the chunks missing in dst, so it is resized only once. */
+	size_t n_new = 0;
+	for (size_t d = 0, s = 0; s < n_src; ++s) {
+		while (d < n_dst && dst->chunks[d].key < s_chunks[s].key)
+			++d;
+		if (d == n_dst || dst->chunks[d].key != s_chunks[s].key)
+			++n_new;
+	}
+
+	bool changed = n_new != 0;
+	if (n_new != 0) {
+		/* Merge from the back, so no chunk is moved twice. */
+		ARR_RESIZE(cbitset_chunk_t, dst->chunks, n_dst + n_new);
+		cbitset_chunk_t *const d_chunks = dst->chunks;
+		size_t d   = n_dst;
+		size_t s   = n_src;
+		size_t out = n_dst + n_new;
+		while (s > 0) {
+			if (d > 0 && d_chunks[d - 1].key > s_chunks[s - 1].key) {
+				d_chunks[--out] = d_chunks[--d];
+			} else if (d > 0 && d_chunks[d - 1].key == s_chunks[s - 1].key) {
+				d_chunks[--out] = d_chunks[--d];
+				chunk_or(&d_chunks[out], &s_chunks[--s]);
+			} else {
+				chunk_copy(&d_chunks[--out], &s_chunks[--s]);
+			}
+		}
+		assert(out == d);
+		return changed;
+	}
+
+	for (size_t d = 0, s = 0; s < n_src; ++s) {
+		while (dst->chunks[d].key < s_chunks[s].key)
+			++d;
+		changed |= chunk_or(&dst->chunks[d], &s_chunks[s]);
+	}
+	return changed;
+}
+
+bool cbitset_and(cbitset_t *const dst, cbitset_t const *const src)
+{
+	cbitset_chunk_t       *const d_chunks = dst->chunks;
+	cbitset_chunk_t const *const s_chunks = src->chunks;
+	size_t                 const n_src    = ARR_LEN(s_chunks);
+	size_t                 const n_dst    = ARR_LEN(d_chunks);
+
+	bool   changed = false;
+	size_t out     = 0;
+	size_t s       = 0;
+	for (size_t d = 0; d < n_dst; ++d) {
+		cbitset_chunk_t *const c = &d_chunks[d];
+		while (s < n_src && s_chunks[s].key < c->key)
+			++s;
+		if (s < n_src && s_chunks[s].key == c->key) {
+			changed |= chunk_and(c, &s_chunks[s]);
+			if (c->count != 0) {
+				d_chunks[out++] = *c;
+				continue;
+			}
+		}
+		chunk_free(c);
+		changed = true;
+	}
+	ARR_SHRINKLEN(dst->chunks, out);
+	return changed;
+}
+
+bool cbitset_intersect(cbitset_t const *const a, cbitset_t const *const b)
+{
+	size_t const n_a = ARR_LEN(a->chunks);
+	size_t const n_b = ARR_LEN(b->chunks);
+	for (size_t i = 0, j = 0; i < n_a && j < n_b;) {
+		uint32_t const key_a = a->chunks[i].key;
+		uint32_t const key_b = b->chunks[j].key;
+		if (key_a < key_b) {
+			++i;
+		} else if (key_b < key_a) {
+			++j;
+		} else {
+			if (chunk_intersect(&a->chunks[i], &b->chunks[j]))
+				return true;
+			++i;
+			++j;
+		}
+	}
+	return false;
+}
+
+size_t cbitset_get_memory(cbitset_t const *const set)
+{
+	size_t const n   = ARR_LEN(set->chunks);
+	size_t       res = sizeof(*set) + n * sizeof(*set->chunks);
+	for (size_t i = 0; i < n; ++i) {
+		cbitset_chunk_t const *const c = &set->chunks[i];
+		if (c->kind == CBITSET_SPARSE)
+			res += sparse_capacity(c->count) * sizeof(uint16_t);
+		else if (c->kind == CBITSET_DENSE)
+			res += CHUNK_WORDS * sizeof(unsigned);
+	}
+	return res;
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Chunked bitsets for large, unevenly populated sets.
+ */
+#ifndef FIRM_ADT_CBITSET_H
+#define FIRM_ADT_CBITSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @ingroup adt
+ * @defgroup cbitset Chunked Bitsets
+ * A set of unsigned numbers, which is split into chunks of CBITSET_CHUNK_BITS
+ * numbers.  Only chunks with members are stored, each in the smallest of three
+ * representations: a sorted array of offsets for few members, a raw bitset
+ * for many members, or nothing at all if all numbers of the chunk are members.
+ * Memory use thus depends on the number and distribution of the members
+ * rather than on the largest member, which makes the sets suitable for
+ * analyses on huge graphs, where most sets are sparse or contain long ranges.
+ * @{
+ */
+
+/** Numbers per chunk */
+#define CBITSET_CHUNK_BITS 1024
+/** Maximum number of members of a chunk stored as an array of offsets */
+#define CBITSET_SPARSE_MAX 64
+
+typedef enum cbitset_kind_t {
+	CBITSET_SPARSE, /**< sorted array of offsets */
+	CBITSET_DENSE,  /**< raw bitset */
+	CBITSET_FULL,   /**< all numbers of the chunk, no data */
+} cbitset_kind_t;
+
+typedef struct cbitset_chunk_t {
+	uint32_t key;   /**< first number of the chunk / CBITSET_CHUNK_BITS */
+	uint16_t count; /**< number of members */
+	uint8_t  kind;  /**< a cbitset_kind_t */
+	union {
+		uint16_t *elems; /**< CBITSET_SPARSE: sorted offsets */
+		unsigned *words; /**< CBITSET_DENSE: raw bitset of the chunk */
+	} u;
+} cbitset_chunk_t;
+
+typedef struct cbitset_t {
+	cbitset_chunk_t *chunks; /**< flexible array of chunks sorted by key */
+} cbitset_t;
+
+/** Initializes the empty set @p set. */
+void cbitset_init(cbitset_t *set);
+
+/** Frees the memory of set @p set. */
+void cbitset_free(cbitset_t *set);
+
+/** Removes all members of set @p set. */
+void cbitset_clear_all(cbitset_t *set);
+
+/** Adds @p bit to set @p set. */
+void cbitset_set(cbitset_t *set, size_t bit);
+
+/** Removes @p bit from set @p set. */
+void cbitset_clear(cbitset_t *set, size_t bit);
+
+/** Returns whether @p bit is a member of set @p set. */
+bool cbitset_is_set(cbitset_t const *set, size_t bit);
+
+/** Returns whether set @p set is empty. */
+bool cbitset_is_empty(cbitset_t const *set);
+
+/** Returns the number of members of set @p set. */
+size_t cbitset_popcount(cbitset_t const *set);
+
+/**
+ * Returns the smallest member of set @p set, which is not smaller than
+ * @p pos, or (size_t)-1 if there is none.
+ */
+size_t cbitset_next(cbitset_t const *set, size_t pos);
+
+/** Makes @p dst a copy of @p src. */
+void cbitset_copy(cbitset_t *dst, cbitset_t const *src);
+
+/**
+ * Adds all members of @p src to @p dst.
+ * @return true if @p dst changed
+ */
+bool cbitset_or(cbitset_t *dst, cbitset_t const *src);
+
+/**
+ * Removes all members of @p dst, which are not members of @p src.
+ * @return true if @p dst changed
+ */
+bool cbitset_and(cbitset_t *dst, cbitset_t const *src);
+
+/** Returns whether the sets @p a and @p b have a common member. */
+bool cbitset_intersect(cbitset_t const *a, cbitset_t const *b);
+
+/** Returns the number of bytes allocated for set @p set. */
+size_t cbitset_get_memory(cbitset_t const *set);
+
+/**
+ * Iterates over the members of a chunked bitset in ascending order.
+ * @param set  the set
+ * @param elm  name of the size_t iteration variable
+ */
+#define cbitset_foreach(set, elm) \
+	for (size_t elm = cbitset_next((set), 0); elm != (size_t)-1; \
+	     elm = cbitset_next((set), elm + 1))
+
+/** @} */
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Indexed binary heap with priority changes and removal.
+ *
+ * The children of position i are at 2*i+1 and 2*i+2.  Every entry stores its
+ * position, so it can be found without a search when its priority changes.
+ */
+#include "heap.h"
+
+#include <assert.h>
+
+#include "array.h"
+#include "panic.h"
+
+static void heap_place(heap_t *const heap, heap_el_t const el,
+                       size_t const pos)
+{
+	heap->elems[pos] = el;
+	el.entry->index  = pos;
+}
+
+/** Moves @p el from position @p pos towards the root. */
+static void heap_sift_up(heap_t *const heap, heap_el_t const el, size_t pos)
+{
+	while (pos > 0) {
+		size_t    const parent_pos = (pos - 1) / 2;
+		heap_el_t const parent     = heap->elems[parent_pos];
+		if (parent.priority >= el.priority)
+			break;
+		heap_place(heap, parent, pos);
+		pos = parent_pos;
+	}
+	heap_place(heap, el, pos);
+}
+
+/** Moves @p el from position @p pos towards the leaves. */
+static void heap_sift_down(heap_t *const heap, heap_el_t const el, size_t pos)
+{
+	heap_el_t const *const elems = heap->elems;
+	size_t           const len   = ARR_LEN(elems);
+	for (;;) {
+		size_t child = 2 * pos + 1;
+		if (child >= len)
+			break;
+		if (child + 1 < len && elems[child + 1].priority > elems[child].priority)
+			++child;
+		if (elems[child].priority <= el.priority)
+			break;
+		heap_place(heap, elems[child], pos);
+		pos = child;
+	}
+	heap_place(heap, el, pos);
+}
+
+void heap_init(heap_t *const heap)
+{
+	heap->elems = NEW_ARR_F(heap_el_t, 0);
+}
+
+void heap_free(heap_t *const heap)
+{
+	DEL_ARR_F(heap->elems);
+}
+
+size_t heap_length(heap_t const *const heap)
+{
+	return ARR_LEN(heap->elems);
+}
+
+void heap_insert(heap_t *const heap, heap_entry_t *const entry,
+                 int const priority)
+{
+	assert(!heap_contains(entry));
+	heap_el_t const el = { .priority = priority, .entry = entry };
+	ARR_APP1(heap_el_t, heap->elems, el);
+	heap_sift_up(heap, el, ARR_LEN(heap->elems) - 1);
+}
+
+heap_entry_t *heap_pop_max(heap_t *const heap)
+{
+	if (heap_empty(heap))
+		panic("attempt to retrieve element from empty heap");
+	heap_entry_t *const res = heap->elems[0].entry;
+	heap_remove(heap, res);
+	return res;
+}
+
+void heap_set_priority(heap_t *const heap, heap_entry_t *const entry,
+                       int const priority)
+{
+	assert(heap_contains(entry) && heap->elems[entry->index].entry == entry);
+	size_t    const pos = entry->index;
+	heap_el_t const el  = { .priority = priority, .entry = entry };
+	if (priority > heap->elems[pos].priority) {
+		heap_sift_up(heap, el, pos);
+	} else {
+		heap_sift_down(heap, el, pos);
+	}
+}
+
+void heap_remove(heap_t *const heap, heap_entry_t *const entry)
+{
+	assert(heap_contains(entry) && heap->elems[entry->index].entry == entry);
+	size_t    const pos  = entry->index;
+	size_t    const len  = ARR_LEN(heap->elems) - 1;
+	heap_el_t const last = heap->elems[len];
+	ARR_SHRINKLEN(heap->elems, len);
+	entry->index = HEAP_NOT_QUEUED;
+	if (last.entry == entry)
+		return;
+
+	/* fill the hole with the last entry, which may have to move either way */
+	if (pos > 0 && heap->elems[(pos - 1) / 2].priority < last.priority) {
+		heap_sift_up(heap, last, pos);
+	} else {
+		heap_sift_down(heap, last, pos);
+	}
+}
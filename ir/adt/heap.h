@@ -0,0 +1,100 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Indexed binary heap with priority changes and removal.
+ */
+#ifndef FIRM_ADT_HEAP_H
+#define FIRM_ADT_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @ingroup adt
+ * @defgroup heap Indexed Heap
+ * A priority queue which returns the entry with the highest priority first.
+ * Entries are embedded into the queued objects and remember their position
+ * in the heap, so the priority of a queued entry can be changed and an entry
+ * can be removed in logarithmic time.  An object is queued at most once.
+ * @{
+ */
+
+/** Index of an entry which is not in a heap */
+#define HEAP_NOT_QUEUED ((size_t)-1)
+
+/** An entry of a heap, embedded into the queued object */
+typedef struct heap_entry_t {
+	size_t index; /**< position in the heap or HEAP_NOT_QUEUED */
+} heap_entry_t;
+
+/** A position in the heap.  The priority is kept here, so comparisons do not
+ * touch the queued objects. */
+typedef struct heap_el_t {
+	int           priority;
+	heap_entry_t *entry;
+} heap_el_t;
+
+typedef struct heap_t {
+	heap_el_t *elems; /**< flexible array of the queued entries */
+} heap_t;
+
+/** Initializes the heap @p heap. */
+void heap_init(heap_t *heap);
+
+/** Frees the heap @p heap.  Queued entries stay untouched. */
+void heap_free(heap_t *heap);
+
+/** Initializes @p entry as not queued. */
+static inline void heap_entry_init(heap_entry_t *const entry)
+{
+	entry->index = HEAP_NOT_QUEUED;
+}
+
+/** Returns whether @p entry is in a heap. */
+static inline bool heap_contains(heap_entry_t const *const entry)
+{
+	return entry->index != HEAP_NOT_QUEUED;
+}
+
+/** Returns the number of entries in heap @p heap. */
+size_t heap_length(heap_t const *heap);
+
+/** Returns whether heap @p heap is empty. */
+static inline bool heap_empty(heap_t const *const heap)
+{
+	return heap_length(heap) == 0;
+}
+
+/** Inserts @p entry, which must not be queued, with priority @p priority. */
+void heap_insert(heap_t *heap, heap_entry_t *entry, int priority);
+
+/** Removes and returns the entry with the highest priority. */
+heap_entry_t *heap_pop_max(heap_t *heap);
+
+/** Returns the priority of the queued @p entry. */
+static inline int heap_get_priority(heap_t const *const heap,
+                                    heap_entry_t const *const entry)
+{
+	return heap->elems[entry->index].priority;
+}
+
+/** Changes the priority of the queued @p entry to @p priority. */
+void heap_set_priority(heap_t *heap, heap_entry_t *entry, int priority);
+
+/** Removes the queued @p entry from heap @p heap. */
+void heap_remove(heap_t *heap, heap_entry_t *entry);
+
+/**
+ * Returns the object of type @p type with the heap entry @p member, which
+ * contains the heap entry @p ptr.
+ */
+#define heap_container(ptr, type, member) \
+	((type*)((char*)(ptr) - offsetof(type, member)))
+
+/** @} */
+
+#endif
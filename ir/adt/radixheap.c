@@ -0,0 +1,82 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Radix heap for monotone integer priorities.
+ */
+#include "radixheap.h"
+
+#include <assert.h>
+
+#include "array.h"
+#include "bitfiddle.h"
+#include "panic.h"
+
+/** Returns the bucket of @p key relative to the last removed key. */
+static unsigned get_bucket(radixheap_t const *const heap, uint32_t const key)
+{
+	uint32_t const diff = key ^ heap->last;
+	return diff == 0 ? 0 : 32 - nlz(diff);
+}
+
+void radixheap_init(radixheap_t *const heap)
+{
+	for (unsigned i = 0; i < RADIXHEAP_N_BUCKETS; ++i)
+		heap->buckets[i] = NEW_ARR_F(radixheap_el_t, 0);
+	heap->last   = 0;
+	heap->length = 0;
+}
+
+void radixheap_free(radixheap_t *const heap)
+{
+	for (unsigned i = 0; i < RADIXHEAP_N_BUCKETS; ++i)
+		DEL_ARR_F(heap->buckets[i]);
+}
+
+void radixheap_put(radixheap_t *const heap, void *const data,
+                   uint32_t const key)
+{
+	assert(key >= heap->last && "radix heap keys must be monotone");
+	radixheap_el_t const el = { .key = key, .data = data };
+	ARR_APP1(radixheap_el_t, heap->buckets[get_bucket(heap, key)], el);
+	++heap->length;
+}
+
+void *radixheap_pop_min(radixheap_t *const heap)
+{
+	if (heap->length == 0)
+		panic("attempt to retrieve element from empty radix heap");
+
+	if (ARR_LEN(heap->buckets[0]) == 0) {
+		/* Redistribute the first non-empty bucket relative to its minimum.
+		 * All its keys share the bits above the bucket's bit with the
+		 * minimum, so they all end up in lower buckets. */
+		unsigned b = 1;
+		while (ARR_LEN(heap->buckets[b]) == 0)
+			++b;
+		radixheap_el_t *const bucket = heap->buckets[b];
+		uint32_t              min    = bucket[0].key;
+		for (size_t i = 1, n = ARR_LEN(bucket); i < n; ++i) {
+			if (bucket[i].key < min)
+				min = bucket[i].key;
+		}
+		heap->last = min;
+		for (size_t i = 0, n = ARR_LEN(bucket); i < n; ++i) {
+			unsigned const nb = get_bucket(heap, bucket[i].key);
+			assert(nb < b);
+			ARR_APP1(radixheap_el_t, heap->buckets[nb], bucket[i]);
+		}
+		ARR_SHRINKLEN(heap->buckets[b], 0);
+	}
+
+	radixheap_el_t *const bucket = heap->buckets[0];
+	size_t          const len    = ARR_LEN(bucket) - 1;
+	void           *const data   = bucket[len].data;
+	ARR_SHRINKLEN(heap->buckets[0], len);
+	if (--heap->length == 0)
+		heap->last = 0;
+	return data;
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief  Radix heap for monotone integer priorities.
+ */
+#ifndef FIRM_ADT_RADIXHEAP_H
+#define FIRM_ADT_RADIXHEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @ingroup adt
+ * @defgroup radixheap Radix Heap
+ * A priority queue with unsigned keys, which returns the element with the
+ * smallest key first.  The queue is monotone: a new key must not be smaller
+ * than the last key removed, unless the queue has run empty in between.
+ * Elements are kept in buckets by the highest bit in which their key differs
+ * from the last removed key, so an element moves between buckets at most 32
+ * times and no comparisons between elements are needed.
+ * @{
+ */
+
+/** Number of buckets: one for every bit of the key plus one for equal keys */
+#define RADIXHEAP_N_BUCKETS 33
+
+typedef struct radixheap_el_t {
+	uint32_t key;
+	void    *data;
+} radixheap_el_t;
+
+typedef struct radixheap_t {
+	radixheap_el_t *buckets[RADIXHEAP_N_BUCKETS]; /**< flexible arrays */
+	uint32_t        last;   /**< the last key removed */
+	size_t          length;
+} radixheap_t;
+
+/** Initializes radix heap @p heap. */
+void radixheap_init(radixheap_t *heap);
+
+/** Frees radix heap @p heap. */
+void radixheap_free(radixheap_t *heap);
+
+/** Inserts @p data with key @p key into radix heap @p heap. */
+void radixheap_put(radixheap_t *heap, void *data, uint32_t key);
+
+/** Removes and returns an element with the smallest key. */
+void *radixheap_pop_min(radixheap_t *heap);
+
+/** Returns the number of elements in radix heap @p heap. */
+static inline size_t radixheap_length(radixheap_t const *const heap)
+{
+	return heap->length;
+}
+
+/** Returns whether radix heap @p heap is empty. */
+static inline bool radixheap_empty(radixheap_t const *const heap)
+{
+	return heap->length == 0;
+}
+
+/** @} */
+
+#endif
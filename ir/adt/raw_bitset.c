@@ -0,0 +1,336 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Vectorized kernels for operations on large raw bitsets.
+ *
+ * The kernels use SSE2 where it is part of the target and AVX2 if the host cpu
+ * supports it (detected at runtime by init_rbitset()); elsewhere and for the
+ * remaining elements plain C loops are used.
+ */
+#include "raw_bitset.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && defined(__SSE2__)
+#define RBITSET_USE_SSE2 1
+#include <immintrin.h>
+#else
+#define RBITSET_USE_SSE2 0
+#endif
+
+#if RBITSET_USE_SSE2 && (__GNUC__ >= 5 || defined(__clang__))
+#define RBITSET_USE_AVX2 1
+#else
+#define RBITSET_USE_AVX2 0
+#endif
+
+#if RBITSET_USE_AVX2
+static bool use_avx2;
+#endif
+
+void init_rbitset(void)
+{
+#if RBITSET_USE_AVX2
+	__builtin_cpu_init();
+	use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+static inline unsigned apply_scalar(rbitset_op_t op, unsigned a, unsigned b)
+{
+	switch (op) {
+	case RBITSET_AND:    return a & b;
+	case RBITSET_OR:     return a | b;
+	case RBITSET_ANDNOT: return a & ~b;
+	case RBITSET_XOR:    return a ^ b;
+	case RBITSET_COPY:   return b;
+	}
+	return a;
+}
+
+#if RBITSET_USE_SSE2
+static inline __m128i sse2_apply(rbitset_op_t op, __m128i a, __m128i b)
+{
+	switch (op) {
+	case RBITSET_AND:    return _mm_and_si128(a, b);
+	case RBITSET_OR:     return _mm_or_si128(a, b);
+	case RBITSET_ANDNOT: return _mm_andnot_si128(b, a);
+	case RBITSET_XOR:    return _mm_xor_si128(a, b);
+	case RBITSET_COPY:   return b;
+	}
+	return a;
+}
+
+static inline bool sse2_is_zero(__m128i x)
+{
+	return _mm_movemask_epi8(_mm_cmpeq_epi32(x, _mm_setzero_si128())) == 0xFFFF;
+}
+
+/** Applies @p op to blocks of 4 elements, returns the number of elements
+ * processed and ors the changed bits into @p changed. */
+static inline size_t sse2_apply_op(rbitset_op_t op, unsigned *dst,
+                                   const unsigned *src, size_t n,
+                                   __m128i *changed)
+{
+	__m128i diff = _mm_setzero_si128();
+	size_t  i    = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i d   = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i s   = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i res = sse2_apply(op, d, s);
+		diff = _mm_or_si128(diff, _mm_xor_si128(d, res));
+		_mm_storeu_si128((__m128i *)(dst + i), res);
+	}
+	*changed = diff;
+	return i;
+}
+
+static size_t sse2_apply_all(rbitset_op_t op, unsigned *dst,
+                             const unsigned *src, size_t n, bool *changed)
+{
+	__m128i diff;
+	size_t  i;
+	switch (op) {
+	case RBITSET_AND:    i = sse2_apply_op(RBITSET_AND,    dst, src, n, &diff); break;
+	case RBITSET_OR:     i = sse2_apply_op(RBITSET_OR,     dst, src, n, &diff); break;
+	case RBITSET_ANDNOT: i = sse2_apply_op(RBITSET_ANDNOT, dst, src, n, &diff); break;
+	case RBITSET_XOR:    i = sse2_apply_op(RBITSET_XOR,    dst, src, n, &diff); break;
+	default:             i = sse2_apply_op(RBITSET_COPY,   dst, src, n, &diff); break;
+	}
+	*changed = !sse2_is_zero(diff);
+	return i;
+}
+
+static size_t sse2_find(rbitset_op_t op, const unsigned *a, const unsigned *b,
+                        size_t n)
+{
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+		if (!sse2_is_zero(sse2_apply(op, x, y)))
+			break;
+	}
+	return i;
+}
+
+static size_t sse2_scan(const unsigned *bitset, size_t i, size_t n,
+                        unsigned mask)
+{
+	__m128i m = _mm_set1_epi32((int)mask);
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(bitset + i));
+		if (!sse2_is_zero(_mm_xor_si128(x, m)))
+			break;
+	}
+	return i;
+}
+
+/** Counts the bits in the 64bit lanes of @p x. */
+static inline __m128i sse2_popcount_epi64(__m128i x)
+{
+	__m128i const m1 = _mm_set1_epi8(0x55);
+	__m128i const m2 = _mm_set1_epi8(0x33);
+	__m128i const m4 = _mm_set1_epi8(0x0F);
+	x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+	x = _mm_add_epi8(_mm_and_si128(x, m2),
+	                 _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+	x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+	return _mm_sad_epu8(x, _mm_setzero_si128());
+}
+
+static size_t sse2_popcount(const unsigned *bitset, size_t n, size_t *count)
+{
+	__m128i sum = _mm_setzero_si128();
+	size_t  i   = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(bitset + i));
+		sum = _mm_add_epi64(sum, sse2_popcount_epi64(x));
+	}
+	sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+	*count = (size_t)_mm_cvtsi128_si32(sum);
+	return i;
+}
+#endif
+
+#if RBITSET_USE_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+static inline AVX2 __m256i avx2_apply(rbitset_op_t op, __m256i a, __m256i b)
+{
+	switch (op) {
+	case RBITSET_AND:    return _mm256_and_si256(a, b);
+	case RBITSET_OR:     return _mm256_or_si256(a, b);
+	case RBITSET_ANDNOT: return _mm256_andnot_si256(b, a);
+	case RBITSET_XOR:    return _mm256_xor_si256(a, b);
+	case RBITSET_COPY:   return b;
+	}
+	return a;
+}
+
+static inline AVX2 size_t avx2_apply_op(rbitset_op_t op, unsigned *dst,
+                                        const unsigned *src, size_t n,
+                                        __m256i *changed)
+{
+	__m256i diff = _mm256_setzero_si256();
+	size_t  i    = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i d   = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i s   = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i res = avx2_apply(op, d, s);
+		diff = _mm256_or_si256(diff, _mm256_xor_si256(d, res));
+		_mm256_storeu_si256((__m256i *)(dst + i), res);
+	}
+	*changed = diff;
+	return i;
+}
+
+static AVX2 size_t avx2_apply_all(rbitset_op_t op, unsigned *dst,
+                                  const unsigned *src, size_t n, bool *changed)
+{
+	__m256i diff;
+	size_t  i;
+	switch (op) {
+	case RBITSET_AND:    i = avx2_apply_op(RBITSET_AND,    dst, src, n, &diff); break;
+	case RBITSET_OR:     i = avx2_apply_op(RBITSET_OR,     dst, src, n, &diff); break;
+	case RBITSET_ANDNOT: i = avx2_apply_op(RBITSET_ANDNOT, dst, src, n, &diff); break;
+	case RBITSET_XOR:    i = avx2_apply_op(RBITSET_XOR,    dst, src, n, &diff); break;
+	default:             i = avx2_apply_op(RBITSET_COPY,   dst, src, n, &diff); break;
+	}
+	*changed = !_mm256_testz_si256(diff, diff);
+	return i;
+}
+
+static AVX2 size_t avx2_find(rbitset_op_t op, const unsigned *a,
+                             const unsigned *b, size_t n)
+{
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i x   = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i y   = _mm256_loadu_si256((const __m256i *)(b + i));
+		__m256i res = avx2_apply(op, x, y);
+		if (!_mm256_testz_si256(res, res))
+			break;
+	}
+	return i;
+}
+
+static AVX2 size_t avx2_scan(const unsigned *bitset, size_t i, size_t n,
+                             unsigned mask)
+{
+	__m256i m = _mm256_set1_epi32((int)mask);
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_xor_si256(
+			_mm256_loadu_si256((const __m256i *)(bitset + i)), m);
+		if (!_mm256_testz_si256(x, x))
+			break;
+	}
+	return i;
+}
+
+/* Counts bits with a nibble lookup table, see Mula, Kurz and Lemire: Faster
+ * Population Counts Using AVX2 Instructions. */
+static AVX2 size_t avx2_popcount(const unsigned *bitset, size_t n,
+                                 size_t *count)
+{
+	__m256i const table = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	__m256i const low = _mm256_set1_epi8(0x0F);
+	__m256i       sum = _mm256_setzero_si256();
+	size_t        i   = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i x  = _mm256_loadu_si256((const __m256i *)(bitset + i));
+		__m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(x, low));
+		__m256i hi = _mm256_shuffle_epi8(table,
+			_mm256_and_si256(_mm256_srli_epi16(x, 4), low));
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi),
+		                                            _mm256_setzero_si256()));
+	}
+	__m128i s = _mm_add_epi64(_mm256_castsi256_si128(sum),
+	                          _mm256_extracti128_si256(sum, 1));
+	s = _mm_add_epi64(s, _mm_unpackhi_epi64(s, s));
+	*count = (size_t)_mm_cvtsi128_si32(s);
+	return i;
+}
+#endif
+
+bool rbitset_apply_(rbitset_op_t op, unsigned *dst, const unsigned *src,
+                    size_t n)
+{
+	bool   changed = false;
+	size_t i       = 0;
+#if RBITSET_USE_AVX2
+	if (use_avx2)
+		i = avx2_apply_all(op, dst, src, n, &changed);
+	else
+#endif
+#if RBITSET_USE_SSE2
+		i = sse2_apply_all(op, dst, src, n, &changed);
+#endif
+	for (; i < n; ++i) {
+		unsigned res = apply_scalar(op, dst[i], src[i]);
+		changed |= res != dst[i];
+		dst[i]   = res;
+	}
+	return changed;
+}
+
+size_t rbitset_find_(rbitset_op_t op, const unsigned *a, const unsigned *b,
+                     size_t n)
+{
+	size_t i = 0;
+#if RBITSET_USE_AVX2
+	if (use_avx2)
+		i = avx2_find(op, a, b, n);
+	else
+#endif
+#if RBITSET_USE_SSE2
+		i = sse2_find(op, a, b, n);
+#endif
+	/* continues in the block, where the vector loop stopped */
+	for (; i < n; ++i) {
+		if (apply_scalar(op, a[i], b[i]) != 0)
+			break;
+	}
+	return i;
+}
+
+size_t rbitset_scan_(const unsigned *bitset, size_t i, size_t n,
+                     unsigned mask)
+{
+#if RBITSET_USE_AVX2
+	if (use_avx2)
+		i = avx2_scan(bitset, i, n, mask);
+	else
+#endif
+#if RBITSET_USE_SSE2
+		i = sse2_scan(bitset, i, n, mask);
+#endif
+	for (; i < n; ++i) {
+		if (bitset[i] != mask)
+			break;
+	}
+	return i;
+}
+
+size_t rbitset_popcount_(const unsigned *bitset, size_t n)
+{
+	size_t count = 0;
+	size_t i     = 0;
+#if RBITSET_USE_AVX2
+	if (use_avx2)
+		i = avx2_popcount(bitset, n, &count);
+	else
+#endif
+#if RBITSET_USE_SSE2
+		i = sse2_popcount(bitset, n, &count);
+#endif
+	for (; i < n; ++i) {
+		count += popcount(bitset[i]);
+	}
+	return count;
+}
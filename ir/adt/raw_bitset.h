@@ -20,6 +20,9 @@
  *
  *     The bitset is built as an array of unsigned integers. The unused bits
  *     must be zero.
+ *
+ *     Bulk operations on bitsets with at least RBITSET_BULK_ELEMS elements
+ *     use the vectorized kernels in raw_bitset.c.
  */
 #ifndef FIRM_ADT_RAW_BITSET_H
 #define FIRM_ADT_RAW_BITSET_H
@@ -34,6 +37,48 @@
 #define BITSET_SIZE_BYTES(size_bits) (BITSET_SIZE_ELEMS(size_bits) * sizeof(unsigned))
 #define BITSET_ELEM(bitset,pos)      bitset[pos / BITS_PER_ELEM]
 
+/** Minimum number of elements for which the vectorized kernels are used. */
+#define RBITSET_BULK_ELEMS 16
+
+/** Element-wise operations of the vectorized kernels. */
+typedef enum rbitset_op_t {
+	RBITSET_AND,    /**< dst & src */
+	RBITSET_OR,     /**< dst | src */
+	RBITSET_ANDNOT, /**< dst & ~src */
+	RBITSET_XOR,    /**< dst ^ src */
+	RBITSET_COPY,   /**< src */
+} rbitset_op_t;
+
+/**
+ * Selects the vectorized kernels for the host cpu.  Without it, the kernels
+ * use SSE2 where available.
+ */
+void init_rbitset(void);
+
+/**
+ * Replaces the @p n elements of @p dst by their combination with @p src.
+ * Returns whether @p dst changed.
+ */
+bool rbitset_apply_(rbitset_op_t op, unsigned *dst, const unsigned *src,
+                    size_t n);
+
+/**
+ * Returns the index of the first of the @p n elements where the combination
+ * of @p a and @p b is not zero, or @p n.
+ */
+size_t rbitset_find_(rbitset_op_t op, const unsigned *a, const unsigned *b,
+                     size_t n);
+
+/**
+ * Returns the index of the first element starting at @p i which differs from
+ * @p mask, or @p n.
+ */
+size_t rbitset_scan_(const unsigned *bitset, size_t i, size_t n,
+                     unsigned mask);
+
+/** Returns the number of set bits in the @p n elements of @p bitset. */
+size_t rbitset_popcount_(const unsigned *bitset, size_t n);
+
 /**
  * Allocate an empty raw bitset on the heap.
  *
@@ -92,7 +137,10 @@ static inline unsigned *rbitset_duplicate_obstack_alloc(struct obstack *obst,
  */
 static inline bool rbitset_is_empty(const unsigned *bitset, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_scan_(bitset, 0, n, 0) == n;
+	for (size_t i = 0; i < n; ++i) {
 		if (bitset[i] != 0)
 			return false;
 	}
@@ -209,8 +257,11 @@ static inline bool rbitset_is_set(const unsigned *bitset, size_t pos)
  */
 static inline unsigned rbitset_popcount(const unsigned *bitset, size_t size)
 {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_popcount_(bitset, n);
 	unsigned res = 0;
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	for (size_t i = 0; i < n; ++i) {
 		res += popcount(bitset[i]);
 	}
 	return res;
@@ -304,8 +355,17 @@ static inline size_t rbitset_next_max(const unsigned *bitset, size_t pos,
 		res = elem_pos * BITS_PER_ELEM + p;
 	} else {
 		size_t n = BITSET_SIZE_ELEMS(last);
-		/* Else search for set bits in the next units. */
+		/* Else search for set bits in the next units.  Long runs of
+		 * unmatched units are skipped by the vectorized kernels. */
+		size_t scalar_end = n;
+		if (n - elem_pos > 2 * RBITSET_BULK_ELEMS)
+			scalar_end = elem_pos + RBITSET_BULK_ELEMS;
 		for (elem_pos++; elem_pos < n; elem_pos++) {
+			if (elem_pos == scalar_end) {
+				elem_pos = rbitset_scan_(bitset, elem_pos, n, mask);
+				if (elem_pos == n)
+					break;
+			}
 			elem = bitset[elem_pos] ^ mask;
 
 			p = ntz(elem);
@@ -379,7 +439,12 @@ static inline size_t rbitset_prev(const unsigned *bitset, size_t pos,
  */
 static inline void rbitset_and(unsigned *dst, const unsigned *src, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS) {
+		rbitset_apply_(RBITSET_AND, dst, src, n);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i) {
 		dst[i] &= src[i];
 	}
 }
@@ -393,7 +458,12 @@ static inline void rbitset_and(unsigned *dst, const unsigned *src, size_t size)
  */
 static inline void rbitset_or(unsigned *dst, const unsigned *src, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS) {
+		rbitset_apply_(RBITSET_OR, dst, src, n);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i) {
 		dst[i] |= src[i];
 	}
 }
@@ -408,7 +478,12 @@ static inline void rbitset_or(unsigned *dst, const unsigned *src, size_t size)
 static inline void rbitset_andnot(unsigned *dst, const unsigned *src,
                                   size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS) {
+		rbitset_apply_(RBITSET_ANDNOT, dst, src, n);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i) {
 		dst[i] &= ~src[i];
 	}
 }
@@ -422,11 +497,60 @@ static inline void rbitset_andnot(unsigned *dst, const unsigned *src,
  */
 static inline void rbitset_xor(unsigned *dst, const unsigned *src, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS) {
+		rbitset_apply_(RBITSET_XOR, dst, src, n);
+		return;
+	}
+	for (size_t i = 0; i < n; ++i) {
 		dst[i] ^= src[i];
 	}
 }
 
+/**
+ * Inplace Union of two sets, which tests whether dst changed.
+ *
+ * @param dst   the destination bitset and first operand
+ * @param src   the second bitset
+ * @param size  size of both bitsets in bits
+ * @return true if a bit of src was not set in dst
+ */
+static inline bool rbitset_or_changed(unsigned *dst, const unsigned *src,
+                                      size_t size)
+{
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_apply_(RBITSET_OR, dst, src, n);
+	unsigned changed = 0;
+	for (size_t i = 0; i < n; ++i) {
+		changed |= src[i] & ~dst[i];
+		dst[i]  |= src[i];
+	}
+	return changed != 0;
+}
+
+/**
+ * Inplace Intersection of two sets, which tests whether dst changed.
+ *
+ * @param dst   the destination bitset and first operand
+ * @param src   the second bitset
+ * @param size  size of both bitsets in bits
+ * @return true if a bit of dst was not set in src
+ */
+static inline bool rbitset_and_changed(unsigned *dst, const unsigned *src,
+                                       size_t size)
+{
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_apply_(RBITSET_AND, dst, src, n);
+	unsigned changed = 0;
+	for (size_t i = 0; i < n; ++i) {
+		changed |= dst[i] & ~src[i];
+		dst[i]  &= src[i];
+	}
+	return changed != 0;
+}
+
 /**
  * Set bits in a range to zero or one
  * @param bitset   the bitset
@@ -506,7 +630,10 @@ static inline bool rbitsets_equal(const unsigned *bitset1,
 static inline bool rbitsets_have_common(const unsigned *bitset1,
                                         const unsigned *bitset2, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_find_(RBITSET_AND, bitset1, bitset2, n) != n;
+	for (size_t i = 0; i < n; ++i) {
 		if ((bitset1[i] & bitset2[i]) != 0)
 			return true;
 	}
@@ -523,7 +650,10 @@ static inline bool rbitsets_have_common(const unsigned *bitset1,
 static inline bool rbitset_contains(const unsigned *bitset1,
                                     const unsigned *bitset2, size_t size)
 {
-	for (size_t i = 0, n = BITSET_SIZE_ELEMS(size); i < n; ++i) {
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_find_(RBITSET_ANDNOT, bitset1, bitset2, n) == n;
+	for (size_t i = 0; i < n; ++i) {
 		if ((bitset1[i] & bitset2[i]) != bitset1[i])
 			return false;
 	}
@@ -563,6 +693,28 @@ static inline void rbitset_copy(unsigned *dst, const unsigned *src,
 	memcpy(dst, src, BITSET_SIZE_BYTES(size));
 }
 
+/**
+ * Copy a raw bitset into another and test whether the destination changed.
+ *
+ * @param dst   the destination set
+ * @param src   the source set
+ * @param size  size of both bitsets in bits
+ * @return true if dst was not equal to src
+ */
+static inline bool rbitset_copy_changed(unsigned *dst, const unsigned *src,
+                                        size_t size)
+{
+	size_t n = BITSET_SIZE_ELEMS(size);
+	if (n >= RBITSET_BULK_ELEMS)
+		return rbitset_apply_(RBITSET_COPY, dst, src, n);
+	unsigned changed = 0;
+	for (size_t i = 0; i < n; ++i) {
+		changed |= dst[i] ^ src[i];
+		dst[i]   = src[i];
+	}
+	return changed != 0;
+}
+
 /**
  * Convenience macro for raw bitset iteration.
  * @param bitset The bitset.
@@ -0,0 +1,143 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Per-iteration steps of induction variables and affine addresses.
+ */
+#include "induction.h"
+
+#include "irnode_t.h"
+#include "tv.h"
+#include "typerep.h"
+
+bool get_const_long(ir_node const *const node, long *const value)
+{
+	if (!is_Const(node))
+		return false;
+	ir_tarval *const tv = get_Const_tarval(node);
+	if (!tarval_is_long(tv))
+		return false;
+	*value = get_tarval_long(tv);
+	return true;
+}
+
+static bool is_in_loop(iv_loop_t const *const loop, ir_node const *const node)
+{
+	return loop->in_loop(loop->env, get_nodes_block(node));
+}
+
+bool get_iv_step(iv_loop_t const *const loop, ir_node const *const phi,
+                 long *const step)
+{
+	ir_node *next = NULL;
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n; ++i) {
+		ir_node const *const pred_block = get_Block_cfgpred_block(loop->header, i);
+		if (pred_block == NULL || !loop->in_loop(loop->env, pred_block))
+			continue;
+		ir_node *const pred = get_Phi_pred(phi, i);
+		if (next != NULL && pred != next)
+			return false;
+		next = pred;
+	}
+
+	if (next == NULL) {
+		return false;
+	} else if (is_Add(next)) {
+		ir_node *const l = get_Add_left(next);
+		ir_node *const r = get_Add_right(next);
+		if (l == phi)
+			return get_const_long(r, step);
+		if (r == phi)
+			return get_const_long(l, step);
+	} else if (is_Sub(next) && get_Sub_left(next) == phi) {
+		if (get_const_long(get_Sub_right(next), step)) {
+			*step = -*step;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool get_affine_step(iv_loop_t const *const loop, ir_node const *const node,
+                     long *const step)
+{
+	if (!is_in_loop(loop, node)) {
+		*step = 0;
+		return true;
+	}
+
+	long l;
+	long r;
+	switch (get_irn_opcode(node)) {
+	case iro_Phi:
+		return get_nodes_block(node) == loop->header
+		    && get_iv_step(loop, node, step);
+
+	case iro_Add:
+		if (!get_affine_step(loop, get_Add_left(node), &l)
+		    || !get_affine_step(loop, get_Add_right(node), &r))
+			return false;
+		*step = l + r;
+		return true;
+
+	case iro_Sub:
+		if (!get_affine_step(loop, get_Sub_left(node), &l)
+		    || !get_affine_step(loop, get_Sub_right(node), &r))
+			return false;
+		*step = l - r;
+		return true;
+
+	case iro_Mul: {
+		ir_node *factor;
+		if (get_const_long(get_Mul_right(node), &r)) {
+			factor = get_Mul_left(node);
+		} else if (get_const_long(get_Mul_left(node), &r)) {
+			factor = get_Mul_right(node);
+		} else {
+			return false;
+		}
+		if (!get_affine_step(loop, factor, &l))
+			return false;
+		*step = l * r;
+		return true;
+	}
+
+	case iro_Shl:
+		if (!get_const_long(get_Shl_right(node), &r) || r < 0 || r >= 32
+		    || !get_affine_step(loop, get_Shl_left(node), &l))
+			return false;
+		*step = l << r;
+		return true;
+
+	case iro_Conv: {
+		/* the induction variables do not wrap around within the loop, so
+		 * extensions keep the value affine */
+		ir_node *const op      = get_Conv_op(node);
+		ir_mode *const mode    = get_irn_mode(node);
+		ir_mode *const op_mode = get_irn_mode(op);
+		if (!(mode_is_int(mode) || mode_is_reference(mode))
+		    || !(mode_is_int(op_mode) || mode_is_reference(op_mode))
+		    || get_mode_size_bits(mode) < get_mode_size_bits(op_mode))
+			return false;
+		return get_affine_step(loop, op, step);
+	}
+
+	case iro_Member:
+		return get_affine_step(loop, get_Member_ptr(node), step);
+
+	case iro_Sel: {
+		if (!get_affine_step(loop, get_Sel_ptr(node), &l)
+		    || !get_affine_step(loop, get_Sel_index(node), &r))
+			return false;
+		ir_type const *const elem = get_array_element_type(get_Sel_type(node));
+		*step = l + r * (long)get_type_size(elem);
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
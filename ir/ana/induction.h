@@ -0,0 +1,48 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Per-iteration steps of induction variables and affine addresses.
+ */
+#ifndef FIRM_ANA_INDUCTION_H
+#define FIRM_ANA_INDUCTION_H
+
+#include <stdbool.h>
+
+#include "firm_types.h"
+
+/** Checks whether @p block belongs to the loop described by @p env. */
+typedef bool (iv_in_loop_func)(void const *env, ir_node const *block);
+
+/**
+ * A loop whose induction variables are Phis in its header.
+ */
+typedef struct iv_loop_t {
+	ir_node const   *header;  /**< the block entered from outside the loop */
+	iv_in_loop_func *in_loop; /**< checks whether a block belongs to the loop */
+	void const      *env;     /**< the environment of in_loop */
+} iv_loop_t;
+
+/**
+ * Returns the integer value of @p node if it is a Const.
+ */
+bool get_const_long(ir_node const *node, long *value);
+
+/**
+ * Returns the per-iteration increment of the header Phi @p phi if it is an
+ * induction variable, i.e. it is incremented or decremented by a constant on
+ * all back edges.
+ */
+bool get_iv_step(iv_loop_t const *loop, ir_node const *phi, long *step);
+
+/**
+ * Computes by how much the value of @p node changes from one iteration to the
+ * next.  Fails if @p node is not an affine function of induction variables.
+ * Nodes outside of the loop are invariant.
+ */
+bool get_affine_step(iv_loop_t const *loop, ir_node const *node, long *step);
+
+#endif
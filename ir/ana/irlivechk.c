@@ -27,7 +27,9 @@
 /* statev is expensive here, only enable when needed */
 #define DISABLE_STATEV
 
+#include "array.h"
 #include "bitset.h"
+#include "cbitset.h"
 #include "debug.h"
 #include "dfs_t.h"
 #include "irdom.h"
@@ -47,10 +49,10 @@ typedef struct bl_info_t {
 	unsigned id : 31;          /**< A tight number for the block.
 	                                we're just reusing the pre num from
 	                                the DFS. */
-	bitset_t *red_reachable;   /**< Holds all id's if blocks reachable
+	cbitset_t red_reachable;   /**< Holds all id's if blocks reachable
 	                                in the CFG modulo back edges. */
 
-	bitset_t *be_tgt_reach;    /**< Target blocks of back edges whose
+	cbitset_t be_tgt_reach;    /**< Target blocks of back edges whose
 	                                sources are reachable from this block
 	                                in the reduced graph. */
 } bl_info_t;
@@ -63,6 +65,7 @@ struct lv_chk_t {
 	bitset_t      *back_edge_src;
 	bitset_t      *back_edge_tgt;
 	bl_info_t    **map;
+	unsigned      *uses;  /**< ids of the use blocks of a queried node */
 	DEBUG_ONLY(firm_dbg_module_t *dbg;)
 };
 
@@ -73,9 +76,9 @@ static bl_info_t *get_block_info(lv_chk_t *lv, const ir_node *block)
 		info                = OALLOC(&lv->obst, bl_info_t);
 		info->id            = get_Block_dom_tree_pre_num(block);
 		info->block         = block;
-		info->red_reachable = bitset_obstack_alloc(&lv->obst, lv->n_blocks);
-		info->be_tgt_reach  = bitset_obstack_alloc(&lv->obst, lv->n_blocks);
 		info->be_tgt_calc   = 0;
+		cbitset_init(&info->red_reachable);
+		cbitset_init(&info->be_tgt_reach);
 		ir_nodemap_insert(&lv->block_infos, block, info);
 	}
 	return info;
@@ -96,7 +99,7 @@ static void red_trans_closure(lv_chk_t *lv)
 		ir_node   *const bl = dfs_get_post_num_node(lv->dfs, i);
 		bl_info_t *const bi = get_block_info(lv, bl);
 
-		bitset_set(bi->red_reachable, bi->id);
+		cbitset_set(&bi->red_reachable, bi->id);
 		foreach_block_succ(bl, edge) {
 			ir_node        *succ = get_edge_src_irn(edge);
 			bl_info_t      *si   = get_block_info(lv, succ);
@@ -108,7 +111,7 @@ static void red_trans_closure(lv_chk_t *lv)
 			 */
 			if (kind != DFS_EDGE_BACK) {
 				assert(dfs_get_post_num(lv->dfs, bl) > dfs_get_post_num(lv->dfs, succ));
-				bitset_or(bi->red_reachable, si->red_reachable);
+				cbitset_or(&bi->red_reachable, &si->red_reachable);
 			} else {
 				/* mark block as a back edge src and succ as back edge tgt. */
 				bitset_set(lv->back_edge_src, bi->id);
@@ -125,18 +128,16 @@ static void compute_back_edge_chain(lv_chk_t *lv, const ir_node *bl)
 	bl_info_t *bi = get_block_info(lv, bl);
 	DBG((lv->dbg, LEVEL_2, "computing T_%d\n", bi->id));
 
-	/* put all back edge sources reachable (reduced) from here in tmp */
-	bitset_t *tmp = bitset_alloca(lv->n_blocks);
-	bitset_copy(tmp, bi->red_reachable);
-	bitset_set(tmp, bi->id);
-	bitset_and(tmp, lv->back_edge_src);
 	bi->be_tgt_calc = true;
 
-	DBG((lv->dbg, LEVEL_2, "\treachable be src: %B\n", tmp));
+	/* iterate over all back edge sources reachable (reduced) from here.
+	 * Note that red_reachable contains bl itself. */
+	bitset_foreach(lv->back_edge_src, elm) {
+		if (!cbitset_is_set(&bi->red_reachable, elm))
+			continue;
 
-	/* iterate over them ... */
-	bitset_foreach(tmp, elm) {
 		bl_info_t *si = lv->map[elm];
+		DBG((lv->dbg, LEVEL_2, "\treachable be src: %zu\n", elm));
 
 		/* and find back edge targets which are not reduced reachable from bl */
 		foreach_block_succ(si->block, edge) {
@@ -144,14 +145,14 @@ static void compute_back_edge_chain(lv_chk_t *lv, const ir_node *bl)
 			bl_info_t      *ti   = get_block_info(lv, tgt);
 			dfs_edge_kind_t kind = dfs_get_edge_kind(lv->dfs, si->block, tgt);
 
-			if (kind == DFS_EDGE_BACK && !bitset_is_set(bi->red_reachable, ti->id)) {
+			if (kind == DFS_EDGE_BACK && !cbitset_is_set(&bi->red_reachable, ti->id)) {
 				if (!ti->be_tgt_calc)
 					compute_back_edge_chain(lv, tgt);
-				bitset_set(bi->be_tgt_reach, ti->id);
-				bitset_or(bi->be_tgt_reach, ti->be_tgt_reach);
+				cbitset_set(&bi->be_tgt_reach, ti->id);
+				cbitset_or(&bi->be_tgt_reach, &ti->be_tgt_reach);
 			}
 		}
-		bitset_clear(bi->be_tgt_reach, bi->id);
+		cbitset_clear(&bi->be_tgt_reach, bi->id);
 	}
 }
 
@@ -175,7 +176,7 @@ static inline void compute_back_edge_chains(lv_chk_t *lv)
 
 				if (kind != DFS_EDGE_BACK) {
 					assert(dfs_get_post_num(lv->dfs, bl) > dfs_get_post_num(lv->dfs, succ));
-					bitset_or(bi->be_tgt_reach, si->be_tgt_reach);
+					cbitset_or(&bi->be_tgt_reach, &si->be_tgt_reach);
 				}
 			}
 		}
@@ -184,7 +185,7 @@ static inline void compute_back_edge_chains(lv_chk_t *lv)
 	for (int i = 0, n = dfs_get_n_nodes(lv->dfs); i < n; ++i) {
 		ir_node const *bl = dfs_get_post_num_node(lv->dfs, i);
 		bl_info_t     *bi = get_block_info(lv, bl);
-		bitset_set(bi->be_tgt_reach, bi->id);
+		cbitset_set(&bi->be_tgt_reach, bi->id);
 	}
 }
 
@@ -202,6 +203,7 @@ lv_chk_t *lv_chk_new(ir_graph *irg)
 	res->back_edge_src = bitset_obstack_alloc(&res->obst, res->n_blocks);
 	res->back_edge_tgt = bitset_obstack_alloc(&res->obst, res->n_blocks);
 	res->map           = OALLOCNZ(&res->obst, bl_info_t*, res->n_blocks);
+	res->uses          = NEW_ARR_F(unsigned, 0);
 
 	/* fill the map which maps pre_num to block infos */
 	for (int i = res->n_blocks; i-- > 0; ) {
@@ -224,8 +226,15 @@ lv_chk_t *lv_chk_new(ir_graph *irg)
 		const ir_node   *irn = dfs_get_pre_num_node(res->dfs, i);
 		const bl_info_t *bi  = get_block_info(res, irn);
 		DBG((res->dbg, LEVEL_1, "lv_chk for %d -> %+F\n", i, irn));
-		DBG((res->dbg, LEVEL_1, "\tred reach: %B\n", bi->red_reachable));
-		DBG((res->dbg, LEVEL_1, "\ttgt reach: %B\n", bi->be_tgt_reach));
+		DB((res->dbg, LEVEL_1, "\tred reach:"));
+		cbitset_foreach(&bi->red_reachable, elm) {
+			DB((res->dbg, LEVEL_1, " %zu", elm));
+		}
+		DB((res->dbg, LEVEL_1, "\n\ttgt reach:"));
+		cbitset_foreach(&bi->be_tgt_reach, elm) {
+			DB((res->dbg, LEVEL_1, " %zu", elm));
+		}
+		DB((res->dbg, LEVEL_1, "\n"));
 	}
 #endif
 
@@ -238,6 +247,14 @@ lv_chk_t *lv_chk_new(ir_graph *irg)
 
 void lv_chk_free(lv_chk_t *lv)
 {
+	for (size_t i = 0, n = ARR_LEN(lv->block_infos.data); i < n; ++i) {
+		bl_info_t *const bi = (bl_info_t*)lv->block_infos.data[i];
+		if (bi != NULL) {
+			cbitset_free(&bi->red_reachable);
+			cbitset_free(&bi->be_tgt_reach);
+		}
+	}
+	DEL_ARR_F(lv->uses);
 	dfs_free(lv->dfs);
 	obstack_free(&lv->obst, NULL);
 	ir_nodemap_destroy(&lv->block_infos);
@@ -309,7 +326,7 @@ unsigned lv_chk_bl_xxx(lv_chk_t *lv, const ir_node *bl, const ir_node *var)
 		     "lv check %+F (def in %+F #%d) in different block %+F #%d\n",
 		     var, def_bl, def->id, bl, bli->id));
 
-		bitset_t *uses = bitset_alloca(lv->n_blocks);
+		ARR_SHRINKLEN(lv->uses, 0);
 		foreach_out_edge(var, edge) {
 			ir_node *user = get_edge_src_irn(edge);
 
@@ -342,9 +359,9 @@ unsigned lv_chk_bl_xxx(lv_chk_t *lv, const ir_node *bl, const ir_node *var)
 				res |= mask;
 
 			const bl_info_t *bi = get_block_info(lv, use_bl);
-			bitset_set(uses, bi->id);
+			ARR_APP1(unsigned, lv->uses, bi->id);
+			DBG((lv->dbg, LEVEL_2, "\tuse in %u\n", bi->id));
 		}
-		DBG((lv->dbg, LEVEL_2, "\tuses: %B\n", uses));
 
 		/* get the dominance range which really matters. all uses outside
 		 * the definition's dominance range are not to consider. note,
@@ -356,18 +373,16 @@ unsigned lv_chk_bl_xxx(lv_chk_t *lv, const ir_node *bl, const ir_node *var)
 		/* prepare a set with all reachable back edge targets.
 		 * this will determine our "looking points" from where
 		 * we will search/find the calculated uses. */
-		const bitset_t *Tq = bli->be_tgt_reach;
+		const cbitset_t *Tq = &bli->be_tgt_reach;
 
 		/* now, visit all viewing points in the temporary bitset lying
 		 * in the dominance range of the variable. Note that for reducible
 		 * flow-graphs the first iteration is sufficient and the loop
 		 * will be left. */
-		DBG((lv->dbg, LEVEL_2, "\tbe tgt reach: %B, dom span: [%u, %u]\n", Tq,
-		     min_dom, max_dom));
-		size_t i = bitset_next_set(Tq, min_dom);
+		DBG((lv->dbg, LEVEL_2, "\tdom span: [%u, %u]\n", min_dom, max_dom));
+		size_t i = cbitset_next(Tq, min_dom);
 		while (i <= max_dom) {
-			const bl_info_t *ti                   = lv->map[i];
-			bool             use_in_current_block = bitset_is_set(uses, ti->id);
+			const bl_info_t *ti = lv->map[i];
 
 			stat_ev_cnt_inc(iter);
 
@@ -390,28 +405,24 @@ unsigned lv_chk_bl_xxx(lv_chk_t *lv, const ir_node *bl, const ir_node *var)
 			 * Note that the live in information has been calculated by the
 			 * uses iteration above.
 			 */
-			if (ti == bli && !bitset_is_set(lv->back_edge_tgt, ti->id)) {
-				DBG((lv->dbg, LEVEL_2, "\tlooking not from a back edge target and q == t. removing use: %d\n", ti->id));
-				bitset_clear(uses, ti->id);
-			}
+			bool const skip_self = ti == bli
+			                    && !bitset_is_set(lv->back_edge_tgt, ti->id);
+			if (skip_self)
+				DBG((lv->dbg, LEVEL_2, "\tlooking not from a back edge target and q == t. ignoring use: %d\n", ti->id));
 
 			/* If we can reach a use, the variable is live there and we say goodbye */
-			DBG((lv->dbg, LEVEL_2, "\tlooking from %d: seeing %B\n",
-			     ti->id, ti->red_reachable));
-			if (bitset_intersect(ti->red_reachable, uses)) {
-				res |= lv_chk_state_in | lv_chk_state_out | lv_chk_state_end;
-				goto end;
+			DBG((lv->dbg, LEVEL_2, "\tlooking from %d\n", ti->id));
+			for (size_t u = 0, n_uses = ARR_LEN(lv->uses); u < n_uses; ++u) {
+				unsigned const use_id = lv->uses[u];
+				if (skip_self && use_id == ti->id)
+					continue;
+				if (cbitset_is_set(&ti->red_reachable, use_id)) {
+					res |= lv_chk_state_in | lv_chk_state_out | lv_chk_state_end;
+					goto end;
+				}
 			}
 
-			/*
-			 * if we deleted a use do to the commentary above, we have to
-			 * re-add it since it might be visible from further view points
-			 * (we only need that in the non-reducible case).
-			 */
-			if (use_in_current_block)
-				bitset_set(uses, ti->id);
-
-			i = bitset_next_set(Tq, get_Block_dom_max_subtree_pre_num(ti->block) + 1);
+			i = cbitset_next(Tq, get_Block_dom_max_subtree_pre_num(ti->block) + 1);
 		}
 
 	}
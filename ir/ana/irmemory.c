@@ -431,6 +431,10 @@ pointer:
 		}
 	}
 
+	/* whole program points-to information */
+	if (get_points_to_relation(addr1, addr2) == ir_no_alias)
+		return ir_no_alias;
+
 	/* Type based alias analysis */
 	if (options & aa_opt_type_based) {
 		ir_alias_relation rel;
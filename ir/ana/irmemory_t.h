@@ -60,4 +60,18 @@ ir_storage_class_class_t get_base_sc(ir_storage_class_class_t x);
 ir_storage_class_class_t classify_pointer(const ir_node *addr,
                                           const ir_node *base);
 
+/**
+ * Frees the points-to information of a graph.  Must be called whenever node
+ * indices are reassigned.
+ */
+void free_irg_points_to(ir_graph *irg);
+
+/**
+ * Determines the alias relation of two addresses using the results of
+ * compute_irp_points_to().  Returns ir_may_alias if no points-to information
+ * is available.
+ */
+ir_alias_relation get_points_to_relation(const ir_node *addr1,
+                                         const ir_node *addr2);
+
 #endif
@@ -0,0 +1,706 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Whole program points-to analysis.
+ *
+ * A flow- and context-insensitive unification based analysis in the style of
+ * Steensgaard: Every pointer value and every memory object belongs to an
+ * equivalence class.  A pointer value can only point to objects of its own
+ * class and the contents of all objects of a class can only point into the
+ * class's pointee class.  Assignments unify the classes involved (and
+ * recursively their pointees), which leads to an almost linear running time.
+ *
+ * Objects are global and local entities, Alloc nodes and calls to malloc-like
+ * functions.  The analysis is field-insensitive: a pointer into a compound
+ * object is in the class of the whole object; fields are distinguished by the
+ * local rules of get_alias_relation() instead.
+ *
+ * Everything the program cannot see (externally visible entities, parameters
+ * and results of functions with unknown callers, values passed to unknown
+ * functions, integer to pointer conversions, ...) is unified with the
+ * "unknown" class, which points to itself.
+ */
+#include "irmemory_t.h"
+
+#include "array.h"
+#include "debug.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irouts_t.h"
+#include "irprog_t.h"
+#include "obst.h"
+#include "pmap.h"
+#include "type_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
+
+/** An equivalence class representative, 0 is used for "no class". */
+typedef unsigned pts_class_t;
+
+typedef struct pts_ecr_t {
+	pts_class_t parent;  /**< union-find parent, self for representatives */
+	pts_class_t pointee; /**< class of the pointed to objects or 0 */
+} pts_ecr_t;
+
+/** The classes of the parameters and results of a method. */
+typedef struct pts_method_t {
+	size_t      n_params;
+	size_t      n_ress;
+	pts_class_t classes[]; /**< n_params parameters followed by results */
+} pts_method_t;
+
+static pts_ecr_t      *ecrs;            /**< all classes, ARR_F */
+static pmap           *entity_classes;  /**< entity -> class of its object */
+static pmap           *method_infos;    /**< method entity -> pts_method_t */
+static struct obstack  obst;
+/** The class for everything unknown, points to itself. */
+static pts_class_t     unknown_class;
+static bool            points_to_valid;
+static bool            use_points_to = true;
+
+static pts_class_t new_class(void)
+{
+	pts_class_t const res = (pts_class_t)ARR_LEN(ecrs);
+	pts_ecr_t   const ecr = { .parent = res, .pointee = 0 };
+	ARR_APP1(pts_ecr_t, ecrs, ecr);
+	return res;
+}
+
+static pts_class_t find(pts_class_t c)
+{
+	pts_class_t root = c;
+	while (ecrs[root].parent != root)
+		root = ecrs[root].parent;
+	/* path compression */
+	while (ecrs[c].parent != root) {
+		pts_class_t const next = ecrs[c].parent;
+		ecrs[c].parent = root;
+		c = next;
+	}
+	return root;
+}
+
+/**
+ * Unifies two classes and (recursively) their pointee classes.
+ */
+static void join(pts_class_t a, pts_class_t b)
+{
+	for (;;) {
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return;
+		/* keep the unknown class as representative */
+		if (b == unknown_class) {
+			pts_class_t const t = a;
+			a = b;
+			b = t;
+		}
+		ecrs[b].parent = a;
+
+		pts_class_t const pa = ecrs[a].pointee;
+		pts_class_t const pb = ecrs[b].pointee;
+		if (pb == 0)
+			return;
+		if (pa == 0) {
+			ecrs[a].pointee = pb;
+			return;
+		}
+		a = pa;
+		b = pb;
+	}
+}
+
+/** Returns the class of the objects pointed to by class @p c. */
+static pts_class_t get_pointee(pts_class_t c)
+{
+	c = find(c);
+	if (ecrs[c].pointee == 0) {
+		pts_class_t const pointee = new_class();
+		ecrs[c].pointee = pointee;
+	}
+	return ecrs[c].pointee;
+}
+
+static void join_unknown(pts_class_t c)
+{
+	join(c, unknown_class);
+}
+
+static pts_class_t get_node_class(ir_node const *const node)
+{
+	ir_graph *const irg = get_irn_irg(node);
+	unsigned  const idx = get_irn_idx(node);
+	assert(idx < irg->n_points_to);
+	pts_class_t *const slot = &irg->points_to[idx];
+	if (*slot == 0)
+		*slot = new_class();
+	return *slot;
+}
+
+static void join_node(ir_node const *const node, pts_class_t const c)
+{
+	join(get_node_class(node), c);
+}
+
+static void join_nodes(ir_node const *const a, ir_node const *const b)
+{
+	join(get_node_class(a), get_node_class(b));
+}
+
+static bool is_reference(ir_node const *const node)
+{
+	return mode_is_reference(get_irn_mode(node));
+}
+
+/**
+ * Returns the class of the object of an entity.  Objects accessible from the
+ * outside of the program are unknown.
+ */
+static pts_class_t get_entity_class(ir_entity *const ent)
+{
+	pts_class_t res = PTR_TO_INT(pmap_get(void, entity_classes, ent));
+	if (res == 0) {
+		res = new_class();
+		pmap_insert(entity_classes, ent, INT_TO_PTR(res));
+		if (entity_is_externally_visible(ent)
+		    || (get_entity_linkage(ent) & IR_LINKAGE_HIDDEN_USER)
+		    || is_parameter_entity(ent))
+			join_unknown(res);
+	}
+	return res;
+}
+
+/**
+ * Returns the parameter and result classes of a method.  If the method may be
+ * called from an unknown place, all its parameters and results are unknown.
+ */
+static pts_method_t *get_method_info(ir_entity *const ent)
+{
+	pts_method_t *info = pmap_get(pts_method_t, method_infos, ent);
+	if (info == NULL) {
+		ir_type *const mtp      = get_entity_type(ent);
+		size_t   const n_params = get_method_n_params(mtp);
+		size_t   const n_ress   = get_method_n_ress(mtp);
+		size_t   const n        = n_params + n_ress;
+		info = (pts_method_t*)obstack_alloc(&obst, sizeof(*info) + n * sizeof(info->classes[0]));
+		info->n_params = n_params;
+		info->n_ress   = n_ress;
+		for (size_t i = 0; i < n; ++i)
+			info->classes[i] = new_class();
+		pmap_insert(method_infos, ent, info);
+
+		if (get_entity_irg(ent) == NULL || entity_is_externally_visible(ent)) {
+			for (size_t i = 0; i < n; ++i)
+				join_unknown(info->classes[i]);
+		}
+	}
+	return info;
+}
+
+static pts_class_t get_param_class(ir_entity *const ent, size_t const pos)
+{
+	pts_method_t *const info = get_method_info(ent);
+	return pos < info->n_params ? info->classes[pos] : unknown_class;
+}
+
+static pts_class_t get_result_class(ir_entity *const ent, size_t const pos)
+{
+	pts_method_t *const info = get_method_info(ent);
+	return pos < info->n_ress ? info->classes[info->n_params + pos]
+	                          : unknown_class;
+}
+
+/**
+ * The address of a method escaped, so it may be called from unknown places.
+ */
+static void method_address_taken(ir_entity *const ent)
+{
+	pts_method_t *const info = get_method_info(ent);
+	for (size_t i = 0, n = info->n_params + info->n_ress; i < n; ++i)
+		join_unknown(info->classes[i]);
+}
+
+static bool is_call_ptr_only(ir_node const *const address)
+{
+	foreach_irn_out_r(address, i, user) {
+		if (!is_Call(user) || get_Call_ptr(user) != address)
+			return false;
+	}
+	return true;
+}
+
+static void handle_call(ir_node *const call)
+{
+	ir_entity *const callee = get_Call_callee(call);
+	for (int i = 0, n = get_Call_n_params(call); i < n; ++i) {
+		ir_node *const arg = get_Call_param(call, i);
+		if (!is_reference(arg))
+			continue;
+		pts_class_t const c = callee != NULL ? get_param_class(callee, i)
+		                                     : unknown_class;
+		join_node(arg, c);
+	}
+}
+
+static void handle_frame(ir_graph *const irg, ir_node *const frame)
+{
+	/* Member(frame) nodes select the class of the entity, any other use
+	 * might reach any of the local objects */
+	foreach_irn_out_r(frame, i, user) {
+		if (is_Member(user))
+			continue;
+		join_node(frame, unknown_class);
+		ir_type *const frame_type = get_irg_frame_type(irg);
+		for (size_t m = 0, n = get_compound_n_members(frame_type); m < n; ++m)
+			join_unknown(get_entity_class(get_compound_member(frame_type, m)));
+		return;
+	}
+}
+
+static void handle_proj(ir_node *const proj)
+{
+	ir_node *const pred = get_Proj_pred(proj);
+	if (is_Start(pred)) {
+		if (get_Proj_num(proj) == pn_Start_P_frame_base)
+			handle_frame(get_irn_irg(proj), proj);
+		return;
+	}
+	if (!is_reference(proj))
+		return;
+
+	unsigned const num = get_Proj_num(proj);
+	switch (get_irn_opcode(pred)) {
+	case iro_Load:
+		if (num == pn_Load_res)
+			join_node(proj, get_pointee(get_node_class(get_Load_ptr(pred))));
+		return;
+	case iro_Alloc:
+		/* each Alloc is an object of its own, use the Alloc node's class */
+		join_nodes(proj, pred);
+		return;
+	case iro_Proj: {
+		ir_node *const pred_pred = get_Proj_pred(pred);
+		if (is_Start(pred_pred)) {
+			ir_entity *const ent = get_irg_entity(get_irn_irg(proj));
+			join_node(proj, get_param_class(ent, num));
+			return;
+		} else if (is_Call(pred_pred)) {
+			ir_entity *const callee = get_Call_callee(pred_pred);
+			if (callee == NULL) {
+				join_node(proj, unknown_class);
+			} else if (get_entity_additional_properties(callee)
+			           & mtp_property_malloc) {
+				/* each call to malloc is an object of its own */
+				join_nodes(proj, pred_pred);
+			} else {
+				join_node(proj, get_result_class(callee, num));
+			}
+			return;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	join_node(proj, unknown_class);
+}
+
+/**
+ * Post-walker: Unify the classes of all values which might be assigned to
+ * each other.
+ */
+static void pts_node_walker(ir_node *const node, void *const env)
+{
+	(void)env;
+	switch (get_irn_opcode(node)) {
+	case iro_Address: {
+		ir_entity *const ent = get_Address_entity(node);
+		join_node(node, get_entity_class(ent));
+		if (is_method_entity(ent) && !is_call_ptr_only(node))
+			method_address_taken(ent);
+		return;
+	}
+
+	case iro_Member: {
+		ir_node *const ptr = get_Member_ptr(node);
+		if (ptr == get_irg_frame(get_irn_irg(node))) {
+			join_node(node, get_entity_class(get_Member_entity(node)));
+		} else {
+			join_nodes(node, ptr);
+		}
+		return;
+	}
+
+	case iro_Sel:
+		join_nodes(node, get_Sel_ptr(node));
+		return;
+
+	case iro_Add:
+	case iro_Sub:
+	case iro_Phi:
+	case iro_Mux:
+	case iro_Id:
+		/* all reference operands flow into the result (a Sub of two
+		 * references "connects" them for later pointer arithmetic) */
+		foreach_irn_in(node, i, op) {
+			if (is_reference(op))
+				join_nodes(node, op);
+		}
+		return;
+
+	case iro_Confirm: {
+		ir_node *const value = get_Confirm_value(node);
+		if (is_reference(value))
+			join_nodes(node, value);
+		return;
+	}
+
+	case iro_Conv:
+	case iro_Bitcast: {
+		ir_node *const op = get_irn_n(node, 0);
+		if (is_reference(node)) {
+			if (is_reference(op))
+				join_nodes(node, op);
+			else
+				join_node(node, unknown_class);
+		} else if (is_reference(op)) {
+			/* the address escapes as an integer */
+			join_node(op, unknown_class);
+		}
+		return;
+	}
+
+	case iro_Const:
+		/* null points nowhere, other constant addresses anywhere */
+		if (is_reference(node) && !tarval_is_null(get_Const_tarval(node)))
+			join_node(node, unknown_class);
+		return;
+
+	case iro_Proj:
+		handle_proj(node);
+		return;
+
+	case iro_Store: {
+		ir_node *const value = get_Store_value(node);
+		if (is_reference(value)) {
+			pts_class_t const ptr = get_node_class(get_Store_ptr(node));
+			join_node(value, get_pointee(ptr));
+		}
+		return;
+	}
+
+	case iro_CopyB: {
+		pts_class_t const dst = get_node_class(get_CopyB_dst(node));
+		pts_class_t const src = get_node_class(get_CopyB_src(node));
+		join(get_pointee(dst), get_pointee(src));
+		return;
+	}
+
+	case iro_Call:
+		handle_call(node);
+		return;
+
+	case iro_Return: {
+		ir_entity *const ent = get_irg_entity(get_irn_irg(node));
+		for (size_t i = 0, n = get_Return_n_ress(node); i < n; ++i) {
+			ir_node *const res = get_Return_res(node, i);
+			if (is_reference(res))
+				join_node(res, get_result_class(ent, i));
+		}
+		return;
+	}
+
+	case iro_Load:
+	case iro_Cmp:
+	case iro_Free:
+	case iro_Unknown:
+	case iro_Alloc:
+	case iro_Start:
+	case iro_End:
+	case iro_Block:
+	case iro_Anchor:
+		return;
+
+	default:
+		/* anything else (Builtin, ASM, ...) might do anything with its
+		 * reference operands or produce arbitrary addresses */
+		foreach_irn_in(node, i, op) {
+			if (is_reference(op))
+				join_node(op, unknown_class);
+		}
+		if (is_reference(node))
+			join_node(node, unknown_class);
+		return;
+	}
+}
+
+/**
+ * Returns the class an initializer expression points to or 0 if it does not
+ * contain an address.
+ */
+static pts_class_t get_const_class(ir_node *const value)
+{
+	switch (get_irn_opcode(value)) {
+	case iro_Address: {
+		ir_entity *const ent = get_Address_entity(value);
+		if (is_method_entity(ent))
+			method_address_taken(ent);
+		return get_entity_class(ent);
+	}
+	case iro_Const:
+		if (is_reference(value) && !tarval_is_null(get_Const_tarval(value)))
+			return unknown_class;
+		return 0;
+	default: {
+		pts_class_t res = 0;
+		foreach_irn_in(value, i, op) {
+			pts_class_t const c = get_const_class(op);
+			if (c == 0)
+				continue;
+			if (res != 0)
+				join(res, c);
+			else
+				res = c;
+		}
+		/* addresses converted to integers escape */
+		if (res != 0 && !is_reference(value))
+			join_unknown(res);
+		return res;
+	}
+	}
+}
+
+static void handle_initializer(pts_class_t const pointee,
+                               ir_initializer_t const *const initializer)
+{
+	switch (get_initializer_kind(initializer)) {
+	case IR_INITIALIZER_CONST: {
+		pts_class_t const c = get_const_class(get_initializer_const_value(initializer));
+		if (c != 0)
+			join(pointee, c);
+		return;
+	}
+	case IR_INITIALIZER_TARVAL: {
+		ir_tarval *const tv = get_initializer_tarval_value(initializer);
+		if (mode_is_reference(get_tarval_mode(tv)) && !tarval_is_null(tv))
+			join_unknown(pointee);
+		return;
+	}
+	case IR_INITIALIZER_NULL:
+		return;
+	case IR_INITIALIZER_COMPOUND:
+		for (size_t i = 0, n = get_initializer_compound_n_entries(initializer);
+		     i < n; ++i) {
+			handle_initializer(pointee, get_initializer_compound_value(initializer, i));
+		}
+		return;
+	}
+	panic("invalid initializer");
+}
+
+static void handle_global_initializers(void)
+{
+	for (ir_segment_t s = IR_SEGMENT_FIRST; s <= IR_SEGMENT_LAST; ++s) {
+		ir_type *const type = get_segment_type(s);
+		for (size_t i = 0, n = get_compound_n_members(type); i < n; ++i) {
+			ir_entity *const ent = get_compound_member(type, i);
+			if (get_entity_kind(ent) != IR_ENTITY_NORMAL)
+				continue;
+			ir_initializer_t *const initializer = get_entity_initializer(ent);
+			if (initializer == NULL)
+				continue;
+			pts_class_t const pointee = get_pointee(get_entity_class(ent));
+			handle_initializer(pointee, initializer);
+		}
+	}
+}
+
+/**
+ * Replaces the class of each node by its representative.
+ */
+static void compress_classes(ir_graph *const irg)
+{
+	for (unsigned i = 0, n = irg->n_points_to; i < n; ++i) {
+		if (irg->points_to[i] != 0)
+			irg->points_to[i] = find(irg->points_to[i]);
+	}
+}
+
+#ifdef DEBUG_libfirm
+typedef struct access_t {
+	ir_node const *addr;
+	ir_type const *type;
+	unsigned       size;
+} access_t;
+
+static void collect_accesses(ir_node *const node, void *const env)
+{
+	access_t **const accesses = (access_t**)env;
+	access_t         access;
+	if (is_Load(node)) {
+		access.addr = get_Load_ptr(node);
+		access.type = get_Load_type(node);
+		access.size = get_mode_size_bytes(get_Load_mode(node));
+	} else if (is_Store(node)) {
+		access.addr = get_Store_ptr(node);
+		access.type = get_Store_type(node);
+		access.size = get_mode_size_bytes(get_irn_mode(get_Store_value(node)));
+	} else {
+		return;
+	}
+	ARR_APP1(access_t, *accesses, access);
+}
+
+/**
+ * Counts the pairs of memory accesses in each graph, which are only known not
+ * to alias because of the points-to information.
+ */
+static void report_alias_pairs(void)
+{
+	foreach_irp_irg(i, irg) {
+		access_t *accesses = NEW_ARR_F(access_t, 0);
+		irg_walk_graph(irg, NULL, collect_accesses, &accesses);
+
+		unsigned n_pairs   = 0;
+		unsigned n_no_pts  = 0;
+		unsigned n_no_alias = 0;
+		for (size_t a = 0, n = ARR_LEN(accesses); a < n; ++a) {
+			for (size_t b = a + 1; b < n; ++b) {
+				access_t const *const a1 = &accesses[a];
+				access_t const *const a2 = &accesses[b];
+				++n_pairs;
+				use_points_to = false;
+				if (get_alias_relation(a1->addr, a1->type, a1->size, a2->addr, a2->type, a2->size) != ir_may_alias)
+					++n_no_alias;
+				use_points_to = true;
+				if (get_alias_relation(a1->addr, a1->type, a1->size, a2->addr, a2->type, a2->size) == ir_no_alias)
+					++n_no_pts;
+			}
+		}
+		DB((dbg, LEVEL_1, "%+F: %u access pairs, %u disambiguated locally, %u with points-to\n",
+		    irg, n_pairs, n_no_alias, n_no_pts));
+		DEL_ARR_F(accesses);
+	}
+}
+#endif
+
+void compute_irp_points_to(void)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.ana.pointsto");
+	free_irp_points_to();
+
+	ecrs           = NEW_ARR_F(pts_ecr_t, 1);
+	entity_classes = pmap_create();
+	method_infos   = pmap_create();
+	obstack_init(&obst);
+	unknown_class  = new_class();
+	ecrs[unknown_class].pointee = unknown_class;
+
+	foreach_irp_irg(i, irg) {
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		                         | IR_GRAPH_PROPERTY_NO_TUPLES);
+		irg->n_points_to = get_irg_last_idx(irg);
+		irg->points_to   = XMALLOCNZ(pts_class_t, irg->n_points_to);
+	}
+
+	handle_global_initializers();
+	foreach_irp_irg(i, irg) {
+		irg_walk_graph(irg, NULL, pts_node_walker, NULL);
+	}
+
+	foreach_irp_irg(i, irg) {
+		compress_classes(irg);
+	}
+	unknown_class = find(unknown_class);
+	DB((dbg, LEVEL_1, "points-to: %zu equivalence classes\n", ARR_LEN(ecrs)));
+
+	/* only the node classes are needed from now on */
+	DEL_ARR_F(ecrs);
+	ecrs = NULL;
+	pmap_destroy(entity_classes);
+	pmap_destroy(method_infos);
+	obstack_free(&obst, NULL);
+	points_to_valid = true;
+
+#ifdef DEBUG_libfirm
+	if (firm_dbg_get_mask(dbg) & LEVEL_1)
+		report_alias_pairs();
+#endif
+}
+
+void free_irg_points_to(ir_graph *const irg)
+{
+	free(irg->points_to);
+	irg->points_to   = NULL;
+	irg->n_points_to = 0;
+}
+
+void free_irp_points_to(void)
+{
+	if (!points_to_valid)
+		return;
+	foreach_irp_irg(i, irg) {
+		free_irg_points_to(irg);
+	}
+	points_to_valid = false;
+}
+
+/**
+ * Returns the points-to class of an address.  Addresses created after the
+ * analysis are traced back to an analysed base address if possible.
+ */
+static pts_class_t get_address_class(ir_node const *addr)
+{
+	for (;;) {
+		ir_graph *const irg = get_irn_irg(addr);
+		unsigned  const idx = get_irn_idx(addr);
+		if (idx < irg->n_points_to && irg->points_to[idx] != 0)
+			return irg->points_to[idx];
+
+		switch (get_irn_opcode(addr)) {
+		case iro_Add:
+		case iro_Sub: {
+			ir_node *const left = get_binop_left(addr);
+			addr = is_reference(left) ? left : get_binop_right(addr);
+			break;
+		}
+		case iro_Member:
+			addr = get_Member_ptr(addr);
+			if (addr == get_irg_frame(irg))
+				return 0;
+			break;
+		case iro_Sel:
+			addr = get_Sel_ptr(addr);
+			break;
+		case iro_Confirm:
+			addr = get_Confirm_value(addr);
+			break;
+		default:
+			return 0;
+		}
+	}
+}
+
+ir_alias_relation get_points_to_relation(ir_node const *const addr1,
+                                         ir_node const *const addr2)
+{
+	if (!points_to_valid || !use_points_to)
+		return ir_may_alias;
+
+	pts_class_t const class1 = get_address_class(addr1);
+	pts_class_t const class2 = get_address_class(addr2);
+	if (class1 == 0 || class2 == 0
+	    || class1 == unknown_class || class2 == unknown_class
+	    || class1 == class2)
+		return ir_may_alias;
+
+	DB((dbg, LEVEL_2, "points-to: %+F and %+F do not alias\n", addr1, addr2));
+	return ir_no_alias;
+}
@@ -301,6 +301,19 @@ my $x87store = {
 	attr      => "const amd64_binop_addr_attr_t *attr_init",
 };
 
+my $prefetchop = {
+	op_flags  => [ "uses_memory" ],
+	state     => "exc_pinned",
+	in_reqs   => "...",
+	out_reqs  => [ "mem" ],
+	outs      => [ "M" ],
+	attr_type => "amd64_addr_attr_t",
+	attr      => "x86_addr_t addr",
+	fixed     => "amd64_op_mode_t op_mode = AMD64_OP_ADDR;\n"
+	            ."x86_insn_size_t size    = X86_SIZE_8;\n",
+	emit      => "{name} %A",
+};
+
 %nodes = (
 push_am => {
 	op_flags  => [ "uses_memory" ],
@@ -484,6 +497,14 @@ cmpxchg => {
 	emit      => "lock cmpxchg%M %AM",
 },
 
+prefetcht0 => { template => $prefetchop },
+
+prefetcht1 => { template => $prefetchop },
+
+prefetcht2 => { template => $prefetchop },
+
+prefetchnta => { template => $prefetchop },
+
 # TODO Setcc can also operate on memory
 setcc => {
 	irn_flags => [  ],
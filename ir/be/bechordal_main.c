@@ -117,14 +117,27 @@ void be_chordal_dump(unsigned const mask, ir_graph *const irg, arch_register_cla
 	}
 }
 
+typedef struct memory_operand_env_t {
+	regalloc_if_t const *regif;
+	be_lv_t             *lv;
+	ir_nodeset_t         changed; /**< values with changed liveness */
+} memory_operand_env_t;
+
+static void add_operands(ir_nodeset_t *const set, ir_node const *const node)
+{
+	foreach_irn_in(node, i, op) {
+		ir_nodeset_insert(set, op);
+	}
+}
+
 /**
  * Post-Walker: Checks for the given reload if has only one user that can
  * perform the reload as part of its address mode.
  * Fold the reload into the user it that is possible.
  */
-static void memory_operand_walker(ir_node *irn, void *env)
+static void memory_operand_walker(ir_node *irn, void *data)
 {
-	const regalloc_if_t *regif = (const regalloc_if_t*)env;
+	memory_operand_env_t *const env = (memory_operand_env_t*)data;
 	foreach_irn_in(irn, i, in) {
 		if (!arch_irn_is(skip_Proj(in), reload))
 			continue;
@@ -133,7 +146,14 @@ static void memory_operand_walker(ir_node *irn, void *env)
 		/* only use memory operands, if the reload is only used by 1 node */
 		if (get_irn_n_edges(in) > 1)
 			continue;
-		regif->perform_memory_operand(irn, i);
+		/* the operands of the reload and the user may be rewired */
+		if (env->lv->sets_valid) {
+			add_operands(&env->changed, skip_Proj(in));
+			add_operands(&env->changed, irn);
+		}
+		env->regif->perform_memory_operand(irn, i);
+		if (env->lv->sets_valid)
+			add_operands(&env->changed, irn);
 	}
 }
 
@@ -144,7 +164,19 @@ void check_for_memory_operands(ir_graph *irg, const regalloc_if_t *regif)
 {
 	if (regif->perform_memory_operand == NULL)
 		return;
-	irg_walk_graph(irg, NULL, memory_operand_walker, (void*)regif);
+
+	memory_operand_env_t env = {
+		.regif = regif,
+		.lv    = be_get_irg_liveness(irg),
+	};
+	ir_nodeset_init(&env.changed);
+	irg_walk_graph(irg, NULL, memory_operand_walker, &env);
+
+	foreach_ir_nodeset(&env.changed, node, iter) {
+		if (!is_Deleted(node))
+			be_liveness_update(env.lv, node);
+	}
+	ir_nodeset_destroy(&env.changed);
 }
 
 static be_node_stats_t last_node_stats;
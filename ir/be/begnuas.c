@@ -1541,7 +1541,7 @@ static void emit_global_decls(be_main_env_t const *const main_env)
 	}
 }
 
-void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const swtch, ir_mode *const entry_mode, emit_target_func const emit_target)
+ir_node const **be_get_jump_table(ir_node const *const node, be_switch_attr_t const *const swtch, unsigned long *const length_out)
 {
 	/* go over all proj's and collect their jump targets */
 	unsigned        n_outs  = arch_get_irn_n_outs(node);
@@ -1600,6 +1600,20 @@ void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const
 			}
 		}
 	}
+	for (unsigned long i = 0; i < length; ++i) {
+		if (labels[i] == NULL)
+			labels[i] = targets[0];
+	}
+
+	free(targets);
+	*length_out = length;
+	return labels;
+}
+
+void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const swtch, ir_mode *const entry_mode, emit_target_func const emit_target)
+{
+	unsigned long         length;
+	ir_node const **const labels = be_get_jump_table(node, swtch, &length);
 
 	/* emit table */
 	unsigned         const pointer_size = get_mode_size_bytes(entry_mode);
@@ -1613,11 +1627,8 @@ void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const
 	}
 
 	for (unsigned long i = 0; i < length; ++i) {
-		ir_node const *target = labels[i];
-		if (target == NULL)
-			target = targets[0];
 		emit_size_type(pointer_size);
-		emit_target(entity, target);
+		emit_target(entity, labels[i]);
 		be_emit_char('\n');
 		be_emit_write_line();
 	}
@@ -1626,7 +1637,6 @@ void be_emit_jump_table(ir_node const *const node, be_switch_attr_t const *const
 		be_gas_emit_switch_section(GAS_SECTION_TEXT);
 
 	free(labels);
-	free(targets);
 }
 
 static void emit_global_asms(void)
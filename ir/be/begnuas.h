@@ -124,6 +124,13 @@ const char *be_gas_insn_label_prefix(void);
 
 typedef void (*emit_target_func)(ir_entity const *table, ir_node const *proj_x);
 
+/**
+ * Returns the targets of a jump table for switch operations.  Entry i of the
+ * returned array is the control flow Proj taken for selector value i.  The
+ * array has *length entries and must be freed by the caller.
+ */
+ir_node const **be_get_jump_table(ir_node const *node, be_switch_attr_t const *swtch, unsigned long *length);
+
 /**
  * Emits a jump table for switch operations
  */
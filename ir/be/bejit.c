@@ -182,6 +182,12 @@ unsigned be_begin_fragment(uint8_t const p2align, uint8_t const max_skip)
 	return obstack_object_size(fragment_info_arr_obst)/sizeof(fragment_info_t*);
 }
 
+unsigned be_get_fragment_offset(void)
+{
+	fragment_info_t const *const fragment = obstack_base(fragment_info_obst);
+	return obstack_object_size(code_obst) - fragment->address;
+}
+
 void be_finish_fragment(void)
 {
 	size_t size = obstack_object_size(fragment_info_obst);
@@ -360,7 +366,7 @@ void be_jit_emit_memory(char *const buffer, ir_jit_function_t *const function,
 	for (size_t i = 0, n = function->n_fragments; i < n; ++i) {
 		fragment_info_t const *const fragment  = function->fragment_infos[i];
 		unsigned               const address   = fragment->address;
-		unsigned               const nop_bytes = last_address - address;
+		unsigned               const nop_bytes = address - last_address;
 		assert(address >= last_address);
 		if (nop_bytes > 0)
 			emitter->nops(buffer + last_address, nop_bytes);
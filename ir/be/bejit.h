@@ -41,6 +41,9 @@ ir_jit_function_t *be_jit_finish_function(void);
 unsigned be_begin_fragment(uint8_t p2align, uint8_t max_skip);
 void be_finish_fragment(void);
 
+/** Returns the offset of the next byte in the current fragment */
+unsigned be_get_fragment_offset(void);
+
 extern struct obstack *code_obst;
 
 /** Append a byte to the current fragment */
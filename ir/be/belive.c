@@ -87,7 +87,7 @@ static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
 
 	be_lv_info_t *irn_live = ir_nodehashmap_get(be_lv_info_t, &li->map, bl);
 	if (irn_live == NULL) {
-		irn_live = OALLOCFZ(&li->obst, be_lv_info_t, nodes, LV_STD_SIZE);
+		irn_live = ARENA_ALLOCFZ(&li->arena, be_lv_info_t, nodes, LV_STD_SIZE);
 		irn_live->n_size = LV_STD_SIZE;
 		ir_nodehashmap_insert(&li->map, bl, irn_live);
 	}
@@ -103,12 +103,14 @@ static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
 		unsigned n_members = irn_live->n_members;
 		unsigned n_size    = irn_live->n_size;
 		if (n_members + 1 >= n_size) {
-			/* double the array size. */
+			/* double the array size and recycle the old one */
 			unsigned      const new_size = 2 * n_size;
-			be_lv_info_t *const nw       = OALLOCF(&li->obst, be_lv_info_t, nodes, new_size);
-			memcpy(nw, irn_live, sizeof(*irn_live) + n_size * sizeof(*irn_live->nodes));
+			size_t        const old_size = sizeof(*irn_live) + n_size * sizeof(*irn_live->nodes);
+			be_lv_info_t *const nw       = ARENA_ALLOCF(&li->arena, be_lv_info_t, nodes, new_size);
+			memcpy(nw, irn_live, old_size);
 			memset(&nw->nodes[n_size], 0, (new_size - n_size) * sizeof(*irn_live->nodes));
 			nw->n_size = new_size;
+			arena_free(&li->arena, irn_live, old_size);
 			irn_live = nw;
 			ir_nodehashmap_insert(&li->map, bl, nw);
 		}
@@ -126,29 +128,25 @@ static be_lv_info_node_t *be_lv_get_or_set(be_lv_t *li, ir_node *bl,
 	return res;
 }
 
-typedef struct lv_remove_walker_t {
-	be_lv_t       *lv;
-	ir_node const *irn;
-} lv_remove_walker_t;
-
 /**
  * Removes a node from the list of live variables of a block.
+ * @return The liveness state the node had in the block.
  */
-static void lv_remove_irn_walker(ir_node *const bl, void *const data)
+static be_lv_state_t lv_remove_irn(be_lv_t *const lv, ir_node const *const bl,
+                                   ir_node const *const irn)
 {
-	lv_remove_walker_t *const w        = (lv_remove_walker_t*)data;
-	be_lv_info_t       *const irn_live = ir_nodehashmap_get(be_lv_info_t, &w->lv->map, bl);
+	be_lv_info_t *const irn_live = ir_nodehashmap_get(be_lv_info_t, &lv->map, bl);
 	if (irn_live == NULL)
-		return;
+		return be_lv_state_none;
 
 	unsigned           const n   = irn_live->n_members;
-	ir_node     const *const irn = w->irn;
 	unsigned           const pos = _be_liveness_bsearch(irn_live, irn);
 	be_lv_info_node_t *const res = &irn_live->nodes[pos];
 	if (res->node != irn)
-		return;
+		return be_lv_state_none;
 
 	/* The node is indeed in the block's array. Let's remove it. */
+	be_lv_state_t const state = res->flags;
 	for (unsigned i = pos + 1; i < n; ++i)
 		irn_live->nodes[i - 1] = irn_live->nodes[i];
 
@@ -157,6 +155,28 @@ static void lv_remove_irn_walker(ir_node *const bl, void *const data)
 
 	--irn_live->n_members;
 	DBG((dbg, LEVEL_3, "\tdeleting %+F from %+F at pos %d\n", irn, bl, pos));
+	return state;
+}
+
+/**
+ * Removes a node from the liveness information of a block and of all
+ * successor blocks its live range continues into.
+ * Every block (other than the definition block) containing the node is live-in
+ * and all its predecessors are live-out, so following the live-out edges
+ * starting at the definition block reaches the whole live range.
+ */
+static void lv_remove_live_range(be_lv_t *const lv, ir_node const *const bl,
+                                 ir_node const *const irn)
+{
+	be_lv_state_t const state = lv_remove_irn(lv, bl, irn);
+	if (!(state & be_lv_state_out))
+		return;
+
+	foreach_block_succ(bl, edge) {
+		ir_node *const succ = get_edge_src_irn(edge);
+		if (be_get_live_state(lv, succ, irn) & be_lv_state_in)
+			lv_remove_live_range(lv, succ, irn);
+	}
 }
 
 static struct {
@@ -265,7 +285,7 @@ void be_liveness_compute_sets(be_lv_t *lv)
 
 	be_timer_push(T_LIVE);
 	ir_nodehashmap_init(&lv->map);
-	obstack_init(&lv->obst);
+	arena_init(&lv->arena);
 
 	ir_graph *irg = lv->irg;
 	unsigned n = get_irg_last_idx(irg);
@@ -285,6 +305,7 @@ void be_liveness_compute_sets(be_lv_t *lv)
 
 	DEL_ARR_F(nodes);
 	lv->sets_valid = true;
+	++lv->n_sets_computed;
 	be_timer_pop(T_LIVE);
 }
 
@@ -299,7 +320,7 @@ void be_liveness_invalidate_sets(be_lv_t *lv)
 {
 	if (!lv->sets_valid)
 		return;
-	obstack_free(&lv->obst, NULL);
+	arena_destroy(&lv->arena);
 	ir_nodehashmap_destroy(&lv->map);
 	lv->sets_valid = false;
 }
@@ -333,10 +354,10 @@ void be_liveness_remove(be_lv_t *lv, const ir_node *irn)
 	assert(lv->sets_valid);
 
 	/* Removes a single irn from the liveness information.
-	 * Since an irn can only be live at blocks dominated by the block of its
-	 * definition, we only have to process that dominance subtree. */
-	lv_remove_walker_t w = { lv, irn };
-	dom_tree_walk(get_nodes_block(irn), lv_remove_irn_walker, NULL, &w);
+	 * Only the blocks of its live range have to be visited, which is much
+	 * cheaper than walking the dominance subtree of the definition. */
+	if (is_liveness_node(irn))
+		lv_remove_live_range(lv, get_nodes_block(irn), irn);
 }
 
 void be_liveness_introduce(be_lv_t *lv, ir_node *irn)
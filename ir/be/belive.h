@@ -12,6 +12,7 @@
 #ifndef FIRM_BE_BELIVE_H
 #define FIRM_BE_BELIVE_H
 
+#include "arena.h"
 #include "be_types.h"
 #include "irnodeset.h"
 #include "irnodehashmap.h"
@@ -131,8 +132,9 @@ void be_liveness_nodes_live_before(be_lv_t const *lv,
 
 struct be_lv_t {
 	ir_nodehashmap_t map;
-	struct obstack   obst;
+	arena_t          arena;
 	bool             sets_valid;
+	unsigned         n_sets_computed; /**< number of full set computations */
 	ir_graph        *irg;
 	lv_chk_t        *lvc;
 };
@@ -9,6 +9,7 @@
  * @author      Sebastian Hack
  * @date        25.11.2004
  */
+#include "arena.h"
 #include "be_t.h"
 #include "beasm.h"
 #include "bechordal_t.h"
@@ -313,6 +314,19 @@ static ir_graph *be_prepare_profile(const char *const cup_name)
 	return prof_init_irg;
 }
 
+/**
+ * Prints the available performance counters of a timer and ends the line.
+ */
+static void print_counters(ir_timer_t const *const timer)
+{
+	for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c) {
+		if (ir_timer_counter_available(c))
+			printf(" %14llu %s", ir_timer_counter(timer, c),
+			       ir_timer_counter_name(c));
+	}
+	putchar('\n');
+}
+
 void be_begin(FILE *file_handle, const char *cup_name)
 {
 	memset(be_asm_constraint_flags, 0, sizeof(be_asm_constraint_flags));
@@ -320,6 +334,7 @@ void be_begin(FILE *file_handle, const char *cup_name)
 	bemain_timer = NULL;
 	if (be_options.timing) {
 		bemain_timer = ir_timer_new();
+		ir_timer_enable_counters(bemain_timer);
 
 		if (ir_timer_enter_high_priority())
 			be_warningf(NULL, "could not enter high priority mode");
@@ -347,6 +362,7 @@ void be_begin(FILE *file_handle, const char *cup_name)
 		for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 			be_timers[t] = ir_timer_new();
 			ir_timer_init_parent(be_timers[t]);
+			ir_timer_enable_counters(be_timers[t]);
 		}
 	}
 
@@ -466,6 +482,7 @@ bool be_step_first(ir_graph *irg)
 		return false;
 
 	be_timer_push(T_OTHER);
+	arena_reset_peak();
 	if (stat_ev_enabled) {
 		stat_ev_ctx_push_fmt("bemain_irg", "%+F", irg);
 		stat_ev_ull("bemain_insns_start", be_count_insns(irg));
@@ -516,6 +533,9 @@ void be_step_last(ir_graph *irg)
 	if (stat_ev_enabled) {
 		stat_ev_ull("bemain_insns_finish", be_count_insns(irg));
 		stat_ev_ull("bemain_blocks_finish", be_count_blocks(irg));
+		stat_ev_ull("bemain_live_sets_computed",
+		            be_get_irg_liveness(irg)->n_sets_computed);
+		stat_ev_ull("bemain_arena_peak_bytes", arena_get_peak());
 	}
 
 	be_dump(DUMP_FINAL, irg, "final");
@@ -530,13 +550,23 @@ void be_step_last(ir_graph *irg)
 				snprintf(buf, sizeof(buf), "bemain_time_%s",
 				         get_timer_name(t));
 				stat_ev_dbl(buf, ir_timer_elapsed_usec(be_timers[t]));
+				for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c) {
+					if (!ir_timer_counter_available(c))
+						continue;
+					snprintf(buf, sizeof(buf), "bemain_%s_%s",
+					         ir_timer_counter_name(c), get_timer_name(t));
+					stat_ev_ull(buf, ir_timer_counter(be_timers[t], c));
+				}
 			}
 		} else {
 			printf("==>> IRG %s <<==\n", get_entity_name(get_irg_entity(irg)));
 			for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 				double val = ir_timer_elapsed_usec(be_timers[t]) / 1000.0;
-				printf("%-20s: %10.3f msec\n", get_timer_name(t), val);
+				printf("%-20s: %10.3f msec", get_timer_name(t), val);
+				print_counters(be_timers[t]);
 			}
+			printf("%-20s: %10u\n", "live sets computed",
+			       be_get_irg_liveness(irg)->n_sets_computed);
 		}
 		for (be_timer_id_t t = T_FIRST; t < T_LAST+1; ++t) {
 			ir_timer_reset(be_timers[t]);
@@ -558,9 +588,18 @@ void be_finish(void)
 		ir_timer_leave_high_priority();
 		if (stat_ev_enabled) {
 			stat_ev_dbl("bemain_backend_time", ir_timer_elapsed_msec(bemain_timer));
+			for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c) {
+				if (!ir_timer_counter_available(c))
+					continue;
+				char buf[128];
+				snprintf(buf, sizeof(buf), "bemain_backend_%s",
+				         ir_timer_counter_name(c));
+				stat_ev_ull(buf, ir_timer_counter(bemain_timer, c));
+			}
 		} else {
 			double val = ir_timer_elapsed_usec(bemain_timer) / 1000.0;
-			printf("%-20s: %10.3f msec\n", "BEMAINLOOP", val);
+			printf("%-20s: %10.3f msec", "BEMAINLOOP", val);
+			print_counters(bemain_timer);
 		}
 	}
 
@@ -596,6 +635,7 @@ ir_jit_function_t *be_jit_compile(ir_jit_segment_t *const segment,
 		return NULL;
 	be_irg_t *const birg = OALLOCZ(&obst, be_irg_t);
 	initialize_birg(birg, irg, &env);
+	ir_estimate_execfreq(irg);
 	if (ir_target.isa->handle_intrinsics)
 		ir_target.isa->handle_intrinsics(irg);
 	be_dump(DUMP_INITIAL, irg, "prepared");
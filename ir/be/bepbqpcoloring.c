@@ -37,7 +37,7 @@
 #include "belive.h"
 #include "belive.h"
 #include "pdeq.h"
-#include "pqueue.h"
+#include "radixheap.h"
 
 /* pbqp includes */
 #include "kaps.h"
@@ -70,6 +70,8 @@ typedef struct be_pbqp_alloc_env_t {
 	pbqp_matrix_t               *ife_matrix_template;
 	pbqp_matrix_t               *aff_matrix_template;
 	deq_t                        rpeo;
+	radixheap_t                  restr_nodes_queue;
+	radixheap_t                  queue;
 	unsigned                    *restr_nodes;
 	unsigned                    *ife_edge_num;
 	ir_execfreq_int_factors      execfreq_factors;
@@ -273,6 +275,18 @@ static void create_affinity_edges(ir_node *irn, void *env)
 	}
 }
 
+#if !USE_BIPARTIT_MATCHING
+/**
+ * The radix heaps return the smallest key first, so nodes with more
+ * interference edges get smaller keys.
+ */
+static uint32_t get_queue_key(be_pbqp_alloc_env_t const *const pbqp_alloc_env,
+                              ir_node const *const irn)
+{
+	return UINT32_MAX - pbqp_alloc_env->ife_edge_num[get_irn_idx(irn)];
+}
+#endif
+
 static void create_pbqp_coloring_instance(ir_node *block, void *data)
 {
 	be_pbqp_alloc_env_t         *pbqp_alloc_env     = (be_pbqp_alloc_env_t*)data;
@@ -286,8 +300,8 @@ static void create_pbqp_coloring_instance(ir_node *block, void *data)
 	int                         *assignment         = ALLOCAN(int, cls->n_regs);
 #else
 	unsigned                    *restr_nodes        = pbqp_alloc_env->restr_nodes;
-	pqueue_t                    *restr_nodes_queue  = new_pqueue();
-	pqueue_t                    *queue              = new_pqueue();
+	radixheap_t                 *restr_nodes_queue  = &pbqp_alloc_env->restr_nodes_queue;
+	radixheap_t                 *queue              = &pbqp_alloc_env->queue;
 	ir_node                     *last_element       = NULL;
 	pbqp_node_t                **sorted_list        = NEW_ARR_F(pbqp_node_t*, 0);
 #endif
@@ -440,9 +454,9 @@ static void create_pbqp_coloring_instance(ir_node *block, void *data)
 
 				/* insert proj node into priority queue (descending by the number of interference edges) */
 				if (get_free_regs(restr_nodes, cls, proj) <= 4) {
-					pqueue_put(restr_nodes_queue, proj, pbqp_alloc_env->ife_edge_num[get_irn_idx(proj)]);
+					radixheap_put(restr_nodes_queue, proj, get_queue_key(pbqp_alloc_env, proj));
 				} else {
-					pqueue_put(queue, proj, pbqp_alloc_env->ife_edge_num[get_irn_idx(proj)]);
+					radixheap_put(queue, proj, get_queue_key(pbqp_alloc_env, proj));
 				}
 
 				/* skip last step if there is no last_element */
@@ -457,9 +471,9 @@ static void create_pbqp_coloring_instance(ir_node *block, void *data)
 
 			if (last_element != NULL && allHaveIFEdges) {
 				if (get_free_regs(restr_nodes, cls, last_element) <= 4) {
-					pqueue_put(restr_nodes_queue, last_element, pbqp_alloc_env->ife_edge_num[get_irn_idx(last_element)]);
+					radixheap_put(restr_nodes_queue, last_element, get_queue_key(pbqp_alloc_env, last_element));
 				} else {
-					pqueue_put(queue, last_element, pbqp_alloc_env->ife_edge_num[get_irn_idx(last_element)]);
+					radixheap_put(queue, last_element, get_queue_key(pbqp_alloc_env, last_element));
 				}
 				/* remove node from list */
 				pbqp_node_t *node = get_node(pbqp_inst, last_element->node_idx);
@@ -473,14 +487,14 @@ static void create_pbqp_coloring_instance(ir_node *block, void *data)
 			}
 
 			/* first insert all restricted proj nodes */
-			while (!pqueue_empty(restr_nodes_queue)) {
-				ir_node *node = (ir_node*)pqueue_pop_front(restr_nodes_queue);
+			while (!radixheap_empty(restr_nodes_queue)) {
+				ir_node *node = (ir_node*)radixheap_pop_min(restr_nodes_queue);
 				ARR_APP1(pbqp_node_t*, sorted_list, get_node(pbqp_inst, get_irn_idx(node)));
 			}
 
 			/* insert proj nodes descending by their number of interference edges */
-			while (!pqueue_empty(queue)) {
-				ir_node *node = (ir_node*)pqueue_pop_front(queue);
+			while (!radixheap_empty(queue)) {
+				ir_node *node = (ir_node*)radixheap_pop_min(queue);
 				ARR_APP1(pbqp_node_t*, sorted_list, get_node(pbqp_inst, get_irn_idx(node)));
 			}
 
@@ -517,8 +531,6 @@ static void create_pbqp_coloring_instance(ir_node *block, void *data)
 #if USE_BIPARTIT_MATCHING
 #else
 	DEL_ARR_F(sorted_list);
-	del_pqueue(queue);
-	del_pqueue(restr_nodes_queue);
 #endif
 }
 
@@ -565,6 +577,8 @@ static void be_pbqp_coloring(be_chordal_env_t *env)
 	pbqp_alloc_env.ife_edge_num     = XMALLOCNZ(unsigned, get_irg_last_idx(irg));
 	pbqp_alloc_env.env              = env;
 	deq_init(&pbqp_alloc_env.rpeo);
+	radixheap_init(&pbqp_alloc_env.restr_nodes_queue);
+	radixheap_init(&pbqp_alloc_env.queue);
 
 	unsigned const colors_n = cls->n_regs;
 	/* create costs matrix template for interference edges */
@@ -674,6 +688,8 @@ static void be_pbqp_coloring(be_chordal_env_t *env)
 #endif
 	free_pbqp(pbqp_alloc_env.pbqp_inst);
 	deq_free(&pbqp_alloc_env.rpeo);
+	radixheap_free(&pbqp_alloc_env.queue);
+	radixheap_free(&pbqp_alloc_env.restr_nodes_queue);
 	free(pbqp_alloc_env.restr_nodes);
 	free(pbqp_alloc_env.ife_edge_num);
 }
@@ -22,6 +22,7 @@
  * TODO:
  *  - make use of free registers in the permute_values code
  */
+#include "arena.h"
 #include "be.h"
 #include "bechordal_t.h"
 #include "beirg.h"
@@ -47,7 +48,6 @@
 #include "irnode_t.h"
 #include "irtools.h"
 #include "lpp.h"
-#include "obst.h"
 #include "panic.h"
 #include "pdeq.h"
 #include "raw_bitset.h"
@@ -69,7 +69,7 @@
 
 DEBUG_ONLY(static firm_dbg_module_t *dbg = NULL;)
 
-static struct obstack               obst;
+static arena_t                      arena;
 static ir_graph                    *irg;
 static const arch_register_class_t *cls;
 static be_lv_t                     *lv;
@@ -117,7 +117,7 @@ static allocation_info_t *get_allocation_info(ir_node *node)
 {
 	allocation_info_t *info = (allocation_info_t*)get_irn_link(node);
 	if (info == NULL) {
-		info = OALLOCFZ(&obst, allocation_info_t, prefs, n_regs);
+		info = ARENA_ALLOCFZ(&arena, allocation_info_t, prefs, n_regs);
 		info->current_value  = node;
 		info->original_value = node;
 		set_irn_link(node, info);
@@ -140,7 +140,7 @@ static block_info_t *get_block_info(ir_node *block)
 
 	assert(is_Block(block));
 	if (info == NULL) {
-		info = OALLOCFZ(&obst, block_info_t, assignments, n_regs);
+		info = ARENA_ALLOCFZ(&arena, block_info_t, assignments, n_regs);
 		set_irn_link(block, info);
 	}
 
@@ -1660,7 +1660,7 @@ static void determine_block_order(void)
 			costs += pred_costs->costs;
 		}
 
-		cost_info          = OALLOCZ(&obst, block_costs_t);
+		cost_info          = ARENA_ALLOCZ(&arena, block_costs_t);
 		cost_info->costs   = costs;
 		cost_info->dfs_num = dfs_num++;
 		set_irn_link(block, cost_info);
@@ -1717,8 +1717,8 @@ static void determine_block_order(void)
 
 	DEL_ARR_F(blocklist);
 
-	obstack_free(&obst, NULL);
-	obstack_init(&obst);
+	arena_destroy(&arena);
+	arena_init(&arena);
 
 	block_order   = order;
 	n_block_order = n_blocks;
@@ -1782,7 +1782,7 @@ static void be_pref_alloc(ir_graph *new_irg, const regalloc_if_t *regif)
 	set_optimize(0);
 
 	irg = new_irg;
-	obstack_init(&obst);
+	arena_init(&arena);
 
 	be_spill_prepare_for_constraints(irg);
 
@@ -1798,6 +1798,8 @@ static void be_pref_alloc(ir_graph *new_irg, const regalloc_if_t *regif)
 
 		stat_ev_ctx_push_str("regcls", cls->name);
 
+		/* the allocation infos of a class are dead after its coloring */
+		arena_mark_t const mark = arena_mark(&arena);
 		n_regs      = cls->n_regs;
 		normal_regs = rbitset_malloc(n_regs);
 		be_get_allocatable_regs(irg, cls, normal_regs);
@@ -1822,12 +1824,13 @@ static void be_pref_alloc(ir_graph *new_irg, const regalloc_if_t *regif)
 		 * now */
 		be_invalidate_live_sets(irg);
 		free(normal_regs);
+		arena_release(&arena, mark);
 
 		stat_ev_ctx_pop("regcls");
 	}
 
 	free_block_order();
-	obstack_free(&obst, NULL);
+	arena_destroy(&arena);
 
 	set_optimize(last_opt_state);
 }
@@ -9,6 +9,7 @@
  * @author      Daniel Grund, Matthias Braun
  * @date        20.09.2005
  */
+#include "arena.h"
 #include "bearch.h"
 #include "bechordal_t.h"
 #include "beirg.h"
@@ -29,7 +30,6 @@
 #include "irmode_t.h"
 #include "irnode_t.h"
 #include "irtools.h"
-#include "obst.h"
 #include "statev_t.h"
 #include "util.h"
 #include <stdbool.h>
@@ -60,7 +60,7 @@ typedef struct workset_t {
 	loc_t    vals[];  /**< array of the values/distances in this working set */
 } workset_t;
 
-static struct obstack               obst;
+static arena_t                      arena;
 static const arch_register_class_t *cls;
 static const be_lv_t               *lv;
 static be_loopana_t                *loop_ana;
@@ -88,11 +88,11 @@ static const lc_opt_table_entry_t options[] = {
 };
 
 /**
- * Alloc a new workset on obstack @p ob with maximum size @p max
+ * Alloc a new workset on the arena with maximum size n_regs
  */
 static workset_t *new_workset(void)
 {
-	return OALLOCFZ(&obst, workset_t, vals, n_regs);
+	return ARENA_ALLOCFZ(&arena, workset_t, vals, n_regs);
 }
 
 /**
@@ -105,11 +105,11 @@ static void workset_copy(workset_t *dest, const workset_t *src)
 }
 
 /**
- * Alloc a new instance on obstack and make it equal to @param workset
+ * Alloc a new instance on the arena and make it equal to @param workset
  */
 static workset_t *workset_clone(workset_t *workset)
 {
-	workset_t *res = OALLOCF(&obst, workset_t, vals, n_regs);
+	workset_t *res = ARENA_ALLOCF(&arena, workset_t, vals, n_regs);
 	workset_copy(res, workset);
 	return res;
 }
@@ -242,7 +242,7 @@ typedef struct block_info_t {
 
 static block_info_t *new_block_info(ir_node *block)
 {
-	block_info_t *info = OALLOCZ(&obst, block_info_t);
+	block_info_t *info = ARENA_ALLOCZ(&arena, block_info_t);
 	set_irn_link(block, info);
 	return info;
 }
@@ -805,7 +805,7 @@ static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
 
 	/* init belady env */
 	stat_ev_tim_push();
-	obstack_init(&obst);
+	arena_init(&arena);
 	cls          = rcls;
 	lv           = be_get_irg_liveness(irg);
 	n_regs       = be_get_n_allocatable_regs(irg, cls);
@@ -840,7 +840,7 @@ static void be_spill_belady(ir_graph *irg, const arch_register_class_t *rcls,
 	be_delete_spill_env(senv);
 	be_end_uses(uses);
 	be_free_loop_pressure(loop_ana);
-	obstack_free(&obst, NULL);
+	arena_destroy(&arena);
 }
 
 BE_REGISTER_MODULE_CONSTRUCTOR(be_init_spillbelady)
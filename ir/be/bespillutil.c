@@ -16,6 +16,7 @@
 #include "bearch.h"
 #include "bechordal_t.h"
 #include "beirg.h"
+#include "belive.h"
 #include "bemodule.h"
 #include "benode.h"
 #include "besched.h"
@@ -32,6 +33,7 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irnodehashmap.h"
+#include "irnodeset.h"
 #include "statev_t.h"
 #include "target_t.h"
 #include "type_t.h"
@@ -536,10 +538,50 @@ static void determine_spill_costs(spill_env_t *env, spill_info_t *spillinfo)
 	DB((dbg, LEVEL_1, "spill %+F after definition\n", to_spill));
 }
 
+/**
+ * Updates the liveness information after spills, reloads and remats have been
+ * inserted: The new nodes get introduced, while their operands and the spilled
+ * values (whose users have been rerouted to the reloads) get updated.
+ *
+ * @param env        the spill environment
+ * @param lv         the liveness information
+ * @param first_new  the first node index used by a node created by the spiller
+ */
+static void update_liveness(spill_env_t *env, be_lv_t *lv, unsigned first_new)
+{
+	ir_nodeset_t changed;
+	ir_nodeset_init(&changed);
+	for (spill_info_t *si = env->spills; si != NULL; si = si->next) {
+		ir_nodeset_insert(&changed, si->to_spill);
+	}
+
+	ir_graph *const irg = env->irg;
+	for (unsigned i = first_new, n = get_irg_last_idx(irg); i < n; ++i) {
+		ir_node *const node = get_idx_irn(irg, i);
+		if (is_Deleted(node))
+			continue;
+
+		be_liveness_introduce(lv, node);
+		foreach_irn_in(node, p, op) {
+			if (get_irn_idx(op) < first_new)
+				ir_nodeset_insert(&changed, op);
+		}
+	}
+
+	foreach_ir_nodeset(&changed, node, iter) {
+		if (!is_Deleted(node))
+			be_liveness_update(lv, node);
+	}
+	ir_nodeset_destroy(&changed);
+}
+
 void be_insert_spills_reloads(spill_env_t *env)
 {
 	be_timer_push(T_RA_SPILL_APPLY);
 
+	/* all nodes created from here on are spills, reloads, remats or Phis */
+	unsigned const first_new = get_irg_last_idx(env->irg);
+
 	/* create all phi-ms first, this is needed so, that phis, hanging on
 	   spilled phis work correctly */
 	for (spill_info_t *info = env->mem_phis; info != NULL;
@@ -669,12 +711,13 @@ void be_insert_spills_reloads(spill_env_t *env)
 	stat_ev_dbl("spill_remats", env->remat_count);
 	stat_ev_dbl("spill_spilled_phis", env->spilled_phi_count);
 
-	/* Matze: In theory be_ssa_construction should take care of the liveness...
-	 * try to disable this again in the future */
-	be_invalidate_live_sets(env->irg);
-
 	be_remove_dead_nodes_from_schedule(env->irg);
 
+	/* update the liveness sets incrementally instead of recomputing them */
+	be_lv_t *const lv = be_get_irg_liveness(env->irg);
+	if (lv->sets_valid)
+		update_liveness(env, lv, first_new);
+
 	be_timer_pop(T_RA_SPILL_APPLY);
 }
 
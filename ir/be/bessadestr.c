@@ -53,12 +53,12 @@ static void impl_parcopy(const arch_register_class_t *cls,
 	 * Goal: Establish invariant that each node has <= 1 outgoing edges by
 	 *       recording restore copies (and inserting them later). */
 	for (unsigned to_reg = 0; to_reg < n_regs; ++to_reg) {
-		const unsigned from_reg    = parcopy[to_reg];
-		unsigned       from_n_used = n_used[from_reg];
-
+		const unsigned from_reg = parcopy[to_reg];
 		if (from_reg == n_regs)
 			continue;
 
+		unsigned from_n_used = n_used[from_reg];
+
 		/* Decide if the current edge should be kept or not.
 		 * We keep an edge if it is a self-loop or if it is the last outgoing
 		 * edge of a node with multiple outgoing edges.
@@ -227,11 +227,15 @@ void be_ssa_destruction(ir_graph *irg, const arch_register_class_t *cls)
 {
 	FIRM_DBG_REGISTER(dbg, "ir.be.ssadestr");
 
-	be_invalidate_live_sets(irg);
-	be_assure_live_chk(irg);
+	/* The liveness sets are updated while inserting the shuffle code, so keep
+	 * using them if they are available. */
+	be_lv_t *const lv         = be_get_irg_liveness(irg);
+	bool     const sets_valid = lv->sets_valid;
+	if (!sets_valid)
+		be_assure_live_chk(irg);
 
 	irg_block_walk_graph(irg, insert_shuffle_code_walker, NULL, (void*)cls);
 
-	/* unfortunately updating doesn't work yet. */
-	be_invalidate_live_chk(irg);
+	if (!sets_valid)
+		be_invalidate_live_chk(irg);
 }
@@ -27,6 +27,7 @@
 #include "irgraph_t.h"
 #include "irgwalk.h"
 #include "irhooks.h"
+#include "irmemory_t.h"
 #include "irnode_t.h"
 #include "irnodemap.h"
 #include "irop_t.h"
@@ -325,6 +326,7 @@ void be_transform_graph(ir_graph *irg, arch_pretrans_nodes *func)
 	irg->last_node_idx = 0;
 
 	free_vrp_data(irg);
+	free_irg_points_to(irg);
 
 	/* create new value table for CSE */
 	new_identities(irg);
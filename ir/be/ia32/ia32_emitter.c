@@ -1422,6 +1422,10 @@ static unsigned emit_jit_entity_relocation_asm(char *const buffer,
 		be_emit_irprintf("\t.long %"PRId32"\n", offset);
 		be_emit_write_line();
 		return 4;
+	} else if (be_kind == IA32_RELOCATION_ABSJUMP) {
+		be_emit_irprintf("\t.long .%+"PRId32"\n", offset);
+		be_emit_write_line();
+		return 4;
 	}
 
 	unsigned res = 4;
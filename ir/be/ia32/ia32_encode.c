@@ -293,6 +293,11 @@ static void enc_copy(const ir_node *copy)
 	enc_mov(in, out);
 }
 
+static void enc_copyebpesp(ir_node const *const node)
+{
+	enc_mov(arch_get_irn_register_in(node, 0), arch_get_irn_register_out(node, 0));
+}
+
 static void enc_perm(const ir_node *node)
 {
 	arch_register_t       const *const reg0 = arch_get_irn_register_out(node, 0);
@@ -637,7 +642,7 @@ static void enc_imulimm(const ir_node *node)
 	ia32_immediate_attr_t const *const attr  = get_ia32_immediate_attr_const(right);
 	bool                         const imm8  = ia32_is_8bit_imm(attr);
 	enc_unop_reg(node, 0x69 | (imm8 ? OP_IMM8 : 0), n_ia32_IMul_left);
-	enc_imm(attr, imm8 ? 8 : 32);
+	enc_imm(attr, imm8 ? X86_SIZE_8 : X86_SIZE_32);
 }
 
 static void enc_dec(const ir_node *node)
@@ -855,7 +860,7 @@ static void enc_push(const ir_node *node)
 		ia32_immediate_attr_t const *const attr = get_ia32_immediate_attr_const(value);
 		bool                         const imm8 = ia32_is_8bit_imm(attr);
 		be_emit8(0x68 | (imm8 ? OP_IMM8 : 0));
-		enc_imm(attr, imm8 ? 8 : 32);
+		enc_imm(attr, imm8 ? X86_SIZE_8 : X86_SIZE_32);
 	} else {
 		arch_register_t const *const reg = arch_get_irn_register(value);
 		be_emit8(0x50 + reg->encoding);
@@ -997,11 +1002,29 @@ static void enc_ia32_jcc(const ir_node *node)
 
 static void enc_switchjmp(const ir_node *node)
 {
-	be_emit8(0xFF); // jmp *tbl.label(,%in,4)
-	enc_mod_am(0x05, node);
+	/* The table directly follows the jump in the same fragment. */
+	assert(get_irn_n_reg(node, n_ia32_base) == NULL);
+	ir_node         const *const idx   = get_irn_n_reg(node, n_ia32_index);
+	arch_register_t const *const reg   = arch_get_irn_register(idx);
+	ir_node         const *const block = get_nodes_block(node);
+	unsigned const fragment_num
+		= PTR_TO_INT(ir_nodehashmap_get(void, &block_fragmentnum, block));
+	be_emit8(0xFF); // jmp *tbl(,%in,4)
+	be_emit8(MOD_IND | ENC_REG(4, REG_LOW) | ENC_RM(0x04, REG_LOW));
+	be_emit8(ENC_SIB(get_ia32_attr_const(node)->addr.log_scale, reg->encoding, 0x05));
+	be_emit_reloc_fragment(4, IA32_RELOCATION_ABSJUMP, fragment_num,
+	                       be_get_fragment_offset() + 4);
 
 	ia32_switch_attr_t const *const attr = get_ia32_switch_attr_const(node);
-	be_emit_jump_table(node, &attr->swtch, mode_P, ia32_emit_jumptable_target);
+	unsigned long         length;
+	ir_node const **const labels = be_get_jump_table(node, &attr->swtch, &length);
+	for (unsigned long i = 0; i < length; ++i) {
+		ir_node const *const target = be_emit_get_cfop_target(labels[i]);
+		unsigned const target_num
+			= PTR_TO_INT(ir_nodehashmap_get(void, &block_fragmentnum, target));
+		be_emit_reloc_fragment(4, IA32_RELOCATION_ABSJUMP, target_num, 0);
+	}
+	free(labels);
 }
 
 static void enc_return(const ir_node *node)
@@ -1285,6 +1308,7 @@ static void ia32_register_binary_emitters(void)
 	be_set_emitter(op_ia32_CMovcc,        enc_cmovcc);
 	be_set_emitter(op_ia32_Call,          enc_call);
 	be_set_emitter(op_ia32_Const,         enc_mov_const);
+	be_set_emitter(op_ia32_CopyEbpEsp,    enc_copyebpesp);
 	be_set_emitter(op_ia32_Conv_I2I,      enc_conv_i2i);
 	be_set_emitter(op_ia32_CopyB_i,       enc_copybi);
 	be_set_emitter(op_ia32_Dec,           enc_dec);
@@ -1428,8 +1452,12 @@ static unsigned enc_relocation_callback(char *const buffer,
 {
 	uint32_t value;
 	if (entity == NULL) {
-		assert(be_kind == IA32_RELOCATION_RELJUMP);
-		value = (uint32_t)offset;
+		if (be_kind == IA32_RELOCATION_ABSJUMP) {
+			value = (uint32_t)((intptr_t)buffer + offset);
+		} else {
+			assert(be_kind == IA32_RELOCATION_RELJUMP);
+			value = (uint32_t)offset;
+		}
 	} else {
 		intptr_t const entity_addr = (intptr_t)be_jit_get_entity_addr(entity);
 		if (entity_addr == (intptr_t)-1)
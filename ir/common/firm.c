@@ -32,6 +32,7 @@
 #include "irtools.h"
 #include "lc_opts.h"
 #include "opt_init.h"
+#include "raw_bitset.h"
 #include "target_t.h"
 #include "tv_t.h"
 #include "type_t.h"
@@ -57,6 +58,7 @@ void ir_init_library(void)
 	initialized = true;
 
 	firm_init_flags();
+	init_rbitset();
 	init_ident();
 	init_edges();
 	init_tarval_1();
@@ -7,6 +7,11 @@
  * @file
  * @brief   platform neutral timing utilities
  */
+#ifdef __linux__
+/* for the syscall() prototype used to open the performance counters */
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <string.h>
 
@@ -43,17 +48,105 @@ typedef struct timeval ir_timer_val_t;
 
 static inline void _time_reset(ir_timer_val_t *val);
 
+typedef unsigned long long ir_counter_vals_t[IR_TIMER_COUNTER_LAST + 1];
+
 /**
  * A timer.
  */
 struct ir_timer_t {
-	ir_timer_val_t elapsed;     /**< the elapsed time so far */
-	ir_timer_val_t start;       /**< the start value of the timer */
-	ir_timer_t     *parent;     /**< parent of a timer */
-	ir_timer_t     *displaced;  /**< former timer in case of timer_push */
-	unsigned       running : 1; /**< set if this timer is running */
+	ir_timer_val_t    elapsed;        /**< the elapsed time so far */
+	ir_timer_val_t    start;          /**< the start value of the timer */
+	ir_counter_vals_t counters;       /**< the counted events so far */
+	ir_counter_vals_t counters_start; /**< the counter values at start */
+	ir_timer_t        *parent;        /**< parent of a timer */
+	ir_timer_t        *displaced;     /**< former timer in case of timer_push */
+	unsigned          running  : 1;   /**< set if this timer is running */
+	unsigned          counting : 1;   /**< set if the timer reads counters */
 };
 
+#ifdef __linux__
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+
+/** The perf event group leader, -1 if unavailable, -2 if not opened yet. */
+static int counter_group = -2;
+/** Position of each counter in the group or -1 if unavailable. */
+static int counter_slot[IR_TIMER_COUNTER_LAST + 1];
+
+static int open_counters(void)
+{
+	static const unsigned long long configs[] = {
+		[IR_TIMER_INSTRUCTIONS]  = PERF_COUNT_HW_INSTRUCTIONS,
+		[IR_TIMER_CYCLES]        = PERF_COUNT_HW_CPU_CYCLES,
+		[IR_TIMER_CACHE_MISSES]  = PERF_COUNT_HW_CACHE_MISSES,
+		[IR_TIMER_BRANCH_MISSES] = PERF_COUNT_HW_BRANCH_MISSES,
+	};
+
+	if (counter_group != -2)
+		return counter_group >= 0;
+
+	counter_group = -1;
+	int n_slots = 0;
+	for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c) {
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size           = sizeof(attr);
+		attr.type           = PERF_TYPE_HARDWARE;
+		attr.config         = configs[c];
+		attr.read_format    = PERF_FORMAT_GROUP;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv     = 1;
+		/* the first counter that can be opened becomes the group leader */
+		int const fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1,
+		                            counter_group, 0);
+		if (fd < 0) {
+			counter_slot[c] = -1;
+			continue;
+		}
+		if (counter_group < 0)
+			counter_group = fd;
+		counter_slot[c] = n_slots++;
+	}
+	return counter_group >= 0;
+}
+
+static void read_counters(ir_counter_vals_t vals)
+{
+	/* with PERF_FORMAT_GROUP the number of counters precedes the values */
+	unsigned long long buf[IR_TIMER_COUNTER_LAST + 2];
+	ssize_t const      res = read(counter_group, buf, sizeof(buf));
+	for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c) {
+		int const slot = counter_slot[c];
+		vals[c] = res > 0 && slot >= 0 ? buf[slot + 1] : 0;
+	}
+}
+
+int ir_timer_counter_available(ir_timer_counter_t counter)
+{
+	return open_counters() && counter_slot[counter] >= 0;
+}
+
+#else
+
+static int open_counters(void)
+{
+	return 0;
+}
+
+static void read_counters(ir_counter_vals_t vals)
+{
+	memset(vals, 0, sizeof(ir_counter_vals_t));
+}
+
+int ir_timer_counter_available(ir_timer_counter_t counter)
+{
+	(void)counter;
+	return 0;
+}
+
+#endif
+
 /** The top of the timer stack */
 static ir_timer_t *timer_stack;
 
@@ -284,6 +377,7 @@ void ir_timer_reset(ir_timer_t *timer)
 {
 	_time_reset(&timer->elapsed);
 	_time_reset(&timer->start);
+	memset(timer->counters, 0, sizeof(timer->counters));
 	timer->running = 0;
 }
 
@@ -295,6 +389,8 @@ void ir_timer_start(ir_timer_t *timer)
 
 	_time_reset(&timer->start);
 	_time_get(&timer->start);
+	if (timer->counting)
+		read_counters(timer->counters_start);
 	timer->running = 1;
 
 	if (timer->parent == NULL) {
@@ -307,8 +403,9 @@ void ir_timer_start(ir_timer_t *timer)
 
 void ir_timer_reset_and_start(ir_timer_t *timer)
 {
-  _time_reset(&timer->elapsed);
-  ir_timer_start(timer);
+	_time_reset(&timer->elapsed);
+	memset(timer->counters, 0, sizeof(timer->counters));
+	ir_timer_start(timer);
 }
 
 void ir_timer_stop(ir_timer_t *timer)
@@ -323,6 +420,12 @@ void ir_timer_stop(ir_timer_t *timer)
 	ir_timer_val_t tgt;
 
 	_time_get(&val);
+	if (timer->counting) {
+		ir_counter_vals_t counters;
+		read_counters(counters);
+		for (ir_timer_counter_t c = 0; c <= IR_TIMER_COUNTER_LAST; ++c)
+			timer->counters[c] += counters[c] - timer->counters_start[c];
+	}
 	timer->running = 0;
 	_time_add(&timer->elapsed, &timer->elapsed, _time_sub(&tgt, &val, &timer->start));
 }
@@ -417,3 +520,34 @@ double ir_timer_elapsed_sec(const ir_timer_t *timer)
 	}
 	return _time_to_sec(elapsed);
 }
+
+int ir_timer_enable_counters(ir_timer_t *timer)
+{
+	if (timer->running)
+		panic("enabling counters of running timer");
+	timer->counting = open_counters();
+	return timer->counting;
+}
+
+unsigned long long ir_timer_counter(const ir_timer_t *timer,
+                                    ir_timer_counter_t counter)
+{
+	unsigned long long val = timer->counters[counter];
+	if (timer->running && timer->counting) {
+		ir_counter_vals_t counters;
+		read_counters(counters);
+		val += counters[counter] - timer->counters_start[counter];
+	}
+	return val;
+}
+
+const char *ir_timer_counter_name(ir_timer_counter_t counter)
+{
+	switch (counter) {
+	case IR_TIMER_INSTRUCTIONS:  return "instructions";
+	case IR_TIMER_CYCLES:        return "cycles";
+	case IR_TIMER_CACHE_MISSES:  return "cache_misses";
+	case IR_TIMER_BRANCH_MISSES: return "branch_misses";
+	}
+	panic("invalid performance counter");
+}
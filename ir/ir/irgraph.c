@@ -19,7 +19,7 @@
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irhooks.h"
-#include "irmemory.h"
+#include "irmemory_t.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
@@ -267,6 +267,23 @@ ir_graph *create_irg_copy(ir_graph *irg)
 	return res;
 }
 
+ir_graph *create_irg_clone(ir_graph *irg, ir_entity *ent)
+{
+	ir_graph *const res = create_irg_copy(irg);
+	hook_new_graph(res, ent);
+
+	res->ent               = ent;
+	res->callee_info_state = irg_callee_info_none;
+	res->mem_disambig_opt  = irg->mem_disambig_opt;
+	res->index             = get_irp_new_irg_idx();
+#ifdef DEBUG_libfirm
+	res->graph_nr          = get_irp_new_node_nr();
+#endif
+	set_entity_irg(ent, res);
+	add_irp_irg(res);
+	return res;
+}
+
 void free_ir_graph(ir_graph *irg)
 {
 	assert(irg->kind == k_ir_graph);
@@ -275,6 +292,7 @@ void free_ir_graph(ir_graph *irg)
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
 
 	free_irg_outs(irg);
+	free_irg_points_to(irg);
 	del_identities(irg);
 	if (irg->ent) {
 		set_entity_irg(irg->ent, NULL);  /* not set in const code irg */
@@ -143,6 +143,8 @@ struct ir_graph {
 	bool                out_obst_allocated;
 	ir_bitinfo          bitinfo;     /**< bit info */
 	ir_vrp_info         vrp;         /**< vrp info */
+	unsigned           *points_to;   /**< points-to class per node index */
+	unsigned            n_points_to; /**< length of points_to */
 	ir_loop            *loop;        /**< The outermost loop for this graph. */
 	ir_dom_front_info_t domfront;    /**< dominance frontier analysis data */
 	irg_edges_info_t    edge_info;   /**< edge info for automatic outs */
@@ -191,6 +193,17 @@ ir_graph *new_const_code_irg(void);
  */
 ir_graph *create_irg_copy(ir_graph *irg);
 
+/**
+ * Create a copy of a given graph as the implementation of another method
+ * entity and add it to the program.  The entity must have the same type
+ * as the entity of the original graph.
+ * Uses the link fields of the original graphs.
+ *
+ * @param irg  The graph that must be copied.
+ * @param ent  The entity of the new graph.
+ */
+ir_graph *create_irg_clone(ir_graph *irg, ir_entity *ent);
+
 /**
  * Set the op_pin_state_pinned state of a graph.
  *
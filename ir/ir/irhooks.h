@@ -12,6 +12,7 @@
 #define FIRM_IR_IRHOOKS_H
 
 #include <stdio.h>
+#include "compiler.h"
 #include "firm_types.h"
 
 /**
@@ -89,19 +90,30 @@ void register_hook(hook_type_t hook, hook_entry_t *entry);
  */
 void unregister_hook(hook_type_t hook, hook_entry_t *entry);
 
-/** Global list of registerd hooks. */
+/** Global list of registered hooks. */
 extern hook_entry_t *hooks[hook_last];
 
+/**
+ * Checks whether any hook of type @p what is registered.
+ * Compiling with FIRM_NO_HOOKS removes all hook calls.
+ */
+#ifdef FIRM_NO_HOOKS
+#define hook_active(what) 0
+#else
+#define hook_active(what) UNLIKELY(hooks[what] != NULL)
+#endif
+
 /**
  * Executes the hook @p what with the args @p args
  * Do not use this macro directly.
  */
-#define hook_exec(what, args) do {             \
-	hook_entry_t *_p;                          \
-	for (_p = hooks[what]; _p; _p = _p->next){ \
-		void *hook_ctx_ = _p->context;         \
-		_p->hook._##what args;                 \
-	}                                          \
+#define hook_exec(what, args) do {                                        \
+	if (hook_active(what)) {                                              \
+		for (hook_entry_t *_p = hooks[what]; _p != NULL; _p = _p->next) { \
+			void *hook_ctx_ = _p->context;                                \
+			_p->hook._##what args;                                        \
+		}                                                                 \
+	}                                                                     \
 } while (0)
 
 /** Called after a new node has been created */
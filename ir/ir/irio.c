@@ -1411,7 +1411,10 @@ ir_entity *read_entity_ref(read_env_t *env)
 ir_mode *read_mode_ref(read_env_t *env)
 {
 	char *str = read_string(env);
-	for (size_t i = 0, n = ir_get_n_modes(); i < n; i++) {
+	// Mode names are not unique: a target may replace the default pointer mode
+	// by a new mode with the same name.  Prefer the newest one, which is the
+	// mode in use.
+	for (size_t i = ir_get_n_modes(); i-- > 0;) {
 		ir_mode *mode = ir_get_mode(i);
 		if (streq(str, get_mode_name(mode))) {
 			obstack_free(&env->obst, str);
@@ -1600,6 +1603,9 @@ static bool type_matches(const ir_type *t, tp_opcode op, unsigned size,
 	// This is only set after we deserialized the type, so we have
 	// to account for that.
 	flags |= state == layout_fixed ? tf_layout_fixed : 0;
+	// Every graph has its own frame type, so frame types are never shared.
+	if (flags & tf_frame_type)
+		return false;
 	return t->opcode == op
 		&& t->size == size
 		&& t->align == align
@@ -1637,7 +1643,6 @@ static void read_type(read_env_t *env)
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& other->attr.array.element_type == elemtype
 				&& other->attr.array.size == length) {
-				printf("Matched array type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1655,7 +1660,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& streq_null(other->name, id)) {
-				printf("Matched class type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1704,7 +1708,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& other->attr.pointer.points_to == points_to) {
-				printf("Matched pointer type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1721,7 +1724,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& other->mode == mode) {
-				printf("Matched primitive type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1739,7 +1741,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& streq_null(other->name, id)) {
-				printf("Matched struct type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1757,7 +1758,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& streq_null(other->name, id)) {
-				printf("Matched union type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -1775,7 +1775,6 @@ static void read_type(read_env_t *env)
 			ir_type *other = get_irp_type(i);
 			if (type_matches(other, opcode, size, align, state, flags)
 				&& streq_null(other->name, id)) {
-				printf("Matched segment type: %s\n", other->name);
 				type = other;
 				goto extend_env;
 			}
@@ -94,6 +94,8 @@ void free_ir_prog(void)
 	if (irp == NULL)
 		return;
 
+	free_irp_points_to();
+
 	/* must iterate backwards here */
 	foreach_irp_irg_r(i, irg) {
 		free_ir_graph(irg);
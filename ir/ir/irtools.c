@@ -10,10 +10,14 @@
  */
 #include "irtools.h"
 
+#include "ircons.h"
 #include "irbackedge_t.h"
+#include "irgraph_t.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "irprintf.h"
+#include "typerep.h"
+#include "xmalloc.h"
 #include <stdlib.h>
 
 void firm_clear_link(ir_node *n, void *env)
@@ -92,3 +96,43 @@ void irn_rewire_inputs(ir_node *node)
 	/* Now the new node is complete. We can add it to the hash table for CSE. */
 	add_identities(new_node);
 }
+
+bool has_register_signature(ir_type const *const mtp)
+{
+	if (is_method_variadic(mtp))
+		return false;
+	for (size_t i = 0, n = get_method_n_params(mtp); i < n; ++i) {
+		if (is_aggregate_type(get_method_param_type(mtp, i)))
+			return false;
+	}
+	for (size_t i = 0, n = get_method_n_ress(mtp); i < n; ++i) {
+		if (is_aggregate_type(get_method_res_type(mtp, i)))
+			return false;
+	}
+	return true;
+}
+
+ir_node *new_r_forwarding_call(ir_node *const block, ir_node *const mem,
+                               ir_entity *const callee, ir_type *const mtp)
+{
+	ir_graph *const irg      = get_irn_irg(block);
+	size_t    const n_params = get_method_n_params(mtp);
+	size_t    const n_ress   = get_method_n_ress(mtp);
+	ir_node  *const args     = get_irg_args(irg);
+	ir_node **const params   = ALLOCAN(ir_node*, n_params);
+	for (size_t i = 0; i < n_params; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_param_type(mtp, i));
+		params[i] = new_r_Proj(args, mode, i);
+	}
+
+	ir_node  *const ptr     = new_r_Address(irg, callee);
+	ir_node  *const call    = new_r_Call(block, mem, ptr, n_params, params, mtp);
+	ir_node  *const new_mem = new_r_Proj(call, mode_M, pn_Call_M);
+	ir_node  *const ress    = new_r_Proj(call, mode_T, pn_Call_T_result);
+	ir_node **const results = ALLOCAN(ir_node*, n_ress);
+	for (size_t i = 0; i < n_ress; ++i) {
+		ir_mode *const mode = get_type_mode(get_method_res_type(mtp, i));
+		results[i] = new_r_Proj(ress, mode, i);
+	}
+	return new_r_Return(block, new_mem, n_ress, results);
+}
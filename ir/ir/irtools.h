@@ -11,6 +11,8 @@
 #ifndef FIRM_COMMON_IRTOOLS_H
 #define FIRM_COMMON_IRTOOLS_H
 
+#include <stdbool.h>
+
 #include "firm_types.h"
 #include "lc_opts.h"
 #include "pset.h"
@@ -74,4 +76,26 @@ ir_node *irn_copy_into_irg(const ir_node *node, ir_graph *irg);
  */
 void irn_rewire_inputs(ir_node *node);
 
+/**
+ * Returns true if the method type @p mtp passes all its parameters and
+ * results as scalars, i.e. it is not variadic and has no compound parameter
+ * or result.  Calls of such methods can be built from the Projs of the
+ * arguments alone.
+ */
+bool has_register_signature(ir_type const *mtp);
+
+/**
+ * Constructs a call of @p callee passing the arguments of the graph of
+ * @p block and a Return of its results.
+ *
+ * @param block   the block of the call
+ * @param mem     the memory of the call
+ * @param callee  the called method
+ * @param mtp     the type of the call, which must have a register signature
+ *
+ * @return the Return node, which still has to be added to the end block
+ */
+ir_node *new_r_forwarding_call(ir_node *block, ir_node *mem,
+                               ir_entity *callee, ir_type *mtp);
+
 #endif
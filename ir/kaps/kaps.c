@@ -14,6 +14,7 @@
 #include "adt/array.h"
 #include "adt/xmalloc.h"
 #include "matrix.h"
+#include "num_array.h"
 #include "pbqp_edge.h"
 #include "pbqp_edge_t.h"
 #include "pbqp_node.h"
@@ -54,6 +55,7 @@ pbqp_t *alloc_pbqp(unsigned number_nodes)
 {
 	pbqp_t *pbqp = XMALLOC(pbqp_t);
 
+	num_array_init();
 	obstack_init(&pbqp->obstack);
 
 #ifdef NDEBUG
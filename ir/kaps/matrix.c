@@ -11,6 +11,7 @@
  */
 #include "matrix.h"
 
+#include "num_array.h"
 #include "pbqp_t.h"
 #include "vector.h"
 #include <assert.h>
@@ -74,11 +75,7 @@ void pbqp_matrix_add(pbqp_matrix_t *sum, pbqp_matrix_t *summand)
 	assert(sum->cols == summand->cols);
 	assert(sum->rows == summand->rows);
 
-	unsigned len = sum->rows * sum->cols;
-
-	for (unsigned i = 0; i < len; ++i) {
-		sum->entries[i] = pbqp_add(sum->entries[i], summand->entries[i]);
-	}
+	num_array_add(sum->entries, summand->entries, sum->rows * sum->cols);
 }
 
 void pbqp_matrix_set_col_value(pbqp_matrix_t *mat, unsigned col, num value)
@@ -180,46 +177,24 @@ void pbqp_matrix_sub_col_value(pbqp_matrix_t *matrix, unsigned col_index,
 
 num pbqp_matrix_get_row_min(pbqp_matrix_t *matrix, unsigned row_index, vector_t *flags)
 {
-	num      min = INF_COSTS;
 	unsigned len = flags->len;
 
 	assert(matrix->cols == len);
 
-	for (unsigned col_index = 0; col_index < len; ++col_index) {
-		/* Ignore virtual deleted columns. */
-		if (flags->entries[col_index].data == INF_COSTS) continue;
-
-		num elem = matrix->entries[row_index * len + col_index];
-
-		if (elem < min) {
-			min = elem;
-		}
-	}
-
-	return min;
+	/* Ignore virtual deleted columns. */
+	return num_array_min_masked(&matrix->entries[row_index * len],
+	                            vector_data(flags), len);
 }
 
 unsigned pbqp_matrix_get_row_min_index(pbqp_matrix_t *matrix, unsigned row_index, vector_t *flags)
 {
-	unsigned min_index = 0;
-	num      min       = INF_COSTS;
-	unsigned len       = flags->len;
+	unsigned len = flags->len;
 
 	assert(matrix->cols == len);
 
-	for (unsigned col_index = 0; col_index < len; ++col_index) {
-		/* Ignore virtual deleted columns. */
-		if (flags->entries[col_index].data == INF_COSTS) continue;
-
-		num elem = matrix->entries[row_index * len + col_index];
-
-		if (elem < min) {
-			min = elem;
-			min_index = col_index;
-		}
-	}
-
-	return min_index;
+	/* Ignore virtual deleted columns. */
+	return num_array_min_index(&matrix->entries[row_index * len],
+	                           vector_data(flags), len);
 }
 
 void pbqp_matrix_sub_row_value(pbqp_matrix_t *matrix, unsigned row_index,
@@ -277,9 +252,7 @@ void pbqp_matrix_add_to_all_cols(pbqp_matrix_t *mat, vector_t *vec)
 	for (unsigned row_index = 0; row_index < row_len; ++row_index) {
 		num value = vec->entries[row_index].data;
 
-		for (unsigned col_index = 0; col_index < col_len; ++col_index) {
-			mat->entries[row_index * col_len + col_index] = pbqp_add(mat->entries[row_index * col_len + col_index], value);
-		}
+		num_array_add_value(&mat->entries[row_index * col_len], value, col_len);
 	}
 }
 
@@ -291,10 +264,6 @@ void pbqp_matrix_add_to_all_rows(pbqp_matrix_t *mat, vector_t *vec)
 	assert(col_len == vec->len);
 
 	for (unsigned row_index = 0; row_index < row_len; ++row_index) {
-		for (unsigned col_index = 0; col_index < col_len; ++col_index) {
-			num value = vec->entries[col_index].data;
-
-			mat->entries[row_index * col_len + col_index] = pbqp_add(mat->entries[row_index * col_len + col_index], value);
-		}
+		num_array_add(&mat->entries[row_index * col_len], vector_data(vec), col_len);
 	}
 }
@@ -0,0 +1,273 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Kernels operating on contiguous arrays of PBQP costs.
+ */
+#include "num_array.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* The vectorized kernels rely on num being a 32bit unsigned integer with
+ * INF_COSTS as its maximum, so that saturating addition yields the same results
+ * as pbqp_add(). */
+#if KAPS_USE_UNSIGNED && UINT_MAX == 0xFFFFFFFFu && defined(__GNUC__) \
+    && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define KAPS_USE_SSE2 1
+#include <immintrin.h>
+#else
+#define KAPS_USE_SSE2 0
+#endif
+
+#if KAPS_USE_SSE2 && (__GNUC__ >= 5 || defined(__clang__))
+#define KAPS_USE_AVX2 1
+#else
+#define KAPS_USE_AVX2 0
+#endif
+
+#if KAPS_USE_AVX2
+static bool use_avx2;
+#endif
+
+void num_array_init(void)
+{
+#if KAPS_USE_AVX2
+	__builtin_cpu_init();
+	use_avx2 = __builtin_cpu_supports("avx2");
+#endif
+}
+
+static inline num add_scalar(num x, num y)
+{
+	if (x == INF_COSTS || y == INF_COSTS)
+		return INF_COSTS;
+
+	num res = x + y;
+	assert(res < INF_COSTS);
+	return res;
+}
+
+#if KAPS_USE_SSE2
+/* SSE2 only has signed 32bit comparisons, flip the sign bit to compare
+ * unsigned values. */
+static inline __m128i sse2_bias(__m128i x)
+{
+	return _mm_xor_si128(x, _mm_set1_epi32(INT_MIN));
+}
+
+static inline __m128i sse2_add_sat(__m128i x, __m128i y)
+{
+	__m128i sum      = _mm_add_epi32(x, y);
+	__m128i overflow = _mm_cmpgt_epi32(sse2_bias(x), sse2_bias(sum));
+	return _mm_or_si128(sum, overflow);
+}
+
+static inline __m128i sse2_min_epu32(__m128i x, __m128i y)
+{
+	__m128i x_greater = _mm_cmpgt_epi32(sse2_bias(x), sse2_bias(y));
+	return _mm_or_si128(_mm_and_si128(x_greater, y),
+	                    _mm_andnot_si128(x_greater, x));
+}
+
+/** Returns INF_COSTS in all lanes where flags is INF_COSTS, else x. */
+static inline __m128i sse2_mask(__m128i x, __m128i flags)
+{
+	return _mm_or_si128(x, _mm_cmpeq_epi32(flags, _mm_set1_epi32(-1)));
+}
+
+static inline num sse2_hmin(__m128i x)
+{
+	x = sse2_min_epu32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+	x = sse2_min_epu32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (num)_mm_cvtsi128_si32(x);
+}
+#endif
+
+#if KAPS_USE_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+static inline AVX2 __m256i avx2_add_sat(__m256i x, __m256i y)
+{
+	__m256i sum         = _mm256_add_epi32(x, y);
+	__m256i no_overflow = _mm256_cmpeq_epi32(_mm256_max_epu32(sum, x), sum);
+	return _mm256_or_si256(sum, _mm256_xor_si256(no_overflow,
+	                                             _mm256_set1_epi32(-1)));
+}
+
+static inline AVX2 __m256i avx2_mask(__m256i x, __m256i flags)
+{
+	return _mm256_or_si256(x, _mm256_cmpeq_epi32(flags, _mm256_set1_epi32(-1)));
+}
+
+static inline AVX2 num avx2_hmin(__m256i x)
+{
+	__m128i m = _mm_min_epu32(_mm256_castsi256_si128(x),
+	                          _mm256_extracti128_si256(x, 1));
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+	m = _mm_min_epu32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (num)_mm_cvtsi128_si32(m);
+}
+
+static AVX2 unsigned avx2_add(num *dst, const num *src, unsigned len)
+{
+	unsigned i = 0;
+	for (; i + 8 <= len; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i y = _mm256_loadu_si256((const __m256i *)(src + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), avx2_add_sat(x, y));
+	}
+	return i;
+}
+
+static AVX2 unsigned avx2_add_value(num *dst, num value, unsigned len)
+{
+	__m256i  y = _mm256_set1_epi32((int)value);
+	unsigned i = 0;
+	for (; i + 8 <= len; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(dst + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), avx2_add_sat(x, y));
+	}
+	return i;
+}
+
+static AVX2 unsigned avx2_min(const num *src, const num *flags, unsigned len,
+                              num *min)
+{
+	__m256i  m = _mm256_set1_epi32(-1);
+	unsigned i = 0;
+	for (; i + 8 <= len; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *)(src + i));
+		if (flags != NULL) {
+			__m256i f = _mm256_loadu_si256((const __m256i *)(flags + i));
+			x = avx2_mask(x, f);
+		}
+		m = _mm256_min_epu32(m, x);
+	}
+	*min = avx2_hmin(m);
+	return i;
+}
+#endif
+
+#if KAPS_USE_SSE2
+static unsigned sse2_add(num *dst, const num *src, unsigned len)
+{
+	unsigned i = 0;
+	for (; i + 4 <= len; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i y = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), sse2_add_sat(x, y));
+	}
+	return i;
+}
+
+static unsigned sse2_add_value(num *dst, num value, unsigned len)
+{
+	__m128i  y = _mm_set1_epi32((int)value);
+	unsigned i = 0;
+	for (; i + 4 <= len; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(dst + i));
+		_mm_storeu_si128((__m128i *)(dst + i), sse2_add_sat(x, y));
+	}
+	return i;
+}
+
+static unsigned sse2_min(const num *src, const num *flags, unsigned len,
+                         num *min)
+{
+	__m128i  m = _mm_set1_epi32(-1);
+	unsigned i = 0;
+	for (; i + 4 <= len; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+		if (flags != NULL) {
+			__m128i f = _mm_loadu_si128((const __m128i *)(flags + i));
+			x = sse2_mask(x, f);
+		}
+		m = sse2_min_epu32(m, x);
+	}
+	*min = sse2_hmin(m);
+	return i;
+}
+#endif
+
+void num_array_add(num *dst, const num *src, unsigned len)
+{
+	unsigned i = 0;
+#if KAPS_USE_AVX2
+	if (use_avx2)
+		i = avx2_add(dst, src, len);
+	else
+#endif
+#if KAPS_USE_SSE2
+		i = sse2_add(dst, src, len);
+#endif
+	for (; i < len; ++i) {
+		dst[i] = add_scalar(dst[i], src[i]);
+	}
+}
+
+void num_array_add_value(num *dst, num value, unsigned len)
+{
+	unsigned i = 0;
+#if KAPS_USE_AVX2
+	if (use_avx2)
+		i = avx2_add_value(dst, value, len);
+	else
+#endif
+#if KAPS_USE_SSE2
+		i = sse2_add_value(dst, value, len);
+#endif
+	for (; i < len; ++i) {
+		dst[i] = add_scalar(dst[i], value);
+	}
+}
+
+static num min_flagged(const num *src, const num *flags, unsigned len)
+{
+	num      min = INF_COSTS;
+	unsigned i   = 0;
+#if KAPS_USE_AVX2
+	if (use_avx2)
+		i = avx2_min(src, flags, len, &min);
+	else
+#endif
+#if KAPS_USE_SSE2
+		i = sse2_min(src, flags, len, &min);
+#endif
+	for (; i < len; ++i) {
+		/* Ignore virtual deleted entries. */
+		if (flags != NULL && flags[i] == INF_COSTS)
+			continue;
+		if (src[i] < min)
+			min = src[i];
+	}
+	return min;
+}
+
+num num_array_min(const num *src, unsigned len)
+{
+	return min_flagged(src, NULL, len);
+}
+
+num num_array_min_masked(const num *src, const num *flags, unsigned len)
+{
+	assert(flags != NULL);
+	return min_flagged(src, flags, len);
+}
+
+unsigned num_array_min_index(const num *src, const num *flags, unsigned len)
+{
+	num min = min_flagged(src, flags, len);
+	if (min == INF_COSTS)
+		return 0;
+
+	unsigned i = 0;
+	while (src[i] != min || (flags != NULL && flags[i] == INF_COSTS))
+		++i;
+	assert(i < len);
+	return i;
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Kernels operating on contiguous arrays of PBQP costs.
+ *
+ * These are the inner loops of the vector and matrix operations.  On x86
+ * hosts they use SSE2, and AVX2 if the CPU supports it (determined at
+ * runtime by num_array_init()); elsewhere plain C loops are used.  All
+ * additions saturate at INF_COSTS, so they agree with pbqp_add().
+ */
+#ifndef KAPS_NUM_ARRAY_H
+#define KAPS_NUM_ARRAY_H
+
+#include "pbqp_t.h"
+
+/**
+ * Selects the kernel implementation for the host CPU.  May be called
+ * multiple times.
+ */
+void num_array_init(void);
+
+/** dst[i] = pbqp_add(dst[i], src[i]) for all i < len */
+void num_array_add(num *dst, const num *src, unsigned len);
+
+/** dst[i] = pbqp_add(dst[i], value) for all i < len */
+void num_array_add_value(num *dst, num value, unsigned len);
+
+/** Returns the minimum of src[0..len), or INF_COSTS if len is 0. */
+num num_array_min(const num *src, unsigned len);
+
+/**
+ * Returns the minimum of all src[i] with i < len where flags[i] is not
+ * INF_COSTS, or INF_COSTS if there is no such entry.
+ */
+num num_array_min_masked(const num *src, const num *flags, unsigned len);
+
+/**
+ * Returns the index of the first minimal entry of src[0..len), ignoring
+ * entries whose flag is INF_COSTS if @p flags is not NULL.  Returns 0 if all
+ * considered entries are INF_COSTS.
+ */
+unsigned num_array_min_index(const num *src, const num *flags, unsigned len);
+
+#endif
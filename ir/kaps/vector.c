@@ -12,8 +12,12 @@
 #include "vector.h"
 
 #include "adt/array.h"
+#include "compiler.h"
+#include "num_array.h"
 #include <string.h>
 
+COMPILETIME_ASSERT(sizeof(vec_elem_t) == sizeof(num), vec_elem_size)
+
 num pbqp_add(num x, num y)
 {
 	if (x == INF_COSTS || y == INF_COSTS)
@@ -44,6 +48,9 @@ vector_t *vector_alloc(pbqp_t *pbqp, unsigned length)
 
 	vec->len = length;
 	memset(vec->entries, 0, sizeof(*vec->entries) * length);
+#if KAPS_ENABLE_VECTOR_NAMES
+	vec->names = OALLOCNZ(&pbqp->obstack, const char*, length);
+#endif
 
 	return vec;
 }
@@ -53,6 +60,9 @@ vector_t *vector_copy(pbqp_t *pbqp, vector_t *v)
 	unsigned  len  = v->len;
 	vector_t *copy = (vector_t *)obstack_copy(&pbqp->obstack, v, sizeof(*copy) + sizeof(*copy->entries) * len);
 	assert(copy);
+#if KAPS_ENABLE_VECTOR_NAMES
+	copy->names = (const char **)obstack_copy(&pbqp->obstack, v->names, sizeof(*copy->names) * len);
+#endif
 
 	return copy;
 }
@@ -63,9 +73,7 @@ void vector_add(vector_t *sum, vector_t *summand)
 
 	assert(len == summand->len);
 
-	for (unsigned i = 0; i < len; ++i) {
-		sum->entries[i].data = pbqp_add(sum->entries[i].data, summand->entries[i].data);
-	}
+	num_array_add(vector_data(sum), vector_data(summand), len);
 }
 
 void vector_set(vector_t *vec, unsigned index, num value)
@@ -78,17 +86,13 @@ void vector_set(vector_t *vec, unsigned index, num value)
 void vector_set_description(vector_t *vec, unsigned index, const char *name)
 {
 	assert(index < vec->len);
-	vec->entries[index].name = name;
+	vec->names[index] = name;
 }
 #endif
 
 void vector_add_value(vector_t *vec, num value)
 {
-	unsigned len = vec->len;
-
-	for (unsigned index = 0; index < len; ++index) {
-		vec->entries[index].data = pbqp_add(vec->entries[index].data, value);
-	}
+	num_array_add_value(vector_data(vec), value, vec->len);
 }
 
 void vector_add_matrix_col(vector_t *vec, pbqp_matrix_t *mat, unsigned col_index)
@@ -110,46 +114,19 @@ void vector_add_matrix_row(vector_t *vec, pbqp_matrix_t *mat, unsigned row_index
 	assert(len == mat->cols);
 	assert(row_index < mat->rows);
 
-
-	for (unsigned index = 0; index < len; ++index) {
-		vec->entries[index].data = pbqp_add(vec->entries[index].data, mat->entries[row_index * mat->cols + index]);
-	}
+	num_array_add(vector_data(vec), &mat->entries[row_index * mat->cols], len);
 }
 
 num vector_get_min(vector_t *vec)
 {
-	unsigned len = vec->len;
-	num      min = INF_COSTS;
-
-	assert(len > 0);
-
-	for (unsigned index = 0; index < len; ++index) {
-		num elem = vec->entries[index].data;
-
-		if (elem < min) {
-			min = elem;
-		}
-	}
+	assert(vec->len > 0);
 
-	return min;
+	return num_array_min(vector_data(vec), vec->len);
 }
 
 unsigned vector_get_min_index(vector_t *vec)
 {
-	unsigned len       = vec->len;
-	unsigned min_index = 0;
-	num      min       = INF_COSTS;
-
-	assert(len > 0);
-
-	for (unsigned index = 0; index < len; ++index) {
-		num elem = vec->entries[index].data;
-
-		if (elem < min) {
-			min = elem;
-			min_index = index;
-		}
-	}
+	assert(vec->len > 0);
 
-	return min_index;
+	return num_array_min_index(vector_data(vec), NULL, vec->len);
 }
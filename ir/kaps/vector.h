@@ -16,6 +16,12 @@
 
 num pbqp_add(num x, num y);
 
+/* Returns the costs of the given vector as a plain array. */
+static inline num *vector_data(vector_t *vec)
+{
+	return &vec->entries[0].data;
+}
+
 vector_t *vector_alloc(pbqp_t *pbqp, unsigned length);
 
 /* Copy the given vector. */
@@ -16,18 +16,20 @@
 
 typedef struct vec_elem_t vec_elem_t;
 
+/* Only contains the costs, so the entries of a vector can be processed by the
+ * num_array kernels. */
 struct vec_elem_t {
 	num data;
-#if KAPS_ENABLE_VECTOR_NAMES
-	const char *name;
-#endif
 };
 
 typedef struct vector_t vector_t;
 
 struct vector_t {
-	unsigned   len;
-	vec_elem_t entries[];
+	unsigned     len;
+#if KAPS_ENABLE_VECTOR_NAMES
+	const char **names;
+#endif
+	vec_elem_t   entries[];
 };
 
 #endif
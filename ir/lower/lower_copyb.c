@@ -17,6 +17,7 @@
 #include "irprog_t.h"
 #include "lowering.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "target_t.h"
 #include "type_t.h"
 #include "util.h"
@@ -177,6 +178,8 @@ static void find_copyb_nodes(ir_node *irn, void *ctx)
 void lower_CopyB(ir_graph *irg, unsigned max_small_sz, unsigned min_large_sz,
                  int allow_misaligns)
 {
+	pass_stats_begin(irg, "lower_CopyB");
+
 	assert(max_small_sz < min_large_sz && "CopyB size ranges must not overlap");
 
 	max_small_size      = max_small_sz;
@@ -196,4 +199,6 @@ void lower_CopyB(ir_graph *irg, unsigned max_small_sz, unsigned min_large_sz,
 	                                    : IR_GRAPH_PROPERTIES_ALL);
 
 	DEL_ARR_F(env.copybs);
+
+	pass_stats_end(irg);
 }
@@ -17,6 +17,7 @@
 #include "irnode_t.h"
 #include "irprog_t.h"
 #include "lowering.h"
+#include "pass_stats_t.h"
 #include "typerep.h"
 
 /**
@@ -151,10 +152,12 @@ static void lower_irnode(ir_node *irn, void *env)
 
 void lower_highlevel_graph(ir_graph *irg)
 {
+	pass_stats_begin(irg, "lower_highlevel_graph");
 	/* Finally: lower Offset/TypeConst-size and Sel nodes, unaligned Load/Stores. */
 	irg_walk_graph(irg, NULL, lower_irnode, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+	pass_stats_end(irg);
 }
 
 /*
@@ -162,13 +165,19 @@ void lower_highlevel_graph(ir_graph *irg)
  */
 void lower_const_code(void)
 {
+	pass_stats_begin(NULL, "lower_const_code");
 	walk_const_code(NULL, lower_irnode, NULL);
+	pass_stats_end(NULL);
 }
 
 void lower_highlevel()
 {
+	pass_stats_begin(NULL, "lower_highlevel");
+
 	foreach_irp_irg(i, irg) {
 		lower_highlevel_graph(irg);
 	}
 	lower_const_code();
+
+	pass_stats_end(NULL);
 }
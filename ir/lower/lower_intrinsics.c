@@ -21,6 +21,7 @@
 #include "irverify.h"
 #include "lowering.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "pmap.h"
 #include "target_t.h"
 #include "tv_t.h"
@@ -100,6 +101,8 @@ static void call_mapper(ir_node *node, void *data)
 
 void ir_lower_intrinsics(ir_graph *irg, ir_intrinsics_map *map)
 {
+	pass_stats_begin(irg, "ir_lower_intrinsics");
+
 	if (map->part_block_used) {
 		ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_PHI_LIST);
 		collect_phiprojs_and_start_block_nodes(irg);
@@ -111,6 +114,8 @@ void ir_lower_intrinsics(ir_graph *irg, ir_intrinsics_map *map)
 	if (map->n_intrinsics > 0) {
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
 	}
+
+	pass_stats_end(irg);
 }
 
 /**
@@ -15,6 +15,7 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "lowering.h"
+#include "pass_stats_t.h"
 #include "util.h"
 #include <assert.h>
 
@@ -82,6 +83,8 @@ static void lower_mux_node(ir_node* mux)
 
 void lower_mux(ir_graph *irg, lower_mux_callback *cb_func)
 {
+	pass_stats_begin(irg, "lower_mux");
+
 	/* Scan the graph for mux nodes to lower. */
 	walk_env_t env;
 	env.cb_func = cb_func;
@@ -106,4 +109,6 @@ void lower_mux(ir_graph *irg, lower_mux_callback *cb_func)
 		clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	}
 	DEL_ARR_F(env.muxes);
+
+	pass_stats_end(irg);
 }
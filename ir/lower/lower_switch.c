@@ -9,19 +9,26 @@
  * @author  Moritz Kroll
  */
 #include "array.h"
+#include "execfreq.h"
 #include "ircons.h"
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
-#include "irnodeset.h"
 #include "irouts_t.h"
 #include "lowering.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "util.h"
 #include <stdbool.h>
 
+/** Minimum percentage of the values of a jump table which must be cases. */
+#define MIN_JUMP_TABLE_DENSITY 40
+/** Maximum number of clusters tested one after another. */
+#define MAX_CHAIN_CLUSTERS 3
+/** Maximum number of distinct targets of a bit test cluster. */
+#define MAX_BIT_TEST_TARGETS 3
+
 typedef struct walk_env_t {
-	ir_nodeset_t  processed;
 	ir_mode      *selector_mode;
 	unsigned      spare_size; /**< the allowed spare size for table switches */
 	unsigned      small_switch;
@@ -29,11 +36,25 @@ typedef struct walk_env_t {
 } walk_env_t;
 
 typedef struct target_t {
-	ir_node *block;     /**< block that is targetted */
-	uint16_t n_entries; /**< number of table entries targetting this block */
-	uint16_t i;
+	ir_node  *block;     /**< block that is targetted */
+	ir_node **preds;     /**< new control flow predecessors of block */
+	unsigned  n_entries; /**< number of table entries targetting this block */
+	double    weight;    /**< estimated frequency of a single entry */
 } target_t;
 
+typedef enum cluster_kind_t {
+	CLUSTER_RANGE,      /**< a single entry tested by a compare */
+	CLUSTER_JUMP_TABLE, /**< a dense range of entries handled by a Switch */
+	CLUSTER_BIT_TEST,   /**< a narrow range of entries tested by bit masks */
+} cluster_kind_t;
+
+typedef struct cluster_t {
+	cluster_kind_t kind;
+	unsigned       first;  /**< index of the first table entry */
+	unsigned       last;   /**< index of the last table entry */
+	double         weight; /**< estimated frequency of the cluster */
+} cluster_t;
+
 typedef struct switch_info_t {
 	ir_node     *switchn;
 	ir_tarval   *switch_min;
@@ -42,6 +63,11 @@ typedef struct switch_info_t {
 	unsigned     num_cases;
 	target_t    *targets;
 	ir_node    **defusers;    /**< the Projs pointing to the default case */
+	ir_mode     *umode;       /**< unsigned variant of the selector mode */
+	ir_node     *uselector;   /**< the selector converted to umode */
+	ir_mode     *selector_mode; /**< mode of the selector of new Switches */
+	uint64_t    *offsets;     /**< entry minimums relative to switch_min */
+	uint64_t    *ends;        /**< entry maximums relative to switch_min */
 } switch_info_t;
 
 /**
@@ -91,6 +117,7 @@ static void analyse_switch1(switch_info_t *info)
 		assert((unsigned)pn < n_outs);
 		assert(targets[(unsigned)pn].block == NULL);
 		targets[(unsigned)pn].block = target;
+		targets[(unsigned)pn].preds = NEW_ARR_F(ir_node*, 0);
 	}
 
 	const ir_switch_table *table = get_Switch_table(switchn);
@@ -105,6 +132,14 @@ static void analyse_switch1(switch_info_t *info)
 		++target->n_entries;
 	}
 
+	/* the critical edges are split, so the target blocks are only reached
+	 * through the Switch */
+	for (unsigned pn = 0; pn < n_outs; ++pn) {
+		target_t *target = &targets[pn];
+		if (target->n_entries > 0)
+			target->weight = get_block_execfreq(target->block) / target->n_entries;
+	}
+
 	info->default_block = targets[pn_Switch_default].block;
 	info->targets       = targets;
 }
@@ -284,133 +319,462 @@ static ir_node *create_case_cond(const ir_switch_table_entry *entry,
 	if (entry->min == entry->max) {
 		cmp = new_rd_Cmp(dbgi, block, selector, minconst, ir_relation_equal);
 	} else {
+		/* compare unsigned, so values below min wrap around */
+		ir_mode   *umode        = find_unsigned_mode(get_irn_mode(selector));
 		ir_tarval *adjusted_max = tarval_sub(entry->max, entry->min);
 		ir_node   *sub          = new_rd_Sub(dbgi, block, selector, minconst);
-		ir_node   *maxconst     = new_r_Const(irg, adjusted_max);
-		cmp = new_rd_Cmp(dbgi, block, sub, maxconst, ir_relation_less_equal);
+		ir_node   *usub         = new_rd_Conv(dbgi, block, sub, umode);
+		ir_node   *maxconst     = new_r_Const(irg, tarval_convert_to(adjusted_max, umode));
+		cmp = new_rd_Cmp(dbgi, block, usub, maxconst, ir_relation_less_equal);
 	}
 	return new_rd_Cond(dbgi, block, cmp);
 }
 
-static void connect_to_target(target_t *target, ir_node *cf)
+/**
+ * Returns true if @p n_entries entries spanning @p span + 1 values should be
+ * handled by a jump table.
+ */
+static bool is_dense(const walk_env_t *env, uint64_t span, uint64_t n_entries)
+{
+	uint64_t spare = span - (n_entries - 1);
+	return spare < env->spare_size
+	    && n_entries * 100 >= (span + 1) * MIN_JUMP_TABLE_DENSITY;
+}
+
+static void connect_to_target(switch_info_t *info, unsigned pn, ir_node *cf)
+{
+	ARR_APP1(ir_node*, info->targets[pn].preds, cf);
+}
+
+static ir_switch_table_entry *get_entries(const switch_info_t *info)
+{
+	return get_Switch_table(info->switchn)->entries;
+}
+
+/**
+ * Computes the entry values relative to the smallest case value.  Returns
+ * false if the values are too far apart to be represented.
+ */
+static bool compute_offsets(switch_info_t *info)
+{
+	const ir_switch_table *table     = get_Switch_table(info->switchn);
+	size_t                 n_entries = ir_switch_table_get_n_entries(table);
+	ir_mode               *umode     = info->umode;
+	ir_tarval             *min       = tarval_convert_to(info->switch_min, umode);
+
+	info->offsets = XMALLOCN(uint64_t, n_entries);
+	info->ends    = XMALLOCN(uint64_t, n_entries);
+	for (size_t e = 0; e < n_entries; ++e) {
+		const ir_switch_table_entry *entry
+			= ir_switch_table_get_entry_const(table, e);
+		ir_tarval *offset = tarval_sub(tarval_convert_to(entry->min, umode), min);
+		ir_tarval *end    = tarval_sub(tarval_convert_to(entry->max, umode), min);
+		if (!tarval_is_long(offset) || !tarval_is_long(end))
+			return false;
+		info->offsets[e] = (uint64_t)get_tarval_long(offset);
+		info->ends[e]    = (uint64_t)get_tarval_long(end);
+	}
+	return true;
+}
+
+static double get_entry_weight(const switch_info_t *info, unsigned e)
+{
+	return info->targets[get_entries(info)[e].pn].weight;
+}
+
+static void append_cluster(cluster_t **clusters, cluster_kind_t kind,
+                           unsigned first, unsigned last,
+                           const switch_info_t *info)
+{
+	double weight = 0;
+	for (unsigned e = first; e <= last; ++e)
+		weight += get_entry_weight(info, e);
+
+	cluster_t cluster = {
+		.kind   = kind,
+		.first  = first,
+		.last   = last,
+		.weight = weight,
+	};
+	ARR_APP1(cluster_t, *clusters, cluster);
+}
+
+/**
+ * Partitions the entries into the minimal number of jump tables and single
+ * entries.  A range of entries may become a jump table if it has more than
+ * small_switch entries and less than spare_size holes.
+ */
+static unsigned *find_jump_tables(const switch_info_t *info,
+                                  const walk_env_t *env, unsigned n_entries)
 {
-	ir_node *block     = target->block;
-	unsigned n_entries = target->n_entries;
-	if (get_Block_n_cfgpreds(block) != (int)n_entries) {
-		ir_node **new_in = ALLOCAN(ir_node*, n_entries);
-		ir_graph *irg    = get_irn_irg(block);
-		ir_node  *dummy  = new_r_Dummy(irg, mode_X);
-		for (unsigned i = 0; i < n_entries; ++i) {
-			new_in[i] = dummy;
+	unsigned *n_parts = XMALLOCN(unsigned, n_entries + 1);
+	unsigned *last    = XMALLOCN(unsigned, n_entries);
+	n_parts[n_entries] = 0;
+	for (unsigned i = n_entries; i-- > 0;) {
+		n_parts[i] = n_parts[i + 1] + 1;
+		last[i]    = i;
+		for (unsigned j = i + env->small_switch; j < n_entries; ++j) {
+			/* the number of holes only grows with j */
+			uint64_t span = info->ends[j] - info->offsets[i];
+			if (span - (j - i) >= env->spare_size)
+				break;
+			if (is_dense(env, span, j - i + 1)
+			    && n_parts[j + 1] + 1 < n_parts[i]) {
+				n_parts[i] = n_parts[j + 1] + 1;
+				last[i]    = j;
+			}
 		}
-		set_irn_in(block, n_entries, new_in);
-		assert(target->i == 0);
 	}
-	assert(target->i < n_entries);
-	set_Block_cfgpred(target->block, target->i++, cf);
+	free(n_parts);
+	return last;
 }
 
 /**
- * Creates an if cascade realizing binary search.
+ * Returns true if testing the entries first..last with bit masks is cheaper
+ * than comparing them one by one.
  */
-static void create_if_cascade(switch_info_t *info, ir_node *block,
-                              ir_switch_table_entry *curcases,
-                              unsigned numcases)
+static bool is_bit_test_profitable(const switch_info_t *info, unsigned first,
+                                   unsigned last, unsigned n_targets)
 {
-	ir_graph      *irg      = get_irn_irg(block);
-	const ir_node *switchn  = info->switchn;
-	dbg_info      *dbgi     = get_irn_dbg_info(switchn);
-	ir_node       *selector = get_Switch_selector(switchn);
+	uint64_t n_values = 0;
+	for (unsigned e = first; e <= last; ++e)
+		n_values += info->ends[e] - info->offsets[e] + 1;
+	return (n_targets == 1 && n_values >= 3)
+	    || (n_targets == 2 && n_values >= 5)
+	    || (n_targets == 3 && n_values >= 6);
+}
 
-	if (numcases == 0) {
-		/* zero cases: "goto default;" */
-		ARR_APP1(ir_node*, info->defusers, new_r_Jmp(block));
-	} else if (numcases == 1) {
-		/*only one case: "if (sel == val) goto target else goto default;"*/
-		const ir_switch_table_entry *entry = &curcases[0];
-		ir_node *cond      = create_case_cond(entry, dbgi, block, selector);
-		ir_node *trueproj  = new_r_Proj(cond, mode_X, pn_Cond_true);
-		ir_node *falseproj = new_r_Proj(cond, mode_X, pn_Cond_false);
-
-		connect_to_target(&info->targets[entry->pn], trueproj);
-		ARR_APP1(ir_node*, info->defusers, falseproj);
-	} else if (numcases == 2) {
-		/* only two cases: "if (sel == val[0]) goto target[0];" */
-		const ir_switch_table_entry *entry0 = &curcases[0];
-		const ir_switch_table_entry *entry1 = &curcases[1];
-		ir_node *cond      = create_case_cond(entry0, dbgi, block, selector);
-		ir_node *trueproj  = new_r_Proj(cond, mode_X, pn_Cond_true);
-		ir_node *falseproj = new_r_Proj(cond, mode_X, pn_Cond_false);
-		connect_to_target(&info->targets[entry0->pn], trueproj);
-
-		ir_node *in[]    = { falseproj };
-		ir_node *neblock = new_r_Block(irg, ARRAY_SIZE(in), in);
-
-		/* second part: "else if (sel == val[1]) goto target[1] else goto default;" */
-		ir_node *cond1      = create_case_cond(entry1, dbgi, neblock, selector);
-		ir_node *trueproj1  = new_r_Proj(cond1, mode_X, pn_Cond_true);
-		ir_node *falseproj1 = new_r_Proj(cond1, mode_X, pn_Cond_false);
-		connect_to_target(&info->targets[entry1->pn], trueproj1);
-		ARR_APP1(ir_node*, info->defusers, falseproj1);
-	} else {
-		/* recursive case: split cases in the middle */
-		unsigned midcase = numcases / 2;
-		const ir_switch_table_entry *entry = &curcases[midcase];
-		ir_node *val = new_r_Const(irg, entry->min);
-		ir_node *cmp = new_rd_Cmp(dbgi, block, selector, val, ir_relation_less);
-		ir_node *cond = new_rd_Cond(dbgi, block, cmp);
+/**
+ * Combines consecutive single entries into bit test clusters.
+ */
+static void find_bit_tests(const switch_info_t *info, const walk_env_t *env,
+                           unsigned first, unsigned last, cluster_t **clusters)
+{
+	unsigned bits = MIN(get_mode_size_bits(env->selector_mode), 63u);
+	for (unsigned i = first; i <= last;) {
+		unsigned pns[MAX_BIT_TEST_TARGETS];
+		unsigned n_targets = 0;
+		unsigned end       = i;
+		for (unsigned j = i; j <= last; ++j) {
+			if (info->ends[j] - info->offsets[i] >= bits)
+				break;
+			unsigned pn = get_entries(info)[j].pn;
+			unsigned t  = 0;
+			while (t < n_targets && pns[t] != pn)
+				++t;
+			if (t == n_targets) {
+				if (n_targets == MAX_BIT_TEST_TARGETS)
+					break;
+				pns[n_targets++] = pn;
+			}
+			end = j;
+		}
 
-		ir_node *ltin[]  = { new_r_Proj(cond, mode_X, pn_Cond_true) };
-		ir_node *ltblock = new_r_Block(irg, ARRAY_SIZE(ltin), ltin);
+		if (end > i && is_bit_test_profitable(info, i, end, n_targets)) {
+			append_cluster(clusters, CLUSTER_BIT_TEST, i, end, info);
+			i = end + 1;
+		} else {
+			append_cluster(clusters, CLUSTER_RANGE, i, i, info);
+			++i;
+		}
+	}
+}
 
-		ir_node *gein[]  = { new_r_Proj(cond, mode_X, pn_Cond_false) };
-		ir_node *geblock = new_r_Block(irg, ARRAY_SIZE(gein), gein);
+static cluster_t *find_clusters(switch_info_t *info, const walk_env_t *env)
+{
+	unsigned   n_entries = ir_switch_table_get_n_entries(get_Switch_table(info->switchn));
+	cluster_t *clusters  = NEW_ARR_F(cluster_t, 0);
+	if (n_entries == 0)
+		return clusters;
+	if (!compute_offsets(info)) {
+		for (unsigned e = 0; e < n_entries; ++e)
+			append_cluster(&clusters, CLUSTER_RANGE, e, e, info);
+		return clusters;
+	}
 
-		create_if_cascade(info, ltblock, curcases, midcase);
-		create_if_cascade(info, geblock, curcases + midcase, numcases - midcase);
+	unsigned *last = find_jump_tables(info, env, n_entries);
+	unsigned  run  = 0;
+	for (unsigned i = 0; i < n_entries; i = last[i] + 1) {
+		if (last[i] == i)
+			continue;
+		if (run < i)
+			find_bit_tests(info, env, run, i - 1, &clusters);
+		append_cluster(&clusters, CLUSTER_JUMP_TABLE, i, last[i], info);
+		run = last[i] + 1;
 	}
+	if (run < n_entries)
+		find_bit_tests(info, env, run, n_entries - 1, &clusters);
+	free(last);
+	return clusters;
 }
 
 /**
- * Block-Walker: searches for Switch nodes
+ * Returns the selector relative to the entry @p e as unsigned value.
  */
-static void find_switch_nodes(ir_node *block, void *ctx)
+static ir_node *create_offset_selector(switch_info_t *info, ir_node *block,
+                                       unsigned e)
 {
-	walk_env_t *env = (walk_env_t*)ctx;
+	ir_tarval *min = tarval_convert_to(get_entries(info)[e].min, info->umode);
+	if (tarval_is_null(min))
+		return info->uselector;
 
-	/* because we split critical blocks only blocks with 1 predecessors may
-	 * contain Proj->Cond nodes */
-	if (get_Block_n_cfgpreds(block) != 1)
-		return;
+	ir_graph *irg  = get_irn_irg(block);
+	dbg_info *dbgi = get_irn_dbg_info(info->switchn);
+	return new_rd_Sub(dbgi, block, info->uselector, new_r_Const(irg, min));
+}
 
-	ir_node *projx = get_Block_cfgpred(block, 0);
-	if (!is_Proj(projx))
-		return;
-	assert(get_irn_mode(projx) == mode_X);
+/**
+ * Creates a check whether the selector lies in the range of @p cluster.
+ * Returns the block reached if it does, @p out_of_range is set to the
+ * control flow leaving otherwise.
+ */
+static ir_node *create_range_check(switch_info_t *info, ir_node *block,
+                                   const cluster_t *cluster, ir_node **offset,
+                                   ir_node **out_of_range)
+{
+	ir_graph  *irg   = get_irn_irg(block);
+	dbg_info  *dbgi  = get_irn_dbg_info(info->switchn);
+	uint64_t   span  = info->ends[cluster->last] - info->offsets[cluster->first];
+	ir_tarval *max   = new_tarval_from_long(span, info->umode);
+	*offset = create_offset_selector(info, block, cluster->first);
+	ir_node   *cmp   = new_rd_Cmp(dbgi, block, *offset, new_r_Const(irg, max),
+	                              ir_relation_less_equal);
+	ir_node   *cond  = new_rd_Cond(dbgi, block, cmp);
+	ir_node   *in[]  = { new_r_Proj(cond, mode_X, pn_Cond_true) };
+	*out_of_range = new_r_Proj(cond, mode_X, pn_Cond_false);
+	return new_r_Block(irg, ARRAY_SIZE(in), in);
+}
 
-	ir_node *switchn = get_Proj_pred(projx);
-	if (!is_Switch(switchn))
+/**
+ * Creates a Switch for the dense entries of @p cluster, which the backend
+ * turns into a jump table.  Returns the control flow taken if the selector
+ * is outside of the cluster.
+ */
+static ir_node *create_jump_table(switch_info_t *info, ir_node *block,
+                                  const cluster_t *cluster)
+{
+	ir_node *offset;
+	ir_node *out_of_range;
+	ir_node *in_range = create_range_check(info, block, cluster, &offset,
+	                                       &out_of_range);
+
+	ir_graph        *irg       = get_irn_irg(block);
+	dbg_info        *dbgi      = get_irn_dbg_info(info->switchn);
+	ir_mode         *mode      = info->selector_mode;
+	unsigned         n_outs    = get_Switch_n_outs(info->switchn);
+	unsigned        *new_pns   = XMALLOCNZ(unsigned, n_outs);
+	unsigned         n_entries = cluster->last - cluster->first + 1;
+	uint64_t         base      = info->offsets[cluster->first];
+	ir_switch_table *table     = ir_new_switch_table(irg, n_entries);
+	unsigned         n_new_outs = 1;
+	for (unsigned i = 0; i < n_entries; ++i) {
+		unsigned                     e     = cluster->first + i;
+		const ir_switch_table_entry *entry = &get_entries(info)[e];
+		if (new_pns[entry->pn] == 0)
+			new_pns[entry->pn] = n_new_outs++;
+		ir_tarval *min = new_tarval_from_long(info->offsets[e] - base, mode);
+		ir_tarval *max = new_tarval_from_long(info->ends[e] - base, mode);
+		ir_switch_table_set(table, i, min, max, new_pns[entry->pn]);
+	}
+
+	ir_node *selector = new_rd_Conv(dbgi, in_range, offset, mode);
+	ir_node *switchn  = new_rd_Switch(dbgi, in_range, selector, n_new_outs, table);
+	for (unsigned pn = 0; pn < n_outs; ++pn) {
+		if (new_pns[pn] != 0)
+			connect_to_target(info, pn, new_r_Proj(switchn, mode_X, new_pns[pn]));
+	}
+	ARR_APP1(ir_node*, info->defusers,
+	         new_r_Proj(switchn, mode_X, pn_Switch_default));
+	free(new_pns);
+	return out_of_range;
+}
+
+/**
+ * Tests the entries of @p cluster by checking whether the bit for the
+ * selector value is set in a mask of the values leading to each target.
+ * Returns the control flow taken if the selector is outside of the cluster.
+ */
+static ir_node *create_bit_test(switch_info_t *info, ir_node *block,
+                                const cluster_t *cluster)
+{
+	ir_node *offset;
+	ir_node *out_of_range;
+	block = create_range_check(info, block, cluster, &offset, &out_of_range);
+
+	/* collect the masks, the heavier targets are tested first */
+	unsigned pns[MAX_BIT_TEST_TARGETS];
+	uint64_t masks[MAX_BIT_TEST_TARGETS];
+	double   weights[MAX_BIT_TEST_TARGETS];
+	unsigned n_targets = 0;
+	uint64_t base      = info->offsets[cluster->first];
+	for (unsigned e = cluster->first; e <= cluster->last; ++e) {
+		unsigned pn = get_entries(info)[e].pn;
+		unsigned t  = 0;
+		while (t < n_targets && pns[t] != pn)
+			++t;
+		if (t == n_targets) {
+			pns[t]     = pn;
+			masks[t]   = 0;
+			weights[t] = 0;
+			++n_targets;
+		}
+		for (uint64_t v = info->offsets[e]; v <= info->ends[e]; ++v)
+			masks[t] |= (uint64_t)1 << (v - base);
+		weights[t] += get_entry_weight(info, e);
+	}
+	for (unsigned t = 1; t < n_targets; ++t) {
+		for (unsigned u = t; u > 0 && weights[u] > weights[u - 1]; --u) {
+			unsigned pn = pns[u];
+			uint64_t m  = masks[u];
+			double   w  = weights[u];
+			pns[u]     = pns[u - 1];
+			masks[u]   = masks[u - 1];
+			weights[u] = weights[u - 1];
+			pns[u - 1]     = pn;
+			masks[u - 1]   = m;
+			weights[u - 1] = w;
+		}
+	}
+
+	ir_graph *irg   = get_irn_irg(block);
+	dbg_info *dbgi  = get_irn_dbg_info(info->switchn);
+	ir_mode  *mode  = info->selector_mode;
+	ir_node  *one   = new_r_Const(irg, get_mode_one(mode));
+	ir_node  *shift = new_rd_Conv(dbgi, block, offset, mode);
+	ir_node  *bit   = new_rd_Shl(dbgi, block, one, shift);
+	ir_node  *zero  = new_r_Const(irg, get_mode_null(mode));
+	for (unsigned t = 0; t < n_targets; ++t) {
+		ir_node *mask  = new_r_Const(irg, new_tarval_from_long(masks[t], mode));
+		ir_node *and   = new_rd_And(dbgi, block, bit, mask);
+		ir_node *cmp   = new_rd_Cmp(dbgi, block, and, zero, ir_relation_less_greater);
+		ir_node *cond  = new_rd_Cond(dbgi, block, cmp);
+		ir_node *taken = new_r_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *other = new_r_Proj(cond, mode_X, pn_Cond_false);
+		connect_to_target(info, pns[t], taken);
+		if (t + 1 < n_targets) {
+			ir_node *in[] = { other };
+			block = new_r_Block(irg, ARRAY_SIZE(in), in);
+		} else {
+			ARR_APP1(ir_node*, info->defusers, other);
+		}
+	}
+	return out_of_range;
+}
+
+/**
+ * Creates the test for @p cluster.  Returns the control flow taken if the
+ * selector is outside of the cluster.
+ */
+static ir_node *create_cluster_test(switch_info_t *info, ir_node *block,
+                                    const cluster_t *cluster)
+{
+	switch (cluster->kind) {
+	case CLUSTER_RANGE: {
+		const ir_switch_table_entry *entry = &get_entries(info)[cluster->first];
+		dbg_info *dbgi     = get_irn_dbg_info(info->switchn);
+		ir_node  *selector = get_Switch_selector(info->switchn);
+		ir_node  *cond     = create_case_cond(entry, dbgi, block, selector);
+		connect_to_target(info, entry->pn, new_r_Proj(cond, mode_X, pn_Cond_true));
+		return new_r_Proj(cond, mode_X, pn_Cond_false);
+	}
+	case CLUSTER_JUMP_TABLE:
+		return create_jump_table(info, block, cluster);
+	case CLUSTER_BIT_TEST:
+		return create_bit_test(info, block, cluster);
+	}
+	panic("invalid switch cluster");
+}
+
+/**
+ * Tests a few clusters one after another, the most frequent first.
+ */
+static void create_cluster_chain(switch_info_t *info, ir_node *block,
+                                 cluster_t *clusters, unsigned n_clusters)
+{
+	const cluster_t *order[MAX_CHAIN_CLUSTERS];
+	for (unsigned c = 0; c < n_clusters; ++c) {
+		unsigned i = c;
+		for (; i > 0 && clusters[c].weight > order[i - 1]->weight; --i)
+			order[i] = order[i - 1];
+		order[i] = &clusters[c];
+	}
+
+	ir_graph *irg = get_irn_irg(block);
+	for (unsigned c = 0; c < n_clusters; ++c) {
+		ir_node *out = create_cluster_test(info, block, order[c]);
+		if (c + 1 < n_clusters) {
+			ir_node *in[] = { out };
+			block = new_r_Block(irg, ARRAY_SIZE(in), in);
+		} else {
+			ARR_APP1(ir_node*, info->defusers, out);
+		}
+	}
+}
+
+/**
+ * Creates a binary search tree over the clusters.  The clusters are split
+ * such that both halves are executed about equally often.
+ */
+static void create_search_tree(switch_info_t *info, ir_node *block,
+                               cluster_t *clusters, unsigned n_clusters)
+{
+	if (n_clusters == 0) {
+		ARR_APP1(ir_node*, info->defusers, new_r_Jmp(block));
 		return;
-	if (!ir_nodeset_insert(&env->processed, switchn))
+	}
+	if (n_clusters <= MAX_CHAIN_CLUSTERS) {
+		create_cluster_chain(info, block, clusters, n_clusters);
 		return;
+	}
+
+	double total = 0;
+	for (unsigned c = 0; c < n_clusters; ++c)
+		total += clusters[c].weight;
+
+	unsigned mid = n_clusters / 2;
+	if (total > 0) {
+		double left = clusters[0].weight;
+		mid = 1;
+		while (mid < n_clusters - 1 && left + clusters[mid].weight / 2 < total / 2) {
+			left += clusters[mid].weight;
+			++mid;
+		}
+	}
+
+	ir_graph *irg      = get_irn_irg(block);
+	dbg_info *dbgi     = get_irn_dbg_info(info->switchn);
+	ir_node  *selector = get_Switch_selector(info->switchn);
+	ir_tarval *min     = get_entries(info)[clusters[mid].first].min;
+	ir_node  *val      = new_r_Const(irg, min);
+	ir_node  *cmp      = new_rd_Cmp(dbgi, block, selector, val, ir_relation_less);
+	ir_node  *cond     = new_rd_Cond(dbgi, block, cmp);
+
+	ir_node *ltin[]  = { new_r_Proj(cond, mode_X, pn_Cond_true) };
+	ir_node *ltblock = new_r_Block(irg, ARRAY_SIZE(ltin), ltin);
+
+	ir_node *gein[]  = { new_r_Proj(cond, mode_X, pn_Cond_false) };
+	ir_node *geblock = new_r_Block(irg, ARRAY_SIZE(gein), gein);
+
+	create_search_tree(info, ltblock, clusters, mid);
+	create_search_tree(info, geblock, clusters + mid, n_clusters - mid);
+}
 
+static void lower_switch_node(walk_env_t *env, ir_node *switchn)
+{
 	switch_info_t info;
 	analyse_switch0(&info, switchn);
 
 	/*
 	 * Here we have: num_cases and [switch_min, switch_max] interval.
-	 * We do an if-cascade if there are too many spare numbers.
+	 * A single jump table is kept if the cases are dense enough.
 	 */
 	ir_mode   *selector_mode = get_irn_mode(get_Switch_selector(switchn));
-	ir_tarval *spare = tarval_sub(info.switch_max, info.switch_min);
+	ir_tarval *span  = tarval_sub(info.switch_max, info.switch_min);
 	ir_mode   *mode  = find_unsigned_mode(selector_mode);
-	spare = tarval_convert_to(spare, mode);
-	ir_tarval *num_cases_minus_one
-		= new_tarval_from_long(info.num_cases-1, mode);
-	spare = tarval_sub(spare, num_cases_minus_one);
-	ir_tarval *spare_size = new_tarval_from_long(env->spare_size, mode);
+	span = tarval_convert_to(span, mode);
 	bool lower_switch = info.num_cases <= env->small_switch
-		|| (tarval_cmp(spare, spare_size) & ir_relation_greater_equal);
+		|| !tarval_is_long(span)
+		|| !is_dense(env, get_tarval_long(span), info.num_cases);
 
 	if (!lower_switch) {
 		/* we won't decompose the switch. But we must add an out-of-bounds
@@ -422,23 +786,54 @@ static void find_switch_nodes(ir_node *block, void *ctx)
 	normalize_table(switchn, selector_mode, NULL);
 	analyse_switch1(&info);
 
-	/* Now create the if cascade */
-	env->changed  = true;
-	info.defusers = NEW_ARR_F(ir_node*, 0);
-	block         = get_nodes_block(switchn);
-	ir_switch_table *table = get_Switch_table(switchn);
-	create_if_cascade(&info, block, table->entries, table->n_entries);
-
-	/* Connect new default case users */
+	/* Partition the cases and create the search tree */
+	env->changed       = true;
+	info.defusers      = NEW_ARR_F(ir_node*, 0);
+	info.umode         = mode;
+	info.selector_mode = env->selector_mode;
+	info.offsets       = NULL;
+	info.ends          = NULL;
+	ir_node *block     = get_nodes_block(switchn);
+	ir_node *selector  = get_Switch_selector(switchn);
+	info.uselector     = mode == selector_mode ? selector
+	                   : new_r_Conv(block, selector, mode);
+
+	cluster_t *clusters = find_clusters(&info, env);
+	create_search_tree(&info, block, clusters, ARR_LEN(clusters));
+	DEL_ARR_F(clusters);
+
+	/* Connect new default case users and targets */
 	set_irn_in(info.default_block, ARR_LEN(info.defusers), info.defusers);
+	for (unsigned pn = 0, n_outs = get_Switch_n_outs(switchn); pn < n_outs; ++pn) {
+		target_t *target = &info.targets[pn];
+		if (target->block == NULL)
+			continue;
+		if (pn != pn_Switch_default)
+			set_irn_in(target->block, ARR_LEN(target->preds), target->preds);
+		DEL_ARR_F(target->preds);
+	}
 
 	DEL_ARR_F(info.defusers);
+	free(info.offsets);
+	free(info.ends);
 	free(info.targets);
 }
 
+/**
+ * Walker: collects Switch nodes.
+ */
+static void collect_switches(ir_node *node, void *ctx)
+{
+	ir_node ***switches = (ir_node***)ctx;
+	if (is_Switch(node))
+		ARR_APP1(ir_node*, *switches, node);
+}
+
 void lower_switch(ir_graph *irg, unsigned small_switch, unsigned spare_size,
                   ir_mode *selector_mode)
 {
+	pass_stats_begin(irg, "lower_switch");
+
 	if (mode_is_signed(selector_mode))
 		panic("expected unsigned mode for switch selector");
 
@@ -447,14 +842,23 @@ void lower_switch(ir_graph *irg, unsigned small_switch, unsigned spare_size,
 	env.spare_size          = spare_size;
 	env.small_switch        = small_switch;
 	env.changed             = false;
-	ir_nodeset_init(&env.processed);
 
-	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
-	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
-
-	irg_block_walk_graph(irg, find_switch_nodes, NULL, &env);
-	ir_nodeset_destroy(&env.processed);
+	ir_node **switches = NEW_ARR_F(ir_node*, 0);
+	irg_walk_graph(irg, NULL, collect_switches, &switches);
+	if (ARR_LEN(switches) > 0) {
+		/* the frequencies of the case blocks guide the search trees */
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES);
+		ir_estimate_execfreq(irg);
+		assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
+		                         | IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
+
+		for (size_t i = 0, n = ARR_LEN(switches); i < n; ++i)
+			lower_switch_node(&env, switches[i]);
+	}
+	DEL_ARR_F(switches);
 
 	confirm_irg_properties(irg, env.changed ? IR_GRAPH_PROPERTIES_NONE
 	                                        : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
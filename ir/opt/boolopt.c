@@ -16,6 +16,7 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "iroptimize.h"
+#include "pass_stats_t.h"
 #include "tv.h"
 #include <assert.h>
 
@@ -698,6 +699,8 @@ restart:
 
 void opt_bool(ir_graph *const irg)
 {
+	pass_stats_begin(irg, "opt_bool");
+
 	bool_opt_env_t env;
 
 	/* register a debug mask */
@@ -718,4 +721,6 @@ void opt_bool(ir_graph *const irg)
 
 	confirm_irg_properties(irg,
 		env.changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
@@ -19,6 +19,7 @@
 #include "irnode_t.h"
 #include "iroptimize.h"
 #include "irverify.h"
+#include "pass_stats_t.h"
 #include "util.h"
 #include "xmalloc.h"
 #include <assert.h>
@@ -542,6 +543,8 @@ again:;
 
 void optimize_cf(ir_graph *irg)
 {
+	pass_stats_begin(irg, "optimize_cf");
+
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_ONE_RETURN);
 	/* we have some hacky is_Id() checks here so exchange must not use Deleted
@@ -583,4 +586,6 @@ void optimize_cf(ir_graph *irg)
 	                     | IR_RESOURCE_IRN_LINK);
 	confirm_irg_properties(irg, global_changed ? IR_GRAPH_PROPERTIES_NONE
 	                                           : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
@@ -40,6 +40,7 @@
 #include "list.h"
 #include "obstack.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "pmap.h"
 #include "set.h"
 #include "tv_t.h"
@@ -3180,6 +3181,8 @@ static void add_memory_keeps(ir_graph *irg, ir_node **kept_memory, size_t len)
 
 void combo(ir_graph *irg)
 {
+	pass_stats_begin(irg, "combo");
+
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_BADS
 		| IR_GRAPH_PROPERTY_NO_TUPLES
@@ -3275,4 +3278,6 @@ void combo(ir_graph *irg)
 	set_value_of_func(NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+
+	pass_stats_end(irg);
 }
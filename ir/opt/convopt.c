@@ -30,6 +30,7 @@
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "pass_stats_t.h"
 #include "tv.h"
 #include "util.h"
 #include "vrp.h"
@@ -275,6 +276,8 @@ static void conv_opt_walker(ir_node *node, void *data)
 
 void conv_opt(ir_graph *irg)
 {
+	pass_stats_begin(irg, "conv_opt");
+
 	FIRM_DBG_REGISTER(dbg, "firm.opt.conv");
 
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
@@ -293,4 +296,6 @@ void conv_opt(ir_graph *irg)
 
 	confirm_irg_properties(irg,
 		global_changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
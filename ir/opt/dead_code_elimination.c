@@ -19,11 +19,13 @@
 #include "irgraph_t.h"
 #include "irgwalk.h"
 #include "irhooks.h"
+#include "irmemory_t.h"
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
 #include "irtools.h"
+#include "pass_stats_t.h"
 #include "pmap.h"
 #include "vrp.h"
 
@@ -74,6 +76,8 @@ static void copy_graph_env(ir_graph *irg)
  */
 void dead_node_elimination(ir_graph *irg)
 {
+	pass_stats_begin(irg, "dead_node_elimination");
+
 	edges_deactivate(irg);
 
 	/* Handle graph state */
@@ -81,6 +85,7 @@ void dead_node_elimination(ir_graph *irg)
 	free_irg_outs(irg);
 	free_loop_information(irg);
 	free_vrp_data(irg);
+	free_irg_points_to(irg);
 	clear_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 
 	/* A quiet place, where the old obstack can rest in peace,
@@ -101,4 +106,6 @@ void dead_node_elimination(ir_graph *irg)
 
 	/* Free memory from old unoptimized obstack */
 	obstack_free(&graveyard_obst, 0);  /* First empty the obstack ... */
+
+	pass_stats_end(irg);
 }
@@ -0,0 +1,249 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Speculative devirtualization.
+ *
+ * Uses the callee sets computed by cgana() to turn indirect calls with few
+ * possible targets into a chain of compares of the call address against the
+ * targets, each guarding a direct call:
+ *
+ *   r = ptr(args)  =>  if (ptr == f) r = f(args);
+ *                      else if (ptr == g) r = g(args);
+ *                      else r = ptr(args);
+ *
+ * If the callee set is complete, the last target is called directly without
+ * a compare and there is no indirect fallback call.  The direct calls can be
+ * inlined by inline_functions() afterwards.
+ */
+#include "array.h"
+#include "cgana.h"
+#include "debug.h"
+#include "ircons.h"
+#include "iredges_t.h"
+#include "irgmod.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "pass_stats_t.h"
+#include "statev_t.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef struct devirt_env_t {
+	unsigned   max_targets; /**< maximum number of known targets */
+	ir_node  **calls;       /**< calls that may be converted */
+} devirt_env_t;
+
+static bool is_open_callee_set(ir_node const *const call)
+{
+	/* cgana puts the unknown entity at position 0 */
+	return is_unknown_entity(cg_get_call_callee(call, 0));
+}
+
+static size_t get_n_known_callees(ir_node const *const call)
+{
+	return cg_get_call_n_callees(call) - is_open_callee_set(call);
+}
+
+static ir_entity *get_known_callee(ir_node const *const call, size_t const pos)
+{
+	return cg_get_call_callee(call, pos + is_open_callee_set(call));
+}
+
+/**
+ * Walker: Collects indirect calls with a small set of known callees.
+ */
+static void collect_calls(ir_node *const node, void *const data)
+{
+	devirt_env_t *const env = (devirt_env_t*)data;
+	if (!is_Call(node) || is_Address(get_Call_ptr(node)))
+		return;
+	/* exception control flow would need to be merged as well */
+	if (ir_throws_exception(node) || !cg_call_has_callees(node)
+	    || cg_get_call_n_callees(node) == 0)
+		return;
+
+	size_t const n_known = get_n_known_callees(node);
+	if (n_known == 0 || n_known > env->max_targets)
+		return;
+	ARR_APP1(ir_node*, env->calls, node);
+}
+
+/**
+ * Creates a copy of @p call in @p block calling @p ptr.
+ */
+static ir_node *copy_call(ir_node *const call, ir_node *const block,
+                          ir_node *const ptr, size_t const n_callees,
+                          ir_entity **const callees)
+{
+	dbg_info *const dbgi     = get_irn_dbg_info(call);
+	ir_node  *const mem      = get_Call_mem(call);
+	int       const n_params = get_Call_n_params(call);
+	ir_node **const params   = get_Call_param_arr(call);
+	ir_type  *const type     = get_Call_type(call);
+	ir_node  *const res      = new_rd_Call(dbgi, block, mem, ptr, n_params, params, type);
+	cg_set_call_callee_arr(res, n_callees, callees);
+	return res;
+}
+
+/**
+ * Turns @p call into a compare chain of its known callees.
+ */
+static void guard_call(ir_node *const call)
+{
+	ir_graph  *const irg      = get_irn_irg(call);
+	ir_node   *const ptr      = get_Call_ptr(call);
+	bool       const open     = is_open_callee_set(call);
+	size_t     const n_known  = get_n_known_callees(call);
+	size_t     const n_paths  = n_known + open;
+
+	if (n_paths == 1) {
+		/* only one possible callee, no guard necessary */
+		ir_entity *callee = get_known_callee(call, 0);
+		set_Call_ptr(call, new_r_Address(irg, callee));
+		cg_set_call_callee_arr(call, 1, &callee);
+		return;
+	}
+
+	/* collect the memory and result Projs */
+	ir_node  *proj_mem = NULL;
+	ir_node  *proj_res = NULL;
+	ir_node **results  = NEW_ARR_F(ir_node*, 0);
+	foreach_out_edge(call, edge) {
+		ir_node *const proj = get_edge_src_irn(edge);
+		if (!is_Proj(proj))
+			continue;
+		if (get_Proj_num(proj) == pn_Call_M) {
+			proj_mem = proj;
+		} else if (get_Proj_num(proj) == pn_Call_T_result) {
+			proj_res = proj;
+			foreach_out_edge(proj, res_edge) {
+				ir_node *const res = get_edge_src_irn(res_edge);
+				if (is_Proj(res))
+					ARR_APP1(ir_node*, results, res);
+			}
+		}
+	}
+	size_t const n_results = ARR_LEN(results);
+
+	ir_node  *const lower_block = part_block_edges(call);
+	ir_node        *block       = get_nodes_block(call);
+	ir_node **const jmps        = ALLOCAN(ir_node*, n_paths);
+	ir_node **const mems        = ALLOCAN(ir_node*, n_paths);
+	ir_node **const values      = ALLOCAN(ir_node*, n_paths * n_results);
+	for (size_t p = 0; p < n_paths; ++p) {
+		ir_node *callee_ptr;
+		ir_node *call_block;
+		ir_node *new_call;
+		if (p < n_known) {
+			ir_entity *callee  = get_known_callee(call, p);
+			ir_node   *address = new_r_Address(irg, callee);
+			callee_ptr = address;
+			if (p + 1 < n_paths) {
+				dbg_info *const dbgi       = get_irn_dbg_info(call);
+				ir_node  *const cmp        = new_rd_Cmp(dbgi, block, ptr, address, ir_relation_equal);
+				ir_node  *const cond       = new_rd_Cond(dbgi, block, cmp);
+				ir_node  *const proj_true  = new_r_Proj(cond, mode_X, pn_Cond_true);
+				ir_node  *const proj_false = new_r_Proj(cond, mode_X, pn_Cond_false);
+				call_block = new_r_Block(irg, 1, &proj_true);
+				block      = new_r_Block(irg, 1, &proj_false);
+			} else {
+				call_block = block;
+			}
+			new_call = copy_call(call, call_block, callee_ptr, 1, &callee);
+		} else {
+			/* fallback: the original indirect call */
+			call_block = block;
+			new_call   = copy_call(call, call_block, ptr,
+			                       cg_get_call_n_callees(call),
+			                       call->attr.call.callee_arr);
+		}
+
+		jmps[p] = new_r_Jmp(call_block);
+		mems[p] = new_r_Proj(new_call, mode_M, pn_Call_M);
+		ir_node *const new_res = new_r_Proj(new_call, mode_T, pn_Call_T_result);
+		for (size_t r = 0; r < n_results; ++r) {
+			ir_node *const res = results[r];
+			values[r * n_paths + p] = new_r_Proj(new_res, get_irn_mode(res), get_Proj_num(res));
+		}
+	}
+	set_irn_in(lower_block, n_paths, jmps);
+
+	if (proj_mem != NULL)
+		exchange(proj_mem, new_r_Phi(lower_block, n_paths, mems, mode_M));
+	for (size_t r = 0; r < n_results; ++r) {
+		ir_node *const res = results[r];
+		ir_node *const phi = new_r_Phi(lower_block, n_paths, &values[r * n_paths], get_irn_mode(res));
+		exchange(res, phi);
+	}
+	DEL_ARR_F(results);
+
+	if (proj_res != NULL)
+		kill_node(proj_res);
+	kill_node(call);
+}
+
+unsigned devirtualize_calls(unsigned max_targets, unsigned max_new_calls)
+{
+	pass_stats_begin(NULL, "devirtualize_calls");
+
+	FIRM_DBG_REGISTER(dbg, "firm.opt.devirtualize");
+
+	ir_entity **free_methods;
+	cgana(&free_methods);
+	free(free_methods);
+
+	unsigned n_converted = 0;
+	unsigned n_new_calls = 0;
+	foreach_irp_irg(i, irg) {
+		devirt_env_t env = {
+			.max_targets = max_targets,
+			.calls       = NEW_ARR_F(ir_node*, 0),
+		};
+		irg_walk_graph(irg, NULL, collect_calls, &env);
+
+		size_t const n_calls = ARR_LEN(env.calls);
+		if (n_calls > 0)
+			assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES);
+
+		bool changed = false;
+		for (size_t c = 0; c < n_calls; ++c) {
+			ir_node *const call  = env.calls[c];
+			size_t   const n_add = get_n_known_callees(call)
+			                     + is_open_callee_set(call) - 1;
+			if (n_new_calls + n_add > max_new_calls)
+				continue;
+			DB((dbg, LEVEL_1, "%+F: guarding %+F with %zu direct calls%s\n",
+			    irg, call, get_n_known_callees(call),
+			    is_open_callee_set(call) ? " and fallback" : ""));
+			n_new_calls += n_add;
+			++n_converted;
+			guard_call(call);
+			changed = true;
+		}
+		DEL_ARR_F(env.calls);
+
+		if (changed) {
+			confirm_irg_properties(irg,
+				IR_GRAPH_PROPERTY_NO_BADS
+				| IR_GRAPH_PROPERTY_NO_TUPLES
+				| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
+				| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
+		}
+	}
+
+	stat_ev_ull("devirt_converted_calls", n_converted);
+	stat_ev_ull("devirt_added_calls", n_new_calls);
+	DB((dbg, LEVEL_1, "converted %u call sites, added %u calls\n",
+	    n_converted, n_new_calls));
+
+	pass_stats_end(NULL);
+	return n_converted;
+}
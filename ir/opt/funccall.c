@@ -25,6 +25,7 @@
 #include "irtools.h"
 #include "opt_init.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "raw_bitset.h"
 #include "util.h"
 #include <stdbool.h>
@@ -805,6 +806,8 @@ static mtp_additional_properties check_nothrow_or_malloc(ir_graph *irg, bool top
 
 void optimize_funccalls(void)
 {
+	pass_stats_begin(NULL, "optimize_funccalls");
+
 	/* prepare: mark all graphs as not analyzed */
 	size_t last_idx = get_irp_last_idx();
 	ready_set = rbitset_malloc(last_idx);
@@ -836,6 +839,8 @@ void optimize_funccalls(void)
 
 	free(busy_set);
 	free(ready_set);
+
+	pass_stats_end(NULL);
 }
 
 void firm_init_funccalls(void)
@@ -15,6 +15,7 @@
 #include "iroptimize.h"
 #include "irprog_t.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "type_t.h"
 #include "typerep.h"
 
@@ -120,6 +121,8 @@ static void garbage_collect_in_segment(ir_type *segment)
 
 void garbage_collect_entities(void)
 {
+	pass_stats_begin(NULL, "garbage_collect_entities");
+
 	FIRM_DBG_REGISTER(dbg, "firm.opt.garbagecollect");
 
 	/* start a type walk for all externally visible entities */
@@ -153,4 +156,6 @@ void garbage_collect_entities(void)
 		garbage_collect_in_segment(type);
 	}
 	irp_free_resources(irp, IRP_RESOURCE_TYPE_VISITED);
+
+	pass_stats_end(NULL);
 }
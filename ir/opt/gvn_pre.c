@@ -27,6 +27,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irouts.h"
+#include "pass_stats_t.h"
 #include "tv_t.h"
 #include "valueset.h"
 
@@ -1785,6 +1786,8 @@ static void gvn_pre(ir_graph *irg, pre_env *env)
  */
 void do_gvn_pre(ir_graph *irg)
 {
+	pass_stats_begin(irg, "do_gvn_pre");
+
 	pre_env               env;
 	ir_nodeset_t          keeps;
 	optimization_state_t  state;
@@ -1878,4 +1881,6 @@ void do_gvn_pre(ir_graph *irg)
 	/* TODO assure nothing else breaks. */
 	set_opt_global_cse(0);
 	edges_activate(irg);
+
+	pass_stats_end(irg);
 }
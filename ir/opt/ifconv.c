@@ -17,6 +17,7 @@
 #include "irnode_t.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "pass_stats_t.h"
 #include "pdeq.h"
 #include "target_t.h"
 #include <assert.h>
@@ -432,6 +433,8 @@ static void fill_waitq(ir_node *node, void *env) {
 
 void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 {
+	pass_stats_begin(irg, "opt_if_conv_cb");
+
 	walker_env  env   = { .allow_ifconv = callback, .changed = false };
 	deq_t waitq;
 	deq_init(&waitq);
@@ -477,6 +480,8 @@ void opt_if_conv_cb(ir_graph *irg, arch_allow_ifconv_func callback)
 	confirm_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
 		| IR_GRAPH_PROPERTY_ONE_RETURN);
+
+	pass_stats_end(irg);
 }
 
 void opt_if_conv(ir_graph *irg)
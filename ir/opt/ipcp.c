@@ -0,0 +1,544 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Interprocedural constant propagation and function specialization.
+ *
+ * Parameter values are propagated along the call edges of the program with
+ * an optimistic lattice: Each parameter of a private method (a method whose
+ * callers are all known) starts out undefined and is lowered to the meet of
+ * the values its callers pass.  A value is either a constant, the address of
+ * an entity, a range of integers (taken from vrp) or unknown.  Arguments
+ * which are parameters of the caller themselves take the caller's lattice
+ * value, so constants are propagated through call chains.
+ *
+ * Afterwards parameters that are constant for all callers are replaced by the
+ * constant and comparisons of parameters with a known range are folded.
+ * Finally calls passing constants to a method which does not see these
+ * constants from all callers are redirected to a specialized copy of the
+ * method, if the estimated benefit is above a threshold and the growth budget
+ * allows it.
+ */
+#include "analyze_irg_args.h"
+#include "array.h"
+#include "debug.h"
+#include "irgmod.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irprog_t.h"
+#include "pass_stats_t.h"
+#include "pdeq.h"
+#include "tv.h"
+#include "util.h"
+#include "vrp.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+/** Lattice heights of a parameter value. */
+typedef enum value_kind_t {
+	VALUE_TOP,     /**< no value seen yet */
+	VALUE_ADDRESS, /**< the address of an entity */
+	VALUE_RANGE,   /**< a value in [lo, hi], a constant if lo == hi */
+	VALUE_BOTTOM,  /**< unknown value */
+} value_kind_t;
+
+typedef struct ipcp_value_t {
+	value_kind_t  kind;
+	ir_entity    *entity; /**< the entity for VALUE_ADDRESS */
+	ir_tarval    *lo;     /**< lower bound for VALUE_RANGE */
+	ir_tarval    *hi;     /**< upper bound for VALUE_RANGE */
+} ipcp_value_t;
+
+typedef struct irg_info_t {
+	ir_graph     *irg;
+	ir_node     **calls;       /**< calls of methods with a known graph */
+	ipcp_value_t *params;      /**< parameter values, NULL if not private */
+	size_t        n_params;
+	bool          in_worklist;
+} irg_info_t;
+
+/** A group of calls passing the same constants to the same method. */
+typedef struct specialization_t {
+	ir_entity    *callee;
+	ipcp_value_t *args;   /**< the constant arguments, VALUE_TOP otherwise */
+	ir_node     **calls;
+	float         weight;
+} specialization_t;
+
+static irg_info_t *infos;
+static size_t      n_infos;
+
+static irg_info_t *get_irg_info(ir_graph const *const irg)
+{
+	size_t const idx = get_irg_idx(irg);
+	return idx < n_infos ? &infos[idx] : NULL;
+}
+
+static ir_graph *get_call_callee_irg(ir_node const *const call)
+{
+	ir_entity *const callee = get_Call_callee(call);
+	return callee != NULL ? get_entity_linktime_irg(callee) : NULL;
+}
+
+static bool is_constant(ipcp_value_t const *const value)
+{
+	return value->kind == VALUE_ADDRESS
+	    || (value->kind == VALUE_RANGE && value->lo == value->hi);
+}
+
+static bool value_equal(ipcp_value_t const *const a, ipcp_value_t const *const b)
+{
+	return a->kind == b->kind && a->entity == b->entity && a->lo == b->lo
+	    && a->hi == b->hi;
+}
+
+static ipcp_value_t const bottom = { .kind = VALUE_BOTTOM };
+
+/**
+ * Lowers @p value to the meet of itself and @p other.
+ *
+ * @return true if @p value changed
+ */
+static bool meet(ipcp_value_t *const value, ipcp_value_t const *const other)
+{
+	ipcp_value_t res;
+	if (other->kind == VALUE_TOP || value->kind == VALUE_BOTTOM) {
+		return false;
+	} else if (value->kind == VALUE_TOP) {
+		res = *other;
+	} else if (value->kind != other->kind || other->kind == VALUE_BOTTOM) {
+		res = bottom;
+	} else if (value->kind == VALUE_ADDRESS) {
+		res = value->entity == other->entity ? *value : bottom;
+	} else {
+		ir_mode *const mode = get_tarval_mode(value->lo);
+		if (get_tarval_mode(other->lo) != mode) {
+			res = bottom;
+		} else if (!mode_is_int(mode)) {
+			res = value->lo == other->lo ? *value : bottom;
+		} else {
+			res = *value;
+			if (tarval_cmp(other->lo, res.lo) == ir_relation_less)
+				res.lo = other->lo;
+			if (tarval_cmp(other->hi, res.hi) == ir_relation_greater)
+				res.hi = other->hi;
+			if (res.lo == get_mode_min(mode) && res.hi == get_mode_max(mode))
+				res = bottom;
+		}
+	}
+	if (value_equal(value, &res))
+		return false;
+	*value = res;
+	return true;
+}
+
+/**
+ * Returns the lattice value of an argument passed by a call in @p irg.
+ */
+static ipcp_value_t get_arg_value(ir_graph *const irg, ir_node *arg)
+{
+	ipcp_value_t res = bottom;
+	arg = skip_Id(arg);
+	if (is_Const(arg)) {
+		res.kind = VALUE_RANGE;
+		res.lo   = get_Const_tarval(arg);
+		res.hi   = res.lo;
+	} else if (is_Address(arg)) {
+		res.kind   = VALUE_ADDRESS;
+		res.entity = get_Address_entity(arg);
+	} else if (is_Proj(arg) && get_Proj_pred(arg) == get_irg_args(irg)) {
+		irg_info_t *const info = get_irg_info(irg);
+		unsigned    const num  = get_Proj_num(arg);
+		if (info->params != NULL && num < info->n_params)
+			res = info->params[num];
+	} else if (mode_is_int(get_irn_mode(arg))) {
+		vrp_attr const *const vrp = vrp_get_info(arg);
+		if (vrp != NULL && vrp->range_type == VRP_RANGE) {
+			res.kind = VALUE_RANGE;
+			res.lo   = vrp->range_bottom;
+			res.hi   = vrp->range_top;
+		}
+	}
+	return res;
+}
+
+static void push_irg(deq_t *const worklist, ir_graph *const irg)
+{
+	irg_info_t *const info = get_irg_info(irg);
+	if (info->in_worklist)
+		return;
+	info->in_worklist = true;
+	deq_push_pointer_right(worklist, irg);
+}
+
+/**
+ * Meets the parameter values of all callees of @p irg with the arguments
+ * passed to them.
+ */
+static void propagate_calls(deq_t *const worklist, ir_graph *const irg)
+{
+	irg_info_t *const info = get_irg_info(irg);
+	for (size_t c = 0, n_calls = ARR_LEN(info->calls); c < n_calls; ++c) {
+		ir_node          *const call        = info->calls[c];
+		ir_graph         *const callee_irg  = get_call_callee_irg(call);
+		irg_info_t       *const callee_info = get_irg_info(callee_irg);
+		if (callee_info->params == NULL)
+			continue;
+
+		bool         changed  = false;
+		size_t const n_params = callee_info->n_params;
+		if ((size_t)get_Call_n_params(call) < n_params) {
+			/* mismatching call type, give up */
+			for (size_t i = 0; i < n_params; ++i)
+				changed |= meet(&callee_info->params[i], &bottom);
+		} else {
+			for (size_t i = 0; i < n_params; ++i) {
+				ipcp_value_t const value = get_arg_value(irg, get_Call_param(call, i));
+				changed |= meet(&callee_info->params[i], &value);
+			}
+		}
+		if (changed)
+			push_irg(worklist, callee_irg);
+	}
+}
+
+static void collect_calls(ir_node *const node, void *const env)
+{
+	irg_info_t *const info = (irg_info_t*)env;
+	if (is_Call(node) && get_call_callee_irg(node) != NULL)
+		ARR_APP1(ir_node*, info->calls, node);
+}
+
+/**
+ * A method is private if all its calls are known, i.e. it is not visible
+ * outside the program and its address is only used for direct calls.
+ */
+static bool is_private_method(ir_entity *const ent)
+{
+	return !entity_is_externally_visible(ent)
+	    && !(get_entity_linkage(ent) & IR_LINKAGE_HIDDEN_USER)
+	    && !(get_entity_usage(ent) & ir_usage_address_taken)
+	    && !is_method_variadic(get_entity_type(ent));
+}
+
+static ir_mode *get_value_mode(ipcp_value_t const *const value)
+{
+	return value->kind == VALUE_ADDRESS ? mode_P : get_tarval_mode(value->lo);
+}
+
+static ir_node *new_value_node(ir_graph *const irg,
+                               ipcp_value_t const *const value)
+{
+	if (value->kind == VALUE_ADDRESS)
+		return new_r_Address(irg, value->entity);
+	return new_r_Const(irg, value->lo);
+}
+
+/**
+ * Tries to evaluate the comparison of a value in [lo, hi] with a constant.
+ */
+static ir_tarval *fold_range_cmp(ipcp_value_t const *const value,
+                                 ir_relation const relation,
+                                 ir_tarval *const bound)
+{
+	ir_relation const rel_lo   = tarval_cmp(value->lo, bound);
+	ir_relation const rel_hi   = tarval_cmp(value->hi, bound);
+	ir_relation       possible = ir_relation_false;
+	if (rel_lo == ir_relation_less)
+		possible |= ir_relation_less;
+	if (rel_hi == ir_relation_greater)
+		possible |= ir_relation_greater;
+	if ((rel_lo & ir_relation_less_equal) && (rel_hi & ir_relation_greater_equal))
+		possible |= ir_relation_equal;
+
+	if ((possible & ~relation) == ir_relation_false)
+		return get_tarval_b_true();
+	if ((possible & relation) == ir_relation_false)
+		return get_tarval_b_false();
+	return NULL;
+}
+
+/**
+ * Folds comparisons of the parameter @p proj with a constant.
+ */
+static bool fold_cmps(ir_node *const proj, ipcp_value_t const *const value)
+{
+	bool changed = false;
+	foreach_irn_out_r(proj, i, user) {
+		if (!is_Cmp(user))
+			continue;
+		ir_node    *other    = get_Cmp_right(user);
+		ir_relation relation = get_Cmp_relation(user);
+		if (other == proj) {
+			other    = get_Cmp_left(user);
+			relation = get_inversed_relation(relation);
+		}
+		if (!is_Const(other))
+			continue;
+		ir_tarval *const tv = fold_range_cmp(value, relation, get_Const_tarval(other));
+		if (tv == NULL)
+			continue;
+		DB((dbg, LEVEL_2, "folded %+F to %T\n", user, tv));
+		exchange(user, new_r_Const(get_irn_irg(user), tv));
+		changed = true;
+	}
+	return changed;
+}
+
+/**
+ * Replaces the parameters with constant values in @p irg and folds
+ * comparisons of parameters with known ranges.
+ */
+static void apply_param_values(ir_graph *const irg,
+                               ipcp_value_t const *const values,
+                               size_t const n_values)
+{
+	assure_irg_outs(irg);
+	bool           changed = false;
+	ir_node *const args    = get_irg_args(irg);
+	foreach_irn_out_r(args, i, proj) {
+		unsigned const num = get_Proj_num(proj);
+		if (num >= n_values)
+			continue;
+		ipcp_value_t const *const value = &values[num];
+		if (value->kind == VALUE_TOP || value->kind == VALUE_BOTTOM
+		    || get_value_mode(value) != get_irn_mode(proj))
+			continue;
+		if (is_constant(value)) {
+			ir_node *const replacement = new_value_node(irg, value);
+			DB((dbg, LEVEL_2, "replaced %+F by %+F\n", proj, replacement));
+			exchange(proj, replacement);
+			changed = true;
+		} else if (mode_is_int(get_irn_mode(proj))) {
+			changed |= fold_cmps(proj, value);
+		}
+	}
+	if (changed)
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+}
+
+static void count_nodes(ir_node *const node, void *const env)
+{
+	(void)node;
+	++*(unsigned*)env;
+}
+
+static unsigned get_irg_n_nodes(ir_graph *const irg)
+{
+	unsigned n_nodes = 0;
+	irg_walk_graph(irg, NULL, count_nodes, &n_nodes);
+	return n_nodes;
+}
+
+static specialization_t *find_specialization(specialization_t *const specs,
+                                             ir_entity *const callee,
+                                             ipcp_value_t const *const args,
+                                             size_t const n_args)
+{
+	for (size_t s = 0, n = ARR_LEN(specs); s < n; ++s) {
+		specialization_t *const spec = &specs[s];
+		if (spec->callee != callee)
+			continue;
+		for (size_t i = 0; i < n_args; ++i) {
+			if (!value_equal(&spec->args[i], &args[i]))
+				goto next;
+		}
+		return spec;
+next:;
+	}
+	return NULL;
+}
+
+/**
+ * Collects the calls passing constants to methods which do not see these
+ * constants from all callers.
+ */
+static specialization_t *collect_specializations(struct obstack *const obst)
+{
+	specialization_t *specs  = NEW_ARR_F(specialization_t, 0);
+	ipcp_value_t     *args   = NULL;
+	size_t            n_args = 0;
+	for (size_t idx = 0; idx < n_infos; ++idx) {
+		irg_info_t *const info = &infos[idx];
+		ir_graph   *const irg  = info->irg;
+		if (irg == NULL)
+			continue;
+		for (size_t c = 0, n_calls = ARR_LEN(info->calls); c < n_calls; ++c) {
+			ir_node    *const call        = info->calls[c];
+			ir_entity  *const callee      = get_Call_callee(call);
+			irg_info_t *const callee_info = get_irg_info(get_call_callee_irg(call));
+			size_t      const n_params    = get_method_n_params(get_entity_type(callee));
+			if ((size_t)get_Call_n_params(call) < n_params)
+				continue;
+
+			/* the buffer is reused if no new specialization took it, but
+			 * the callee may have more parameters than the last one */
+			if (args == NULL || n_args < n_params) {
+				args   = OALLOCN(obst, ipcp_value_t, n_params);
+				n_args = n_params;
+			}
+			float weight = 0;
+			for (size_t i = 0; i < n_params; ++i) {
+				args[i] = get_arg_value(irg, get_Call_param(call, i));
+				if (!is_constant(&args[i])
+				    || (callee_info->params != NULL
+				        && is_constant(&callee_info->params[i]))) {
+					args[i] = (ipcp_value_t){ .kind = VALUE_TOP };
+					continue;
+				}
+				weight += (float)(get_method_param_weight(callee, i) + 1);
+			}
+			if (weight == 0)
+				continue;
+
+			specialization_t *spec = find_specialization(specs, callee, args, n_params);
+			if (spec == NULL) {
+				specialization_t const new_spec = {
+					.callee = callee,
+					.args   = args,
+					.calls  = NEW_ARR_F(ir_node*, 0),
+					.weight = 0,
+				};
+				ARR_APP1(specialization_t, specs, new_spec);
+				spec   = &specs[ARR_LEN(specs) - 1];
+				args   = NULL;
+				n_args = 0;
+			}
+			ARR_APP1(ir_node*, spec->calls, call);
+			/* we save the work on the constants in every call */
+			spec->weight += weight;
+		}
+	}
+	return specs;
+}
+
+static int cmp_specialization(void const *const p1, void const *const p2)
+{
+	specialization_t const *const s1 = (specialization_t const*)p1;
+	specialization_t const *const s2 = (specialization_t const*)p2;
+	return (s1->weight < s2->weight) - (s1->weight > s2->weight);
+}
+
+/**
+ * Creates a copy of the method called by @p spec with the constant
+ * arguments built in and redirects the calls to it.
+ */
+static void specialize(specialization_t const *const spec)
+{
+	ir_entity *const callee = spec->callee;
+	ir_graph  *const irg    = get_entity_linktime_irg(callee);
+	ident     *const name   = id_unique(get_entity_name(callee));
+	ir_entity *const clone  = clone_entity(callee, name, get_entity_owner(callee));
+	set_entity_visibility(clone, ir_visibility_local);
+
+	ir_graph *const clone_irg = create_irg_clone(irg, clone);
+	size_t    const n_params  = get_method_n_params(get_entity_type(callee));
+	apply_param_values(clone_irg, spec->args, n_params);
+
+	for (size_t i = 0, n = ARR_LEN(spec->calls); i < n; ++i) {
+		ir_node *const call = spec->calls[i];
+		set_Call_ptr(call, new_r_Address(get_irn_irg(call), clone));
+	}
+	DB((dbg, LEVEL_1, "specialized %+F as %+F for %zu calls (weight %f)\n",
+	    callee, clone, ARR_LEN(spec->calls), spec->weight));
+}
+
+void ipcp(float threshold, unsigned max_growth)
+{
+	pass_stats_begin(NULL, "ipcp");
+
+	FIRM_DBG_REGISTER(dbg, "firm.opt.ipcp");
+
+	assure_irp_globals_entity_usage_computed();
+
+	n_infos = get_irp_last_idx();
+	infos   = XMALLOCNZ(irg_info_t, n_infos);
+	deq_t worklist;
+	deq_init(&worklist);
+
+	/* initialize the lattice: parameters of methods with unknown callers are
+	 * bottom, all others top */
+	foreach_irp_irg(i, irg) {
+		irg_info_t *const info = get_irg_info(irg);
+		info->irg   = irg;
+		info->calls = NEW_ARR_F(ir_node*, 0);
+		irg_walk_graph(irg, NULL, collect_calls, info);
+		set_vrp_data(irg);
+
+		ir_entity *const ent = get_irg_entity(irg);
+		if (is_private_method(ent)) {
+			info->n_params = get_method_n_params(get_entity_type(ent));
+			info->params   = XMALLOCNZ(ipcp_value_t, info->n_params);
+		}
+		push_irg(&worklist, irg);
+	}
+
+	/* propagate until a fixpoint is reached */
+	while (!deq_empty(&worklist)) {
+		ir_graph   *const irg  = deq_pop_pointer_left(ir_graph, &worklist);
+		irg_info_t *const info = get_irg_info(irg);
+		info->in_worklist = false;
+		propagate_calls(&worklist, irg);
+	}
+	deq_free(&worklist);
+
+	/* replace parameters that are constant for all callers, specialized
+	 * copies created below inherit this */
+	for (size_t idx = 0; idx < n_infos; ++idx) {
+		irg_info_t *const info = &infos[idx];
+		if (info->params == NULL)
+			continue;
+#ifdef DEBUG_libfirm
+		for (size_t i = 0; i < info->n_params; ++i) {
+			ipcp_value_t const *const value = &info->params[i];
+			if (value->kind == VALUE_ADDRESS)
+				DB((dbg, LEVEL_1, "%+F: param %zu is %+F\n", info->irg, i, value->entity));
+			else if (value->kind == VALUE_RANGE)
+				DB((dbg, LEVEL_1, "%+F: param %zu in [%T, %T]\n", info->irg, i, value->lo, value->hi));
+		}
+#endif
+		apply_param_values(info->irg, info->params, info->n_params);
+	}
+
+	/* specialize methods for constant arguments not seen by all callers */
+	struct obstack obst;
+	obstack_init(&obst);
+	specialization_t *const specs = collect_specializations(&obst);
+	QSORT_ARR(specs, cmp_specialization);
+	unsigned growth = 0;
+	for (size_t s = 0, n = ARR_LEN(specs); s < n; ++s) {
+		specialization_t const *const spec = &specs[s];
+		if (spec->weight >= threshold) {
+			ir_graph *const irg     = get_entity_linktime_irg(spec->callee);
+			unsigned  const n_nodes = get_irg_n_nodes(irg);
+			if (growth + n_nodes <= max_growth) {
+				growth += n_nodes;
+				specialize(spec);
+			}
+		}
+		DEL_ARR_F(spec->calls);
+	}
+	DEL_ARR_F(specs);
+	obstack_free(&obst, NULL);
+
+	for (size_t idx = 0; idx < n_infos; ++idx) {
+		irg_info_t *const info = &infos[idx];
+		if (info->irg == NULL)
+			continue;
+		free_vrp_data(info->irg);
+		free(info->params);
+		DEL_ARR_F(info->calls);
+	}
+	free(infos);
+	infos   = NULL;
+	n_infos = 0;
+
+	pass_stats_end(NULL);
+}
@@ -22,6 +22,7 @@
 #include "iropt_t.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "pass_stats_t.h"
 #include "pdeq.h"
 #include <assert.h>
 
@@ -123,7 +124,9 @@ static void find_unreachable_blocks(ir_node *block, void *env)
 
 void local_optimize_graph(ir_graph *irg)
 {
+	pass_stats_begin(irg, "local_optimize_graph");
 	local_optimize_node(get_irg_end(irg));
+	pass_stats_end(irg);
 }
 
 /**
@@ -153,6 +156,8 @@ static void opt_walker(ir_node *n, deq_t *waitq)
 
 void optimize_graph_df(ir_graph *irg)
 {
+	pass_stats_begin(irg, "optimize_graph_df");
+
 	ir_graph_properties_t props = IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES;
 	if (get_opt_global_cse()) {
 		set_irg_pinned(irg, op_pin_state_floats);
@@ -217,6 +222,8 @@ void optimize_graph_df(ir_graph *irg)
 	 * Doing this AFTER edges where deactivated saves cycles */
 	ir_node *end = get_irg_end(irg);
 	remove_End_Bads_and_doublets(end);
+
+	pass_stats_end(irg);
 }
 
 void local_opts_const_code(void)
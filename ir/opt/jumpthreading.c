@@ -21,6 +21,7 @@
 #include "iroptimize.h"
 #include "iroptimize.h"
 #include "irtools.h"
+#include "pass_stats_t.h"
 #include "tv.h"
 #include "vrp.h"
 #include <assert.h>
@@ -635,6 +636,8 @@ static void thread_jumps(ir_node* block, void* data)
 
 void opt_jumpthreading(ir_graph* irg)
 {
+	pass_stats_begin(irg, "opt_jumpthreading");
+
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
@@ -663,4 +666,6 @@ void opt_jumpthreading(ir_graph* irg)
 	} else {
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
 	}
+
+	pass_stats_end(irg);
 }
@@ -29,6 +29,7 @@
 #include "iroptimize.h"
 #include "irtools.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "set.h"
 #include "target_t.h"
 #include "tv_t.h"
@@ -2290,11 +2291,15 @@ void combine_memops(ir_graph *irg)
 	if (!ir_target.fast_unaligned_memaccess)
 		return;
 
+	pass_stats_begin(irg, "combine_memops");
 	irg_walk_graph(irg, combine_memop, NULL, NULL);
+	pass_stats_end(irg);
 }
 
 void optimize_load_store(ir_graph *irg)
 {
+	pass_stats_begin(irg, "optimize_load_store");
+
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 	                         | IR_GRAPH_PROPERTY_NO_CRITICAL_EDGES
@@ -2343,4 +2348,6 @@ void optimize_load_store(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_NO_BADS | IR_GRAPH_PROPERTY_NO_TUPLES
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
 		| IR_GRAPH_PROPERTY_MANY_RETURNS);
+
+	pass_stats_end(irg);
 }
@@ -12,6 +12,7 @@
 
 #include "array.h"
 #include "debug.h"
+#include "execfreq.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
 #include "irdom.h"
@@ -22,11 +23,14 @@
 #include "irloop_t.h"
 #include "irnode_t.h"
 #include "irnodemap.h"
+#include "irnodeset.h"
 #include "iroptimize.h"
 #include "irouts.h"
 #include "irtools.h"
 #include "opt_init.h"
 #include "panic.h"
+#include "pass_stats_t.h"
+#include "statev_t.h"
 #include "util.h"
 #include <math.h>
 #include <stdbool.h>
@@ -89,6 +93,9 @@ typedef struct loop_stats_t {
 	unsigned u_simple_counting_loop;
 	unsigned constant_unroll;
 	unsigned invariant_unroll;
+	unsigned full_unroll;
+	unsigned cold;
+	unsigned pressure_limit;
 
 	unsigned unhandled;
 } loop_stats_t;
@@ -114,6 +121,9 @@ static void print_stats(void)
 	DB((dbg, LEVEL_2, "u_simple_counting :   %d\n", stats.u_simple_counting_loop));
 	DB((dbg, LEVEL_2, "constant_unroll   :   %d\n", stats.constant_unroll));
 	DB((dbg, LEVEL_2, "invariant_unroll  :   %d\n", stats.invariant_unroll));
+	DB((dbg, LEVEL_2, "full_unroll       :   %d\n", stats.full_unroll));
+	DB((dbg, LEVEL_2, "cold              :   %d\n", stats.cold));
+	DB((dbg, LEVEL_2, "pressure_limit    :   %d\n", stats.pressure_limit));
 	DB((dbg, LEVEL_2, "=======================================\n"));
 }
 
@@ -131,6 +141,11 @@ typedef struct loop_opt_params_t {
 	bool     allow_const_unrolling;
 	bool     allow_invar_unrolling;
 	unsigned invar_unrolling_min_size;  /* [nodes] */
+	unsigned max_unroll_factor;         /* Unroll factor of hot loops [number] */
+	unsigned max_full_unroll;           /* Trip count unrolled completely [number] */
+	unsigned max_register_pressure;     /* Live values of all copies [number] */
+	double   min_unroll_freq;           /* Colder loops stay rolled [execfreq] */
+	double   hot_loop_freq;             /* Hot loops are unrolled more [execfreq] */
 } loop_opt_params_t;
 
 static loop_opt_params_t opt_params;
@@ -149,9 +164,14 @@ typedef struct loop_info_t {
 
 	/* for unrolling */
 	unsigned max_unroll;       /* Number of unrolls satisfying max_loop_size */
+	unsigned max_size_unroll;  /* Number of unrolls satisfying only the size limit */
 	unsigned exit_cond;        /* 1 if condition==true exits the loop.  */
 	unsigned latest_value:1;   /* 1 if condition is checked against latest counter value */
 	unsigned decreasing:1;     /* Step operation is_Sub, or step is<0 */
+	unsigned inclusive:1;      /* Loop continues if the iv equals end_val */
+	unsigned full_unroll:1;    /* The loop is unrolled completely */
+	unsigned pressure;         /* Estimated values live in one iteration */
+	double   freq;             /* Execution frequency of the loop head */
 
 	/* IV informations of a simple loop */
 	ir_node *start_val;
@@ -1245,6 +1265,12 @@ static void correct_phis(ir_node *const node, void *const env)
 		ir_node  *const in[]  = { get_Phi_pred(node, 0) };
 		ir_mode  *const mode  = get_irn_mode(node);
 		ir_node  *const exch  = new_rd_Phi(dbgi, block, ARRAY_SIZE(in), in, mode);
+		/* The new Phi may be the node itself, found by CSE. */
+		if (exch == node)
+			return;
+		/* A copy of a memory Phi is not in a loop anymore. */
+		if (get_Phi_loop(node))
+			remove_End_keepalive(get_irg_end(get_irn_irg(node)), node);
 		exchange(node, exch);
 	}
 }
@@ -1333,15 +1359,22 @@ static void place_copies(int const copies)
 		ir_node *const head_pred      = get_Block_cfgpred(loop_head, be_src_pos);
 		ir_node *const loop_condition = get_unroll_copy(head_pred, unroll_nr - 1);
 
-		set_irn_n(loop_head, loop_info.be_src_pos, loop_condition);
+		ir_graph *const irg            = get_irn_irg(loop_head);
+
+		/* Completely unrolled loops never take the backedge. */
+		if (loop_info.full_unroll)
+			set_irn_n(loop_head, be_src_pos, new_r_Bad(irg, mode_X));
+		else
+			set_irn_n(loop_head, be_src_pos, loop_condition);
 
 		for_each_phi(loop_head, phi) {
 			ir_node *const pred = get_Phi_pred(phi, be_src_pos);
 
 			/* It is possible, that the value used
 			 * in the OWN backedge path is NOT assigned in this loop. */
-			ir_node *const last_pred = is_in_loop(pred) ?
-				get_unroll_copy(pred, copies) : pred;
+			ir_node *const last_pred = loop_info.full_unroll
+				? new_r_Bad(irg, get_irn_mode(phi))
+				: is_in_loop(pred) ? get_unroll_copy(pred, copies) : pred;
 			set_irn_n(phi, be_src_pos, last_pred);
 		}
 	} else {
@@ -1409,28 +1442,16 @@ static ir_node *clone_block_sans_bes(ir_graph *const irg, ir_node *const node, i
 	return new_r_Block(irg, c, ins);
 }
 
-/* Creates a structure to calculate absolute value of node op.
- * Returns mux node with absolute value. */
-static ir_node *new_Abs(ir_node *const op, ir_mode *const mode)
-{
-	ir_node  *const block    = get_nodes_block(op);
-	ir_graph *const irg      = get_irn_irg(op);
-	ir_node  *const zero     = new_r_Const_null(irg, mode);
-	ir_node  *const cmp      = new_r_Cmp(block, op, zero, ir_relation_less);
-	ir_node  *const minus_op = new_r_Minus(block, op);
-	ir_node  *const mux      = new_r_Mux(block, cmp, op, minus_op);
-	return mux;
-}
-
-
 /* Creates blocks for duffs device, using previously obtained
  * informations about the iv.
- * TODO split */
+ * The preheader computes the number of iterations of the tail-controlled
+ * loop and a Switch enters the unrolled loop at the copy, which leaves the
+ * remaining iterations a multiple of unroll_nr.
+ * Requires a step of 1 or -1 and a power of two as unroll_nr. */
 static void create_duffs_block(ir_graph *const irg)
 {
-	/* TODO naming
-	 * 1. Calculate first approach to count.
-	 *    Condition: (end - start) % step == 0 */
+	/* 1. Preheader
+	 *    Takes over the entry edges of the loop head. */
 	ir_node *const block1 = clone_block_sans_bes(irg, loop_head, loop_head);
 	DB((dbg, LEVEL_4, "Duff block 1 %N\n", block1));
 
@@ -1445,97 +1466,64 @@ static void create_duffs_block(ir_graph *const irg)
 		DB((dbg, LEVEL_4, "BLOCK1 %N phi %N\n", block1, new_phi));
 	}
 
-	ir_mode *const mode = get_irn_mode(loop_info.end_val);
-	ir_node *const ems  = new_r_Sub(block1, loop_info.end_val, loop_info.start_val);
-	DB((dbg, LEVEL_4, "BLOCK1 sub %N\n", ems));
-
-	DB((dbg, LEVEL_4, "mod ins %N %N\n", ems, loop_info.step));
-	ir_node *const nomem   = get_irg_no_mem(irg);
-	ir_node *const ems_mod = new_r_Mod(block1, nomem, ems, loop_info.step, true);
-	ir_node *const mod_res = new_r_Proj(ems_mod, mode_Iu, pn_Mod_res);
-
-	ir_node *const ems_div = new_r_Div(block1, nomem, ems, loop_info.step, true);
-	ir_node *const div_res = new_r_Proj(ems_div, mode, pn_Div_res);
-
-	DB((dbg, LEVEL_4, "New modulus node %N\n", ems_mod));
-
-	ir_node *const null          = new_r_Const_null(irg, mode);
-	ir_node *const cmp_null      = new_r_Cmp(block1, mod_res, null, ir_relation_less);
-	ir_node *const ems_mode_cond = new_r_Cond(block1, cmp_null);
-
-	/* ems % step == 0 */
-	ir_node *const x_true  = new_r_Proj(ems_mode_cond, mode_X, pn_Cond_true);
-	/* ems % step != 0 */
-	ir_node *const x_false = new_r_Proj(ems_mode_cond, mode_X, pn_Cond_false);
+	/* All values are computed in the mode of the iv.  The number of
+	 * iterations may not be representable in it, but it is only needed
+	 * modulo unroll_nr, which divides the modulus of the mode. */
+	ir_mode *const mode  = get_irn_mode(loop_info.end_val);
+	ir_node *const start = loop_info.start_val;
+	ir_node *const end   = loop_info.end_val;
+
+	/* The loop is run more than once, if its first condition holds.  This
+	 * compares start, or start + step for the latest value, with end. */
+	ir_node *first = start;
+	if (loop_info.latest_value) {
+		ir_node *const step = loop_info.step;
+		first = is_Sub(loop_info.add) ? new_r_Sub(block1, start, step)
+		                              : new_r_Add(block1, start, step);
+	}
+	ir_relation relation = loop_info.decreasing ? ir_relation_greater : ir_relation_less;
+	if (loop_info.inclusive)
+		relation |= ir_relation_equal;
+	ir_node *const cmp_more  = new_r_Cmp(block1, first, end, relation);
+	ir_node *const more_cond = new_r_Cond(block1, cmp_more);
+	ir_node *const x_more    = new_r_Proj(more_cond, mode_X, pn_Cond_true);
+	ir_node *const x_once    = new_r_Proj(more_cond, mode_X, pn_Cond_false);
 
 	/* 2. Second block.
-	 * Assures, duffs device receives a valid count.
-	 * Condition:
-	 *     decreasing: count < 0
-	 *     increasing: count > 0
-	 */
-	ir_node *const count_block_ins[] = { x_true, x_false };
+	 *    count % unroll_nr, if the loop is executed more than once.
+	 *    The iv covers |end - start| with steps of 1 and the loop is left
+	 *    after the iteration, in which the compared value reaches end (or
+	 *    passes it for inclusive conditions).  So the body is executed
+	 *    |end - start| + inclusive - latest_value + 1 times. */
+	ir_node *const count_block_ins[] = { x_more };
 	ir_node *const count_block       = new_r_Block(irg, ARRAY_SIZE(count_block_ins), count_block_ins);
 	DB((dbg, LEVEL_4, "Duff block 2 %N\n", count_block));
 
-
-	/* Increase loop-taken-count depending on the loop condition
-	 * uses the latest iv to compare to. */
-	ir_node       *true_val;
-	ir_node       *false_val;
-	ir_node *const one = new_r_Const_one(irg, mode);
-	if (loop_info.latest_value == 1) {
-		/* ems % step == 0 :  +0 */
-		true_val  = null;
-		/* ems % step != 0 :  +1 */
-		false_val = one;
-	} else {
-		/* ems % step == 0 :  +1 */
-		true_val  = one;
-		/* ems % step != 0 :  +2 */
-		false_val = new_r_Const_long(irg, mode, 2);
-	}
-
-	ir_node *const correction_ins[] = { true_val, false_val };
-	ir_node *const correction       = new_r_Phi(count_block, ARRAY_SIZE(correction_ins), correction_ins, mode);
-
-	/* (end - start) / step  +  correction */
-	ir_node *const count = new_r_Add(count_block ,div_res, correction);
-
-	/* We preconditioned the loop to be tail-controlled.
-	 * So, if count is something 'wrong' like 0,
-	 * negative/positive (depending on step direction),
-	 * we may take the loop once (tail-contr.) and leave it
-	 * to the existing condition, to break; */
-
-	/* Depending on step direction, we have to check for > or < 0 */
-	ir_relation const rel           = loop_info.decreasing == 1 ? ir_relation_less : ir_relation_greater;
-	ir_node    *const cmp_bad_count = new_r_Cmp(count_block, count, null, rel);
-	ir_node    *const bad_count_neg = new_r_Cond(count_block, cmp_bad_count);
-	ir_node    *const good_count    = new_r_Proj(bad_count_neg, mode_X, pn_Cond_true);
-	ir_node    *const bad_count     = new_r_Proj(ems_mode_cond, mode_X, pn_Cond_false);
+	ir_node *const dist = loop_info.decreasing ? new_r_Sub(count_block, start, end)
+	                                           : new_r_Sub(count_block, end, start);
+	long     const adjust   = (long)loop_info.inclusive - (long)loop_info.latest_value + 1;
+	ir_node *const count    = new_r_Add(count_block, dist, new_r_Const_long(irg, mode, adjust));
+	ir_node *const mask     = new_r_Const_long(irg, mode, (long)unroll_nr - 1);
+	ir_node *const count_nr = new_r_And(count_block, count, mask);
+	ir_node *const jmp      = new_r_Jmp(count_block);
+	DB((dbg, LEVEL_4, "Duff count %N\n", count_nr));
 
 	/* 3. Duff Block
-	 *    Contains module to decide which loop to start from. */
-
-	ir_node *const duff_block_ins[] = { good_count, bad_count };
+	 *    Contains the switch deciding which copy to start from. */
+	ir_node *const duff_block_ins[] = { jmp, x_once };
 	ir_node *const duff_block       = new_r_Block(irg, ARRAY_SIZE(duff_block_ins), duff_block_ins);
 	DB((dbg, LEVEL_4, "Duff block 3 %N\n", duff_block));
 
-	/* Get absolute value */
-	ir_node *const abs = new_Abs(count, mode);
-	/* Manually feed the aforementioned count = 1 (bad case)*/
-	ir_node *const count_phi_ins[] = { abs, one };
-	ir_node *const count_phi       = new_r_Phi(duff_block, ARRAY_SIZE(count_phi_ins), count_phi_ins, mode);
-
-	/* count % unroll_nr */
-	ir_node *const unroll_c = new_r_Const_long(irg, mode, (long)unroll_nr);
-	ir_node *const duff_mod = new_r_Mod(duff_block, nomem, count_phi, unroll_c, true);
-	ir_node *const proj     = new_r_Proj(duff_mod, mode, pn_Mod_res);
-	/* condition does NOT create itself in the block of the proj! */
-	ir_node *const cond     = new_r_Cond(duff_block, proj);
+	ir_node *const sel_phi_ins[] = { count_nr, new_r_Const_one(irg, mode) };
+	ir_node *const sel_phi       = new_r_Phi(duff_block, ARRAY_SIZE(sel_phi_ins), sel_phi_ins, mode);
 
-	loop_info.duff_cond = cond;
+	/* Remainder r enters with Proj r, 0 is the default. */
+	ir_switch_table *const table = ir_new_switch_table(irg, unroll_nr - 1);
+	for (int r = 1; r < unroll_nr; ++r) {
+		ir_tarval *const tv = new_tarval_from_long(r, mode);
+		ir_switch_table_set(table, r - 1, tv, tv, r);
+	}
+	loop_info.duff_cond = new_r_Switch(duff_block, sel_phi, unroll_nr, table);
 }
 
 /* Returns 1 if given node is not in loop,
@@ -1746,6 +1734,51 @@ static unsigned simulate_next(ir_tarval **const count_tar, ir_tarval *const step
 		return 0;
 }
 
+/* Counts the loop invariant values used in cur_loop. */
+static void count_invariant_uses(ir_node *const node, void *const env)
+{
+	ir_nodeset_t *const invariants = (ir_nodeset_t*)env;
+	if (is_Block(node) || !is_in_loop(node))
+		return;
+
+	foreach_irn_in(node, i, pred) {
+		if (!is_in_loop(pred) && !is_const(pred)
+		    && mode_is_data(get_irn_mode(pred)))
+			ir_nodeset_insert(invariants, pred);
+	}
+}
+
+/* Estimates the register pressure of one iteration by the number of values
+ * carried from one iteration to the next and the loop invariant values. */
+static unsigned estimate_register_pressure(ir_graph *const irg)
+{
+	unsigned pressure = 0;
+	for_each_phi(loop_head, phi) {
+		if (mode_is_data(get_irn_mode(phi)))
+			++pressure;
+	}
+
+	ir_nodeset_t invariants;
+	ir_nodeset_init(&invariants);
+	irg_walk_graph(irg, count_invariant_uses, NULL, &invariants);
+	pressure += ir_nodeset_size(&invariants);
+	ir_nodeset_destroy(&invariants);
+	return pressure;
+}
+
+/* Returns the maximum unroll factor regarding the hotness and the register
+ * pressure of the loop.  The scheduler interleaves the copies, so their
+ * values are assumed to be live at the same time. */
+static unsigned get_max_unroll_factor(void)
+{
+	unsigned factor = opt_params.max_unroll_factor;
+	if (loop_info.freq < opt_params.hot_loop_freq)
+		factor /= 2;
+	if (loop_info.pressure > 0)
+		factor = MIN(factor, opt_params.max_register_pressure / loop_info.pressure);
+	return MAX(factor, 1);
+}
+
 /* Check if loop meets requirements for a 'simple loop':
  * - Exactly one cf out
  * - Allowed calls
@@ -1763,11 +1796,12 @@ static ir_node *is_simple_loop(void)
 	DB((dbg, LEVEL_4, "1 loop exit\n"));
 
 	/* Calculate maximum unroll_nr keeping node count below limit. */
-	loop_info.max_unroll = (int)((double)opt_params.max_unrolled_loop_size / (double)loop_info.nodes);
-	if (loop_info.max_unroll < 2) {
+	loop_info.max_size_unroll = (int)((double)opt_params.max_unrolled_loop_size / (double)loop_info.nodes);
+	if (loop_info.max_size_unroll < 2) {
 		++stats.too_large;
 		return NULL;
 	}
+	loop_info.max_unroll = MIN(loop_info.max_size_unroll, get_max_unroll_factor());
 
 	DB((dbg, LEVEL_4, "maximum unroll factor %u, to not exceed node limit \n", opt_params.max_unrolled_loop_size));
 
@@ -1837,10 +1871,14 @@ static unsigned get_unroll_decision_invariant(ir_graph *const irg)
 	if (!loop_condition)
 		return 0;
 
-	/* Use a minimal size for the invariant unrolled loop,
+	/* Use a minimal size and frequency for the invariant unrolled loop,
 	 * as duffs device produces overhead */
 	if (loop_info.nodes < opt_params.invar_unrolling_min_size)
 		return 0;
+	if (loop_info.freq < opt_params.hot_loop_freq) {
+		DB((dbg, LEVEL_4, "loop not hot enough for duffs device\n"));
+		return 0;
+	}
 
 	ir_node *iteration_path;
 	unsigned const success = get_invariant_pred(loop_condition, &loop_info.end_val, &iteration_path);
@@ -1853,6 +1891,9 @@ static unsigned get_unroll_decision_invariant(ir_graph *const irg)
 	/* We may find the add or the phi first.
 	 * Until now we only have end_val. */
 	if (is_Add(iteration_path) || is_Sub(iteration_path)) {
+		/* We test against the latest value of the iv. */
+		loop_info.latest_value = 1;
+
 		loop_info.add = iteration_path;
 		DB((dbg, LEVEL_4, "Case 1: Got add %N (maybe not sane)\n", loop_info.add));
 
@@ -1875,6 +1916,9 @@ static unsigned get_unroll_decision_invariant(ir_graph *const irg)
 		DB((dbg, LEVEL_4, "Got start A  %N\n", loop_info.start_val));
 
 	} else if (is_Phi(iteration_path)) {
+		/* We compare with the value the iv had entering this run. */
+		loop_info.latest_value = 0;
+
 		loop_info.iteration_phi = iteration_path;
 		DB((dbg, LEVEL_4, "Case 2: Got phi %N\n", loop_info.iteration_phi));
 
@@ -1901,6 +1945,10 @@ static unsigned get_unroll_decision_invariant(ir_graph *const irg)
 	DB((dbg, LEVEL_4, "start %N, end %N, step %N\n",
 	    loop_info.start_val, loop_info.end_val, loop_info.step));
 
+	/* The trip count is computed in the preheader. */
+	if (is_in_loop(loop_info.start_val) || is_in_loop(loop_info.end_val))
+		return 0;
+
 	ir_mode *const mode = get_irn_mode(loop_info.end_val);
 	if (mode != mode_Is && mode != mode_Iu)
 		return 0;
@@ -1911,17 +1959,50 @@ static unsigned get_unroll_decision_invariant(ir_graph *const irg)
 
 	DB((dbg, LEVEL_4, "mode integer\n"));
 
-	ir_tarval *const step_tar = get_Const_tarval(loop_info.step);
-	if (tarval_is_null(step_tar)) {
-		/* TODO Might be worth a warning. */
+	/* Steps of 1 reach end_val exactly, so the iv cannot wrap around. */
+	ir_tarval *step_tar = get_Const_tarval(loop_info.step);
+	if (is_Sub(loop_info.add))
+		step_tar = tarval_neg(step_tar);
+	if (tarval_is_one(step_tar)) {
+		loop_info.decreasing = 0;
+	} else if (tarval_is_all_one(step_tar)) {
+		loop_info.decreasing = 1;
+	} else {
 		return 0;
 	}
 
-	DB((dbg, LEVEL_4, "step is not 0\n"));
+	DB((dbg, LEVEL_4, "step is 1 or -1\n"));
 
+	/* Normalize the relation to: stay in loop if iv relation end_val. */
+	ir_relation relation = get_Cmp_relation(loop_condition);
+	if (get_Cmp_left(loop_condition) == loop_info.end_val)
+		relation = get_inversed_relation(relation);
+	if (loop_info.exit_cond == 1)
+		relation = get_negated_relation(relation);
+	relation &= ~ir_relation_unordered;
+
+	ir_relation const exclusive = loop_info.decreasing ? ir_relation_greater : ir_relation_less;
+	if (relation == exclusive) {
+		loop_info.inclusive = 0;
+	} else if (relation == (exclusive | ir_relation_equal)) {
+		loop_info.inclusive = 1;
+	} else {
+		return 0;
+	}
+
+	DB((dbg, LEVEL_4, "normalized projection %s\n", get_relation_string(relation)));
+
+	/* duffs device selects the entry copy by masking the count */
+	unsigned factor = 1;
+	while (factor * 2 <= loop_info.max_unroll)
+		factor *= 2;
+	if (factor < 2)
+		return 0;
+
+	unroll_nr = factor;
 	create_duffs_block(irg);
 
-	return loop_info.max_unroll;
+	return factor;
 }
 
 /* Returns unroll factor,
@@ -1945,7 +2026,7 @@ static unsigned get_preferred_factor_constant(ir_tarval *const count_tar)
 	 */
 	/* loop passes % {6, 5, 4, 3, 2} == 0  */
 	ir_mode *const mode = get_irn_mode(loop_info.end_val);
-	for (unsigned prefer = MIN(loop_info.max_unroll, 6); prefer != 1; --prefer) {
+	for (unsigned prefer = loop_info.max_unroll; prefer > 1; --prefer) {
 		ir_tarval *const prefer_tv = new_tarval_from_long(prefer, mode);
 		if (tarval_is_null(tarval_mod(count_tar, prefer_tv))) {
 			DB((dbg, LEVEL_4, "preferred unroll factor %d\n", prefer));
@@ -2143,6 +2224,18 @@ static unsigned get_unroll_decision_constant(void)
 		return 0;
 	}
 
+	/* Unroll small loops completely, removing the loop overhead and
+	 * making the iv constant in every copy. */
+	if (tarval_is_long(count_tar)) {
+		long const count = get_tarval_long(count_tar);
+		if (count > 1 && (unsigned long)count <= opt_params.max_full_unroll
+		    && (unsigned long)count <= loop_info.max_size_unroll) {
+			DB((dbg, LEVEL_2, "unrolling completely\n"));
+			loop_info.full_unroll = 1;
+			return count;
+		}
+	}
+
 	return get_preferred_factor_constant(count_tar);
 }
 
@@ -2167,6 +2260,20 @@ static void unroll_loop(ir_graph *const irg)
 		return;
 	}
 
+	/* Unrolling cold loops only increases the code size. */
+	loop_info.freq = get_block_execfreq(loop_head);
+	if (loop_info.freq < opt_params.min_unroll_freq) {
+		DB((dbg, LEVEL_2, "Frequency %f < minimal frequency %f\n",
+			loop_info.freq, opt_params.min_unroll_freq));
+		++stats.cold;
+		return;
+	}
+
+	loop_info.pressure = estimate_register_pressure(irg);
+	if (loop_info.pressure > 0
+	    && opt_params.max_register_pressure / loop_info.pressure < opt_params.max_unroll_factor)
+		++stats.pressure_limit;
+
 	unroll_nr = 0;
 
 	/* get_unroll_decision_constant and invariant are completely
@@ -2187,6 +2294,17 @@ static void unroll_loop(ir_graph *const irg)
 	}
 
 	DB((dbg, LEVEL_2, " *** Unrolling %d times ***\n", unroll_nr));
+	DB((dbg, LEVEL_1, "unroll decision: nodes %u, frequency %f, pressure %u, max factor %u, factor %d%s\n",
+		loop_info.nodes, loop_info.freq, loop_info.pressure,
+		loop_info.max_unroll, unroll_nr,
+		loop_info.full_unroll ? " (complete)" : ""));
+	stat_ev_ctx_push_fmt("loop_unroll", "%ld", get_loop_loop_nr(cur_loop));
+	stat_ev_int("loop_unroll_nodes", loop_info.nodes);
+	stat_ev_dbl("loop_unroll_freq", loop_info.freq);
+	stat_ev_int("loop_unroll_pressure", loop_info.pressure);
+	stat_ev_int("loop_unroll_factor", unroll_nr > 1 ? unroll_nr : 1);
+	stat_ev_int("loop_unroll_complete", loop_info.full_unroll);
+	stat_ev_ctx_pop("loop_unroll");
 
 	if (unroll_nr > 1) {
 		loop_entries = NEW_ARR_F(entry_edge, 0);
@@ -2210,7 +2328,9 @@ static void unroll_loop(ir_graph *const irg)
 		 * leads to complex special cases. */
 		irg_walk_graph(irg, correct_phis, NULL, NULL);
 
-		if (loop_info.unroll_kind == constant)
+		if (loop_info.full_unroll)
+			++stats.full_unroll;
+		else if (loop_info.unroll_kind == constant)
 			++stats.constant_unroll;
 		else
 			++stats.invariant_unroll;
@@ -2286,10 +2406,15 @@ static void set_loop_params(void)
 	opt_params.allowed_calls            =    0;
 	opt_params.max_cc_size              =    5;
 	opt_params.allow_const_unrolling    = true;
-	opt_params.allow_invar_unrolling    = false;
-	opt_params.invar_unrolling_min_size =   20;
+	opt_params.allow_invar_unrolling    = true;
+	opt_params.invar_unrolling_min_size =    8;
 	opt_params.max_unrolled_loop_size   =  400;
 	opt_params.max_branches             = 9999;
+	opt_params.max_unroll_factor        =    8;
+	opt_params.max_full_unroll          =   16;
+	opt_params.max_register_pressure    =   24;
+	opt_params.min_unroll_freq          =  2.0;
+	opt_params.hot_loop_freq            =  4.0;
 }
 
 /**
@@ -2303,6 +2428,10 @@ static void set_loop_params(void)
  */
 static void loop_optimization(ir_graph *const irg, loop_op_t const loop_op)
 {
+	/* Unrolling decisions depend on the hotness of the loops. */
+	if (loop_op == loop_op_unrolling)
+		ir_estimate_execfreq(irg);
+
 	/* Assure preconditions are met and go through all loops. */
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
@@ -2358,17 +2487,23 @@ static void loop_optimization(ir_graph *const irg, loop_op_t const loop_op)
 
 void do_loop_unrolling(ir_graph *const irg)
 {
+	pass_stats_begin(irg, "do_loop_unrolling");
 	loop_optimization(irg, loop_op_unrolling);
+	pass_stats_end(irg);
 }
 
 void do_loop_inversion(ir_graph *const irg)
 {
+	pass_stats_begin(irg, "do_loop_inversion");
 	loop_optimization(irg, loop_op_inversion);
+	pass_stats_end(irg);
 }
 
 void do_loop_peeling(ir_graph *const irg)
 {
+	pass_stats_begin(irg, "do_loop_peeling");
 	loop_optimization(irg, loop_op_peeling);
+	pass_stats_end(irg);
 }
 
 void firm_init_loop_opt(void)
@@ -0,0 +1,801 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Loop idiom recognition.
+ *
+ * Replaces counted loops which fill or copy an array element by element and
+ * loops which search for the terminating zero of a string by calls to
+ * memset, memcpy and strlen:
+ *
+ *   for (i = s; i < n; ++i) a[i] = 0;     =>  memset(&a[s], 0, ...);
+ *   for (i = s; i < n; ++i) a[i] = b[i];  =>  memcpy(&a[s], &b[s], ...);
+ *   while (*p != 0) ++p;                  =>  p += strlen(p);
+ *
+ * Copies of a constant size become CopyB nodes, which are lowered by
+ * lower_CopyB() depending on their size.
+ *
+ * Only loops in while form are handled: a header block evaluating the loop
+ * condition and a single body block jumping back to the header.  The loop
+ * may not contain memory operations besides the recognized Load and Store.
+ */
+#include "array.h"
+#include "bitfiddle.h"
+#include "debug.h"
+#include "ircons.h"
+#include "irgmod.h"
+#include "irgopt.h"
+#include "induction.h"
+#include "irgraph_t.h"
+#include "irloop_t.h"
+#include "irmemory.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irtools.h"
+#include "panic.h"
+#include "pass_stats_t.h"
+#include "statev_t.h"
+#include "tv.h"
+#include "util.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef enum idiom_kind_t {
+	IDIOM_MEMSET,
+	IDIOM_MEMCPY,
+	IDIOM_STRLEN,
+} idiom_kind_t;
+
+typedef struct idiom_t {
+	idiom_kind_t   kind;
+	ir_node       *header;    /**< the block evaluating the loop condition */
+	ir_node       *body;      /**< the single block of the loop body */
+	int            entry_pos; /**< position of the entry edge of the header */
+	ir_node       *cond;      /**< the Cond ending the header */
+	ir_node       *phi_mem;   /**< the memory Phi of the header */
+	ir_node       *load;      /**< the Load copied from or searched */
+	ir_node       *store;     /**< the Store filling or copying */
+	ir_node       *iv;        /**< the induction variable compared */
+	ir_node       *bound;     /**< the loop invariant bound of iv */
+	bool           guarded;   /**< the loop may execute zero times */
+	unsigned       elem_size; /**< bytes accessed per iteration */
+	ir_node      **exit_phis; /**< Phis of the header used after the loop */
+} idiom_t;
+
+static bool is_loop_block(idiom_t const *const idiom, ir_node const *const block)
+{
+	return block == idiom->header || block == idiom->body;
+}
+
+static bool is_in_loop(idiom_t const *const idiom, ir_node const *const node)
+{
+	return is_loop_block(idiom, get_nodes_block(node));
+}
+
+static int get_back_pos(idiom_t const *const idiom)
+{
+	return 1 - idiom->entry_pos;
+}
+
+static bool in_idiom_loop(void const *const env, ir_node const *const block)
+{
+	return is_loop_block((idiom_t const*)env, block);
+}
+
+/**
+ * Describes the loop of @p idiom for the induction variable analysis.
+ */
+static iv_loop_t get_iv_loop(idiom_t const *const idiom)
+{
+	return (iv_loop_t){
+		.header  = idiom->header,
+		.in_loop = in_idiom_loop,
+		.env     = idiom,
+	};
+}
+
+/**
+ * Returns the object an address into it is based on.
+ */
+static ir_node const *get_base_address(idiom_t const *const idiom,
+                                       ir_node const *node)
+{
+	for (;;) {
+		if (is_Phi(node) && get_nodes_block(node) == idiom->header) {
+			node = get_Phi_pred(node, idiom->entry_pos);
+		} else if (is_Add(node)) {
+			ir_node *const l = get_Add_left(node);
+			node = mode_is_reference(get_irn_mode(l)) ? l : get_Add_right(node);
+		} else if (is_Sub(node) && mode_is_reference(get_irn_mode(node))) {
+			node = get_Sub_left(node);
+		} else if (is_Member(node)) {
+			node = get_Member_ptr(node);
+		} else if (is_Sel(node)) {
+			node = get_Sel_ptr(node);
+		} else {
+			return node;
+		}
+	}
+}
+
+/**
+ * Returns true if all users of @p node are @p user.
+ */
+static bool is_only_used_by(ir_node const *const node, ir_node const *const user)
+{
+	foreach_irn_out_r(node, i, succ) {
+		if (succ != user)
+			return false;
+	}
+	return true;
+}
+
+static ir_node *get_load_proj(ir_node const *const load, unsigned const pn)
+{
+	foreach_irn_out_r(load, i, proj) {
+		if (get_Proj_num(proj) == pn)
+			return proj;
+	}
+	return NULL;
+}
+
+/**
+ * Checks that @p node is a plain memory access in the loop body which steps
+ * over consecutive elements.
+ */
+static bool is_consecutive_access(idiom_t const *const idiom,
+                                  ir_node const *const node,
+                                  ir_node const *const ptr,
+                                  ir_mode const *const mode,
+                                  ir_volatility const volatility)
+{
+	if (volatility != volatility_non_volatile || ir_throws_exception(node))
+		return false;
+	unsigned const bits = get_mode_size_bits(mode);
+	if (bits == 0 || bits % 8 != 0)
+		return false;
+	iv_loop_t const iv_loop = get_iv_loop(idiom);
+	long            step;
+	return get_affine_step(&iv_loop, ptr, &step) && step == (long)(bits / 8);
+}
+
+/**
+ * Inspects the nodes of @p block and records the memory operations.
+ */
+static bool scan_block(idiom_t *const idiom, ir_node *const block)
+{
+	foreach_irn_out_r(block, i, node) {
+		if (get_nodes_block(node) != block)
+			continue;
+
+		ir_mode *const mode = get_irn_mode(node);
+		switch (get_irn_opcode(node)) {
+		case iro_Phi:
+			if (mode == mode_M) {
+				if (idiom->phi_mem != NULL)
+					return false;
+				idiom->phi_mem = node;
+			}
+			break;
+		case iro_Load:
+			if (idiom->load != NULL)
+				return false;
+			idiom->load = node;
+			break;
+		case iro_Store:
+			if (idiom->store != NULL)
+				return false;
+			idiom->store = node;
+			break;
+		case iro_Proj:
+		case iro_Jmp:
+			break;
+		case iro_Cond:
+			if (node != idiom->cond)
+				return false;
+			break;
+		default:
+			if (mode == mode_M || mode == mode_T || mode == mode_X)
+				return false;
+			foreach_irn_in(node, n, pred) {
+				if (get_irn_mode(pred) == mode_M)
+					return false;
+			}
+			break;
+		}
+
+		if (mode == mode_X)
+			continue;
+		/* check for values used after the loop */
+		foreach_irn_out_r(node, n, user) {
+			if (is_End(user) || is_in_loop(idiom, user))
+				continue;
+			if (mode == mode_M && (node == idiom->phi_mem || is_Proj(node)))
+				continue;
+			if (!is_Phi(node) || get_nodes_block(node) != idiom->header)
+				return false;
+			ARR_APP1(ir_node*, idiom->exit_phis, node);
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Finds the header and body of a loop in while form.
+ */
+static bool find_loop_blocks(idiom_t *const idiom, ir_loop const *const loop)
+{
+	if (get_loop_n_elements(loop) != 2)
+		return false;
+	ir_node *blocks[2];
+	for (size_t i = 0; i < 2; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind != k_ir_node)
+			return false;
+		blocks[i] = element.node;
+	}
+
+	for (size_t h = 0; h < 2; ++h) {
+		ir_node *const header = blocks[h];
+		ir_node *const body   = blocks[1 - h];
+		if (get_Block_n_cfgpreds(header) != 2 || get_Block_n_cfgpreds(body) != 1)
+			continue;
+		ir_node *const body_pred = get_Block_cfgpred(body, 0);
+		if (!is_Proj(body_pred))
+			continue;
+		ir_node *const cond = get_Proj_pred(body_pred);
+		if (!is_Cond(cond) || get_nodes_block(cond) != header
+		    || get_irn_n_outs(cond) != 2)
+			continue;
+		for (int e = 0; e < 2; ++e) {
+			ir_node *const entry = get_Block_cfgpred(header, e);
+			ir_node *const back  = get_Block_cfgpred(header, 1 - e);
+			if (!is_Jmp(back) || get_nodes_block(back) != body || is_Bad(entry))
+				continue;
+			idiom->header    = header;
+			idiom->body      = body;
+			idiom->entry_pos = e;
+			idiom->cond      = cond;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Returns the relation under which the loop continues.
+ */
+static ir_relation get_continue_relation(idiom_t const *const idiom)
+{
+	ir_node    *const body_pred = get_Block_cfgpred(idiom->body, 0);
+	ir_relation const relation  = get_Cmp_relation(get_Cond_selector(idiom->cond));
+	return get_Proj_num(body_pred) == pn_Cond_true
+	     ? relation : get_negated_relation(relation);
+}
+
+/**
+ * Finds the induction variable and bound of a counted loop.
+ */
+static bool analyze_trip_count(idiom_t *const idiom)
+{
+	ir_node *const cmp = get_Cond_selector(idiom->cond);
+	if (!is_Cmp(cmp))
+		return false;
+	ir_relation relation = get_continue_relation(idiom);
+	ir_node    *iv       = get_Cmp_left(cmp);
+	ir_node    *bound    = get_Cmp_right(cmp);
+	if (!is_Phi(iv) || get_nodes_block(iv) != idiom->header) {
+		ir_node *const t = iv;
+		iv       = bound;
+		bound    = t;
+		relation = get_inversed_relation(relation);
+	}
+	if (!is_Phi(iv) || get_nodes_block(iv) != idiom->header
+	    || is_in_loop(idiom, bound))
+		return false;
+
+	iv_loop_t const iv_loop = get_iv_loop(idiom);
+	ir_mode  *const mode    = get_irn_mode(iv);
+	long            step;
+	if (!get_iv_step(&iv_loop, iv, &step) || step <= 0 || !is_po2_or_zero(step))
+		return false;
+	if (mode_is_int(mode)) {
+		/* larger steps may wrap around before reaching the bound */
+		if (step != 1)
+			return false;
+	} else if (!mode_is_reference(mode)) {
+		return false;
+	}
+
+	if (relation == ir_relation_less_equal && is_Const(bound)
+	    && mode_is_int(mode)) {
+		/* local optimizations turn i < c into i <= c - 1 */
+		ir_tarval *const tv = get_Const_tarval(bound);
+		if (tv == get_mode_max(mode))
+			return false;
+		bound    = new_r_Const(get_irn_irg(bound), tarval_add(tv, get_mode_one(mode)));
+		relation = ir_relation_less;
+	}
+
+	if (relation == ir_relation_less) {
+		idiom->guarded = true;
+	} else if (relation == ir_relation_less_greater) {
+		idiom->guarded = false;
+	} else {
+		return false;
+	}
+	idiom->iv    = iv;
+	idiom->bound = bound;
+	return true;
+}
+
+/**
+ * Checks whether the stored value can be expressed as a memset byte.
+ */
+static bool is_memset_value(idiom_t const *const idiom, ir_node const *const value)
+{
+	if (is_in_loop(idiom, value))
+		return false;
+	ir_mode *const mode = get_irn_mode(value);
+	if (!mode_is_data(mode))
+		return false;
+	if (get_mode_size_bits(mode) == 8 && mode_is_int(mode))
+		return true;
+	if (!is_Const(value))
+		return false;
+	ir_tarval    *const tv   = get_Const_tarval(value);
+	unsigned char const byte = get_tarval_sub_bits(tv, 0);
+	for (unsigned i = 1, n = get_mode_size_bytes(mode); i < n; ++i) {
+		if (get_tarval_sub_bits(tv, i) != byte)
+			return false;
+	}
+	return true;
+}
+
+static bool analyze_memset(idiom_t *const idiom)
+{
+	ir_node *const store = idiom->store;
+	ir_node *const value = get_Store_value(store);
+	ir_mode *const mode  = get_irn_mode(value);
+	if (!is_memset_value(idiom, value)
+	    || !is_consecutive_access(idiom, store, get_Store_ptr(store), mode,
+	                              get_Store_volatility(store)))
+		return false;
+	idiom->kind      = IDIOM_MEMSET;
+	idiom->elem_size = get_mode_size_bytes(mode);
+	return true;
+}
+
+static bool analyze_memcpy(idiom_t *const idiom)
+{
+	ir_node *const load      = idiom->load;
+	ir_node *const store     = idiom->store;
+	ir_node *const value     = get_Store_value(store);
+	ir_node *const load_mem  = get_load_proj(load, pn_Load_M);
+	ir_node *const store_mem = get_Store_mem(store);
+	if (get_nodes_block(load) != idiom->body
+	    || get_Load_mem(load) != idiom->phi_mem
+	    || (store_mem != idiom->phi_mem && store_mem != load_mem)
+	    || (load_mem != NULL && !is_only_used_by(load_mem, store))
+	    || !is_Proj(value) || get_Proj_pred(value) != load
+	    || !is_only_used_by(value, store))
+		return false;
+
+	ir_mode *const mode = get_irn_mode(value);
+	ir_node *const src  = get_Load_ptr(load);
+	ir_node *const dst  = get_Store_ptr(store);
+	if (!is_consecutive_access(idiom, store, dst, mode, get_Store_volatility(store))
+	    || !is_consecutive_access(idiom, load, src, mode, get_Load_volatility(load)))
+		return false;
+
+	/* the copied ranges must not overlap, so compare the whole objects */
+	ir_type const *const type = get_Load_type(load);
+	if (get_alias_relation(get_base_address(idiom, dst), type, 1,
+	                       get_base_address(idiom, src), type, 1) != ir_no_alias)
+		return false;
+
+	idiom->kind      = IDIOM_MEMCPY;
+	idiom->elem_size = get_mode_size_bytes(mode);
+	return true;
+}
+
+/**
+ * Returns the loaded value if @p node is a (widened) Load result.
+ */
+static ir_node *skip_widening_conv(ir_node *node)
+{
+	while (is_Conv(node)) {
+		ir_node *const op      = get_Conv_op(node);
+		ir_mode *const mode    = get_irn_mode(node);
+		ir_mode *const op_mode = get_irn_mode(op);
+		if (!mode_is_int(mode) || !mode_is_int(op_mode)
+		    || get_mode_size_bits(mode) < get_mode_size_bits(op_mode))
+			break;
+		node = op;
+	}
+	return node;
+}
+
+static bool analyze_strlen(idiom_t *const idiom)
+{
+	ir_node *const load     = idiom->load;
+	ir_node *const load_mem = get_load_proj(load, pn_Load_M);
+	if (get_nodes_block(load) != idiom->header
+	    || get_Load_mem(load) != idiom->phi_mem
+	    || load_mem == NULL
+	    || get_Phi_pred(idiom->phi_mem, get_back_pos(idiom)) != load_mem)
+		return false;
+
+	ir_node *const cmp = get_Cond_selector(idiom->cond);
+	if (!is_Cmp(cmp) || get_continue_relation(idiom) != ir_relation_less_greater)
+		return false;
+	ir_node *l = skip_widening_conv(get_Cmp_left(cmp));
+	ir_node *r = skip_widening_conv(get_Cmp_right(cmp));
+	if (is_Const(l)) {
+		ir_node *const t = l;
+		l = r;
+		r = t;
+	}
+	if (!is_Const(r) || !tarval_is_null(get_Const_tarval(r))
+	    || !is_Proj(l) || get_Proj_pred(l) != load)
+		return false;
+
+	ir_mode *const mode = get_irn_mode(l);
+	if (!mode_is_int(mode) || get_mode_size_bits(mode) != 8
+	    || !is_consecutive_access(idiom, load, get_Load_ptr(load), mode,
+	                              get_Load_volatility(load)))
+		return false;
+
+	idiom->kind      = IDIOM_STRLEN;
+	idiom->elem_size = 1;
+	return true;
+}
+
+static bool analyze_loop(idiom_t *const idiom, ir_loop const *const loop)
+{
+	if (!find_loop_blocks(idiom, loop))
+		return false;
+	if (!scan_block(idiom, idiom->header) || !scan_block(idiom, idiom->body)
+	    || idiom->phi_mem == NULL)
+		return false;
+
+	ir_node *const phi_mem = idiom->phi_mem;
+	ir_node *const store   = idiom->store;
+	ir_node *const load    = idiom->load;
+	bool           matched;
+	if (store != NULL) {
+		/* the Store is the last memory operation of the loop */
+		ir_node *const next_mem = get_Phi_pred(phi_mem, get_back_pos(idiom));
+		if (get_nodes_block(store) != idiom->body || !is_Proj(next_mem)
+		    || get_Proj_pred(next_mem) != store || !analyze_trip_count(idiom))
+			return false;
+		if (load == NULL) {
+			matched = get_Store_mem(store) == phi_mem && analyze_memset(idiom);
+		} else {
+			matched = analyze_memcpy(idiom);
+		}
+	} else if (load != NULL) {
+		matched = analyze_strlen(idiom);
+	} else {
+		return false;
+	}
+	if (!matched)
+		return false;
+
+	/* values computed in the loop must be recomputable from the trip count */
+	iv_loop_t const iv_loop = get_iv_loop(idiom);
+	for (size_t i = 0, n = ARR_LEN(idiom->exit_phis); i < n; ++i) {
+		long step;
+		if (!get_iv_step(&iv_loop, idiom->exit_phis[i], &step))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Recursively collects the loops of @p loop which match an idiom.
+ */
+static void find_idioms(ir_loop const *const loop, idiom_t **const idioms)
+{
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind == k_ir_loop)
+			find_idioms(element.son, idioms);
+	}
+
+	idiom_t idiom = {
+		.phi_mem   = NULL,
+		.load      = NULL,
+		.store     = NULL,
+		.exit_phis = NEW_ARR_F(ir_node*, 0),
+	};
+	if (analyze_loop(&idiom, loop)) {
+		ARR_APP1(idiom_t, *idioms, idiom);
+	} else {
+		DEL_ARR_F(idiom.exit_phis);
+	}
+}
+
+/**
+ * Creates a copy of @p node in @p block computing its value in the first
+ * iteration.
+ */
+static ir_node *copy_entry_value(idiom_t const *const idiom,
+                                 ir_node *const block, ir_node *const node)
+{
+	if (!is_in_loop(idiom, node))
+		return node;
+	if (is_Phi(node))
+		return get_Phi_pred(node, idiom->entry_pos);
+
+	ir_node *const copy = exact_copy(node);
+	set_nodes_block(copy, block);
+	foreach_irn_in(node, i, pred) {
+		set_irn_n(copy, i, copy_entry_value(idiom, block, pred));
+	}
+	return copy;
+}
+
+static ir_mode *get_size_mode(void)
+{
+	return find_unsigned_mode(get_reference_offset_mode(mode_P));
+}
+
+/**
+ * Computes the number of iterations of a counted loop.
+ */
+static ir_node *new_trip_count(idiom_t const *const idiom, ir_node *const block)
+{
+	ir_graph *const irg       = get_irn_irg(block);
+	ir_mode  *const size_mode = get_size_mode();
+	ir_node  *const iv        = idiom->iv;
+	ir_mode  *const mode      = get_irn_mode(iv);
+	ir_node  *const start     = get_Phi_pred(iv, idiom->entry_pos);
+	ir_node  *const bound     = idiom->bound;
+
+	ir_node *diff;
+	if (mode_is_reference(mode)) {
+		diff = new_r_Sub(block, bound, start);
+	} else {
+		ir_mode *const umode = find_unsigned_mode(mode);
+		diff = new_r_Sub(block, new_r_Conv(block, bound, umode),
+		                 new_r_Conv(block, start, umode));
+	}
+	ir_node *count = new_r_Conv(block, diff, size_mode);
+
+	iv_loop_t const iv_loop = get_iv_loop(idiom);
+	long            step;
+	get_iv_step(&iv_loop, iv, &step);
+	if (step > 1) {
+		ir_node *const round = new_r_Const_long(irg, size_mode, step - 1);
+		ir_node *const shift = new_r_Const_long(irg, mode_Iu, log2_floor(step));
+		count = new_r_Shr(block, new_r_Add(block, count, round), shift);
+	}
+	return count;
+}
+
+static ir_node *new_libc_call(ir_node *const block, ir_node *const mem,
+                              char const *const name, ir_type *const mtp,
+                              size_t const n_params, ir_node **const params)
+{
+	ir_graph  *const irg = get_irn_irg(block);
+	ir_entity *const ent = create_compilerlib_entity(name, mtp);
+	ir_node   *const ptr = new_r_Address(irg, ent);
+	return new_r_Call(block, mem, ptr, n_params, params, mtp);
+}
+
+static ir_type *new_libc_type(size_t const n_params, ir_mode *const res_mode)
+{
+	ir_type *const mtp = new_type_method(n_params, 1, false, cc_cdecl_set,
+	                                     mtp_no_property);
+	set_method_res_type(mtp, 0, get_type_for_mode(res_mode));
+	return mtp;
+}
+
+static ir_node *new_memset(ir_node *const block, ir_node *const mem,
+                           ir_node *const dst, ir_node *const value,
+                           ir_node *const n_bytes)
+{
+	ir_type *const mtp = new_libc_type(3, mode_P);
+	set_method_param_type(mtp, 0, get_type_for_mode(mode_P));
+	set_method_param_type(mtp, 1, get_type_for_mode(mode_Is));
+	set_method_param_type(mtp, 2, get_type_for_mode(get_size_mode()));
+
+	ir_graph *const irg = get_irn_irg(block);
+	ir_node        *byte;
+	if (is_Const(value)) {
+		unsigned char const bits = get_tarval_sub_bits(get_Const_tarval(value), 0);
+		byte = new_r_Const_long(irg, mode_Is, bits);
+	} else {
+		byte = new_r_Conv(block, value, mode_Is);
+	}
+	ir_node *in[] = { dst, byte, n_bytes };
+	ir_node *const call = new_libc_call(block, mem, "memset", mtp, ARRAY_SIZE(in), in);
+	return new_r_Proj(call, mode_M, pn_Call_M);
+}
+
+static ir_node *new_memcpy(ir_node *const block, ir_node *const mem,
+                           ir_node *const dst, ir_node *const src,
+                           ir_node *const n_bytes, ir_type *const elem_type)
+{
+	if (is_Const(n_bytes)) {
+		/* let lower_CopyB() decide how to copy */
+		long const     size    = get_tarval_long(get_Const_tarval(n_bytes));
+		if (size == 0)
+			return mem;
+		unsigned const n_elems = size / get_type_size(elem_type);
+		ir_type *const type    = new_type_array(elem_type, n_elems);
+		return new_r_CopyB(block, mem, dst, src, type, cons_none);
+	}
+
+	ir_type *const mtp = new_libc_type(3, mode_P);
+	set_method_param_type(mtp, 0, get_type_for_mode(mode_P));
+	set_method_param_type(mtp, 1, get_type_for_mode(mode_P));
+	set_method_param_type(mtp, 2, get_type_for_mode(get_size_mode()));
+
+	ir_node *in[] = { dst, src, n_bytes };
+	ir_node *const call = new_libc_call(block, mem, "memcpy", mtp, ARRAY_SIZE(in), in);
+	return new_r_Proj(call, mode_M, pn_Call_M);
+}
+
+/**
+ * Creates the call replacing the loop in @p block and returns the new memory.
+ * @p count is set to the number of iterations of the loop.
+ */
+static ir_node *new_idiom_call(idiom_t const *const idiom, ir_node *const block,
+                               ir_node *const mem, ir_node **const count)
+{
+	ir_graph *const irg       = get_irn_irg(block);
+	ir_mode  *const size_mode = get_size_mode();
+	switch (idiom->kind) {
+	case IDIOM_MEMSET: {
+		ir_node *const store   = idiom->store;
+		ir_node *const dst     = copy_entry_value(idiom, block, get_Store_ptr(store));
+		ir_node *const elem    = new_r_Const_long(irg, size_mode, idiom->elem_size);
+		*count = new_trip_count(idiom, block);
+		ir_node *const n_bytes = new_r_Mul(block, *count, elem);
+		return new_memset(block, mem, dst, get_Store_value(store), n_bytes);
+	}
+
+	case IDIOM_MEMCPY: {
+		ir_node *const dst     = copy_entry_value(idiom, block, get_Store_ptr(idiom->store));
+		ir_node *const src     = copy_entry_value(idiom, block, get_Load_ptr(idiom->load));
+		ir_node *const elem    = new_r_Const_long(irg, size_mode, idiom->elem_size);
+		*count = new_trip_count(idiom, block);
+		ir_node *const n_bytes = new_r_Mul(block, *count, elem);
+		return new_memcpy(block, mem, dst, src, n_bytes,
+		                  get_type_for_mode(get_Load_mode(idiom->load)));
+	}
+
+	case IDIOM_STRLEN: {
+		ir_type *const mtp = new_libc_type(1, size_mode);
+		set_method_param_type(mtp, 0, get_type_for_mode(mode_P));
+		ir_node       *str  = copy_entry_value(idiom, block, get_Load_ptr(idiom->load));
+		ir_node *const call = new_libc_call(block, mem, "strlen", mtp, 1, &str);
+		ir_node *const ress = new_r_Proj(call, mode_T, pn_Call_T_result);
+		*count = new_r_Proj(ress, size_mode, 0);
+		return new_r_Proj(call, mode_M, pn_Call_M);
+	}
+	}
+	panic("invalid loop idiom");
+}
+
+/**
+ * Replaces the loop by a call and makes it exit immediately.
+ */
+static void transform_idiom(idiom_t const *const idiom)
+{
+	ir_graph *const irg    = get_irn_irg(idiom->header);
+	ir_node  *const header = idiom->header;
+	ir_node  *const entry  = get_Block_cfgpred(header, idiom->entry_pos);
+	ir_node        *block  = new_r_Block(irg, 1, &entry);
+
+	ir_node *const phi_mem = idiom->phi_mem;
+	ir_node *const mem     = get_Phi_pred(phi_mem, idiom->entry_pos);
+	ir_node       *enter   = NULL;
+	if (idiom->guarded) {
+		ir_node *const iv    = idiom->iv;
+		ir_node *const start = get_Phi_pred(iv, idiom->entry_pos);
+		enter = new_r_Cmp(block, start, idiom->bound, ir_relation_less);
+	}
+
+	ir_node *count;
+	ir_node *new_mem;
+	if (enter == NULL || (is_Const(enter) && get_Const_tarval(enter) == tarval_b_true)) {
+		new_mem = new_idiom_call(idiom, block, mem, &count);
+	} else if (is_Const(enter)) {
+		/* the loop is never entered */
+		new_mem = mem;
+		count   = new_r_Const(irg, get_mode_null(get_size_mode()));
+	} else {
+		/* not every target supports Mux, so guard the call by a branch */
+		ir_node *const cond       = new_r_Cond(block, enter);
+		ir_node *const proj_true  = new_r_Proj(cond, mode_X, pn_Cond_true);
+		ir_node *const proj_false = new_r_Proj(cond, mode_X, pn_Cond_false);
+		ir_node *const call_block = new_r_Block(irg, 1, &proj_true);
+		ir_node       *call_count;
+		ir_node *const call_mem   = new_idiom_call(idiom, call_block, mem, &call_count);
+		ir_node *const join_in[]  = { new_r_Jmp(call_block), proj_false };
+		block = new_r_Block(irg, ARRAY_SIZE(join_in), join_in);
+
+		ir_node *const mems[]   = { call_mem, mem };
+		ir_node *const zero     = new_r_Const(irg, get_mode_null(get_size_mode()));
+		ir_node *const counts[] = { call_count, zero };
+		new_mem = new_r_Phi(block, ARRAY_SIZE(mems), mems, mode_M);
+		count   = new_r_Phi(block, ARRAY_SIZE(counts), counts, get_irn_mode(call_count));
+	}
+	set_Block_cfgpred(header, idiom->entry_pos, new_r_Jmp(block));
+	set_Phi_pred(phi_mem, idiom->entry_pos, new_mem);
+	if (idiom->kind == IDIOM_STRLEN) {
+		/* the Load does not change memory */
+		exchange(get_load_proj(idiom->load, pn_Load_M), phi_mem);
+	}
+
+	/* induction variables have their final values after count iterations */
+	iv_loop_t const iv_loop = get_iv_loop(idiom);
+	for (size_t i = 0, n = ARR_LEN(idiom->exit_phis); i < n; ++i) {
+		ir_node *const phi   = idiom->exit_phis[i];
+		ir_mode *const mode  = get_irn_mode(phi);
+		ir_node *const start = get_Phi_pred(phi, idiom->entry_pos);
+		long           step;
+		get_iv_step(&iv_loop, phi, &step);
+		ir_mode *const offset_mode = mode_is_reference(mode)
+			? get_reference_offset_mode(mode) : mode;
+		ir_node *const offset = new_r_Mul(block,
+			new_r_Conv(block, count, offset_mode),
+			new_r_Const_long(irg, offset_mode, step));
+		set_Phi_pred(phi, idiom->entry_pos, new_r_Add(block, start, offset));
+	}
+
+	/* leave the loop before the first iteration */
+	ir_node *const body_proj = get_Block_cfgpred(idiom->body, 0);
+	ir_node       *exit_proj = NULL;
+	foreach_irn_out_r(idiom->cond, i, proj) {
+		if (proj != body_proj)
+			exit_proj = proj;
+	}
+	exchange(body_proj, new_r_Bad(irg, mode_X));
+	exchange(exit_proj, new_r_Jmp(header));
+}
+
+void opt_loop_idioms(ir_graph *irg)
+{
+	FIRM_DBG_REGISTER(dbg, "firm.opt.loop_idiom");
+	pass_stats_begin(irg, "opt_loop_idioms");
+
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
+
+	/* analyze all loops before changing the graph, the transformation
+	 * invalidates the out edges */
+	idiom_t *idioms = NEW_ARR_F(idiom_t, 0);
+	find_idioms(get_irg_loop(irg), &idioms);
+
+	size_t const n_idioms = ARR_LEN(idioms);
+	for (size_t i = 0; i < n_idioms; ++i) {
+		idiom_t *const idiom = &idioms[i];
+		DB((dbg, LEVEL_1, "%+F: replacing loop %+F by %s\n", irg, idiom->header,
+		    idiom->kind == IDIOM_MEMSET ? "memset" :
+		    idiom->kind == IDIOM_MEMCPY ? "memcpy" : "strlen"));
+		transform_idiom(idiom);
+		DEL_ARR_F(idiom->exit_phis);
+	}
+	DEL_ARR_F(idioms);
+
+	stat_ev_ull("loop_idioms", n_idioms);
+	if (n_idioms == 0) {
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
+	} else {
+		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+		remove_unreachable_code(irg);
+		remove_bads(irg);
+	}
+	pass_stats_end(irg);
+}
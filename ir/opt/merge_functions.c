@@ -0,0 +1,424 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Merging of identical functions.
+ *
+ * Every graph is hashed over its nodes (opcodes, modes, arities and the
+ * important attributes like tarvals and referenced entities).  Graphs with
+ * equal hashes are compared by a simultaneous walk, which establishes an
+ * isomorphism between the two graphs.  Entities on the frame and references
+ * of a function to itself are compared positionally.
+ *
+ * A duplicate which is only called directly from this compilation unit is
+ * removed and its calls are redirected to the remaining copy.  Any other
+ * duplicate is replaced by a thunk calling the remaining copy, so the
+ * function keeps its own address, and its direct calls are redirected to
+ * the remaining copy as well.
+ */
+#include "array.h"
+#include "cgana.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "hashptr.h"
+#include "ircons.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "irop_t.h"
+#include "iroptimize.h"
+#include "irprog_t.h"
+#include "irtools.h"
+#include "pass_stats_t.h"
+#include "pmap.h"
+#include "statev_t.h"
+#include "typerep.h"
+#include "util.h"
+#include "xmalloc.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+/** Information about one graph. */
+typedef struct graph_info_t {
+	ir_graph *irg;     /**< the graph */
+	unsigned  hash;    /**< the hash value of the graph */
+	unsigned  n_nodes; /**< number of nodes in the graph */
+	ir_graph *merged;  /**< the graph this one is merged into or NULL */
+} graph_info_t;
+
+typedef struct hash_env_t {
+	ir_entity *self;    /**< the entity of the hashed graph */
+	ir_type   *frame;   /**< the frame type of the hashed graph */
+	unsigned   hash;    /**< the accumulated hash value */
+	unsigned   n_nodes; /**< the number of visited nodes */
+} hash_env_t;
+
+/** A pair of graphs which are compared. */
+typedef struct compare_env_t {
+	ir_graph  *irg_a;
+	ir_graph  *irg_b;
+	ir_node  **worklist; /**< pairs of nodes still to compare */
+} compare_env_t;
+
+static ir_entity *get_entity_attr(ir_node const *const node)
+{
+	switch (get_irn_opcode(node)) {
+	case iro_Address: return get_Address_entity(node);
+	case iro_Offset:  return get_Offset_entity(node);
+	case iro_Member:  return get_Member_entity(node);
+	default:          return NULL;
+	}
+}
+
+static unsigned hash_entity(hash_env_t const *const env,
+                            ir_entity *const entity)
+{
+	/* references to itself and to the frame are compared by position */
+	if (entity == env->self)
+		return 1;
+	if (get_entity_owner(entity) == env->frame)
+		return get_compound_member_index(env->frame, entity);
+	return hash_ptr(entity);
+}
+
+/**
+ * Walker: Accumulates the hash value of a graph.  The walk order only
+ * depends on the structure of the graph, so isomorphic graphs get the same
+ * hash value.
+ */
+static void hash_node(ir_node *node, void *data)
+{
+	hash_env_t *const env  = (hash_env_t*)data;
+	unsigned          hash = get_irn_opcode(node);
+	hash = hash_combine(hash, hash_ptr(get_irn_mode(node)));
+	hash = hash_combine(hash, get_irn_arity(node));
+
+	ir_entity *const entity = get_entity_attr(node);
+	if (entity != NULL) {
+		hash = hash_combine(hash, hash_entity(env, entity));
+	} else if (is_Const(node)) {
+		hash = hash_combine(hash, hash_ptr(get_Const_tarval(node)));
+	} else if (is_Proj(node)) {
+		hash = hash_combine(hash, get_Proj_num(node));
+	} else if (is_Cmp(node)) {
+		hash = hash_combine(hash, get_Cmp_relation(node));
+	}
+
+	env->hash = hash_combine(env->hash, hash);
+	++env->n_nodes;
+}
+
+static bool method_types_equal(ir_type const *const a, ir_type const *const b)
+{
+	if (a == b)
+		return true;
+	size_t const n_params = get_method_n_params(a);
+	size_t const n_ress   = get_method_n_ress(a);
+	if (n_params != get_method_n_params(b) || n_ress != get_method_n_ress(b)
+	    || is_method_variadic(a) != is_method_variadic(b)
+	    || get_method_calling_convention(a) != get_method_calling_convention(b)
+	    || get_method_additional_properties(a) != get_method_additional_properties(b))
+		return false;
+	for (size_t i = 0; i < n_params; ++i) {
+		if (get_method_param_type(a, i) != get_method_param_type(b, i))
+			return false;
+	}
+	for (size_t i = 0; i < n_ress; ++i) {
+		if (get_method_res_type(a, i) != get_method_res_type(b, i))
+			return false;
+	}
+	return true;
+}
+
+static bool frame_types_equal(ir_type const *const a, ir_type const *const b)
+{
+	size_t const n_members = get_compound_n_members(a);
+	if (n_members != get_compound_n_members(b))
+		return false;
+	for (size_t i = 0; i < n_members; ++i) {
+		ir_entity const *const ent_a = get_compound_member(a, i);
+		ir_entity const *const ent_b = get_compound_member(b, i);
+		if (get_entity_type(ent_a) != get_entity_type(ent_b)
+		    || get_entity_kind(ent_a) != get_entity_kind(ent_b)
+		    || get_entity_alignment(ent_a) != get_entity_alignment(ent_b))
+			return false;
+		if (is_parameter_entity(ent_a)
+		    && get_entity_parameter_number(ent_a) != get_entity_parameter_number(ent_b))
+			return false;
+	}
+	return true;
+}
+
+static bool entities_correspond(compare_env_t const *const env,
+                                ir_entity *const a, ir_entity *const b)
+{
+	if (a == b)
+		return true;
+	if (a == get_irg_entity(env->irg_a))
+		return b == get_irg_entity(env->irg_b);
+	ir_type *const frame_a = get_irg_frame_type(env->irg_a);
+	ir_type *const frame_b = get_irg_frame_type(env->irg_b);
+	return get_entity_owner(a) == frame_a && get_entity_owner(b) == frame_b
+	    && get_compound_member_index(frame_a, a)
+	       == get_compound_member_index(frame_b, b);
+}
+
+/**
+ * Maps node @p a to node @p b and queues the pair for comparison.  Returns
+ * false if one of the nodes is already mapped to another node.
+ */
+static bool map_nodes(compare_env_t *const env, ir_node *const a,
+                      ir_node *const b)
+{
+	ir_node *const link_a = (ir_node*)get_irn_link(a);
+	ir_node *const link_b = (ir_node*)get_irn_link(b);
+	if (link_a != NULL || link_b != NULL)
+		return link_a == b && link_b == a;
+
+	set_irn_link(a, b);
+	set_irn_link(b, a);
+	ARR_APP1(ir_node*, env->worklist, a);
+	return true;
+}
+
+static bool nodes_equal(compare_env_t *const env, ir_node *const a,
+                        ir_node *const b)
+{
+	ir_op *const op = get_irn_op(a);
+	if (op != get_irn_op(b) || get_irn_mode(a) != get_irn_mode(b)
+	    || get_irn_arity(a) != get_irn_arity(b))
+		return false;
+
+	ir_entity *const entity_a = get_entity_attr(a);
+	if (entity_a != NULL) {
+		if (!entities_correspond(env, entity_a, get_entity_attr(b)))
+			return false;
+	} else if (is_Block(a)) {
+		if (get_Block_entity(a) != NULL || get_Block_entity(b) != NULL)
+			return false;
+	} else if (is_Call(a)) {
+		/* front ends often create a new method type for every call */
+		if (!method_types_equal(get_Call_type(a), get_Call_type(b))
+		    || ir_throws_exception(a) != ir_throws_exception(b)
+		    || get_irn_pinned(a) != get_irn_pinned(b))
+			return false;
+	} else if (!op->ops.attrs_equal(a, b)) {
+		return false;
+	}
+
+	if (!is_Block(a) && !map_nodes(env, get_nodes_block(a), get_nodes_block(b)))
+		return false;
+	foreach_irn_in(a, i, pred_a) {
+		if (!map_nodes(env, pred_a, get_irn_n(b, i)))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Checks whether the graphs @p irg_a and @p irg_b are isomorphic.
+ */
+static bool graphs_equal(ir_graph *const irg_a, ir_graph *const irg_b)
+{
+	ir_entity *const ent_a = get_irg_entity(irg_a);
+	ir_entity *const ent_b = get_irg_entity(irg_b);
+	if (!method_types_equal(get_entity_type(ent_a), get_entity_type(ent_b))
+	    || get_entity_additional_properties(ent_a) != get_entity_additional_properties(ent_b)
+	    || !frame_types_equal(get_irg_frame_type(irg_a), get_irg_frame_type(irg_b)))
+		return false;
+
+	ir_reserve_resources(irg_a, IR_RESOURCE_IRN_LINK);
+	ir_reserve_resources(irg_b, IR_RESOURCE_IRN_LINK);
+	irg_walk_graph(irg_a, firm_clear_link, NULL, NULL);
+	irg_walk_graph(irg_b, firm_clear_link, NULL, NULL);
+
+	compare_env_t env = {
+		.irg_a    = irg_a,
+		.irg_b    = irg_b,
+		.worklist = NEW_ARR_F(ir_node*, 0),
+	};
+	bool equal = map_nodes(&env, get_irg_end(irg_a), get_irg_end(irg_b));
+	while (equal && ARR_LEN(env.worklist) > 0) {
+		ir_node *const a = env.worklist[ARR_LEN(env.worklist) - 1];
+		ARR_SHRINKLEN(env.worklist, ARR_LEN(env.worklist) - 1);
+		equal = nodes_equal(&env, a, (ir_node*)get_irn_link(a));
+	}
+	DEL_ARR_F(env.worklist);
+
+	ir_free_resources(irg_b, IR_RESOURCE_IRN_LINK);
+	ir_free_resources(irg_a, IR_RESOURCE_IRN_LINK);
+	return equal;
+}
+
+static bool is_mergeable(ir_graph *const irg)
+{
+	ir_entity *const ent = get_irg_entity(irg);
+	/* the linker may replace weak functions */
+	return !(get_entity_linkage(ent) & (IR_LINKAGE_WEAK | IR_LINKAGE_NO_CODEGEN));
+}
+
+/**
+ * Returns true if all uses of the function @p ent are direct calls in this
+ * compilation unit.
+ */
+static bool is_only_called(ir_entity const *const ent)
+{
+	return !entity_is_externally_visible(ent)
+	    && !(get_entity_linkage(ent) & IR_LINKAGE_HIDDEN_USER)
+	    && !(get_entity_usage(ent) & ir_usage_address_taken);
+}
+
+/**
+ * Replaces the graph of @p ent by a call of @p target.
+ */
+static void make_thunk(ir_entity *const ent, ir_entity *const target)
+{
+	free_ir_graph(get_entity_irg(ent));
+
+	ir_graph *const irg   = new_ir_graph(ent, 0);
+	ir_node  *const block = get_r_cur_block(irg);
+	ir_node  *const ret   = new_r_forwarding_call(block, get_r_store(irg),
+	                                              target, get_entity_type(ent));
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(block);
+	irg_finalize_cons(irg);
+}
+
+typedef struct redirect_env_t {
+	pmap *removed; /**< maps removed functions to their replacement */
+	pmap *thunks;  /**< maps functions replaced by thunks to the thunk target */
+} redirect_env_t;
+
+/**
+ * Walker: Redirects all references to removed functions and direct calls
+ * of functions replaced by thunks.
+ */
+static void redirect_references(ir_node *node, void *data)
+{
+	redirect_env_t const *const env = (redirect_env_t const*)data;
+	if (is_Address(node)) {
+		ir_entity *const repl
+			= pmap_get(ir_entity, env->removed, get_Address_entity(node));
+		if (repl != NULL)
+			set_Address_entity(node, repl);
+	} else if (is_Call(node)) {
+		ir_node *const ptr = get_Call_ptr(node);
+		if (!is_Address(ptr))
+			return;
+		ir_entity *const target
+			= pmap_get(ir_entity, env->thunks, get_Address_entity(ptr));
+		if (target != NULL)
+			set_Call_ptr(node, new_r_Address(get_irn_irg(node), target));
+	}
+}
+
+static int cmp_graph_info(const void *a, const void *b)
+{
+	graph_info_t const *const ia = (graph_info_t const*)a;
+	graph_info_t const *const ib = (graph_info_t const*)b;
+	if (ia->hash != ib->hash)
+		return QSORT_CMP(ia->hash, ib->hash);
+	return QSORT_CMP(get_irg_idx(ia->irg), get_irg_idx(ib->irg));
+}
+
+unsigned merge_identical_functions(void)
+{
+	pass_stats_begin(NULL, "merge_identical_functions");
+
+	FIRM_DBG_REGISTER(dbg, "firm.opt.merge_functions");
+
+	size_t        const n_irgs = get_irp_n_irgs();
+	graph_info_t *const infos  = XMALLOCNZ(graph_info_t, n_irgs);
+	size_t              n_infos = 0;
+	foreach_irp_irg(i, irg) {
+		if (!is_mergeable(irg))
+			continue;
+		hash_env_t env = {
+			.self    = get_irg_entity(irg),
+			.frame   = get_irg_frame_type(irg),
+			.hash    = 0,
+			.n_nodes = 0,
+		};
+		irg_walk_graph(irg, NULL, hash_node, &env);
+		graph_info_t *const info = &infos[n_infos++];
+		info->irg     = irg;
+		info->hash    = env.hash;
+		info->n_nodes = env.n_nodes;
+	}
+	QSORT(infos, n_infos, cmp_graph_info);
+
+	/* compare each graph with the representatives of its hash bucket */
+	assure_irp_globals_entity_usage_computed();
+	unsigned n_merged = 0;
+	unsigned n_nodes  = 0;
+	for (size_t first = 0, last; first < n_infos; first = last) {
+		for (last = first + 1;
+		     last < n_infos && infos[last].hash == infos[first].hash; ++last) {
+			graph_info_t *const info = &infos[last];
+			for (size_t r = first; r < last; ++r) {
+				graph_info_t const *const rep = &infos[r];
+				if (rep->merged != NULL || !graphs_equal(rep->irg, info->irg))
+					continue;
+				ir_entity *const ent = get_irg_entity(info->irg);
+				if (!is_only_called(ent)
+				    && !has_register_signature(get_entity_type(ent)))
+					continue;
+				DB((dbg, LEVEL_1, "merging %+F into %+F\n", info->irg, rep->irg));
+				info->merged = rep->irg;
+				++n_merged;
+				n_nodes += info->n_nodes;
+				break;
+			}
+		}
+	}
+
+	/* redirect the references, before any entity is freed */
+	redirect_env_t env = {
+		.removed = pmap_create(),
+		.thunks  = pmap_create(),
+	};
+	for (size_t i = 0; i < n_infos; ++i) {
+		graph_info_t const *const info = &infos[i];
+		if (info->merged == NULL)
+			continue;
+		ir_entity *const ent    = get_irg_entity(info->irg);
+		ir_entity *const target = get_irg_entity(info->merged);
+		pmap_insert(is_only_called(ent) ? env.removed : env.thunks, ent, target);
+	}
+	if (n_merged > 0) {
+		foreach_irp_irg(i, irg) {
+			irg_walk_graph(irg, NULL, redirect_references, &env);
+			free_callee_info(irg);
+		}
+	}
+
+	/* replace the duplicates */
+	for (size_t i = 0; i < n_infos; ++i) {
+		graph_info_t const *const info = &infos[i];
+		if (info->merged == NULL)
+			continue;
+		ir_entity *const ent = get_irg_entity(info->irg);
+		if (pmap_contains(env.removed, ent)) {
+			free_ir_graph(info->irg);
+			free_entity(ent);
+		} else {
+			make_thunk(ent, get_irg_entity(info->merged));
+		}
+	}
+	pmap_destroy(env.thunks);
+	pmap_destroy(env.removed);
+	free(infos);
+
+	if (n_merged > 0)
+		set_irp_globals_entity_usage_state(ir_entity_usage_not_computed);
+
+	stat_ev_ull("merged_functions", n_merged);
+	stat_ev_ull("merged_function_nodes", n_nodes);
+	DB((dbg, LEVEL_1, "merged %u functions with %u nodes\n", n_merged, n_nodes));
+
+	pass_stats_end(NULL);
+	return n_merged;
+}
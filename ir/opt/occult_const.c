@@ -21,6 +21,7 @@
 #include "irnodemap.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "pass_stats_t.h"
 #include "tv.h"
 #include <stdbool.h>
 
@@ -73,6 +74,8 @@ static void fill_nodemap(ir_node *node, void *data) {
 
 void occult_consts(ir_graph *irg)
 {
+	pass_stats_begin(irg, "occult_consts");
+
 	FIRM_DBG_REGISTER(dbg, "firm.opt.occults");
 
 	constbits_analyze(irg);
@@ -93,4 +96,6 @@ void occult_consts(ir_graph *irg)
 	constbits_clear(irg);
 	confirm_irg_properties(irg,
 	                       env.changed ? IR_GRAPH_PROPERTIES_NONE : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
@@ -20,6 +20,7 @@
 #include "irnode_t.h"
 #include "iropt_t.h"
 #include "iroptimize.h"
+#include "pass_stats_t.h"
 #include "set.h"
 #include "util.h"
 
@@ -1172,6 +1173,7 @@ void shape_blocks(ir_graph *irg)
 
 	DEBUG_ONLY(part_nr = 0;)
 	DB((dbg, LEVEL_1, "Shaping blocks for %+F\n", irg));
+	pass_stats_begin(irg, "shape_blocks");
 
 	/* works better, when returns are placed at the end of the blocks */
 	normalize_n_returns(irg);
@@ -1239,4 +1241,5 @@ void shape_blocks(ir_graph *irg)
 	DEL_ARR_F(env.live_outs);
 	del_set(env.opcode2id_map);
 	obstack_free(&env.obst, NULL);
+	pass_stats_end(irg);
 }
@@ -15,6 +15,7 @@
 #include "irgraph_t.h"
 #include "iroptimize.h"
 #include "irouts_t.h"
+#include "pass_stats_t.h"
 #include "type_t.h"
 
 /*
@@ -28,6 +29,7 @@ void opt_frame_irg(ir_graph *irg)
 	if (n <= 0)
 		return;
 
+	pass_stats_begin(irg, "opt_frame_irg");
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUTS);
 	irp_reserve_resources(irp, IRP_RESOURCE_ENTITY_LINK);
 
@@ -80,4 +82,5 @@ void opt_frame_irg(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 		| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE
 		| IR_GRAPH_PROPERTY_MANY_RETURNS);
+	pass_stats_end(irg);
 }
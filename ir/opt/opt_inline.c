@@ -13,6 +13,7 @@
 #include "cgana.h"
 #include "debug.h"
 #include "entity_t.h"
+#include "heap.h"
 #include "irbackedge_t.h"
 #include "ircons_t.h"
 #include "iredges_t.h"
@@ -34,8 +35,8 @@
 #include "irtools.h"
 #include "list.h"
 #include "opt_init.h"
+#include "pass_stats_t.h"
 #include "pmap.h"
-#include "pqueue.h"
 #include "xmalloc.h"
 #include <assert.h>
 #include <limits.h>
@@ -116,7 +117,7 @@ static void find_addr(ir_node *node, void *env)
 		 */
 		*allow_inline = false;
 	} else if (is_Member(node)) {
-		ir_graph *irg = current_ir_graph;
+		ir_graph *irg = get_irn_irg(node);
 		if (get_Member_ptr(node) == get_irg_frame(irg)) {
 			/* access to frame */
 			ir_entity *ent = get_Member_entity(node);
@@ -147,12 +148,24 @@ static void find_addr(ir_node *node, void *env)
 }
 
 /**
- * Check if we can inline a given call.
- * Currently, we cannot inline two cases:
- * - call with compound arguments
- * - graphs that take the address of a parameter
+ * Check if the body of a graph can be inlined.
+ * Currently, we cannot inline graphs that take the address of a parameter,
+ * of a block or that use alloca().
  *
- * check these conditions here
+ * The result only depends on the graph, so the inliner caches it.
+ */
+static bool can_inline_graph(ir_graph *called_graph)
+{
+	bool res = true;
+	irg_walk_graph(called_graph, find_addr, NULL, &res);
+	return res;
+}
+
+/**
+ * Check if we can inline a given call.
+ * Currently, we cannot inline calls whose type does not match the type of
+ * the called method.  The body of the callee must be checked with
+ * can_inline_graph().
  */
 static bool can_inline(ir_node *call, ir_graph *called_graph)
 {
@@ -217,11 +230,7 @@ static bool can_inline(ir_node *call, ir_graph *called_graph)
 			/* otherwise we can "reinterpret" the bits */
 		}
 	}
-
-	bool res = true;
-	irg_walk_graph(called_graph, find_addr, NULL, &res);
-
-	return res;
+	return true;
 }
 
 /**
@@ -309,7 +318,8 @@ static void copy_parameter_entities(ir_node *call, ir_graph *called_graph)
 	}
 }
 
-/* Inlines a method at the given call site. */
+/* Inlines a method at the given call site. The body of the called graph must
+ * have been checked with can_inline_graph(). */
 static bool inline_method(ir_node *const call, ir_graph *called_graph)
 {
 	/* we cannot inline some types of calls */
@@ -484,11 +494,6 @@ static bool inline_method(ir_node *const call, ir_graph *called_graph)
 	ir_node *call_mem =
 		n_mem_phi > 0 ? new_r_Phi(post_bl, n_mem_phi, cf_pred, mode_M)
 		              : new_r_Bad(irg, mode_M);
-	/* Conserve Phi-list for further inlining -- but might be optimized */
-	if (get_nodes_block(call_mem) == post_bl) {
-		set_irn_link(call_mem, get_irn_link(post_bl));
-		set_irn_link(post_bl, call_mem);
-	}
 	/* Now the real results */
 	ir_type *ctp      = get_Call_type(call);
 	ir_node *call_res;
@@ -515,12 +520,6 @@ static bool inline_method(ir_node *const call, ir_graph *called_graph)
 				n_ret == 0 ? new_r_Bad(irg, res_mode) :
 				n_ret == 1 ? cf_pred[0] :
 				new_r_Phi(post_bl, n_ret, cf_pred, res_mode);
-			/* Conserve Phi-list for further inlining -- but might be
-			 * optimized */
-			if (get_nodes_block(phi) == post_bl) {
-				set_Phi_next(phi, get_Block_phis(post_bl));
-				set_Block_phis(post_bl, phi);
-			}
 
 			if (is_aggregate) {
 				long       call_nr     = get_irn_node_nr(call);
@@ -631,6 +630,7 @@ typedef struct call_entry {
 	int        loop_depth;  /**< The loop depth of this call. */
 	int        benefice;    /**< The calculated benefice of this call. */
 	bool       all_const:1; /**< Set if this call has only constant parameters. */
+	heap_entry_t queue_entry; /**< Entry in the queue of inline candidates. */
 } call_entry;
 
 /**
@@ -646,8 +646,13 @@ typedef struct {
 	unsigned  n_call_nodes_orig; /**< for statistics */
 	unsigned  n_callers;         /**< Number of known graphs that call this graphs. */
 	unsigned  n_callers_orig;    /**< for statistics */
+	unsigned  dfs_num;           /**< DFS number in the call graph, 0 if not visited yet. */
+	unsigned  low_link;          /**< Smallest DFS number reachable in the call graph. */
+	unsigned  on_stack:1;        /**< Set, if this graph is on the SCC stack. */
 	unsigned  got_inline:1;      /**< Set, if at least one call inside this graph was inlined. */
-	unsigned  recursive:1;       /**< Set, if this function is self recursive. */
+	unsigned  recursive:1;       /**< Set, if this function is part of a call graph cycle. */
+	unsigned  body_checked:1;    /**< Set, if body_inlinable is valid. */
+	unsigned  body_inlinable:1;  /**< Cached result of can_inline_graph(). */
 } inline_irg_env;
 
 /**
@@ -665,8 +670,13 @@ static inline_irg_env *alloc_inline_irg_env(void)
 	env->n_call_nodes_orig = 0;
 	env->n_callers         = 0;
 	env->n_callers_orig    = 0;
+	env->dfs_num           = 0;
+	env->low_link          = 0;
+	env->on_stack          = 0;
 	env->got_inline        = 0;
 	env->recursive         = 0;
+	env->body_checked      = 0;
+	env->body_inlinable    = 0;
 	return env;
 }
 
@@ -748,6 +758,7 @@ static void collect_calls2(ir_node *node, void *ctx)
 		entry->loop_depth = get_irn_loop(get_nodes_block(node))->depth;
 		entry->benefice   = 0;
 		entry->all_const  = false;
+		heap_entry_init(&entry->queue_entry);
 
 		list_add_tail(&entry->list, &x->calls);
 	}
@@ -770,6 +781,7 @@ static call_entry *duplicate_call_entry(const call_entry *entry,
 	nentry->benefice   = entry->benefice;
 	nentry->loop_depth = entry->loop_depth + loop_depth_delta;
 	nentry->all_const  = entry->all_const;
+	heap_entry_init(&nentry->queue_entry);
 
 	return nentry;
 }
@@ -971,22 +983,39 @@ static int calc_inline_benefice(call_entry *entry, ir_graph *callee)
 	return entry->benefice = weight;
 }
 
-typedef struct walk_env_t {
-	ir_graph **irgs;
-	size_t     last_irg;
-} walk_env_t;
+/** A call graph node on the DFS stack of create_irg_list(). */
+typedef struct dfs_frame_t {
+	ir_graph *irg; /**< the visited graph */
+	size_t    pos; /**< the next callee to visit */
+} dfs_frame_t;
 
-/**
- * Call graph walker, collect all visited graphs.
- */
-static void callgraph_walker(ir_graph *irg, void *data)
+static inline_irg_env *get_inline_irg_env(const ir_graph *irg)
+{
+	return (inline_irg_env*)get_irg_link(irg);
+}
+
+static void push_dfs_frame(dfs_frame_t *frames, size_t *n_frames,
+                           ir_graph **stack, size_t *n_stack,
+                           unsigned *dfs_num, ir_graph *irg)
 {
-	walk_env_t *env = (walk_env_t *)data;
-	env->irgs[env->last_irg++] = irg;
+	inline_irg_env *env = get_inline_irg_env(irg);
+	env->dfs_num  = ++*dfs_num;
+	env->low_link = env->dfs_num;
+	env->on_stack = 1;
+	stack[(*n_stack)++] = irg;
+	frames[*n_frames].irg = irg;
+	frames[*n_frames].pos = 0;
+	++*n_frames;
 }
 
 /**
- * Creates an inline order for all graphs.
+ * Creates an inline order for all graphs: Computes the strongly connected
+ * components of the call graph with Tarjan's algorithm.  A component is
+ * finished after all components it calls, so the graphs are ordered
+ * bottom-up and the graphs of a component are adjacent.  All graphs in a
+ * non-trivial component are marked as recursive.
+ *
+ * The inline environments must already be linked to the graphs.
  *
  * @return the list of graphs.
  */
@@ -998,28 +1027,110 @@ static ir_graph **create_irg_list(void)
 
 	compute_callgraph();
 
-	size_t     n_irgs = get_irp_n_irgs();
-	walk_env_t env;
-	env.irgs     = XMALLOCNZ(ir_graph*, n_irgs);
-	env.last_irg = 0;
+	size_t       n_irgs   = get_irp_n_irgs();
+	ir_graph   **irgs     = XMALLOCN(ir_graph*, n_irgs);
+	ir_graph   **stack    = XMALLOCN(ir_graph*, n_irgs);
+	dfs_frame_t *frames   = XMALLOCN(dfs_frame_t, n_irgs);
+	size_t       n_done   = 0;
+	size_t       n_stack  = 0;
+	unsigned     dfs_num  = 0;
+	foreach_irp_irg(i, root) {
+		if (get_inline_irg_env(root)->dfs_num != 0)
+			continue;
+
+		size_t n_frames = 0;
+		push_dfs_frame(frames, &n_frames, stack, &n_stack, &dfs_num, root);
+		while (n_frames > 0) {
+			dfs_frame_t    *frame = &frames[n_frames - 1];
+			ir_graph       *irg   = frame->irg;
+			inline_irg_env *env   = get_inline_irg_env(irg);
+			if (frame->pos < get_irg_n_callees(irg)) {
+				ir_graph       *callee     = get_irg_callee(irg, frame->pos++);
+				inline_irg_env *callee_env = get_inline_irg_env(callee);
+				if (callee_env->dfs_num == 0) {
+					push_dfs_frame(frames, &n_frames, stack, &n_stack,
+					               &dfs_num, callee);
+				} else if (callee_env->on_stack) {
+					env->low_link = MIN(env->low_link, callee_env->dfs_num);
+				}
+				continue;
+			}
 
-	callgraph_walk(NULL, callgraph_walker, &env);
-	assert(n_irgs == env.last_irg);
+			--n_frames;
+			if (n_frames > 0) {
+				inline_irg_env *caller_env
+					= get_inline_irg_env(frames[n_frames - 1].irg);
+				caller_env->low_link = MIN(caller_env->low_link, env->low_link);
+			}
+			if (env->low_link != env->dfs_num)
+				continue;
+
+			/* irg is the root of a component, pop it from the stack */
+			size_t    first = n_done;
+			ir_graph *member;
+			do {
+				member = stack[--n_stack];
+				get_inline_irg_env(member)->on_stack = 0;
+				irgs[n_done++] = member;
+			} while (member != irg);
+			if (n_done - first > 1) {
+				for (size_t m = first; m < n_done; ++m)
+					get_inline_irg_env(irgs[m])->recursive = 1;
+			}
+		}
+	}
+	assert(n_done == n_irgs);
+	free(frames);
+	free(stack);
 
 	free_callgraph();
 
-	return env.irgs;
+	return irgs;
+}
+
+/**
+ * Adds the nodes created while inlining a call, that are all nodes with an
+ * index of at least @p first_idx, to the Phi and Proj lists of @p irg.
+ * This keeps the lists valid for part_block() without walking the whole
+ * graph again after every inlined call.
+ */
+static void collect_new_phiprojs(ir_graph *irg, unsigned first_idx)
+{
+	unsigned last_idx = get_irg_last_idx(irg);
+	for (unsigned idx = first_idx; idx < last_idx; ++idx) {
+		ir_node *node = get_idx_irn(irg, idx);
+		if (node != NULL)
+			firm_clear_node_and_phi_links(node, NULL);
+	}
+	for (unsigned idx = first_idx; idx < last_idx; ++idx) {
+		ir_node *node = get_idx_irn(irg, idx);
+		if (node == NULL || is_Deleted(node))
+			continue;
+
+		if (is_Phi(node)) {
+			collect_new_phi_node(node);
+		} else if (is_Proj(node)) {
+			ir_node *pred = node;
+			do {
+				pred = get_Proj_pred(pred);
+			} while (is_Proj(pred));
+			set_irn_link(node, get_irn_link(pred));
+			set_irn_link(pred, node);
+		} else if (is_irn_start_block_placed(node)) {
+			collect_new_start_block_node(node);
+		}
+	}
 }
 
 /**
  * Push a call onto the priority list if its benefice is big enough.
  *
- * @param pqueue   the priority queue of calls
+ * @param queue    the priority queue of calls
  * @param call     the call entry
  * @param inline_threshold
  *                 the threshold value
  */
-static void maybe_push_call(pqueue_t *pqueue, call_entry *call,
+static void maybe_push_call(heap_t *queue, call_entry *call,
                             int inline_threshold)
 {
 	ir_graph                  *caller       = get_irn_irg(call->call);
@@ -1049,7 +1160,22 @@ static void maybe_push_call(pqueue_t *pqueue, call_entry *call,
 		return;
 	}
 
-	pqueue_put(pqueue, call, benefice);
+	heap_insert(queue, &call->queue_entry, benefice);
+}
+
+/**
+ * Recompute the benefice of the queued calls to @p callee after its number
+ * of callers changed.
+ */
+static void requeue_calls_to(heap_t *queue, inline_irg_env const *env,
+                             ir_graph const *callee, int inline_threshold)
+{
+	list_for_each_entry(call_entry, entry, &env->calls, list) {
+		if (entry->callee != callee || !heap_contains(&entry->queue_entry))
+			continue;
+		heap_remove(queue, &entry->queue_entry);
+		maybe_push_call(queue, entry, inline_threshold);
+	}
 }
 
 /**
@@ -1060,11 +1186,15 @@ static void maybe_push_call(pqueue_t *pqueue, call_entry *call,
  *                 bigger than this amount
  * @param inline_threshold
  *                 threshold value for inline decision
+ * @param growth_budget
+ *                 number of nodes all inlined callees may still add to
+ *                 the program, updated while inlining
  * @param copied_graphs
  *                 map containing copied of recursive graphs
  */
 static void inline_into(ir_graph *irg, unsigned maxsize,
-                        int inline_threshold, pmap *copied_graphs)
+                        int inline_threshold, unsigned *growth_budget,
+                        pmap *copied_graphs)
 {
 	inline_irg_env *env = (inline_irg_env*)get_irg_link(irg);
 	if (env->n_call_nodes == 0)
@@ -1078,45 +1208,61 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 	current_ir_graph = irg;
 	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 
-	/* put irgs into the pqueue */
-	pqueue_t *pqueue = new_pqueue();
+	/* put irgs into the queue */
+	heap_t queue;
+	heap_init(&queue);
 
 	list_for_each_entry(call_entry, curr_call, &env->calls, list) {
 		assert(is_Call(curr_call->call));
-		maybe_push_call(pqueue, curr_call, inline_threshold);
+		maybe_push_call(&queue, curr_call, inline_threshold);
 	}
 
 	/* note that the list of possible calls is updated during the process */
 	bool phiproj_computed = false;
-	while (!pqueue_empty(pqueue)) {
-		call_entry     *curr_call  = (call_entry*)pqueue_pop_front(pqueue);
+	while (!heap_empty(&queue)) {
+		call_entry     *curr_call  = heap_container(heap_pop_max(&queue), call_entry, queue_entry);
 		ir_graph       *callee     = curr_call->callee;
 		inline_irg_env *callee_env = (inline_irg_env*)get_irg_link(callee);
 		ir_entity      *ent        = get_irg_entity(callee);
 		mtp_additional_properties props
 			= get_entity_additional_properties(ent);
-		if (!(props & mtp_property_always_inline)
-		    && env->n_nodes + callee_env->n_nodes > maxsize) {
+		bool always_inline = props & mtp_property_always_inline;
+		if (!always_inline && env->n_nodes + callee_env->n_nodes > maxsize) {
 			DB((dbg, LEVEL_2, "%+F: too big (%d) + %+F (%d)\n", irg,
 			    env->n_nodes, callee, callee_env->n_nodes));
 			continue;
 		}
+		if (!always_inline && callee_env->n_nodes > *growth_budget) {
+			DB((dbg, LEVEL_2, "%+F: growth budget (%u) exceeded by %+F (%d)\n",
+			    irg, *growth_budget, callee, callee_env->n_nodes));
+			continue;
+		}
 
-		ir_graph *calleee = pmap_get(ir_graph, copied_graphs, callee);
-		if (calleee != NULL) {
-			int benefice = curr_call->benefice;
+		if (callee_env->recursive) {
 			/*
 			 * Reduce the weight for recursive function IFF not all arguments
 			 * are constant. Inlining recursive functions is rarely good.
 			 */
+			int benefice = curr_call->benefice;
 			if (!curr_call->all_const)
 				benefice -= 2000;
 			if (benefice < inline_threshold)
 				continue;
+		}
 
-			/*
-			 * Remap callee if we have a copy.
-			 */
+		/* the body check only depends on the callee, cache it */
+		if (!callee_env->body_checked) {
+			callee_env->body_checked   = 1;
+			callee_env->body_inlinable = can_inline_graph(callee);
+		}
+		if (!callee_env->body_inlinable)
+			continue;
+
+		/*
+		 * Remap callee if we have a copy.
+		 */
+		ir_graph *calleee = pmap_get(ir_graph, copied_graphs, callee);
+		if (calleee != NULL) {
 			callee     = calleee;
 			callee_env = (inline_irg_env*)get_irg_link(callee);
 		}
@@ -1127,17 +1273,6 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			 * walk the graph and change it. So we have to make a copy of
 			 * the graph first.
 			 */
-			int benefice = curr_call->benefice;
-
-			/*
-			 * Reduce the weight for recursive function IFF not all arguments
-			 * are constant. Inlining recursive functions is rarely good.
-			 */
-			if (!curr_call->all_const)
-				benefice -= 2000;
-			if (benefice < inline_threshold)
-				continue;
-
 			ir_free_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 
 			/*
@@ -1153,11 +1288,11 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
 
 			/* allocate a new environment */
-			callee_env = alloc_inline_irg_env();
-			set_irg_link(copy, callee_env);
+			inline_irg_env *copy_env = alloc_inline_irg_env();
+			set_irg_link(copy, copy_env);
 
 			assure_irg_properties(copy, IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
-			wenv_t wenv = { .x = callee_env, .ignore_callers = true };
+			wenv_t wenv = { .x = copy_env, .ignore_callers = true };
 			irg_walk_graph(copy, NULL, collect_calls2, &wenv);
 
 			/*
@@ -1168,25 +1303,31 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			set_irg_entity(copy, get_irg_entity(callee));
 
 			pmap_insert(copied_graphs, callee, copy);
-			callee = copy;
+			callee     = copy;
+			callee_env = copy_env;
 
 			/* we have only one caller: the original graph */
 			callee_env->n_callers      = 1;
 			callee_env->n_callers_orig = 1;
+			callee_env->recursive      = 1;
+			callee_env->body_checked   = 1;
+			callee_env->body_inlinable = 1;
 		}
 		if (!phiproj_computed) {
 			phiproj_computed = true;
 			collect_phiprojs_and_start_block_nodes(current_ir_graph);
 		}
 		ir_reserve_resources(callee, IR_RESOURCE_IRN_LINK);
-		bool did_inline = inline_method(curr_call->call, callee);
+		unsigned first_idx  = get_irg_last_idx(irg);
+		bool     did_inline = inline_method(curr_call->call, callee);
 		if (!did_inline) {
 			ir_free_resources(callee, IR_RESOURCE_IRN_LINK);
 			continue;
 		}
 
-		/* call was inlined, Phi/Projs for current graph must be recomputed */
-		phiproj_computed = false;
+		/* call was inlined, only the new nodes must be added to the Phi/Proj
+		 * lists of the current graph */
+		collect_new_phiprojs(irg, first_idx);
 
 		/* remove it from the caller list */
 		list_del(&curr_call->list);
@@ -1201,8 +1342,10 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			inline_irg_env *penv = (inline_irg_env*)get_irg_link(centry->callee);
 
 			/* after we have inlined callee, all called methods inside
-			 * callee are now called once more */
-			++penv->n_callers;
+			 * callee are now called once more.  Queued calls to a former
+			 * single-caller function lose their bonus. */
+			if (++penv->n_callers == 2)
+				requeue_calls_to(&queue, env, centry->callee, inline_threshold);
 
 			/* Note that the src list points to Call nodes in the inlined graph,
 			 * but we need Call nodes in our graph. Luckily the inliner leaves
@@ -1220,39 +1363,47 @@ static void inline_into(ir_graph *irg, unsigned maxsize,
 			call_entry *new_entry
 				= duplicate_call_entry(centry, new_call, loop_depth);
 			list_add_tail(&new_entry->list, &env->calls);
-			maybe_push_call(pqueue, new_entry, inline_threshold);
+			maybe_push_call(&queue, new_entry, inline_threshold);
 		}
 		ir_free_resources(callee, IR_RESOURCE_IRN_LINK);
 
-		env->n_call_nodes += callee_env->n_call_nodes;
-		env->n_nodes += callee_env->n_nodes;
+		/* update the summary of the current graph: its callers see the
+		 * inlined size, the local weights must be recomputed */
+		env->n_call_nodes  += callee_env->n_call_nodes;
+		env->n_nodes       += callee_env->n_nodes;
+		env->n_blocks      += callee_env->n_blocks;
+		env->local_weights  = NULL;
+		*growth_budget     -= MIN(*growth_budget, callee_env->n_nodes);
 		--callee_env->n_callers;
 	}
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK|IR_RESOURCE_PHI_LIST);
-	del_pqueue(pqueue);
+	heap_free(&queue);
 }
 
 /*
- * Heuristic inliner. Calculates a benefice value for every call and inlines
- * those calls with a value higher than the threshold.
+ * Summary-based bottom-up inliner.  The graphs are processed per strongly
+ * connected component of the call graph, callees first, so every callee has
+ * its final size when the benefice of a call to it is calculated.
  */
-void inline_functions(unsigned maxsize, int inline_threshold,
-                      opt_ptr after_inline_opt)
+void inline_functions_budget(unsigned maxsize, int inline_threshold,
+                             unsigned max_growth, opt_ptr after_inline_opt)
 {
+	pass_stats_begin(NULL, "inline_functions_budget");
+
 	ir_graph *rem = current_ir_graph;
 	obstack_init(&temp_obst);
 
+	/* extend all irgs by a temporary data structure for inlining. */
+	foreach_irp_irg(i, irg)
+		set_irg_link(irg, alloc_inline_irg_env());
+
 	ir_graph **irgs = create_irg_list();
 
 	/* a map for the copied graphs, used to inline recursive calls */
 	pmap *copied_graphs = pmap_create();
 
-	/* extend all irgs by a temporary data structure for inlining. */
-	size_t n_irgs = get_irp_n_irgs();
-	for (size_t i = 0; i < n_irgs; ++i)
-		set_irg_link(irgs[i], alloc_inline_irg_env());
-
 	/* Precompute information in temporary data structure. */
+	size_t n_irgs = get_irp_n_irgs();
 	wenv_t wenv;
 	wenv.ignore_callers = false;
 	for (size_t i = 0; i < n_irgs; ++i) {
@@ -1266,10 +1417,14 @@ void inline_functions(unsigned maxsize, int inline_threshold,
 	}
 
 	/* -- and now inline. -- */
+	unsigned growth_budget = max_growth;
 	for (size_t i = 0; i < n_irgs; ++i) {
 		ir_graph *irg = irgs[i];
-		inline_into(irg, maxsize, inline_threshold, copied_graphs);
+		inline_into(irg, maxsize, inline_threshold, &growth_budget,
+		            copied_graphs);
 	}
+	DB((dbg, LEVEL_1, "used %u of %u growth budget nodes\n",
+	    max_growth - growth_budget, max_growth));
 
 	for (size_t i = 0; i < n_irgs; ++i) {
 		ir_graph *irg = irgs[i];
@@ -1301,6 +1456,21 @@ void inline_functions(unsigned maxsize, int inline_threshold,
 
 	obstack_free(&temp_obst, NULL);
 	current_ir_graph = rem;
+
+	pass_stats_end(NULL);
+}
+
+/*
+ * Heuristic inliner. Calculates a benefice value for every call and inlines
+ * those calls with a value higher than the threshold.
+ */
+void inline_functions(unsigned maxsize, int inline_threshold,
+                      opt_ptr after_inline_opt)
+{
+	pass_stats_begin(NULL, "inline_functions");
+	inline_functions_budget(maxsize, inline_threshold, UINT_MAX,
+	                        after_inline_opt);
+	pass_stats_end(NULL);
 }
 
 void firm_init_inline(void)
@@ -25,6 +25,7 @@
 #include "iroptimize.h"
 #include "irouts_t.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "raw_bitset.h"
 #include "type_t.h"
 #include "util.h"
@@ -79,6 +80,14 @@ struct memop_t {
 	ir_node  *projs[MAX_PROJ+1]; /**< Projs of this memory op */
 };
 
+/**
+ * A cached Phi-translation of an anticipated memop.
+ */
+typedef struct trans_result_t {
+	unsigned id;  /**< address id of the anticipated memop in the successor */
+	memop_t  *op; /**< the translated memop */
+} trans_result_t;
+
 /**
  * Additional data for every basic block.
  */
@@ -86,15 +95,13 @@ typedef struct block_t block_t;
 struct block_t {
 	memop_t  *memop_forward;     /**< topologically sorted list of memory ops in this block */
 	memop_t  *memop_backward;    /**< last memop in the list */
-	unsigned *avail_out;         /**< out-set of available addresses */
-	memop_t  **id_2_memop_avail; /**< maps avail address ids to memops */
-	unsigned *anticL_in;         /**< in-set of anticipated Load addresses */
-	memop_t  **id_2_memop_antic; /**< maps anticipated address ids to memops */
+	memop_t  **avail_out;        /**< out-set of available memops, sorted by address id */
+	memop_t  **anticL_in;        /**< in-set of anticipated Load memops, sorted by address id */
 	ir_node  *block;             /**< the associated block */
 	block_t  *forward_next;      /**< next block entry for forward iteration */
 	block_t  *backward_next;     /**< next block entry for backward iteration */
 	memop_t  *avail;             /**< used locally for the avail map */
-	memop_t  **trans_results;    /**< used to cached translated nodes due antic calculation. */
+	trans_result_t *trans_results; /**< used to cached translated nodes due antic calculation, sorted by id. */
 };
 
 /**
@@ -336,9 +343,7 @@ static void prepare_blocks(ir_node *irn, void *ctx)
 		entry->memop_forward    = NULL;
 		entry->memop_backward   = NULL;
 		entry->avail_out        = NULL;
-		entry->id_2_memop_avail = NULL;
 		entry->anticL_in        = NULL;
-		entry->id_2_memop_antic = NULL;
 		entry->block            = irn;
 		entry->forward_next     = NULL;
 		entry->backward_next    = NULL;
@@ -875,6 +880,48 @@ static memop_t *find_address(const value_t *value)
 	return NULL;
 }
 
+/**
+ * Find the position of an address id in a memop set.
+ *
+ * @param set  the memop set, sorted by address id
+ * @param id   the address id
+ *
+ * @return the position of the memop for id or the position
+ *         where it would have to be inserted
+ */
+static size_t find_memop_pos(memop_t *const *set, unsigned id)
+{
+	size_t lo = 0;
+	size_t hi = ARR_LEN(set);
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+
+		if (set[mid]->value.id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * Find the memop for an address id in a memop set.
+ *
+ * @param set  the memop set, sorted by address id
+ * @param id   the address id
+ *
+ * @return the memop or NULL if the id is not in the set
+ */
+static memop_t *find_memop(memop_t *const *set, unsigned id)
+{
+	size_t pos = find_memop_pos(set, id);
+
+	if (pos < ARR_LEN(set) && set[pos]->value.id == id)
+		return set[pos];
+	return NULL;
+}
+
 /**
  * Find an address in the avail_out set.
  *
@@ -882,8 +929,9 @@ static memop_t *find_address(const value_t *value)
  */
 static memop_t *find_address_avail(const block_t *bl, unsigned id, const ir_mode *mode)
 {
-	if (rbitset_is_set(bl->avail_out, id)) {
-		memop_t *res = bl->id_2_memop_avail[id];
+	memop_t *res = find_memop(bl->avail_out, id);
+
+	if (res != NULL) {
 
 		if (res->value.mode == mode)
 			return res;
@@ -955,8 +1003,109 @@ static void add_memop(memop_t *op)
  */
 static void add_memop_avail(block_t *bl, memop_t *op)
 {
-	rbitset_set(bl->avail_out, op->value.id);
-	bl->id_2_memop_avail[op->value.id] = op;
+	size_t pos = find_memop_pos(bl->avail_out, op->value.id);
+	size_t len = ARR_LEN(bl->avail_out);
+
+	if (pos == len || bl->avail_out[pos]->value.id != op->value.id) {
+		ARR_RESIZE(memop_t*, bl->avail_out, len + 1);
+		memmove(&bl->avail_out[pos + 1], &bl->avail_out[pos],
+		        (len - pos) * sizeof(bl->avail_out[0]));
+	}
+	bl->avail_out[pos] = op;
+}
+
+/**
+ * Find the position of an address id in a Phi-translation cache.
+ *
+ * @param results  the cache, sorted by address id
+ * @param id       the address id
+ *
+ * @return the position of the entry for id or the position
+ *         where it would have to be inserted
+ */
+static size_t find_trans_result_pos(const trans_result_t *results, unsigned id)
+{
+	size_t lo = 0;
+	size_t hi = ARR_LEN(results);
+
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+
+		if (results[mid].id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/**
+ * Make a memop set of a block the current set.
+ *
+ * @param set  the memop set
+ */
+static void load_curr_set(memop_t *const *set)
+{
+	kill_all();
+	for (size_t i = 0, n = ARR_LEN(set); i < n; ++i)
+		add_memop(set[i]);
+}
+
+/**
+ * Intersect the current set with a memop set of a block.
+ *
+ * @param set  the memop set, sorted by address id
+ */
+static void and_curr_set(memop_t *const *set)
+{
+	size_t end = env.rbs_size - 1;
+	size_t n   = ARR_LEN(set);
+	size_t i   = 0;
+	size_t pos;
+
+	for (pos = rbitset_next(env.curr_set, 0, 1); pos < end; pos = rbitset_next(env.curr_set, pos + 1, 1)) {
+		while (i < n && set[i]->value.id < pos)
+			++i;
+		if (i == n || set[i]->value.id != pos)
+			rbitset_clear(env.curr_set, pos);
+	}
+}
+
+/**
+ * Store the current set into a memop set of a block.
+ *
+ * @param set  the memop set
+ *
+ * @return non-zero if the set of addresses has changed
+ */
+static int store_curr_set(memop_t ***set)
+{
+	memop_t **res     = *set;
+	size_t    len     = ARR_LEN(res);
+	size_t    end     = env.rbs_size - 1;
+	size_t    n       = 0;
+	int       changed = 0;
+	size_t    pos;
+
+	for (pos = rbitset_next(env.curr_set, 0, 1); pos < end; pos = rbitset_next(env.curr_set, pos + 1, 1)) {
+		memop_t *op = env.curr_id_2_memop[pos];
+
+		if (n < len) {
+			if (res[n]->value.id != pos)
+				changed = 1;
+			res[n] = op;
+		} else {
+			ARR_APP1(memop_t*, res, op);
+			changed = 1;
+		}
+		++n;
+	}
+	if (n < len) {
+		ARR_SHRINKLEN(res, n);
+		changed = 1;
+	}
+	*set = res;
+	return changed;
 }
 
 /**
@@ -1116,10 +1265,10 @@ static void calc_gen_kill_avail(block_t *bl)
 static void forward_avail(block_t *bl)
 {
 	/* fill the data from the current block */
-	env.curr_id_2_memop = bl->id_2_memop_avail;
-	env.curr_set        = bl->avail_out;
+	kill_all();
 
 	calc_gen_kill_avail(bl);
+	store_curr_set(&bl->avail_out);
 	dump_curr(bl, "Avail_out");
 }
 
@@ -1141,32 +1290,34 @@ static int backward_antic(block_t *bl)
 		int       pred_pos;
 		ir_node  *succ     = get_Block_cfg_out_ex(block, 0, &pred_pos);
 		block_t  *succ_bl  = get_block_entry(succ);
-		size_t    end      = env.rbs_size - 1;
-		size_t    pos;
+		size_t    j, n_antic;
 
 		kill_all();
 
 		if (bl->trans_results == NULL) {
 			/* allocate the translate cache */
-			bl->trans_results = OALLOCNZ(&env.obst, memop_t*, env.curr_adr_id);
+			bl->trans_results = NEW_ARR_F(trans_result_t, 0);
 		}
 
 		/* check for partly redundant values */
-		for (pos = rbitset_next(succ_bl->anticL_in, 0, 1);
-		     pos < end;
-		     pos = rbitset_next(succ_bl->anticL_in, pos + 1, 1)) {
+		for (j = 0, n_antic = ARR_LEN(succ_bl->anticL_in); j < n_antic; ++j) {
+			unsigned pos = succ_bl->anticL_in[j]->value.id;
 			/*
 			 * do Phi-translation here: Note that at this point the nodes are
 			 * not changed, so we can safely cache the results.
 			 * However: Loads of Load results ARE bad, because we have no way
 			  to translate them yet ...
 			 */
-			memop_t *op = bl->trans_results[pos];
+			size_t   t_pos = find_trans_result_pos(bl->trans_results, pos);
+			size_t   t_len = ARR_LEN(bl->trans_results);
+			memop_t *op    = NULL;
+			if (t_pos < t_len && bl->trans_results[t_pos].id == pos)
+				op = bl->trans_results[t_pos].op;
 			if (op == NULL) {
 				/* not yet translated */
 				ir_node *adr, *trans_adr;
 
-				op  = succ_bl->id_2_memop_antic[pos];
+				op  = succ_bl->anticL_in[j];
 				adr = op->value.address;
 
 				trans_adr = phi_translate(adr, succ, pred_pos);
@@ -1182,7 +1333,11 @@ static int backward_antic(block_t *bl)
 					new_op->node          = op->node; /* we need the node to decide if Load/Store */
 					new_op->flags         = op->flags;
 
-					bl->trans_results[pos] = new_op;
+					ARR_RESIZE(trans_result_t, bl->trans_results, t_len + 1);
+					memmove(&bl->trans_results[t_pos + 1], &bl->trans_results[t_pos],
+					        (t_len - t_pos) * sizeof(bl->trans_results[0]));
+					bl->trans_results[t_pos].id = pos;
+					bl->trans_results[t_pos].op = new_op;
 					op = new_op;
 				}
 			}
@@ -1194,15 +1349,14 @@ static int backward_antic(block_t *bl)
 		block_t *succ_bl = get_block_entry(succ);
 		int i;
 
-		rbitset_copy(env.curr_set, succ_bl->anticL_in, env.rbs_size);
-		MEMCPY(env.curr_id_2_memop, succ_bl->id_2_memop_antic, env.rbs_size);
+		load_curr_set(succ_bl->anticL_in);
 
 		/* Hmm: probably we want kill merges of Loads ans Stores here */
 		for (i = n - 1; i > 0; --i) {
 			ir_node *succ    = get_Block_cfg_out(bl->block, i);
 			block_t *succ_bl = get_block_entry(succ);
 
-			rbitset_and(env.curr_set, succ_bl->anticL_in, env.rbs_size);
+			and_curr_set(succ_bl->anticL_in);
 		}
 	} else {
 		/* block ends with a noreturn call */
@@ -1237,10 +1391,8 @@ static int backward_antic(block_t *bl)
 		}
 	}
 
-	MEMCPY(bl->id_2_memop_antic, env.curr_id_2_memop, env.rbs_size);
-	if (! rbitsets_equal(bl->anticL_in, env.curr_set, env.rbs_size)) {
+	if (store_curr_set(&bl->anticL_in)) {
 		/* changed */
-		rbitset_copy(bl->anticL_in, env.curr_set, env.rbs_size);
 		dump_curr(bl, "AnticL_in*");
 		return 1;
 	}
@@ -1353,9 +1505,7 @@ static void do_replacements(block_t *bl)
  */
 static void calcAvail(void)
 {
-	memop_t  **tmp_memop = env.curr_id_2_memop;
-	unsigned *tmp_set    = env.curr_set;
-	block_t  *bl;
+	block_t *bl;
 
 	/* calculate avail_out */
 	DB((dbg, LEVEL_2, "Calculate Avail_out\n"));
@@ -1364,10 +1514,6 @@ static void calcAvail(void)
 	for (bl = env.forward->forward_next; bl != NULL; bl = bl->forward_next) {
 		forward_avail(bl);
 	}
-
-	/* restore the current sets */
-	env.curr_id_2_memop = tmp_memop;
-	env.curr_set        = tmp_set;
 }
 
 /**
@@ -1482,6 +1628,7 @@ static int insert_Load(block_t *bl)
 	ir_node  *block = bl->block;
 	int      i, n = get_Block_n_cfgpreds(block);
 	size_t   end = env.rbs_size - 1;
+	size_t   pos;
 
 	DB((dbg, LEVEL_3, "processing %+F\n", block));
 
@@ -1492,9 +1639,6 @@ static int insert_Load(block_t *bl)
 
 	if (n > 1) {
 		ir_node **ins = ALLOCAN(ir_node*, n);
-		size_t    pos;
-
-		rbitset_set_all(env.curr_set, env.rbs_size);
 
 		/* More than one predecessors, calculate the join for all avail_outs ignoring unevaluated
 		   Blocks. These put in Top anyway. */
@@ -1504,7 +1648,10 @@ static int insert_Load(block_t *bl)
 			block_t *pred_bl;
 
 			pred_bl = get_block_entry(blk);
-			rbitset_and(env.curr_set, pred_bl->avail_out, env.rbs_size);
+			if (i == n - 1)
+				load_curr_set(pred_bl->avail_out);
+			else
+				and_curr_set(pred_bl->avail_out);
 
 			if (is_Load(pred) || is_Store(pred)) {
 				/* We reached this block by an exception from a Load or Store:
@@ -1516,56 +1663,51 @@ static int insert_Load(block_t *bl)
 
 		}
 		/*
-		 * Ensure that all values are in the map: build Phi's if necessary:
-		 * Note: the last bit is the sentinel and ALWAYS set, so end with -2.
+		 * Ensure that all values are in the map: build Phi's if necessary.
 		 */
-		for (pos = 0; pos < env.rbs_size - 1; ++pos) {
-			if (!rbitset_is_set(env.curr_set, pos)) {
-				env.curr_id_2_memop[pos] = NULL;
-			} else {
-				int      need_phi = 0;
-				memop_t *first    = NULL;
-				ir_mode *mode     = NULL;
-
-				for (i = 0; i < n; ++i) {
-					ir_node *pred    = get_Block_cfgpred_block(bl->block, i);
-					block_t *pred_bl = get_block_entry(pred);
+		for (pos = rbitset_next(env.curr_set, 0, 1); pos < end; pos = rbitset_next(env.curr_set, pos + 1, 1)) {
+			int      need_phi = 0;
+			memop_t *first    = NULL;
+			ir_mode *mode     = NULL;
+
+			for (i = 0; i < n; ++i) {
+				ir_node *pred    = get_Block_cfgpred_block(bl->block, i);
+				block_t *pred_bl = get_block_entry(pred);
 
-					memop_t *mop = pred_bl->id_2_memop_avail[pos];
-					if (first == NULL) {
-						first = mop;
-						ins[0] = first->value.value;
-						mode = get_irn_mode(ins[0]);
-
-						/* no Phi needed so far */
-						env.curr_id_2_memop[pos] = first;
-					} else {
-						ins[i] = conv_to(mop->value.value, mode);
-						if (ins[i] != ins[0]) {
-							if (ins[i] == NULL) {
-								/* conversion failed */
-								env.curr_id_2_memop[pos] = NULL;
-								rbitset_clear(env.curr_set, pos);
-								break;
-							}
-							need_phi = 1;
+				memop_t *mop = find_memop(pred_bl->avail_out, pos);
+				if (first == NULL) {
+					first = mop;
+					ins[0] = first->value.value;
+					mode = get_irn_mode(ins[0]);
+
+					/* no Phi needed so far */
+					env.curr_id_2_memop[pos] = first;
+				} else {
+					ins[i] = conv_to(mop->value.value, mode);
+					if (ins[i] != ins[0]) {
+						if (ins[i] == NULL) {
+							/* conversion failed */
+							env.curr_id_2_memop[pos] = NULL;
+							rbitset_clear(env.curr_set, pos);
+							break;
 						}
+						need_phi = 1;
 					}
 				}
-				if (need_phi) {
-					/* build a Phi  */
-					ir_node *phi = new_r_Phi(bl->block, n, ins, mode);
-					memop_t *phiop = alloc_memop(phi);
+			}
+			if (need_phi) {
+				/* build a Phi  */
+				ir_node *phi = new_r_Phi(bl->block, n, ins, mode);
+				memop_t *phiop = alloc_memop(phi);
 
-					phiop->value = first->value;
-					phiop->value.value = phi;
+				phiop->value = first->value;
+				phiop->value.value = phi;
 
-					/* no need to link it in, as it is a DATA phi */
+				/* no need to link it in, as it is a DATA phi */
 
-					env.curr_id_2_memop[pos] = phiop;
+				env.curr_id_2_memop[pos] = phiop;
 
-					DB((dbg, LEVEL_3, "Created new %+F on merging value for address %+F\n", phi, first->value.address));
-				}
+				DB((dbg, LEVEL_3, "Created new %+F on merging value for address %+F\n", phi, first->value.address));
 			}
 		}
 	} else {
@@ -1573,20 +1715,18 @@ static int insert_Load(block_t *bl)
 		ir_node *pred    = get_Block_cfgpred_block(bl->block, 0);
 		block_t *pred_bl = get_block_entry(pred);
 
-		rbitset_copy(env.curr_set, pred_bl->avail_out, env.rbs_size);
-
-		MEMCPY(env.curr_id_2_memop, pred_bl->id_2_memop_avail, env.rbs_size);
+		load_curr_set(pred_bl->avail_out);
 	}
 
 	if (n > 1) {
-		size_t pos;
+		size_t j, n_antic;
 
 		/* check for partly redundant values */
-		for (pos = rbitset_next(bl->anticL_in, 0, 1);
-		     pos < end;
-		     pos = rbitset_next(bl->anticL_in, pos + 1, 1)) {
-			memop_t *op = bl->id_2_memop_antic[pos];
+		for (j = 0, n_antic = ARR_LEN(bl->anticL_in); j < n_antic; ++j) {
+			memop_t *op = bl->anticL_in[j];
 			int     have_some, all_same;
+
+			pos = op->value.id;
 			ir_node *first;
 
 			if (rbitset_is_set(env.curr_set, pos)) {
@@ -1710,11 +1850,8 @@ static int insert_Load(block_t *bl)
 	calc_gen_kill_avail(bl);
 
 	/* always update the map after gen/kill, as values might have been changed due to RAR/WAR/WAW */
-	MEMCPY(bl->id_2_memop_avail, env.curr_id_2_memop, env.rbs_size);
-
-	if (!rbitsets_equal(bl->avail_out, env.curr_set, env.rbs_size)) {
+	if (store_curr_set(&bl->avail_out)) {
 		/* the avail set has changed */
-		rbitset_copy(bl->avail_out, env.curr_set, env.rbs_size);
 		dump_curr(bl, "Avail_out*");
 		return 1;
 	}
@@ -1751,6 +1888,8 @@ static void insert_Loads_upwards(void)
 
 void opt_ldst(ir_graph *irg)
 {
+	pass_stats_begin(irg, "opt_ldst");
+
 	block_t *bl;
 
 	FIRM_DBG_REGISTER(dbg, "firm.opt.ldst");
@@ -1784,7 +1923,7 @@ void opt_ldst(ir_graph *irg)
 	env.id_2_address  = NEW_ARR_F(ir_node *, 0);
 #endif
 
-	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK);
+	ir_reserve_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 
 	/* first step: allocate block entries. Note that some blocks might be
 	   unreachable here. Using the normal walk ensures that ALL blocks are initialized. */
@@ -1842,17 +1981,11 @@ void opt_ldst(ir_graph *irg)
 	rbitset_set(env.curr_set, env.rbs_size - 1);
 	env.curr_id_2_memop = NEW_ARR_DZ(memop_t*, &env.obst, env.rbs_size);
 
+	/* the block sets only hold their members, so they stay small even for
+	   many addresses in many blocks */
 	for (bl = env.forward; bl != NULL; bl = bl->forward_next) {
-		/* set sentinel bits */
-		bl->avail_out  = rbitset_obstack_alloc(&env.obst, env.rbs_size);
-		rbitset_set(bl->avail_out, env.rbs_size - 1);
-
-		bl->id_2_memop_avail = NEW_ARR_DZ(memop_t*, &env.obst, env.rbs_size);
-
-		bl->anticL_in  = rbitset_obstack_alloc(&env.obst, env.rbs_size);
-		rbitset_set(bl->anticL_in, env.rbs_size - 1);
-
-		bl->id_2_memop_antic = NEW_ARR_DZ(memop_t*, &env.obst, env.rbs_size);
+		bl->avail_out = NEW_ARR_F(memop_t*, 0);
+		bl->anticL_in = NEW_ARR_F(memop_t*, 0);
 	}
 
 	(void)dump_block_list;
@@ -1876,11 +2009,24 @@ no_changes:
 		confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_ALL);
 	}
 
-	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK);
+	for (bl = env.forward; bl != NULL; bl = bl->forward_next) {
+		if (bl->avail_out != NULL) {
+			DEL_ARR_F(bl->avail_out);
+			DEL_ARR_F(bl->anticL_in);
+		}
+	}
+	for (bl = env.backward; bl != NULL; bl = bl->backward_next) {
+		if (bl->trans_results != NULL)
+			DEL_ARR_F(bl->trans_results);
+	}
+
+	ir_free_resources(irg, IR_RESOURCE_IRN_LINK | IR_RESOURCE_BLOCK_MARK | IR_RESOURCE_PHI_LIST);
 	ir_nodehashmap_destroy(&env.adr_map);
 	obstack_free(&env.obst, NULL);
 
 #ifdef DEBUG_libfirm
 	DEL_ARR_F(env.id_2_address);
 #endif
+
+	pass_stats_end(irg);
 }
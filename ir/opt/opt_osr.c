@@ -30,6 +30,7 @@
 #include "irtools.h"
 #include "obst.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "pdeq.h"
 #include "set.h"
 #include "tv.h"
@@ -1184,6 +1185,8 @@ static void lftr(ir_graph *irg, iv_env *env)
 /* Remove any Phi cycles with only one real input. */
 void remove_phi_cycles(ir_graph *irg)
 {
+	pass_stats_begin(irg, "remove_phi_cycles");
+
 	assure_irg_properties(irg,
 		IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
 		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
@@ -1230,6 +1233,8 @@ void remove_phi_cycles(ir_graph *irg)
 	obstack_free(&env.obst, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+
+	pass_stats_end(irg);
 }
 
 /**
@@ -1301,6 +1306,8 @@ static void fix_adds_and_subs(ir_node *irn, void *ctx)
 /* Performs Operator Strength Reduction for the passed graph. */
 void opt_osr(ir_graph *irg, unsigned flags)
 {
+	pass_stats_begin(irg, "opt_osr");
+
 	FIRM_DBG_REGISTER(dbg, "firm.opt.osr");
 
 	assure_irg_properties(irg,
@@ -1355,4 +1362,6 @@ void opt_osr(ir_graph *irg, unsigned flags)
 	obstack_free(&env.obst, NULL);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+
+	pass_stats_end(irg);
 }
@@ -22,6 +22,7 @@
 #include "irnodeset.h"
 #include "iroptimize.h"
 #include "obst.h"
+#include "pass_stats_t.h"
 #include "type_t.h"
 
 typedef struct parallelize_info
@@ -494,6 +495,8 @@ static void eliminate_sync_edges(ir_graph *irg)
 
 void opt_parallelize_mem(ir_graph *irg)
 {
+	pass_stats_begin(irg, "opt_parallelize_mem");
+
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_OUT_EDGES
 	                           | IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE);
 	irg_walk_blkwise_dom_top_down(irg, NULL, walker, NULL);
@@ -501,4 +504,6 @@ void opt_parallelize_mem(ir_graph *irg)
 	eliminate_sync_edges(irg);
 	ir_free_resources(irg, IR_RESOURCE_IRN_LINK);
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+
+	pass_stats_end(irg);
 }
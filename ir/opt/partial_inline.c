@@ -0,0 +1,303 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Partial inlining of early-exit function prologues.
+ *
+ * Functions of the form
+ *
+ *   int f(args) { if (fast_path) return x; ...big slow path... }
+ *
+ * are too big to be inlined as a whole.  This pass splits them into a small
+ * entry region and an outlined copy of the function that is only called on
+ * the slow path:
+ *
+ *   int f(args)      { if (fast_path) return x; return f.cold(args); }
+ *   int f.cold(args) { if (fast_path) return x; ...big slow path... }
+ *
+ * The new f is small enough to be inlined by inline_functions(), so only the
+ * entry region ends up in the callers.  f.cold is a copy of the whole
+ * function, so the entry block is evaluated again on the slow path.  This
+ * is only done if the entry block has no side effects.
+ */
+#include "array.h"
+#include "debug.h"
+#include "entity_t.h"
+#include "execfreq.h"
+#include "ircons.h"
+#include "irgopt.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "irprog_t.h"
+#include "irtools.h"
+#include "pass_stats_t.h"
+#include "statev_t.h"
+#include "util.h"
+#include "xmalloc.h"
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef struct entry_env_t {
+	ir_node  *start_block; /**< the start block of the graph */
+	ir_node  *cond;        /**< the Cond ending the start block */
+	unsigned  n_nodes;     /**< number of nodes in the graph */
+	bool      impure;      /**< set if the start block has side effects */
+} entry_env_t;
+
+/**
+ * Walker: Marks all directly called graphs.
+ */
+static void mark_called(ir_node *node, void *data)
+{
+	bool *const called = (bool*)data;
+	if (!is_Call(node))
+		return;
+	ir_entity *const callee = get_Call_callee(node);
+	if (callee == NULL)
+		return;
+	ir_graph *const callee_irg = get_entity_linktime_irg(callee);
+	if (callee_irg != NULL)
+		called[get_irg_idx(callee_irg)] = true;
+}
+
+static bool is_counted(ir_node const *const node)
+{
+	return !is_Block(node) && !is_Proj(node);
+}
+
+/**
+ * Walker: Counts the nodes of the graph and inspects the start block.
+ */
+static void inspect_entry(ir_node *node, void *data)
+{
+	entry_env_t *const env = (entry_env_t*)data;
+	if (!is_counted(node))
+		return;
+	++env->n_nodes;
+	if (get_nodes_block(node) != env->start_block || is_Start(node))
+		return;
+
+	if (is_Cond(node))
+		env->cond = node;
+	/* the start block is executed again by the outlined function */
+	foreach_irn_in(node, i, pred) {
+		if (get_irn_mode(pred) == mode_M)
+			env->impure = true;
+	}
+}
+
+/**
+ * Walker: Counts the nodes in block visited blocks.  Constants are ignored,
+ * they are all placed in the start block.
+ */
+static void count_region(ir_node *node, void *data)
+{
+	unsigned *const n_nodes = (unsigned*)data;
+	if (is_counted(node) && !is_irn_start_block_placed(node)
+	    && Block_block_visited(get_nodes_block(node)))
+		++*n_nodes;
+}
+
+/**
+ * Returns the block reached by the Proj @p proj of a Cond, or NULL if it
+ * is not a unique block.
+ */
+static ir_node *get_target_block(ir_node const *const proj)
+{
+	if (get_irn_n_outs(proj) != 1)
+		return NULL;
+	ir_node *const block = get_irn_out(proj, 0);
+	return is_Block(block) ? block : NULL;
+}
+
+/**
+ * Marks the blocks reachable from the start block without entering
+ * @p cold_block and returns the number of nodes in them, or UINT_MAX if
+ * @p hot_block reaches @p cold_block.
+ */
+static unsigned get_entry_region_size(ir_graph *const irg,
+                                      ir_node *const start_block,
+                                      ir_node *const hot_block,
+                                      ir_node *const cold_block)
+{
+	inc_irg_block_visited(irg);
+	ir_node *const end_block = get_irg_end_block(irg);
+	mark_Block_block_visited(end_block);
+	mark_Block_block_visited(start_block);
+
+	ir_node **worklist = NEW_ARR_F(ir_node*, 0);
+	ARR_APP1(ir_node*, worklist, hot_block);
+	mark_Block_block_visited(hot_block);
+	bool separated = true;
+	while (ARR_LEN(worklist) > 0) {
+		ir_node *const block = worklist[ARR_LEN(worklist) - 1];
+		ARR_SHRINKLEN(worklist, ARR_LEN(worklist) - 1);
+		for (unsigned i = 0, n = get_Block_n_cfg_outs(block); i < n; ++i) {
+			ir_node *const succ = get_Block_cfg_out(block, i);
+			if (succ == cold_block) {
+				separated = false;
+				break;
+			}
+			if (Block_block_visited(succ))
+				continue;
+			mark_Block_block_visited(succ);
+			ARR_APP1(ir_node*, worklist, succ);
+		}
+	}
+	DEL_ARR_F(worklist);
+	if (!separated)
+		return UINT_MAX;
+
+	unsigned n_nodes = 0;
+	irg_walk_graph(irg, NULL, count_region, &n_nodes);
+	return n_nodes;
+}
+
+/**
+ * Returns true if the profile data or the estimated execution frequencies
+ * do not indicate that @p cold_proj is taken more often than @p hot_proj.
+ */
+static bool is_hot_edge(ir_node *const cond, ir_node *const hot_proj,
+                        ir_node *const cold_proj)
+{
+	switch (get_Cond_jmp_pred(cond)) {
+	case COND_JMP_PRED_TRUE:
+		return get_Proj_num(hot_proj) == pn_Cond_true;
+	case COND_JMP_PRED_FALSE:
+		return get_Proj_num(hot_proj) == pn_Cond_false;
+	case COND_JMP_PRED_NONE:
+		break;
+	}
+	return get_block_execfreq(get_target_block(hot_proj))
+	    >= get_block_execfreq(get_target_block(cold_proj));
+}
+
+/**
+ * Replaces the control flow edge @p cold_proj by a call to the outlined
+ * function @p cold_ent.  The code only reachable through this edge becomes
+ * unreachable.
+ */
+static void outline_cold_edge(ir_graph *const irg, ir_node *const cold_proj,
+                              ir_entity *const cold_ent)
+{
+	ir_node *const cold_block = get_target_block(cold_proj);
+	for (int i = 0, n = get_Block_n_cfgpreds(cold_block); i < n; ++i) {
+		if (get_Block_cfgpred(cold_block, i) == cold_proj)
+			set_Block_cfgpred(cold_block, i, new_r_Bad(irg, mode_X));
+	}
+
+	/* the start block has no side effects, so the memory is still the
+	 * initial one */
+	ir_node *const block = new_r_Block(irg, 1, &cold_proj);
+	ir_node *const mem   = get_irg_initial_mem(irg);
+	ir_node *const ret   = new_r_forwarding_call(block, mem, cold_ent,
+	                                             get_entity_type(cold_ent));
+
+	ir_node  *const end_block = get_irg_end_block(irg);
+	int       const n_end     = get_Block_n_cfgpreds(end_block);
+	ir_node **const end_in    = ALLOCAN(ir_node*, n_end + 1);
+	for (int i = 0; i < n_end; ++i)
+		end_in[i] = get_Block_cfgpred(end_block, i);
+	end_in[n_end] = ret;
+	set_irn_in(end_block, n_end + 1, end_in);
+
+	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_NONE);
+	remove_unreachable_code(irg);
+	remove_bads(irg);
+	opt_frame_irg(irg);
+}
+
+/**
+ * Splits @p irg into its entry region and an outlined copy if it has an
+ * early exit.
+ */
+static bool split_early_exit(ir_graph *const irg, unsigned const min_size,
+                             unsigned const max_entry_size)
+{
+	ir_entity *const ent   = get_irg_entity(irg);
+	mtp_additional_properties const props = get_entity_additional_properties(ent);
+	if ((props & (mtp_property_noinline | mtp_property_always_inline))
+	    || !has_register_signature(get_entity_type(ent)))
+		return false;
+
+	entry_env_t env = {
+		.start_block = get_irg_start_block(irg),
+		.cond        = NULL,
+		.n_nodes     = 0,
+		.impure      = false,
+	};
+	irg_walk_graph(irg, NULL, inspect_entry, &env);
+	if (env.cond == NULL || env.impure || env.n_nodes < min_size)
+		return false;
+
+	assure_irg_outs(irg);
+	ir_node *projs[2] = { NULL, NULL };
+	foreach_irn_out_r(env.cond, i, proj) {
+		projs[get_Proj_num(proj) == pn_Cond_true] = proj;
+	}
+	if (projs[0] == NULL || projs[1] == NULL)
+		return false;
+	ir_node *const blocks[2] = {
+		get_target_block(projs[0]), get_target_block(projs[1])
+	};
+	if (blocks[0] == NULL || blocks[1] == NULL || blocks[0] == blocks[1])
+		return false;
+
+	ir_estimate_execfreq(irg);
+	for (unsigned h = 0; h < 2; ++h) {
+		unsigned const c = 1 - h;
+		if (!is_hot_edge(env.cond, projs[h], projs[c]))
+			continue;
+		unsigned const entry_size
+			= get_entry_region_size(irg, env.start_block, blocks[h], blocks[c]);
+		if (entry_size > max_entry_size || 2 * entry_size > env.n_nodes)
+			continue;
+
+		DB((dbg, LEVEL_1, "%+F: outlining %+F (%u of %u nodes stay)\n",
+		    irg, blocks[c], entry_size, env.n_nodes));
+		ident     *const tag      = new_id_fmt("%s.cold", get_entity_name(ent));
+		ident     *const name     = id_unique(get_id_str(tag));
+		ir_entity *const cold_ent = clone_entity(ent, name, get_entity_owner(ent));
+		set_entity_visibility(cold_ent, ir_visibility_local);
+		add_entity_additional_properties(cold_ent, mtp_property_noinline);
+		create_irg_clone(irg, cold_ent);
+
+		outline_cold_edge(irg, projs[c], cold_ent);
+		return true;
+	}
+	return false;
+}
+
+unsigned partial_inline(unsigned min_size, unsigned max_entry_size)
+{
+	pass_stats_begin(NULL, "partial_inline");
+
+	FIRM_DBG_REGISTER(dbg, "firm.opt.partial_inline");
+
+	/* only split functions that are called directly */
+	bool *const called = XMALLOCNZ(bool, get_irp_last_idx());
+	foreach_irp_irg(i, irg) {
+		irg_walk_graph(irg, NULL, mark_called, called);
+	}
+
+	/* the outlined copies are appended to the graph list, do not visit them */
+	unsigned n_split = 0;
+	for (size_t i = 0, n_irgs = get_irp_n_irgs(); i < n_irgs; ++i) {
+		ir_graph *const irg = get_irp_irg(i);
+		if (called[get_irg_idx(irg)]
+		    && split_early_exit(irg, min_size, max_entry_size))
+			++n_split;
+	}
+	free(called);
+
+	stat_ev_ull("partial_inline_split", n_split);
+
+	pass_stats_end(NULL);
+	return n_split;
+}
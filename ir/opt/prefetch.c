@@ -0,0 +1,402 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief   Software prefetching for strided accesses in loops.
+ *
+ * Loads and Stores in innermost loops whose address is an affine function of
+ * the induction variables advance by a constant stride in every iteration,
+ * e.g. the pointer induction variables created by opt_osr().  Such accesses
+ * are preceded by a prefetch of the address they will access a few iterations
+ * later:
+ *
+ *   for (p = a; p != e; ++p) s += *p;
+ *   =>
+ *   for (p = a; p != e; ++p) { __builtin_prefetch(p + d); s += *p; }
+ *
+ * Accesses with the same stride into the same cache line share a prefetch.
+ * Loops whose trip count is known to be small are skipped.  Streams which
+ * are known to exceed the caches are prefetched without temporal locality.
+ */
+#include "array.h"
+#include "debug.h"
+#include "induction.h"
+#include "ircons.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "irloop_t.h"
+#include "irnode_t.h"
+#include "iroptimize.h"
+#include "irouts_t.h"
+#include "pass_stats_t.h"
+#include "statev_t.h"
+#include "tv.h"
+#include "util.h"
+#include "xmalloc.h"
+#include <stdlib.h>
+
+/** Size of a cache line, accesses within one share a prefetch. */
+#define CACHE_LINE_SIZE     64
+/** Loops with a smaller known trip count are not prefetched. */
+#define MIN_TRIP_COUNT      64
+/** Streams covering more bytes than this are not cached for reuse. */
+#define STREAMING_FOOTPRINT (1 << 22)
+
+DEBUG_ONLY(static firm_dbg_module_t *dbg;)
+
+typedef struct loop_info_t {
+	ir_loop  *loop;
+	ir_node  *header;   /**< the only block entered from outside the loop */
+	ir_node **accesses; /**< the Loads and Stores of the loop */
+	ir_node **conds;    /**< the Conds of the loop */
+	iv_loop_t iv_loop;  /**< the loop for the induction variable analysis */
+} loop_info_t;
+
+typedef struct prefetch_t {
+	ir_node const *base;     /**< the address without constant offset */
+	long           base_off; /**< the constant offset to base */
+	long           stride;   /**< bytes the address advances per iteration */
+	ir_node       *access;   /**< the Load or Store which is prefetched */
+	long           ahead;    /**< bytes prefetched ahead of the access */
+	bool           write;    /**< the data is written */
+	bool           streaming; /**< the data is not reused */
+} prefetch_t;
+
+static bool in_info_loop(void const *const env, ir_node const *const block)
+{
+	loop_info_t const *const info = (loop_info_t const*)env;
+	return get_irn_loop(block) == info->loop;
+}
+
+/**
+ * Finds the only block of the loop with predecessors outside of the loop.
+ */
+static ir_node *find_header(loop_info_t const *const info)
+{
+	ir_node *header = NULL;
+	for (size_t i = 0, n = get_loop_n_elements(info->loop); i < n; ++i) {
+		loop_element const element = get_loop_element(info->loop, i);
+		if (*element.kind != k_ir_node)
+			continue;
+		ir_node *const block = element.node;
+		for (int p = 0, n_preds = get_Block_n_cfgpreds(block); p < n_preds; ++p) {
+			ir_node *const pred = get_Block_cfgpred_block(block, p);
+			if (get_irn_loop(pred) == info->loop)
+				continue;
+			if (header != NULL && header != block)
+				return NULL;
+			header = block;
+		}
+	}
+	return header;
+}
+
+static bool is_back_edge(loop_info_t const *const info, int const pos)
+{
+	return get_irn_loop(get_Block_cfgpred_block(info->header, pos)) == info->loop;
+}
+
+/**
+ * Returns the value of the header Phi @p phi when entering the loop if it is
+ * the same on all entry edges.
+ */
+static ir_node *get_entry_value(loop_info_t const *const info,
+                                ir_node const *const phi)
+{
+	ir_node *value = NULL;
+	for (int i = 0, n = get_Phi_n_preds(phi); i < n; ++i) {
+		if (is_back_edge(info, i))
+			continue;
+		ir_node *const pred = get_Phi_pred(phi, i);
+		if (value != NULL && pred != value)
+			return NULL;
+		value = pred;
+	}
+	return value;
+}
+
+/**
+ * Returns the value of @p node in the first iteration if it is a constant
+ * offset to an induction variable with a constant start value.
+ */
+static bool get_first_value(loop_info_t const *const info,
+                            ir_node const *const node, long *const value)
+{
+	long c;
+	if (is_Phi(node) && get_nodes_block(node) == info->header) {
+		ir_node const *const entry = get_entry_value(info, node);
+		return entry != NULL && get_const_long(entry, value);
+	} else if (is_Add(node) && get_const_long(get_Add_right(node), &c)) {
+		if (!get_first_value(info, get_Add_left(node), value))
+			return false;
+		*value += c;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Returns true if a successor of @p cond lies outside of the loop.
+ */
+static bool is_loop_exit(loop_info_t const *const info, ir_node const *const cond)
+{
+	foreach_irn_out_r(cond, i, proj) {
+		foreach_irn_out_r(proj, j, succ) {
+			if (is_Block(succ) && get_irn_loop(succ) != info->loop)
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Computes an upper bound of the trip count of the loop from exits comparing
+ * an induction variable with a constant.
+ */
+static bool get_trip_count(loop_info_t const *const info,
+                           unsigned long *const count)
+{
+	bool known = false;
+	for (size_t i = 0, n = ARR_LEN(info->conds); i < n; ++i) {
+		ir_node const *const cond = info->conds[i];
+		ir_node const *const cmp  = get_Cond_selector(cond);
+		if (!is_Cmp(cmp) || !is_loop_exit(info, cond))
+			continue;
+
+		ir_node const *iv    = get_Cmp_left(cmp);
+		ir_node const *bound = get_Cmp_right(cmp);
+		if (is_Const(iv)) {
+			ir_node const *const t = iv;
+			iv    = bound;
+			bound = t;
+		}
+		long first;
+		long last;
+		long step;
+		if (!get_const_long(bound, &last) || !get_first_value(info, iv, &first)
+		    || !get_affine_step(&info->iv_loop, iv, &step) || step == 0
+		    || (last > first) != (step > 0))
+			continue;
+
+		unsigned long const distance = last > first
+			? (unsigned long)last - (unsigned long)first
+			: (unsigned long)first - (unsigned long)last;
+		unsigned long const trips = distance / (unsigned long)labs(step) + 1;
+		if (!known || trips < *count)
+			*count = trips;
+		known = true;
+	}
+	return known;
+}
+
+/**
+ * Splits @p ptr into a base address and a constant offset.
+ */
+static ir_node const *get_stream_base(ir_node const *ptr, long *const offset)
+{
+	*offset = 0;
+	long c;
+	while (is_Add(ptr) && get_const_long(get_Add_right(ptr), &c)) {
+		*offset += c;
+		ptr      = get_Add_left(ptr);
+	}
+	return ptr;
+}
+
+/**
+ * Returns true if the access of @p pf is already covered by a prefetch in
+ * @p prefetches starting at @p first.
+ */
+static bool is_covered(prefetch_t const *const prefetches, size_t const first,
+                       prefetch_t const *const pf)
+{
+	for (size_t i = first, n = ARR_LEN(prefetches); i < n; ++i) {
+		prefetch_t const *const other = &prefetches[i];
+		if (other->base == pf->base && other->stride == pf->stride
+		    && labs(other->base_off - pf->base_off) < CACHE_LINE_SIZE)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Collects the prefetches for the accesses of a loop.
+ */
+static void analyze_loop(loop_info_t *const info, unsigned const distance,
+                         prefetch_t **const prefetches)
+{
+	info->header = find_header(info);
+	if (info->header == NULL)
+		return;
+	info->iv_loop = (iv_loop_t){
+		.header  = info->header,
+		.in_loop = in_info_loop,
+		.env     = info,
+	};
+
+	unsigned long count       = 0;
+	bool const    count_known = get_trip_count(info, &count);
+	if (count_known && count < MIN_TRIP_COUNT) {
+		DB((dbg, LEVEL_2, "%+F: trip count %lu too small\n", info->header, count));
+		return;
+	}
+
+	size_t const first = ARR_LEN(*prefetches);
+	for (size_t i = 0, n = ARR_LEN(info->accesses); i < n; ++i) {
+		ir_node *const access = info->accesses[i];
+		ir_node       *ptr;
+		bool           write;
+		if (is_Load(access)) {
+			if (get_Load_volatility(access) == volatility_is_volatile)
+				continue;
+			ptr   = get_Load_ptr(access);
+			write = false;
+		} else {
+			if (get_Store_volatility(access) == volatility_is_volatile)
+				continue;
+			ptr   = get_Store_ptr(access);
+			write = true;
+		}
+
+		long stride;
+		if (!get_affine_step(&info->iv_loop, ptr, &stride) || stride == 0)
+			continue;
+		unsigned long const abs_stride = labs(stride);
+		unsigned long       iterations = (distance + abs_stride - 1) / abs_stride;
+		if (iterations == 0)
+			iterations = 1;
+		if (count_known && iterations >= count)
+			continue;
+
+		prefetch_t pf = {
+			.stride    = stride,
+			.access    = access,
+			.ahead     = (long)iterations * stride,
+			.write     = write,
+			.streaming = count_known
+			          && count * abs_stride >= STREAMING_FOOTPRINT,
+		};
+		pf.base = get_stream_base(ptr, &pf.base_off);
+		if (is_covered(*prefetches, first, &pf))
+			continue;
+		DB((dbg, LEVEL_2, "%+F: prefetch %ld bytes ahead of %+F\n",
+		    info->header, pf.ahead, access));
+		ARR_APP1(prefetch_t, *prefetches, pf);
+	}
+}
+
+/**
+ * Creates a loop_info_t for each innermost loop in @p loop.
+ */
+static void collect_loops(ir_loop *const loop, loop_info_t ***const infos)
+{
+	bool innermost = true;
+	for (size_t i = 0, n = get_loop_n_elements(loop); i < n; ++i) {
+		loop_element const element = get_loop_element(loop, i);
+		if (*element.kind == k_ir_loop) {
+			collect_loops(element.son, infos);
+			innermost = false;
+		}
+	}
+
+	set_loop_link(loop, NULL);
+	if (!innermost || get_loop_depth(loop) == 0)
+		return;
+
+	loop_info_t *const info = XMALLOCZ(loop_info_t);
+	info->loop     = loop;
+	info->accesses = NEW_ARR_F(ir_node*, 0);
+	info->conds    = NEW_ARR_F(ir_node*, 0);
+	set_loop_link(loop, info);
+	ARR_APP1(loop_info_t*, *infos, info);
+}
+
+static void collect_nodes(ir_node *node, void *env)
+{
+	(void)env;
+	if (!is_Load(node) && !is_Store(node) && !is_Cond(node))
+		return;
+	ir_loop *const loop = get_irn_loop(get_nodes_block(node));
+	if (loop == NULL)
+		return;
+	loop_info_t *const info = (loop_info_t*)get_loop_link(loop);
+	if (info == NULL)
+		return;
+	if (is_Cond(node)) {
+		ARR_APP1(ir_node*, info->conds, node);
+	} else {
+		ARR_APP1(ir_node*, info->accesses, node);
+	}
+}
+
+/**
+ * Inserts the prefetch @p pf into the memory chain before its access.
+ */
+static void insert_prefetch(prefetch_t const *const pf)
+{
+	ir_node  *const access = pf->access;
+	ir_node  *const ptr    = is_Load(access) ? get_Load_ptr(access)
+	                                         : get_Store_ptr(access);
+	ir_graph *const irg    = get_irn_irg(access);
+	dbg_info *const dbgi   = get_irn_dbg_info(access);
+	ir_node  *const block  = get_nodes_block(access);
+	ir_mode  *const mode   = get_irn_mode(ptr);
+	ir_mode  *const omode  = get_reference_offset_mode(mode);
+	ir_node  *const ahead  = new_r_Const_long(irg, omode, pf->ahead);
+	ir_node  *const addr   = new_rd_Add(dbgi, block, ptr, ahead);
+	/* locality 0 prefetches without polluting the caches, 3 into all levels */
+	ir_node  *const in[]   = {
+		addr,
+		new_r_Const_long(irg, mode_Is, pf->write),
+		new_r_Const_long(irg, mode_Is, pf->streaming ? 0 : 3),
+	};
+	ir_node  *const mem      = get_memop_mem(access);
+	ir_node  *const prefetch = new_rd_Builtin(dbgi, block, mem, ARRAY_SIZE(in),
+	                                          in, ir_bk_prefetch,
+	                                          get_unknown_type());
+	set_memop_mem(access, new_r_Proj(prefetch, mode_M, pn_Builtin_M));
+}
+
+void opt_prefetch(ir_graph *irg, unsigned distance)
+{
+	pass_stats_begin(irg, "opt_prefetch");
+
+	FIRM_DBG_REGISTER(dbg, "firm.opt.prefetch");
+
+	assure_irg_properties(irg,
+		IR_GRAPH_PROPERTY_NO_BADS
+		| IR_GRAPH_PROPERTY_CONSISTENT_OUTS
+		| IR_GRAPH_PROPERTY_CONSISTENT_LOOPINFO);
+
+	loop_info_t **infos = NEW_ARR_F(loop_info_t*, 0);
+	collect_loops(get_irg_loop(irg), &infos);
+	if (ARR_LEN(infos) > 0)
+		irg_walk_graph(irg, NULL, collect_nodes, NULL);
+
+	/* analyze all loops before changing the graph, the transformation
+	 * invalidates the out edges */
+	prefetch_t *prefetches = NEW_ARR_F(prefetch_t, 0);
+	for (size_t i = 0, n = ARR_LEN(infos); i < n; ++i) {
+		loop_info_t *const info = infos[i];
+		analyze_loop(info, distance, &prefetches);
+		set_loop_link(info->loop, NULL);
+		DEL_ARR_F(info->accesses);
+		DEL_ARR_F(info->conds);
+		free(info);
+	}
+	DEL_ARR_F(infos);
+
+	size_t const n_prefetches = ARR_LEN(prefetches);
+	for (size_t i = 0; i < n_prefetches; ++i)
+		insert_prefetch(&prefetches[i]);
+	DEL_ARR_F(prefetches);
+
+	stat_ev_ull("prefetches", n_prefetches);
+	confirm_irg_properties(irg, n_prefetches == 0
+		? IR_GRAPH_PROPERTIES_ALL : IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+
+	pass_stats_end(irg);
+}
@@ -30,6 +30,7 @@
 #include "irprog_t.h"
 #include "irtools.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "set.h"
 #include "tv.h"
 
@@ -589,6 +590,8 @@ restart:
 
 void proc_cloning(float threshold)
 {
+	pass_stats_begin(NULL, "proc_cloning");
+
 	DEBUG_ONLY(firm_dbg_module_t *dbg;)
 
 	/* register a debug mask */
@@ -665,4 +668,6 @@ void proc_cloning(float threshold)
 		}
 	}
 	obstack_free(&hmap.obst, NULL);
+
+	pass_stats_end(NULL);
 }
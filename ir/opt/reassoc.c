@@ -28,6 +28,7 @@
 #include "irouts.h"
 #include "opt_init.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "pdeq.h"
 #include "unionfind.h"
 
@@ -2069,6 +2070,8 @@ static void do_chaining(ir_graph *irg)
  */
 void optimize_reassociation(ir_graph *irg)
 {
+	pass_stats_begin(irg, "optimize_reassociation");
+
 	assert(get_irg_pinned(irg) != op_pin_state_floats &&
 	       "Reassociation needs pinned graph to work properly");
 
@@ -2111,6 +2114,8 @@ void optimize_reassociation(ir_graph *irg)
 	deq_free(&wq);
 
 	confirm_irg_properties(irg, IR_GRAPH_PROPERTIES_CONTROL_FLOW);
+
+	pass_stats_end(irg);
 }
 
 void ir_register_reassoc_node_ops(void)
@@ -15,6 +15,7 @@
 #include "irgwalk.h"
 #include "irnode_t.h"
 #include "irtools.h"
+#include "pass_stats_t.h"
 #include <assert.h>
 
 /**
@@ -103,6 +104,8 @@ static void collect(ir_node *node, void *env)
 
 void remove_bads(ir_graph *irg)
 {
+	pass_stats_begin(irg, "remove_bads");
+
 	/* A block with only Bad predecessors would violate
 	 * the invariant that each block has at least one predecessor. */
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE);
@@ -132,4 +135,6 @@ void remove_bads(ir_graph *irg)
 			| IR_GRAPH_PROPERTY_CONSISTENT_ENTITY_USAGE);
 	}
 	add_irg_properties(irg, IR_GRAPH_PROPERTY_NO_BADS);
+
+	pass_stats_end(irg);
 }
@@ -22,6 +22,7 @@
 #include "irouts_t.h"
 #include "opt_init.h"
 #include "panic.h"
+#include "pass_stats_t.h"
 #include "pset.h"
 #include "set.h"
 #include "target_t.h"
@@ -562,6 +563,8 @@ static void do_scalar_replacements(ir_graph *irg, pset *members, unsigned nvals,
  */
 void scalar_replacement_opt(ir_graph *irg)
 {
+	pass_stats_begin(irg, "scalar_replacement_opt");
+
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE
 	                         | IR_GRAPH_PROPERTY_CONSISTENT_OUTS
 	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
@@ -640,6 +643,8 @@ void scalar_replacement_opt(ir_graph *irg)
 
 	confirm_irg_properties(irg, changed ? IR_GRAPH_PROPERTIES_NONE
 	                                    : IR_GRAPH_PROPERTIES_ALL);
+
+	pass_stats_end(irg);
 }
 
 void firm_init_scalar_replace(void)
@@ -15,6 +15,7 @@
 #include "irgopt.h"
 #include "irgwalk.h"
 #include "irnode_t.h"
+#include "pass_stats_t.h"
 #include <stdbool.h>
 
 static bool is_block_unreachable(ir_node *block)
@@ -94,6 +95,8 @@ static bool remove_unreachable_keeps(ir_graph *irg)
 
 void remove_unreachable_code(ir_graph *irg)
 {
+	pass_stats_begin(irg, "remove_unreachable_code");
+
 	assure_irg_properties(irg, IR_GRAPH_PROPERTY_CONSISTENT_DOMINANCE
 	                         | IR_GRAPH_PROPERTY_NO_TUPLES);
 
@@ -108,4 +111,6 @@ void remove_unreachable_code(ir_graph *irg)
 		| IR_GRAPH_PROPERTY_MANY_RETURNS
 		: IR_GRAPH_PROPERTIES_ALL);
 	add_irg_properties(irg, IR_GRAPH_PROPERTY_NO_UNREACHABLE_CODE);
+
+	pass_stats_end(irg);
 }
@@ -0,0 +1,241 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Time and memory accounting of optimization passes.
+ */
+#include "pass_stats_t.h"
+
+#include "array.h"
+#include "entity_t.h"
+#include "irgraph_t.h"
+#include "irgwalk.h"
+#include "obst.h"
+#include "panic.h"
+#include "util.h"
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define MAX_PASS_DEPTH 64
+
+/** One run of a pass. */
+typedef struct pass_run_t {
+	char const *name;
+	char const *irg_name;    /**< name of the graph or NULL */
+	uint64_t    start;       /**< start time in microseconds */
+	uint64_t    wall;        /**< wall clock time in microseconds */
+	uint64_t    cpu;         /**< CPU time in microseconds */
+	long        nodes_begin; /**< node count before the pass or -1 */
+	long        nodes_end;   /**< node count after the pass or -1 */
+	size_t      obst_peak;   /**< size of the node obstack */
+} pass_run_t;
+
+bool pass_stats_enabled;
+
+static pass_run_t *runs;
+static size_t      run_stack[MAX_PASS_DEPTH];
+static uint64_t    cpu_stack[MAX_PASS_DEPTH];
+static unsigned    depth;
+static uint64_t    epoch;
+
+static uint64_t wall_usec(void)
+{
+	struct timeval tval;
+	gettimeofday(&tval, NULL);
+	return (uint64_t)tval.tv_sec * 1000000 + (uint64_t)tval.tv_usec;
+}
+
+static uint64_t cpu_usec(void)
+{
+	return (uint64_t)clock() * 1000000 / CLOCKS_PER_SEC;
+}
+
+static void count_node(ir_node *node, void *env)
+{
+	(void)node;
+	++*(long*)env;
+}
+
+/** Counts the reachable nodes of a graph.  This walks the graph, so it is
+ * only done outside of other passes, which might use the visited flags. */
+static long count_nodes(ir_graph *const irg)
+{
+	if (irg == NULL || depth > 0)
+		return -1;
+	long n = 0;
+	irg_walk_graph(irg, count_node, NULL, &n);
+	return n;
+}
+
+static size_t get_obst_size(ir_graph *const irg)
+{
+	return irg != NULL ? (size_t)obstack_memory_used(&irg->obst) : 0;
+}
+
+void do_pass_stats_begin(ir_graph *const irg, char const *const name)
+{
+	if (depth >= MAX_PASS_DEPTH)
+		panic("passes nested too deeply");
+	if (runs == NULL)
+		runs = NEW_ARR_F(pass_run_t, 0);
+
+	long const nodes = count_nodes(irg);
+
+	pass_run_t run;
+	memset(&run, 0, sizeof(run));
+	run.name        = name;
+	run.irg_name    = irg != NULL ? get_entity_name(get_irg_entity(irg)) : NULL;
+	run.nodes_begin = nodes;
+	run.nodes_end   = -1;
+	run.obst_peak   = get_obst_size(irg);
+	ARR_APP1(pass_run_t, runs, run);
+
+	run_stack[depth] = ARR_LEN(runs) - 1;
+	cpu_stack[depth] = cpu_usec();
+	++depth;
+	/* take the start time last to exclude the bookkeeping */
+	runs[ARR_LEN(runs) - 1].start = wall_usec();
+}
+
+void do_pass_stats_end(ir_graph *const irg)
+{
+	/* statistics might have been enabled in the middle of a pass */
+	if (depth == 0)
+		return;
+
+	uint64_t const end     = wall_usec();
+	uint64_t const cpu_end = cpu_usec();
+	--depth;
+	pass_run_t *const run = &runs[run_stack[depth]];
+	run->wall      = end - run->start;
+	run->cpu       = cpu_end - cpu_stack[depth];
+	/* The node obstack only grows during a pass (dead node elimination
+	 * replaces it), so the larger of both sizes is its peak. */
+	run->obst_peak = MAX(run->obst_peak, get_obst_size(irg));
+	run->nodes_end = run->nodes_begin >= 0 ? count_nodes(irg) : -1;
+}
+
+void ir_pass_stats_enable(int const enable)
+{
+	pass_stats_enabled = enable;
+	if (enable && epoch == 0)
+		epoch = wall_usec();
+}
+
+void ir_pass_stats_reset(void)
+{
+	if (runs != NULL)
+		ARR_SHRINKLEN(runs, 0);
+	depth = 0;
+	epoch = wall_usec();
+}
+
+/** Accumulated statistics of a pass. */
+typedef struct pass_total_t {
+	char const *name;
+	char const *irg_name;
+	size_t      calls;
+	uint64_t    wall;
+	uint64_t    cpu;
+	long        node_delta;
+	size_t      obst_peak;
+} pass_total_t;
+
+static bool same_name(char const *const a, char const *const b)
+{
+	return a == b || (a != NULL && b != NULL && streq(a, b));
+}
+
+void ir_pass_stats_print(FILE *const out, int const per_graph)
+{
+	pass_total_t *totals = NEW_ARR_F(pass_total_t, 0);
+	size_t const  n_runs = runs != NULL ? ARR_LEN(runs) : 0;
+	for (size_t i = 0; i < n_runs; ++i) {
+		pass_run_t const *const run      = &runs[i];
+		char const       *const irg_name = per_graph ? run->irg_name : NULL;
+
+		pass_total_t *total = NULL;
+		for (size_t t = 0, n = ARR_LEN(totals); t < n; ++t) {
+			if (streq(totals[t].name, run->name)
+			    && same_name(totals[t].irg_name, irg_name)) {
+				total = &totals[t];
+				break;
+			}
+		}
+		if (total == NULL) {
+			pass_total_t const new_total = { .name = run->name, .irg_name = irg_name };
+			ARR_APP1(pass_total_t, totals, new_total);
+			total = &totals[ARR_LEN(totals) - 1];
+		}
+
+		++total->calls;
+		total->wall += run->wall;
+		total->cpu  += run->cpu;
+		if (run->nodes_begin >= 0 && run->nodes_end >= 0)
+			total->node_delta += run->nodes_end - run->nodes_begin;
+		total->obst_peak = MAX(total->obst_peak, run->obst_peak);
+	}
+
+	fprintf(out, "%-28s", "pass");
+	if (per_graph)
+		fprintf(out, " %-20s", "graph");
+	fprintf(out, " %6s %11s %11s %9s %12s\n", "calls", "wall[ms]", "cpu[ms]",
+	        "nodes+-", "obst[KiB]");
+	for (size_t t = 0, n = ARR_LEN(totals); t < n; ++t) {
+		pass_total_t const *const total = &totals[t];
+		fprintf(out, "%-28s", total->name);
+		if (per_graph)
+			fprintf(out, " %-20s", total->irg_name != NULL ? total->irg_name : "");
+		fprintf(out, " %6zu %11.3f %11.3f %9ld %12zu\n", total->calls,
+		        total->wall / 1000.0, total->cpu / 1000.0, total->node_delta,
+		        total->obst_peak / 1024);
+	}
+	DEL_ARR_F(totals);
+}
+
+static void print_json_string(FILE *const out, char const *const str)
+{
+	putc('"', out);
+	for (char const *c = str; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\')
+			putc('\\', out);
+		if ((unsigned char)*c < 0x20)
+			fprintf(out, "\\u%04x", (unsigned char)*c);
+		else
+			putc(*c, out);
+	}
+	putc('"', out);
+}
+
+void ir_pass_stats_dump_trace(FILE *const out)
+{
+	fputs("{\"traceEvents\":[", out);
+	size_t const n_runs = runs != NULL ? ARR_LEN(runs) : 0;
+	for (size_t i = 0; i < n_runs; ++i) {
+		pass_run_t const *const run = &runs[i];
+		fputs(i == 0 ? "\n" : ",\n", out);
+		fputs("{\"name\":", out);
+		print_json_string(out, run->name);
+		fprintf(out, ",\"cat\":\"pass\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+		        ",\"ts\":%llu,\"dur\":%llu,\"args\":{",
+		        (unsigned long long)(run->start - epoch),
+		        (unsigned long long)run->wall);
+		if (run->irg_name != NULL) {
+			fputs("\"graph\":", out);
+			print_json_string(out, run->irg_name);
+			putc(',', out);
+		}
+		fprintf(out, "\"cpu_us\":%llu,\"obst_bytes\":%zu",
+		        (unsigned long long)run->cpu, run->obst_peak);
+		if (run->nodes_begin >= 0 && run->nodes_end >= 0)
+			fprintf(out, ",\"nodes_before\":%ld,\"nodes_after\":%ld",
+			        run->nodes_begin, run->nodes_end);
+		fputs("}}", out);
+	}
+	fputs("\n]}\n", out);
+}
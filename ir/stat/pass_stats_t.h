@@ -0,0 +1,41 @@
+/*
+ * This file is part of libFirm.
+ * Copyright (C) 2017 University of Karlsruhe.
+ */
+
+/**
+ * @file
+ * @brief       Time and memory accounting of optimization passes.
+ */
+#ifndef FIRM_PASS_STATS_T_H
+#define FIRM_PASS_STATS_T_H
+
+#include <stdbool.h>
+
+#include "firm_types.h"
+#include "timing.h"
+
+extern bool pass_stats_enabled;
+
+void do_pass_stats_begin(ir_graph *irg, char const *name);
+void do_pass_stats_end(ir_graph *irg);
+
+/**
+ * Marks the start of a pass.
+ * @param irg   the graph the pass works on or NULL for whole program passes
+ * @param name  the name of the pass, must be a string constant
+ */
+static inline void pass_stats_begin(ir_graph *const irg, char const *const name)
+{
+	if (pass_stats_enabled)
+		do_pass_stats_begin(irg, name);
+}
+
+/** Marks the end of the pass started last by pass_stats_begin(). */
+static inline void pass_stats_end(ir_graph *const irg)
+{
+	if (pass_stats_enabled)
+		do_pass_stats_end(irg);
+}
+
+#endif
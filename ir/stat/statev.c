@@ -11,21 +11,54 @@
  */
 #include "statev_t.h"
 
+#include "hashptr.h"
 #include "irprintf.h"
+#include "obst.h"
+#include "pset.h"
 #include "stat_timing.h"
 #include "util.h"
+#include "xmalloc.h"
 #include <assert.h>
 #include <regex.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define MAX_TIMER 256
 
+/**
+ * The binary event stream starts with STAT_EV_MAGIC followed by records.
+ * Every record starts with a tag byte and the varint id of its key:
+ *   'K' id len name   defines the name of key id (before its first use)
+ *   'P' id len value  pushes a context
+ *   'O' id            pops a context
+ *   'I' id value      integer event, zigzag encoded varint
+ *   'U' id value      unsigned event, varint
+ *   'D' id value      double event, 8 byte little endian IEEE 754
+ *   'E' id            event without value
+ * Varints are little endian base 128, i.e. 7 bits per byte with the high bit
+ * set on all but the last byte.
+ */
+#define STAT_EV_MAGIC "FIRMEV\0\1"
+
+#define STAT_EV_BUF_SIZE  (64 * 1024)
+#define STAT_EV_MAX_VALUE 256
+
+/** A registered event or context key. */
+typedef struct stat_ev_key_t {
+	char const *name;
+	unsigned    id;      /**< number of the key in the binary stream */
+	bool        enabled; /**< key passes the filter */
+	bool        defined; /**< definition was written to the binary stream */
+} stat_ev_key_t;
+
 int (stat_ev_enabled) = 0;
 
 static FILE          *stat_ev_file;
+static bool           stat_ev_binary;
 static int            stat_ev_timer_sp;
 static timing_ticks_t stat_ev_timer_elapsed[MAX_TIMER];
 static timing_ticks_t stat_ev_timer_start[MAX_TIMER];
@@ -33,17 +66,99 @@ static timing_ticks_t stat_ev_timer_start[MAX_TIMER];
 static regex_t  regex;
 static regex_t *filter;
 
-static bool key_matches(const char *key)
+static struct obstack key_obst;
+static pset          *keys;
+static unsigned       n_keys;
+
+static unsigned char stat_ev_buf[STAT_EV_BUF_SIZE];
+static size_t        stat_ev_buf_len;
+
+static int cmp_key(void const *elt, void const *key)
+{
+	stat_ev_key_t const *const a = (stat_ev_key_t const*)elt;
+	stat_ev_key_t const *const b = (stat_ev_key_t const*)key;
+	return strcmp(a->name, b->name);
+}
+
+/**
+ * Returns the record of a key, registering it on first use.  The filter is
+ * only evaluated once per key.
+ */
+static stat_ev_key_t *get_key(char const *const name)
+{
+	stat_ev_key_t  probe = { .name = name };
+	unsigned const hash  = hash_str(name);
+	stat_ev_key_t *key   = (stat_ev_key_t*)pset_find(keys, &probe, hash);
+	if (key != NULL)
+		return key;
+
+	key          = OALLOCZ(&key_obst, stat_ev_key_t);
+	key->name    = (char const*)obstack_copy0(&key_obst, name, strlen(name));
+	key->id      = n_keys++;
+	key->enabled = filter == NULL || regexec(filter, name, 0, NULL, 0) == 0;
+	pset_insert(keys, key, hash);
+	return key;
+}
+
+static void stat_ev_flush(void)
 {
-	if (filter == NULL)
-		return true;
+	fwrite(stat_ev_buf, 1, stat_ev_buf_len, stat_ev_file);
+	stat_ev_buf_len = 0;
+}
+
+static void put_data(void const *const data, size_t const len)
+{
+	if (stat_ev_buf_len + len > sizeof(stat_ev_buf)) {
+		stat_ev_flush();
+		if (len > sizeof(stat_ev_buf)) {
+			fwrite(data, 1, len, stat_ev_file);
+			return;
+		}
+	}
+	memcpy(&stat_ev_buf[stat_ev_buf_len], data, len);
+	stat_ev_buf_len += len;
+}
 
-	return regexec(filter, key, 0, NULL, 0) == 0;
+static void put_varint(unsigned long long value)
+{
+	unsigned char buf[10];
+	size_t        len = 0;
+	for (; value >= 0x80; value >>= 7)
+		buf[len++] = (unsigned char)(value | 0x80);
+	buf[len++] = (unsigned char)value;
+	put_data(buf, len);
+}
+
+static void put_string(char const *const str, size_t const len)
+{
+	put_varint(len);
+	put_data(str, len);
+}
+
+/**
+ * Starts a binary record for a key.
+ * @return false if the key is filtered out
+ */
+static bool put_record(char const tag, char const *const name)
+{
+	stat_ev_key_t *const key = get_key(name);
+	if (!key->enabled)
+		return false;
+
+	if (!key->defined) {
+		key->defined = true;
+		put_data("K", 1);
+		put_varint(key->id);
+		put_string(key->name, strlen(key->name));
+	}
+	put_data(&tag, 1);
+	put_varint(key->id);
+	return true;
 }
 
 static void stat_ev_vprintf(char ev, const char *key, const char *fmt, va_list ap)
 {
-	if (!key_matches(key))
+	if (!get_key(key)->enabled)
 		return;
 
 	putc(ev, stat_ev_file);
@@ -100,11 +215,36 @@ void stat_ev_tim_pop(const char *name)
 	}
 }
 
-void do_stat_ev_ctx_push_vfmt(const char *key, const char *fmt, va_list ap)
+/**
+ * Excludes the time spent for writing an event from the running timer.
+ * Without a running timer there is nothing to correct, which avoids the
+ * expensive switch to maximum priority for every single event.
+ */
+static bool pause_timer(void)
 {
+	if (stat_ev_timer_sp == 0)
+		return false;
 	stat_ev_tim_push();
-	stat_ev_vprintf('P', key, fmt, ap);
-	stat_ev_tim_pop(NULL);
+	return true;
+}
+
+static void resume_timer(bool const paused)
+{
+	if (paused)
+		stat_ev_tim_pop(NULL);
+}
+
+void do_stat_ev_ctx_push_vfmt(const char *key, const char *fmt, va_list ap)
+{
+	bool const paused = pause_timer();
+	if (!stat_ev_binary) {
+		stat_ev_vprintf('P', key, fmt, ap);
+	} else if (put_record('P', key)) {
+		char value[STAT_EV_MAX_VALUE];
+		ir_vsnprintf(value, sizeof(value), fmt, ap);
+		put_string(value, strlen(value));
+	}
+	resume_timer(paused);
 }
 
 void (stat_ev_ctx_push_fmt)(const char *key, const char *fmt, ...)
@@ -125,9 +265,12 @@ void (stat_ev_ctx_push_str)(const char *key, const char *str)
 
 void do_stat_ev_ctx_pop(const char *key)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('O', key, NULL);
-	stat_ev_tim_pop(NULL);
+	bool const paused = pause_timer();
+	if (stat_ev_binary)
+		put_record('O', key);
+	else
+		stat_ev_printf('O', key, NULL);
+	resume_timer(paused);
 }
 
 void (stat_ev_ctx_pop)(const char *key)
@@ -137,9 +280,18 @@ void (stat_ev_ctx_pop)(const char *key)
 
 void do_stat_ev_dbl(const char *name, double value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%g", value);
-	stat_ev_tim_pop(NULL);
+	bool const paused = pause_timer();
+	if (!stat_ev_binary) {
+		stat_ev_printf('E', name, "%g", value);
+	} else if (put_record('D', name)) {
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		unsigned char buf[8];
+		for (size_t i = 0; i < sizeof(buf); ++i)
+			buf[i] = (unsigned char)(bits >> (8 * i));
+		put_data(buf, sizeof(buf));
+	}
+	resume_timer(paused);
 }
 
 void (stat_ev_dbl)(const char *name, double value)
@@ -149,9 +301,14 @@ void (stat_ev_dbl)(const char *name, double value)
 
 void do_stat_ev_int(const char *name, int value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%d", value);
-	stat_ev_tim_pop(NULL);
+	bool const paused = pause_timer();
+	if (!stat_ev_binary) {
+		stat_ev_printf('E', name, "%d", value);
+	} else if (put_record('I', name)) {
+		unsigned const zigzag = ((unsigned)value << 1) ^ (unsigned)-(value < 0);
+		put_varint(zigzag);
+	}
+	resume_timer(paused);
 }
 
 void (stat_ev_int)(const char *name, int value)
@@ -161,9 +318,12 @@ void (stat_ev_int)(const char *name, int value)
 
 void do_stat_ev_ull(const char *name, unsigned long long value)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "%llu", value);
-	stat_ev_tim_pop(NULL);
+	bool const paused = pause_timer();
+	if (!stat_ev_binary)
+		stat_ev_printf('E', name, "%llu", value);
+	else if (put_record('U', name))
+		put_varint(value);
+	resume_timer(paused);
 }
 
 void (stat_ev_ull)(const char *name, unsigned long long value)
@@ -173,9 +333,12 @@ void (stat_ev_ull)(const char *name, unsigned long long value)
 
 void do_stat_ev(const char *name)
 {
-	stat_ev_tim_push();
-	stat_ev_printf('E', name, "0.0");
-	stat_ev_tim_pop(NULL);
+	bool const paused = pause_timer();
+	if (stat_ev_binary)
+		put_record('E', name);
+	else
+		stat_ev_printf('E', name, "0.0");
+	resume_timer(paused);
 }
 
 void (stat_ev)(const char *name)
@@ -183,15 +346,22 @@ void (stat_ev)(const char *name)
 	stat_ev_(name);
 }
 
-void stat_ev_begin(const char *prefix, const char *filt)
+static void begin(const char *prefix, const char *filt, bool binary)
 {
 	char buf[512];
 
-	snprintf(buf, sizeof(buf), "%s.ev", prefix);
-	stat_ev_file = fopen(buf, "wt");
+	snprintf(buf, sizeof(buf), "%s.%s", prefix, binary ? "evb" : "ev");
+	stat_ev_file = fopen(buf, binary ? "wb" : "wt");
 	if (stat_ev_file == NULL) {
 		fprintf(stderr, "Warning: Couldn't create statev output '%s'\n", buf);
 	}
+	stat_ev_binary = binary;
+	if (binary && stat_ev_file != NULL)
+		put_data(STAT_EV_MAGIC, sizeof(STAT_EV_MAGIC) - 1);
+
+	obstack_init(&key_obst);
+	keys   = new_pset(cmp_key, 64);
+	n_keys = 0;
 
 	if (filt != NULL && filt[0] != '\0') {
 		filter = NULL;
@@ -207,9 +377,25 @@ void stat_ev_begin(const char *prefix, const char *filt)
 	stat_ev_enabled = stat_ev_file != NULL;
 }
 
+void stat_ev_begin(const char *prefix, const char *filt)
+{
+	begin(prefix, filt, false);
+}
+
+void stat_ev_begin_binary(const char *prefix, const char *filt)
+{
+	begin(prefix, filt, true);
+}
+
 void stat_ev_end(void)
 {
+	if (keys != NULL) {
+		del_pset(keys);
+		keys = NULL;
+		obstack_free(&key_obst, NULL);
+	}
 	if (stat_ev_file != NULL) {
+		stat_ev_flush();
 		fclose(stat_ev_file);
 		stat_ev_file    = NULL;
 		stat_ev_enabled = 0;
@@ -15,6 +15,7 @@
 #include "strcalc.h"
 #include "xmalloc.h"
 #include <assert.h>
+#include <fenv.h>
 #include <float.h>
 #include <inttypes.h>
 #include <limits.h>
@@ -27,6 +28,17 @@
 /** The number of extra precision rounding bits */
 #define ROUNDING_BITS 2
 
+/* Use the host arithmetic for values in host float/double format if it
+ * evaluates them in their own precision and supports all rounding modes. */
+#if FLT_RADIX == 2 && FLT_MANT_DIG == 24 && DBL_MANT_DIG == 53 \
+    && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0 \
+    && defined(FE_INEXACT) && defined(FE_TONEAREST) && defined(FE_UPWARD) \
+    && defined(FE_DOWNWARD) && defined(FE_TOWARDZERO)
+#define FC_HOST_ARITHMETIC 1
+#else
+#define FC_HOST_ARITHMETIC 0
+#endif
+
 /* our floating point value */
 struct fp_value {
 	float_descriptor_t desc;
@@ -51,6 +63,9 @@ static unsigned max_precision;
 /** Exact flag. */
 static bool fc_exact = true;
 
+/** Use the host arithmetic where possible. */
+static bool use_host_arithmetic = true;
+
 static float_descriptor_t long_double_desc;
 
 /** pack machine-like */
@@ -131,7 +146,7 @@ static bool normalize(fp_value *val, bool sticky)
 
 	/* check for exponent underflow */
 	if (sc_is_negative(_exp(val))
-	 || sc_is_zero(_exp(val), value_size)) {
+	 || sc_is_zero(_exp(val), value_size*SC_BITS)) {
 		/* exponent underflow */
 		/* shift the mantissa right to have a zero exponent */
 		sc_val_from_ulong(1, temp);
@@ -190,7 +205,7 @@ static bool normalize(fp_value *val, bool sticky)
 	}
 
 	/* could have rounded down to zero */
-	if (sc_is_zero(_mant(val), value_size)
+	if (sc_is_zero(_mant(val), value_size*SC_BITS)
 	    && (val->clss == FC_SUBNORMAL))
 		val->clss = FC_ZERO;
 
@@ -284,6 +299,158 @@ static void fc_get_qnan(const float_descriptor_t *desc, fp_value *result)
 	fc_get_nan(desc, result, false, NULL);
 }
 
+typedef enum host_op_t {
+	HOST_ADD,
+	HOST_SUB,
+	HOST_MUL,
+	HOST_DIV,
+} host_op_t;
+
+#if FC_HOST_ARITHMETIC
+typedef enum host_format_t {
+	HOST_NONE,
+	HOST_FLOAT,
+	HOST_DOUBLE,
+} host_format_t;
+
+static host_format_t get_host_format(const float_descriptor_t *desc)
+{
+	if (desc->explicit_one)
+		return HOST_NONE;
+	if (desc->exponent_size == 8 && desc->mantissa_size == 23)
+		return HOST_FLOAT;
+	if (desc->exponent_size == 11 && desc->mantissa_size == 52)
+		return HOST_DOUBLE;
+	return HOST_NONE;
+}
+
+static bool is_finite(const fp_value *value)
+{
+	return value->clss == FC_NORMAL || value->clss == FC_SUBNORMAL
+	    || value->clss == FC_ZERO;
+}
+
+static int get_host_rounding_mode(void)
+{
+	switch (rounding_mode) {
+	case FC_TONEAREST:  return FE_TONEAREST;
+	case FC_TOPOSITIVE: return FE_UPWARD;
+	case FC_TONEGATIVE: return FE_DOWNWARD;
+	case FC_TOZERO:     return FE_TOWARDZERO;
+	}
+	panic("invalid rounding mode");
+}
+
+/** Returns the IEEE 754 encoding of a float/double value. */
+static uint64_t get_host_bits(const fp_value *value)
+{
+	sc_word *packed = ALLOCAN(sc_word, value_size);
+	pack(value, packed);
+	return sc_val_to_uint64(packed);
+}
+
+static float host_calc_float(float a, float b, host_op_t op)
+{
+	/* volatile keeps the operation between the rounding mode changes */
+	volatile float x = a;
+	volatile float y = b;
+	volatile float res;
+	switch (op) {
+	case HOST_ADD: res = x + y; return res;
+	case HOST_SUB: res = x - y; return res;
+	case HOST_MUL: res = x * y; return res;
+	case HOST_DIV: res = x / y; return res;
+	}
+	panic("invalid host operation");
+}
+
+static double host_calc_double(double a, double b, host_op_t op)
+{
+	volatile double x = a;
+	volatile double y = b;
+	volatile double res;
+	switch (op) {
+	case HOST_ADD: res = x + y; return res;
+	case HOST_SUB: res = x - y; return res;
+	case HOST_MUL: res = x * y; return res;
+	case HOST_DIV: res = x / y; return res;
+	}
+	panic("invalid host operation");
+}
+
+/**
+ * Calculates a op b with the host arithmetic if both are finite values in a
+ * host format.  Special values are left to the emulation, so NaN payloads and
+ * the exactness flag behave the same in both implementations.
+ *
+ * @return true if the result was calculated
+ */
+static bool host_calc(const fp_value *a, const fp_value *b, host_op_t op,
+                      fp_value *result)
+{
+	if (!use_host_arithmetic)
+		return false;
+	const float_descriptor_t *desc   = &a->desc;
+	host_format_t const       format = get_host_format(desc);
+	if (format == HOST_NONE || get_host_format(&b->desc) != format)
+		return false;
+	if (!is_finite(a) || !is_finite(b))
+		return false;
+	if (op == HOST_DIV && b->clss == FC_ZERO)
+		return false;
+
+	uint64_t const bits_a = get_host_bits(a);
+	uint64_t const bits_b = get_host_bits(b);
+	uint64_t       bits_res;
+
+	fenv_t env;
+	fegetenv(&env);
+	fesetround(get_host_rounding_mode());
+	feclearexcept(FE_ALL_EXCEPT);
+	if (format == HOST_FLOAT) {
+		uint32_t const a32 = (uint32_t)bits_a;
+		uint32_t const b32 = (uint32_t)bits_b;
+		float          fa;
+		float          fb;
+		memcpy(&fa, &a32, sizeof(fa));
+		memcpy(&fb, &b32, sizeof(fb));
+		float const    fres = host_calc_float(fa, fb, op);
+		uint32_t       res32;
+		memcpy(&res32, &fres, sizeof(res32));
+		bits_res = res32;
+	} else {
+		double fa;
+		double fb;
+		memcpy(&fa, &bits_a, sizeof(fa));
+		memcpy(&fb, &bits_b, sizeof(fb));
+		double const fres = host_calc_double(fa, fb, op);
+		memcpy(&bits_res, &fres, sizeof(bits_res));
+	}
+	fc_exact = !fetestexcept(FE_INEXACT);
+	fesetenv(&env);
+
+	unsigned char buf[sizeof(bits_res)];
+	for (unsigned i = 0; i < sizeof(buf); ++i)
+		buf[i] = (unsigned char)(bits_res >> (i * CHAR_BIT));
+	fc_val_from_bytes(result, buf, desc);
+	return true;
+}
+#else
+static bool host_calc(const fp_value *a, const fp_value *b, host_op_t op,
+                      fp_value *result)
+{
+	(void)a; (void)b; (void)op; (void)result;
+	return false;
+}
+#endif
+
+bool fc_use_host_arithmetic(bool enable)
+{
+	bool const old = use_host_arithmetic;
+	use_host_arithmetic = enable;
+	return old;
+}
+
 /**
  * calculate a + b, where a is the value with the bigger exponent
  */
@@ -384,7 +551,7 @@ static void _fadd(const fp_value *a, const fp_value *b, fp_value *result)
 	}
 
 	/* resulting exponent is the bigger one */
-	memmove(_exp(result), _exp(a), value_size);
+	memmove(_exp(result), _exp(a), value_size * sizeof(sc_word));
 
 	fc_exact &= normalize(result, sticky);
 }
@@ -394,6 +561,8 @@ void fc_mul(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_calc(a, b, HOST_MUL, result))
+		return;
 
 	if (result != a && result != b)
 		result->desc = a->desc;
@@ -471,6 +640,8 @@ void fc_div(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_calc(a, b, HOST_DIV, result))
+		return;
 
 	if (result != a && result != b)
 		result->desc = a->desc;
@@ -593,7 +764,7 @@ void fc_int(const fp_value *a, fp_value *result)
 	sc_and(_mant(a), temp, _mant(result));
 
 	if (a != result) {
-		memcpy(_exp(result), _exp(a), value_size);
+		memcpy(_exp(result), _exp(a), value_size * sizeof(sc_word));
 		result->sign = a->sign;
 	}
 }
@@ -631,8 +802,8 @@ void fc_val_from_bytes(fp_value *result, const unsigned char *buffer,
 	sc_shlI(_mant(result), ROUNDING_BITS, _mant(result));
 
 	/* check for special values */
-	if (sc_is_zero(_exp(result), value_size)) {
-		if (sc_is_zero(_mant(result), value_size)) {
+	if (sc_is_zero(_exp(result), value_size*SC_BITS)) {
+		if (sc_is_zero(_mant(result), value_size*SC_BITS)) {
 			result->clss = FC_ZERO;
 		} else {
 			result->clss = FC_SUBNORMAL;
@@ -769,7 +940,7 @@ void fc_cast(const fp_value *value, const float_descriptor_t *dest,
 		if (value->clss == FC_SUBNORMAL) {
 			sc_shlI(_mant(value), 1, _mant(result));
 		} else if (value != result) {
-			memcpy(_mant(result), _mant(value), value_size);
+			memcpy(_mant(result), _mant(value), value_size * sizeof(sc_word));
 		}
 
 		/* set the descriptor of the new value */
@@ -841,7 +1012,7 @@ void fc_get_nan(const float_descriptor_t *desc, fp_value *result,
 	bool     explicit_one  = desc->explicit_one;
 	if (payload != NULL) {
 		if (payload != _mant(result))
-			memcpy(_mant(result), payload, value_size);
+			memcpy(_mant(result), payload, value_size * sizeof(sc_word));
 		/* Limit payload to mantissa size. The "explicit_one" on 80bit x86 must
 		 * be 0 for NaNs. */
 		sc_zero_extend(_mant(result), mantissa_size - explicit_one);
@@ -1066,7 +1237,7 @@ void init_fltcalc(unsigned precision)
 
 	rounding_mode = FC_TONEAREST;
 	value_size    = sc_get_value_length();
-	fp_value_size = sizeof(fp_value) + 2*value_size;
+	fp_value_size = sizeof(fp_value) + 2*value_size*sizeof(sc_word);
 
 #if LDBL_MANT_DIG == 64
 	assert(sizeof(long double) == 12 || sizeof(long double) == 16);
@@ -1085,6 +1256,8 @@ void fc_add(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_calc(a, b, HOST_ADD, result))
+		return;
 
 	/* make the value with the bigger exponent the first one */
 	if (sc_comp(_exp(a), _exp(b)) == ir_relation_less)
@@ -1098,6 +1271,8 @@ void fc_sub(const fp_value *a, const fp_value *b, fp_value *result)
 	fc_exact = true;
 	if (handle_NAN(a, b, result))
 		return;
+	if (host_calc(a, b, HOST_SUB, result))
+		return;
 
 	fp_value *temp = (fp_value*) alloca(fp_value_size);
 	memcpy(temp, b, fp_value_size);
@@ -239,6 +239,14 @@ void fc_val_to_bytes(const fp_value *val, unsigned char *buf);
  */
 bool fc_is_exact(void);
 
+/**
+ * Enables or disables the use of the host floatingpoint arithmetic for
+ * values in host float/double format (enabled by default).
+ *
+ * @return the previous setting
+ */
+bool fc_use_host_arithmetic(bool enable);
+
 void init_fltcalc(unsigned precision);
 
 #endif
@@ -21,9 +21,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define SC_MASK      ((sc_word)0xFF)
-#define SC_RESULT(x) ((x) & SC_MASK)
-#define SC_CARRY(x)  ((unsigned)(x) >> SC_BITS)
+#define SC_MASK      (~(sc_word)0)
+
+#ifdef __SIZEOF_INT128__
+/* double word type for intermediate products and quotients */
+#define SC_HAVE_DWORD
+__extension__ typedef unsigned __int128 sc_dword;
+#endif
 
 static char *output_buffer = NULL;  /**< buffer for output */
 static unsigned bit_pattern_size;   /**< maximum number of bits */
@@ -35,14 +39,25 @@ void sc_zero(sc_word *buffer)
 	memset(buffer, 0, sizeof(buffer[0]) * calc_buffer_size);
 }
 
+static void sc_copy(sc_word *dest, const sc_word *src)
+{
+	memcpy(dest, src, sizeof(dest[0]) * calc_buffer_size);
+}
+
+static void sc_fill(sc_word *buffer, sc_word word, unsigned from)
+{
+	for (unsigned i = from; i < calc_buffer_size; ++i)
+		buffer[i] = word;
+}
+
 static sc_word sex_digit(unsigned x)
 {
-	return (SC_MASK << (x+1)) & SC_MASK;
+	return x + 1 < SC_BITS ? SC_MASK << (x+1) : 0;
 }
 
 static sc_word max_digit(unsigned x)
 {
-	return (1u << x) - 1;
+	return ((sc_word)1 << x) - 1;
 }
 
 static sc_word min_digit(unsigned x)
@@ -50,6 +65,77 @@ static sc_word min_digit(unsigned x)
 	return SC_MASK - max_digit(x);
 }
 
+/**
+ * Returns the low word of x * y, stores the high word in @p high.
+ */
+static inline sc_word mul_words(sc_word x, sc_word y, sc_word *high)
+{
+#ifdef SC_HAVE_DWORD
+	sc_dword const res = (sc_dword)x * y;
+	*high = (sc_word)(res >> SC_BITS);
+	return (sc_word)res;
+#else
+	uint64_t const x_lo = (uint32_t)x;
+	uint64_t const x_hi = x >> 32;
+	uint64_t const y_lo = (uint32_t)y;
+	uint64_t const y_hi = y >> 32;
+	uint64_t const p0   = x_lo * y_lo;
+	uint64_t const p1   = x_lo * y_hi;
+	uint64_t const p2   = x_hi * y_lo;
+	uint64_t const mid  = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+	*high = x_hi * y_hi + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+	return (mid << 32) | (uint32_t)p0;
+#endif
+}
+
+/**
+ * Divides the unsigned @p len words long value by @p divisor in place and
+ * returns the remainder.
+ */
+static sc_word div_by_word(sc_word *value, unsigned len, sc_word divisor)
+{
+	assert(divisor != 0);
+	sc_word rem = 0;
+	for (unsigned i = len; i-- > 0; ) {
+#ifdef SC_HAVE_DWORD
+		sc_dword const dividend = ((sc_dword)rem << SC_BITS) | value[i];
+		value[i] = (sc_word)(dividend / divisor);
+		rem      = (sc_word)(dividend % divisor);
+#else
+		/* process the word in two halves, so the intermediate results fit
+		 * into a word */
+		assert(divisor <= UINT32_MAX);
+		sc_word const high   = (rem << 32) | (value[i] >> 32);
+		sc_word const q_high = high / divisor;
+		sc_word const low    = ((high % divisor) << 32) | (uint32_t)value[i];
+		value[i] = (q_high << 32) | (low / divisor);
+		rem      = low % divisor;
+#endif
+	}
+	return rem;
+}
+
+/** Returns true if all words above the first one are zero. */
+static bool fits_word_unsigned(const sc_word *value)
+{
+	for (unsigned i = 1; i < calc_buffer_size; ++i) {
+		if (value[i] != 0)
+			return false;
+	}
+	return true;
+}
+
+/** Returns true if the value is the sign extension of its first word. */
+static bool fits_word_signed(const sc_word *value)
+{
+	sc_word const ext = (value[0] >> (SC_BITS - 1)) ? SC_MASK : 0;
+	for (unsigned i = 1; i < calc_buffer_size; ++i) {
+		if (value[i] != ext)
+			return false;
+	}
+	return true;
+}
+
 void sc_not(const sc_word *val, sc_word *buffer)
 {
 	for (unsigned counter = 0; counter<calc_buffer_size; counter++)
@@ -89,12 +175,8 @@ void sc_andnot(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 void sc_inc(sc_word *buffer)
 {
 	for (unsigned counter = 0; counter < calc_buffer_size; ++counter) {
-		sc_word v = buffer[counter];
-		if (v < SC_MASK) {
-			buffer[counter] = v+1;
+		if (++buffer[counter] != 0)
 			break;
-		}
-		buffer[counter] = 0;
 	}
 }
 
@@ -108,23 +190,48 @@ void sc_add(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 {
 	sc_word carry = 0;
 	for (unsigned counter = 0; counter < calc_buffer_size; ++counter) {
-		unsigned const sum = val1[counter] + val2[counter] + carry;
-		buffer[counter] = SC_RESULT(sum);
-		carry           = SC_CARRY(sum);
+		sc_word const v1  = val1[counter];
+		sc_word const sum = v1 + val2[counter];
+		sc_word const res = sum + carry;
+		buffer[counter] = res;
+		carry           = (sum < v1) | (res < sum);
 	}
 }
 
 void sc_sub(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 {
-	/* intermediate buffer to hold -val2 */
-	sc_word *temp_buffer = ALLOCAN(sc_word, calc_buffer_size);
-
-	sc_neg(val2, temp_buffer);
-	sc_add(val1, temp_buffer, buffer);
+	sc_word borrow = 0;
+	for (unsigned counter = 0; counter < calc_buffer_size; ++counter) {
+		sc_word const v1   = val1[counter];
+		sc_word const v2   = val2[counter];
+		sc_word const diff = v1 - v2;
+		buffer[counter] = diff - borrow;
+		borrow          = (v1 < v2) | (diff < borrow);
+	}
 }
 
 void sc_mul(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 {
+	/* fast path: both values fit into a single (signed) word, the product
+	 * fits into two words */
+	if (fits_word_signed(val1) && fits_word_signed(val2)) {
+		sc_word const v1 = val1[0];
+		sc_word const v2 = val2[0];
+		sc_word       high;
+		sc_word const low = mul_words(v1, v2, &high);
+		/* correct the high word of the unsigned product for signed operands */
+		if (v1 >> (SC_BITS - 1))
+			high -= v2;
+		if (v2 >> (SC_BITS - 1))
+			high -= v1;
+		buffer[0] = low;
+		if (calc_buffer_size > 1) {
+			buffer[1] = high;
+			sc_fill(buffer, (high >> (SC_BITS - 1)) ? SC_MASK : 0, 2);
+		}
+		return;
+	}
+
 	sc_word *temp_buffer = ALLOCANZ(sc_word, calc_buffer_size);
 	sc_word *neg_val1    = ALLOCAN(sc_word, calc_buffer_size);
 	sc_word *neg_val2    = ALLOCAN(sc_word, calc_buffer_size);
@@ -147,33 +254,22 @@ void sc_mul(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 		sc_word outer = val2[c_outer];
 		if (outer == 0)
 			continue;
-		unsigned carry = 0; /* container for carries */
+		sc_word carry = 0; /* container for carries */
 		for (unsigned c_inner = 0; c_inner < max_value_size; c_inner++) {
-			sc_word inner = val1[c_inner];
-			/* do the following calculation:
-			 * Add the current carry, the value at position c_outer+c_inner
-			 * and the result of the multiplication of val1[c_inner] and
-			 * val2[c_outer]. This is the usual pen-and-paper multiplication
-			 */
-
-			/* multiplicate the two digits */
-			unsigned const mul = inner*outer;
-			/* add old value to result of multiplication and the carry */
-			unsigned const sum = temp_buffer[c_inner+c_outer] + mul + carry;
-
-			/* all carries together result in new carry. This is always
-			 * smaller than the base b:
-			 * Both multiplicands, the carry and the value already in the
-			 * temp buffer are single digits and their value is therefore
-			 * at most equal to (b-1).
-			 * This leads to:
-			 * (b-1)(b-1)+(b-1)+(b-1) = b*b-1
-			 * The tables list all operations rem b, so the carry is at
-			 * most
-			 * (b*b-1)rem b = -1rem b = b-1
-			 */
-			temp_buffer[c_inner + c_outer] = SC_RESULT(sum);
-			carry                          = SC_CARRY(sum);
+			/* This is the usual pen-and-paper multiplication: Add the
+			 * current carry, the value at position c_outer+c_inner and the
+			 * product of val1[c_inner] and val2[c_outer].
+			 * The result fits into two words:
+			 * (b-1)(b-1)+(b-1)+(b-1) = b*b-1 */
+			sc_word high;
+			sc_word low = mul_words(val1[c_inner], outer, &high);
+			low  += carry;
+			high += low < carry;
+			sc_word *const res = &temp_buffer[c_inner + c_outer];
+			low  += *res;
+			high += low < *res;
+			*res  = low;
+			carry = high;
 		}
 
 		/* A carry may hang over */
@@ -184,18 +280,18 @@ void sc_mul(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 	if (sign)
 		sc_neg(temp_buffer, buffer);
 	else
-		memcpy(buffer, temp_buffer, calc_buffer_size);
+		sc_copy(buffer, temp_buffer);
 }
 
-/**
- * Shift the buffer to left and add an sc digit
- */
-static void sc_push(sc_word digit, sc_word *buffer)
+/** Unsigned comparison of two values. */
+static ir_relation sc_ucomp(const sc_word *val1, const sc_word *val2)
 {
-	for (unsigned counter = calc_buffer_size - 1; counter-- > 0; ) {
-		buffer[counter+1] = buffer[counter];
+	for (unsigned counter = calc_buffer_size; counter-- > 0; ) {
+		if (val1[counter] != val2[counter])
+			return val1[counter] > val2[counter]
+			     ? ir_relation_greater : ir_relation_less;
 	}
-	buffer[0] = digit;
+	return ir_relation_equal;
 }
 
 bool sc_divmod(const sc_word *dividend, const sc_word *divisor,
@@ -225,49 +321,45 @@ bool sc_divmod(const sc_word *dividend, const sc_word *divisor,
 	}
 
 	sc_word *neg_val2 = ALLOCAN(sc_word, calc_buffer_size);
-	sc_neg(divisor, neg_val2);
-	const sc_word *minus_divisor;
 	if (sc_is_negative(divisor)) {
+		sc_neg(divisor, neg_val2);
 		div_sign = !div_sign;
-		minus_divisor = divisor;
 		divisor = neg_val2;
-	} else {
-		minus_divisor = neg_val2;
 	}
 
 	/* if divisor >= dividend division is easy
 	 * (remember these are absolute values) */
-	switch (sc_comp(dividend, divisor)) {
+	switch (sc_ucomp(dividend, divisor)) {
 	case ir_relation_equal: /* dividend == divisor */
 		quot[0] = 1;
 		goto end;
 
 	case ir_relation_less: /* dividend < divisor */
-		memcpy(rem, dividend, calc_buffer_size);
+		sc_copy(rem, dividend);
 		goto end;
 
 	default: /* unluckily division is necessary :( */
 		break;
 	}
 
-	for (unsigned c_dividend = calc_buffer_size; c_dividend-- > 0; ) {
-		sc_push(dividend[c_dividend], rem);
-		sc_push(0, quot);
-
-		if (sc_comp(rem, divisor) != ir_relation_less) {
-			/* remainder >= divisor */
-			/* subtract until the remainder becomes negative, this should
-			 * be faster than comparing remainder with divisor  */
-			sc_add(rem, minus_divisor, rem);
-
-			while (!sc_is_negative(rem)) {
-				/* TODO can this generate carry or is masking redundant? */
-				quot[0] = SC_RESULT(quot[0] + 1);
-				sc_add(rem, minus_divisor, rem);
+#ifndef SC_HAVE_DWORD
+	if (fits_word_unsigned(divisor) && divisor[0] <= UINT32_MAX) {
+#else
+	if (fits_word_unsigned(divisor)) {
+#endif
+		/* fast path: divide word by word */
+		sc_copy(quot, dividend);
+		rem[0] = div_by_word(quot, calc_buffer_size, divisor[0]);
+	} else {
+		/* binary long division */
+		for (int bit = sc_get_highest_set_bit(dividend); bit >= 0; --bit) {
+			sc_shlI(rem, 1, rem);
+			if (sc_get_bit_at(dividend, bit))
+				rem[0] |= 1;
+			if (sc_ucomp(rem, divisor) != ir_relation_less) {
+				sc_sub(rem, divisor, rem);
+				sc_set_bit_at(quot, bit);
 			}
-
-			/* subtracted one too much */
-			sc_add(rem, divisor, rem);
 		}
 	}
 end:
@@ -292,11 +384,10 @@ void sc_zero_extend(sc_word *buffer, unsigned from_bits)
 	unsigned bit  = from_bits % SC_BITS;
 	unsigned word = from_bits / SC_BITS;
 	if (bit > 0) {
-		memset(&buffer[word+1], 0, calc_buffer_size-(word+1));
 		buffer[word] &= max_digit(bit);
-	} else {
-		memset(&buffer[word], 0, calc_buffer_size-word);
+		++word;
 	}
+	sc_fill(buffer, 0, word);
 }
 
 void sc_sign_extend(sc_word *buffer, unsigned from_bits)
@@ -307,8 +398,7 @@ void sc_sign_extend(sc_word *buffer, unsigned from_bits)
 	if (sign_bit) {
 		/* sign bit is set, we need sign extension */
 		unsigned word = bits / SC_BITS;
-		for (unsigned i = word + 1; i < calc_buffer_size; ++i)
-			buffer[i] = SC_MASK;
+		sc_fill(buffer, SC_MASK, word + 1);
 		buffer[word] |= sex_digit(bits % SC_BITS);
 	} else {
 		sc_zero_extend(buffer, from_bits);
@@ -332,10 +422,6 @@ bool sc_val_from_str(bool negative, unsigned base, const char *str, size_t len,
 	check_ascii();
 
 	assert(base > 1 && base <= 16);
-	sc_word *sc_base = ALLOCAN(sc_word, calc_buffer_size);
-	sc_val_from_ulong(base, sc_base);
-
-	sc_word *val = ALLOCANZ(sc_word, calc_buffer_size);
 
 	sc_zero(buffer);
 
@@ -354,14 +440,18 @@ bool sc_val_from_str(bool negative, unsigned base, const char *str, size_t len,
 
 		if (v >= base)
 			return false;
-		val[0] = v;
 
 		/* Radix conversion from base b to base B:
 		 *  (UnUn-1...U1U0)b == ((((Un*b + Un-1)*b + ...)*b + U1)*b + U0)B */
-		/* multiply current value with base */
-		sc_mul(sc_base, buffer, buffer);
-		/* add next digit to current value  */
-		sc_add(val, buffer, buffer);
+		/* multiply current value with base and add the next digit */
+		sc_word carry = v;
+		for (unsigned i = 0; i < calc_buffer_size; ++i) {
+			sc_word high;
+			sc_word low = mul_words(buffer[i], base, &high);
+			low      += carry;
+			buffer[i] = low;
+			carry     = high + (low < carry);
+		}
 
 		/* get ready for the next letter */
 		str++;
@@ -376,61 +466,26 @@ bool sc_val_from_str(bool negative, unsigned base, const char *str, size_t len,
 
 void sc_val_from_long(long value, sc_word *buffer)
 {
-	bool sign       = value < 0;
-	bool is_minlong = value == LONG_MIN;
-
-	/* use absolute value, special treatment of MIN_LONG to avoid overflow */
-	if (sign) {
-		if (is_minlong)
-			value = -(value+1);
-		else
-			value = -value;
-	}
-
-	sc_zero(buffer);
-
-	sc_word *pos = buffer;
-	while ((value != 0) && (pos < buffer + calc_buffer_size)) {
-		*pos++ = value & SC_MASK;
-		value >>= SC_BITS;
-	}
-
-	if (sign) {
-		if (is_minlong)
-			sc_inc(buffer);
-
-		sc_neg(buffer, buffer);
-	}
+	/* conversion to the unsigned word type sign extends */
+	buffer[0] = (sc_word)value;
+	sc_fill(buffer, value < 0 ? SC_MASK : 0, 1);
 }
 
 void sc_val_from_ulong(unsigned long value, sc_word *buffer)
 {
-	sc_word *pos = buffer;
-
-	while (pos < buffer + calc_buffer_size) {
-		*pos++ = value & SC_MASK;
-		value >>= SC_BITS;
-	}
+	buffer[0] = value;
+	sc_fill(buffer, 0, 1);
 }
 
 long sc_val_to_long(const sc_word *val)
 {
-	unsigned long l = 0;
-	unsigned max_buffer_index = (sizeof(long)*8)/SC_BITS;
-	for (unsigned i = max_buffer_index; i-- > 0; ) {
-		assert(l <= (ULONG_MAX>>SC_BITS) && "signed shift overflow");
-		l = (l << SC_BITS) + val[i];
-	}
+	unsigned long l = (unsigned long)val[0];
 	return l;
 }
 
 uint64_t sc_val_to_uint64(const sc_word *val)
 {
-	uint64_t res = 0;
-	for (unsigned i = calc_buffer_size; i-- > 0; ) {
-		res = (res << SC_BITS) + val[i];
-	}
-	return res;
+	return val[0];
 }
 
 void sc_min_from_bits(unsigned num_bits, bool sign, sc_word *buffer)
@@ -477,20 +532,9 @@ ir_relation sc_comp(const sc_word* const val1, const sc_word* const val2)
 	if (val1_negative != val2_negative)
 		return val1_negative ? ir_relation_less : ir_relation_greater;
 
-	/* loop until two digits differ, the values are equal if there
-	 * are no such two digits */
-	unsigned counter = calc_buffer_size - 1;
-	while (val1[counter] == val2[counter]) {
-		if (counter == 0)
-			return ir_relation_equal;
-		counter--;
-	}
-
-	/* the leftmost digit is the most significant, so this returns
-	 * the correct result.
-	 * This implies the digit enum is ordered */
-	return val1[counter] > val2[counter]
-	     ? ir_relation_greater : ir_relation_less;
+	/* for values of the same sign the two's complement representation
+	 * compares like unsigned numbers */
+	return sc_ucomp(val1, val2);
 }
 
 int sc_get_highest_set_bit(const sc_word *value)
@@ -498,7 +542,7 @@ int sc_get_highest_set_bit(const sc_word *value)
 	for (unsigned counter = calc_buffer_size; counter-- > 0; ) {
 		sc_word word = value[counter];
 		if (word != 0)
-			return counter*SC_BITS + (31 - nlz(word));
+			return counter*SC_BITS + (SC_BITS - 1 - nlz64(word));
 	}
 	return -1;
 }
@@ -508,7 +552,7 @@ int sc_get_highest_clear_bit(const sc_word *value)
 	for (unsigned counter = calc_buffer_size; counter-- > 0; ) {
 		sc_word word = value[counter] ^ SC_MASK;
 		if (word != 0)
-			return counter*SC_BITS + (31 - nlz(word));
+			return counter*SC_BITS + (SC_BITS - 1 - nlz64(word));
 	}
 	return -1;
 }
@@ -519,21 +563,21 @@ int sc_get_lowest_set_bit(const sc_word *value)
 	     ++counter) {
 		sc_word word = value[counter];
 		if (word != 0)
-			return (counter * SC_BITS) + ntz(word);
+			return (counter * SC_BITS) + ntz64(word);
 	}
 	return -1;
 }
 
 void sc_set_bit_at(sc_word *value, unsigned pos)
 {
-	unsigned nibble = pos / SC_BITS;
-	value[nibble] |= 1 << (pos % SC_BITS);
+	unsigned word = pos / SC_BITS;
+	value[word] |= (sc_word)1 << (pos % SC_BITS);
 }
 
 void sc_clear_bit_at(sc_word *value, unsigned pos)
 {
-	unsigned nibble = pos / SC_BITS;
-	value[nibble] &= ~(1 << (pos % SC_BITS));
+	unsigned word = pos / SC_BITS;
+	value[word] &= ~((sc_word)1 << (pos % SC_BITS));
 }
 
 bool sc_is_zero(const sc_word *value, unsigned bits)
@@ -563,19 +607,23 @@ bool sc_is_negative(const sc_word *value)
 	return sc_get_bit_at(value, calc_buffer_size*SC_BITS-1);
 }
 
+/** Returns the byte at the given byte offset of a value. */
+static unsigned char get_byte(const sc_word *value, unsigned byte_ofs)
+{
+	unsigned const bit = byte_ofs * CHAR_BIT;
+	return (unsigned char)(value[bit / SC_BITS] >> (bit % SC_BITS));
+}
+
 unsigned char sc_sub_bits(const sc_word *value, unsigned len, unsigned byte_ofs)
 {
-	if (byte_ofs*SC_BITS >= len)
+	unsigned const bit = byte_ofs * CHAR_BIT;
+	if (bit >= len)
 		return 0;
 
-	assert(SC_BITS == CHAR_BIT);
-	sc_word val = value[byte_ofs];
+	unsigned char val = get_byte(value, byte_ofs);
 	// Mask out if we are at the end
-	if (byte_ofs == (len/SC_BITS)-1) {
-		unsigned bit = len % SC_BITS;
-		if (bit != 0)
-			val &= max_digit(bit);
-	}
+	if (len - bit < CHAR_BIT)
+		val &= (1u << (len - bit)) - 1;
 	return val;
 }
 
@@ -584,12 +632,12 @@ unsigned sc_popcount(const sc_word *value, unsigned bits)
 	unsigned res = 0;
 	unsigned full_words = bits/SC_BITS;
 	for (unsigned i = 0; i < full_words; ++i) {
-		res += popcount(value[i]);
+		res += popcount64(value[i]);
 	}
 	unsigned remaining_bits = bits%SC_BITS;
 	if (remaining_bits != 0) {
 		sc_word mask = max_digit(remaining_bits);
-		res += popcount(value[full_words] & mask);
+		res += popcount64(value[full_words] & mask);
 	}
 
 	return res;
@@ -600,10 +648,11 @@ void sc_val_from_bytes(unsigned char const *const bytes, size_t n_bytes,
 {
 	assert(n_bytes*CHAR_BIT <= (size_t)calc_buffer_size*SC_BITS);
 
-	sc_word *p = buffer;
-	assert(SC_BITS == CHAR_BIT);
-	memcpy(p, bytes, n_bytes);
-	memset(p+n_bytes, 0, buffer+calc_buffer_size-p);
+	sc_zero(buffer);
+	for (size_t i = 0; i < n_bytes; ++i) {
+		size_t const bit = i * CHAR_BIT;
+		buffer[bit / SC_BITS] |= (sc_word)bytes[i] << (bit % SC_BITS);
+	}
 }
 
 void sc_val_to_bytes(const sc_word *buffer, unsigned char *const dest,
@@ -611,55 +660,36 @@ void sc_val_to_bytes(const sc_word *buffer, unsigned char *const dest,
 {
 	assert(dest_len*CHAR_BIT <= (size_t)calc_buffer_size*SC_BITS);
 
-	assert(SC_BITS == CHAR_BIT);
-	memcpy(dest, buffer, dest_len);
+	for (size_t i = 0; i < dest_len; ++i)
+		dest[i] = get_byte(buffer, i);
 }
 
 void sc_val_from_bits(unsigned char const *const bytes, unsigned from,
                       unsigned to, sc_word *buffer)
 {
 	assert(from < to);
-	assert((to - from) / CHAR_BIT <= calc_buffer_size);
-	assert(CHAR_BIT == 8);
-	assert(SC_BITS == CHAR_BIT);
-
-	sc_word *p = buffer;
-
-	/* see which is the lowest and highest byte, special case if they are
-	 * the same. */
-	const unsigned char *const low      = &bytes[from/CHAR_BIT];
-	const unsigned char *const high     = &bytes[(to-1)/CHAR_BIT];
-	const unsigned             low_bit  = from%CHAR_BIT;
-	const unsigned             high_bit = (to-1)%CHAR_BIT + 1;
-	if (low == high) {
-		uint32_t val
-			= ((uint32_t)*low << (32-high_bit)) >> (32-high_bit+low_bit);
-		*p++ = val & SC_MASK;
-		goto clear_rest;
-	}
-
-	/* lowest byte gets applied partially */
-	uint32_t val = ((uint32_t)*low) >> low_bit;
-	*p     = val & SC_MASK;
-	*(p+1) = 0;
-	unsigned bit = (CHAR_BIT-low_bit)%SC_BITS;
-	p += (CHAR_BIT-low_bit)/SC_BITS;
-	/* fully apply bytes in the middle (but note that they may affect up to 2
-	 * units of the destination number) */
-	for (const unsigned char *mid = low+1; mid < high; ++mid) {
-		uint32_t mval = ((uint32_t)*mid) << bit;
-		*p++   |= (mval >> 0)       & SC_MASK;
-		*p      = (mval >> SC_BITS) & SC_MASK;
-	}
-	/* partially apply the highest byte */
-	uint32_t hval = ((uint32_t)(*high) << (32-high_bit)) >> (32-high_bit-bit);
-	*p++ |= (hval >> 0)       & SC_MASK;
-	if ((hval >> SC_BITS) != 0)
-		*p++ = (hval >> SC_BITS) & SC_MASK;
-
-clear_rest:
-	assert(p <= buffer + calc_buffer_size);
-	memset(p, 0, buffer+calc_buffer_size - p);
+	assert((to - from) <= calc_buffer_size * SC_BITS);
+	assert(SC_BITS % CHAR_BIT == 0);
+
+	sc_zero(buffer);
+
+	/* assemble the result byte by byte, each may be composed of two source
+	 * bytes */
+	unsigned const n_bits    = to - from;
+	unsigned const last_byte = (to - 1) / CHAR_BIT;
+	for (unsigned bit = 0; bit < n_bits; bit += CHAR_BIT) {
+		unsigned const pos      = from + bit;
+		unsigned const byte     = pos / CHAR_BIT;
+		unsigned const byte_bit = pos % CHAR_BIT;
+		unsigned       val      = bytes[byte] >> byte_bit;
+		if (byte_bit != 0 && byte < last_byte)
+			val |= (unsigned)bytes[byte + 1] << (CHAR_BIT - byte_bit);
+		if (n_bits - bit < CHAR_BIT)
+			val &= (1u << (n_bits - bit)) - 1;
+		else
+			val &= (1u << CHAR_BIT) - 1;
+		buffer[bit / SC_BITS] |= (sc_word)val << (bit % SC_BITS);
+	}
 }
 
 const char *sc_print(const sc_word *value, unsigned bits, enum base_t base,
@@ -679,25 +709,16 @@ char *sc_print_buf(char *buf, size_t buf_len, const sc_word *value,
 	*(--pos) = '\0';
 	assert(pos >= buf);
 
-	unsigned n_full_words   = bits / SC_BITS;
-	unsigned remaining_bits = bits % SC_BITS;
 	switch (base) {
 	case SC_HEX: {
-		assert(SC_BITS == 8);
-		unsigned counter = 0;
-		for ( ; counter < n_full_words; ++counter) {
-			sc_word x = value[counter];
-			*(--pos) = digits[(x >> 0) & 0xf];
-			*(--pos) = digits[(x >> 4) & 0xf];
-		}
-
-		/* last nibble must be masked */
-		if (remaining_bits != 0) {
-			sc_word mask = max_digit(remaining_bits);
-			sc_word x    = value[counter++] & mask;
-			*(--pos) = digits[(x >> 0) & 0xf];
-			*(--pos) = digits[(x >> 4) & 0xf];
-			assert(pos >= buf);
+		unsigned const n_nibbles = (bits + 3) / 4;
+		for (unsigned nibble = 0; nibble < n_nibbles; ++nibble) {
+			unsigned const bit = nibble * 4;
+			unsigned       x   = (value[bit / SC_BITS] >> (bit % SC_BITS)) & 0xf;
+			/* last nibble must be masked */
+			if (bits - bit < 4)
+				x &= (1u << (bits - bit)) - 1;
+			*(--pos) = digits[x];
 		}
 
 		/* now kill zeros */
@@ -709,47 +730,31 @@ char *sc_print_buf(char *buf, size_t buf_len, const sc_word *value,
 		return pos;
 	}
 	case SC_DEC: {
-		sc_word *base_val = ALLOCANZ(sc_word, calc_buffer_size);
-		base_val[0] = 10;
-
-		const sc_word *p        = value;
-		bool           sign     = false;
-		sc_word       *div2_res = ALLOCAN(sc_word, calc_buffer_size);
+		const sc_word *p    = value;
+		bool           sign = false;
+		sc_word       *neg  = ALLOCAN(sc_word, calc_buffer_size);
 		if (is_signed) {
 			/* check for negative values */
 			if (sc_get_bit_at(value, bits-1)) {
-				sc_neg(value, div2_res);
+				sc_neg(value, neg);
 				sign = true;
-				p = div2_res;
+				p = neg;
 			}
 		}
 
-		/* transfer data into oscillating buffers */
-		sc_word *div1_res = ALLOCANZ(sc_word, calc_buffer_size);
-		unsigned counter = 0;
-		for ( ; counter < n_full_words; ++counter)
-			div1_res[counter] = p[counter];
-
-		/* last nibble must be masked */
-		if (bits % SC_BITS) {
-			sc_word mask = max_digit(bits % SC_BITS);
-			div1_res[counter] = p[counter] & mask;
-			++counter;
-		}
+		/* transfer data into the division buffer, the last word must be
+		 * masked */
+		sc_word *div_res = ALLOCANZ(sc_word, calc_buffer_size);
+		unsigned n_words = (bits + SC_BITS - 1) / SC_BITS;
+		memcpy(div_res, p, n_words * sizeof(div_res[0]));
+		sc_zero_extend(div_res, bits);
 
-		sc_word *m       = div1_res;
-		sc_word *n       = div2_res;
-		sc_word *rem_res = ALLOCAN(sc_word, calc_buffer_size);
 		for (;;) {
-			sc_divmod(m, base_val, n, rem_res);
-			sc_word *t = m;
-			m = n;
-			n = t;
-			*(--pos) = digits[rem_res[0]];
+			*(--pos) = digits[div_by_word(div_res, n_words, 10)];
 
 			sc_word x = 0;
-			for (unsigned i = 0; i < calc_buffer_size; ++i)
-				x |= m[i];
+			for (unsigned i = 0; i < n_words; ++i)
+				x |= div_res[i];
 
 			if (x == 0)
 				break;
@@ -818,18 +823,16 @@ void sc_shlI(const sc_word *value, unsigned shift_count, sc_word *buffer)
 			buffer[counter] = value[counter - shift_words];
 		}
 	} else {
-		sc_word val = value[calc_buffer_size - shift_words - 1];
 		for (unsigned counter = calc_buffer_size; counter-- > shift_words; ) {
-			unsigned nextpos = counter - shift_words - 1;
-			sc_word  next    = nextpos < calc_buffer_size ? value[nextpos] : 0;
-			buffer[counter] = SC_RESULT(val << shift_bits)
-			                | SC_RESULT(next >> (SC_BITS - shift_bits));
-			val = next;
+			unsigned const pos  = counter - shift_words;
+			sc_word  const next = pos > 0 ? value[pos - 1] : 0;
+			buffer[counter] = (value[pos] << shift_bits)
+			                | (next >> (SC_BITS - shift_bits));
 		}
 	}
 
 	/* fill up with zeros */
-	memset(buffer, 0, shift_words);
+	memset(buffer, 0, shift_words * sizeof(buffer[0]));
 }
 
 void sc_shl(const sc_word *val1, const sc_word *val2, sc_word *buffer)
@@ -839,46 +842,52 @@ void sc_shl(const sc_word *val1, const sc_word *val2, sc_word *buffer)
 	sc_shlI(val1, shift_count, buffer);
 }
 
-bool sc_shrI(const sc_word *value, unsigned shift_count, sc_word *buffer)
+/**
+ * Shifts the value right, filling the upper words with @p fill.
+ */
+static void shift_right(const sc_word *value, unsigned shift_count,
+                        sc_word fill, sc_word *buffer)
 {
-	if (shift_count >= calc_buffer_size*SC_BITS) {
-		bool carry_flag = !sc_is_zero(value, calc_buffer_size*SC_BITS);
-		sc_zero(buffer);
-		return carry_flag;
-	}
-
 	unsigned shift_words = shift_count / SC_BITS;
 	unsigned shift_bits  = shift_count % SC_BITS;
+	unsigned limit       = calc_buffer_size - shift_words;
 
-	/* determine carry flag */
-	bool carry_flag = false;
-	for (unsigned i = 0; i < shift_words; ++i) {
-		if (value[i] != 0) {
-			carry_flag = true;
-			break;
-		}
-	}
-
-	/* shift to the right */
 	if (shift_bits == 0) {
 		/* fast path */
-		for (unsigned i = 0; i < calc_buffer_size-shift_words; ++i) {
+		for (unsigned i = 0; i < limit; ++i) {
 			buffer[i] = value[i+shift_words];
 		}
 	} else {
-		sc_word val = value[shift_words];
-		carry_flag |= val & max_digit(shift_bits);
-		for (unsigned i = 0; i < calc_buffer_size-shift_words; ++i) {
+		for (unsigned i = 0; i < limit; ++i) {
 			unsigned next_pos = i+shift_words+1;
-			sc_word  next = next_pos < calc_buffer_size ? value[next_pos] : 0;
-			buffer[i] = SC_RESULT(val >> shift_bits)
-			          | SC_RESULT(next << (SC_BITS - shift_bits));
-			val = next;
+			sc_word  next     = next_pos < calc_buffer_size ? value[next_pos]
+			                                                : fill;
+			buffer[i] = (value[i+shift_words] >> shift_bits)
+			          | (next << (SC_BITS - shift_bits));
 		}
 	}
 
-	/* fill upper words with zero */
-	memset(&buffer[calc_buffer_size-shift_words], 0, shift_words);
+	/* fill upper words */
+	sc_fill(buffer, fill, limit);
+}
+
+/** Returns true if any of the lower @p bits bits of the value is set. */
+static bool lower_bits_set(const sc_word *value, unsigned bits)
+{
+	return !sc_is_zero(value, bits);
+}
+
+bool sc_shrI(const sc_word *value, unsigned shift_count, sc_word *buffer)
+{
+	if (shift_count >= calc_buffer_size*SC_BITS) {
+		bool carry_flag = !sc_is_zero(value, calc_buffer_size*SC_BITS);
+		sc_zero(buffer);
+		return carry_flag;
+	}
+
+	/* determine carry flag */
+	bool carry_flag = lower_bits_set(value, shift_count);
+	shift_right(value, shift_count, 0, buffer);
 	return carry_flag;
 }
 
@@ -897,49 +906,18 @@ bool sc_shrsI(const sc_word *value, unsigned shift_count, unsigned bitsize,
 	/* if shifting far enough the result is either 0 or -1 */
 	if (shift_count >= bitsize) {
 		bool carry_flag = !sc_is_zero(value, calc_buffer_size*SC_BITS);
-		assert(SC_BITS <= CHAR_BIT);
-		memset(buffer, sign, calc_buffer_size);
+		sc_fill(buffer, sign, 0);
 		return carry_flag;
 	}
 
-	unsigned shift_words = shift_count / SC_BITS;
-	unsigned shift_bits  = shift_count % SC_BITS;
-
 	/* determine carry flag */
-	bool carry_flag = false;
-	for (unsigned i = 0; i < shift_words; ++i) {
-		if (value[i] != 0) {
-			carry_flag = true;
-			break;
-		}
-	}
-
-	/* TODO: bitsize % SC_BITS != 0 not implemented yet */
-	assert(bitsize % SC_BITS == 0);
-	unsigned limit = bitsize / SC_BITS;
-
-	/* shift to the right */
-	if (shift_bits == 0) {
-		/* fast path */
-		for (unsigned i = 0; i < limit-shift_words; ++i) {
-			buffer[i] = value[i+shift_words];
-		}
-	} else {
-		sc_word val = value[shift_words];
-		carry_flag |= val & max_digit(shift_bits);
-		for (unsigned i = 0; i < limit-shift_words; ++i) {
-			unsigned next_pos = i+shift_words+1;
-			sc_word next = next_pos<limit ? value[next_pos] : sign;
-			buffer[i] = SC_RESULT(val >> shift_bits)
-			          | SC_RESULT(next << (SC_BITS - shift_bits));
-			val = next;
-		}
-	}
+	bool carry_flag = lower_bits_set(value, shift_count);
 
-	/* fill upper words with extended sign */
-	assert(SC_BITS <= CHAR_BIT);
-	memset(&buffer[limit-shift_words], sign,
-	       calc_buffer_size-(limit-shift_words));
+	/* shift the value sign extended from bitsize */
+	sc_word *temp = ALLOCAN(sc_word, calc_buffer_size);
+	sc_copy(temp, value);
+	sc_sign_extend(temp, bitsize);
+	shift_right(temp, shift_count, sign, buffer);
 	return carry_flag;
 }
 
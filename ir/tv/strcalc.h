@@ -16,9 +16,10 @@
 #include <stdlib.h>
 #include "firm_types.h"
 
-#define SC_BITS 8
+#define SC_BITS 64
 
-typedef uint8_t sc_word;
+/** Values are stored as little endian arrays of 64bit limbs. */
+typedef uint64_t sc_word;
 
 /**
  * The output mode for integer values.
@@ -247,8 +248,8 @@ unsigned sc_get_precision(void);
 /** Return the bit at a given position. */
 static inline bool sc_get_bit_at(const sc_word *value, unsigned pos)
 {
-	unsigned nibble = pos / SC_BITS;
-	return (value[nibble] >> (pos % SC_BITS)) & 1;
+	unsigned word = pos / SC_BITS;
+	return (value[word] >> (pos % SC_BITS)) & 1;
 }
 
 /** Set the bit at the specified position. */
@@ -51,10 +51,23 @@ static unsigned fp_value_size;
 /** The integer overflow mode. */
 static bool wrap_on_overflow = true;
 
+/** Number of entries in the cache of recently created small integer
+ * tarvals, must be a power of 2. */
+#define SMALL_TARVAL_CACHE_SIZE 256
+
+typedef struct small_tarval_cache_entry_t {
+	ir_mode   *mode;
+	uint64_t   value;
+	ir_tarval *tv;
+} small_tarval_cache_entry_t;
+
+/** Direct mapped cache of recently created small integer tarvals. */
+static small_tarval_cache_entry_t small_tarval_cache[SMALL_TARVAL_CACHE_SIZE];
+
 /** Hash a tarval. */
 static unsigned hash_tv(ir_tarval const *const tv)
 {
-	return hash_combine(hash_ptr(tv->mode), hash_data(tv->value, tv->length));
+	return hash_combine(hash_ptr(tv->mode), hash_data((unsigned char const*)tv->value, tv->length));
 }
 
 static int cmp_tv(const void *p1, const void *p2, size_t n)
@@ -77,7 +90,8 @@ static ir_tarval *identify_tarval(ir_tarval const *const tv)
 
 static ir_tarval *get_fp_tarval(const fp_value *value, ir_mode *mode)
 {
-	ir_tarval *const tv = ALLOCAF(ir_tarval, value, fp_value_size);
+	ir_tarval *const tv = ALLOCAF(ir_tarval, value,
+	                              fp_value_size / sizeof(sc_word));
 	tv->kind   = k_tarval;
 	tv->mode   = mode;
 	tv->length = fp_value_size;
@@ -88,7 +102,7 @@ static ir_tarval *get_fp_tarval(const fp_value *value, ir_mode *mode)
 static ir_tarval *get_int_tarval(const sc_word *value, ir_mode *mode)
 {
 	unsigned size = sc_value_length * sizeof(sc_word);
-	ir_tarval *const tv = ALLOCAF(ir_tarval, value, size);
+	ir_tarval *const tv = ALLOCAF(ir_tarval, value, sc_value_length);
 	tv->kind   = k_tarval;
 	tv->mode   = mode;
 	tv->length = size;
@@ -127,6 +141,146 @@ static ir_tarval *get_int_tarval_overflow(const sc_word *value, ir_mode *mode)
 	return get_int_tarval(value, mode);
 }
 
+/**
+ * Returns true if tarvals of the mode are computed with native 64bit
+ * arithmetic instead of strcalc.
+ */
+static inline bool is_small_int_mode(ir_mode const *const mode)
+{
+	return get_mode_arithmetic(mode) == irma_twos_complement
+	    && get_mode_size_bits(mode) <= 64;
+}
+
+/**
+ * Returns the lower 64 bits of an integer tarval.  For small integer modes
+ * this is the value sign or zero extended to 64 bits.
+ */
+static inline uint64_t get_small_value(ir_tarval const *const tv)
+{
+	return tv->value[0];
+}
+
+/** Sign or zero extends the lower @p bits bits of a value to 64 bits. */
+static inline uint64_t extend_small_value(uint64_t value, unsigned bits,
+                                          bool is_signed)
+{
+	if (bits >= 64)
+		return value;
+	uint64_t const mask = ((uint64_t)1 << bits) - 1;
+	value &= mask;
+	if (is_signed && (value >> (bits - 1)) & 1)
+		value |= ~mask;
+	return value;
+}
+
+/** Arithmetic right shift of a 64bit value. */
+static inline uint64_t shrs_small_value(uint64_t value, unsigned shift)
+{
+	assert(shift < 64);
+	return value >> 63 ? ~(~value >> shift) : value >> shift;
+}
+
+/**
+ * Returns the tarval for the lower bits of @p value in the small integer
+ * mode @p mode.  The result wraps around on overflow.
+ */
+static ir_tarval *get_small_int_tarval(uint64_t value, ir_mode *const mode)
+{
+	assert(is_small_int_mode(mode));
+	bool const is_signed = mode_is_signed(mode);
+	value = extend_small_value(value, get_mode_size_bits(mode), is_signed);
+
+	unsigned const hash = hash_combine(hash_ptr(mode),
+	                                   (unsigned)(value ^ (value >> 32)));
+	small_tarval_cache_entry_t *const entry
+		= &small_tarval_cache[hash & (SMALL_TARVAL_CACHE_SIZE - 1)];
+	if (entry->mode == mode && entry->value == value)
+		return entry->tv;
+
+	ir_tarval *const tv = ALLOCAF(ir_tarval, value, sc_value_length);
+	tv->kind     = k_tarval;
+	tv->mode     = mode;
+	tv->length   = sc_value_length * sizeof(sc_word);
+	tv->value[0] = value;
+	sc_word const ext = is_signed && value >> 63 ? ~(sc_word)0 : 0;
+	for (unsigned i = 1; i < sc_value_length; ++i)
+		tv->value[i] = ext;
+
+	ir_tarval *const res = identify_tarval(tv);
+	entry->mode  = mode;
+	entry->value = value;
+	entry->tv    = res;
+	return res;
+}
+
+/**
+ * Determines the shift amount for shifting a value of the small integer mode
+ * @p mode by @p b.  Returns false if it cannot be computed natively.
+ */
+static bool get_small_shift_count(ir_tarval const *const b,
+                                  ir_mode const *const mode,
+                                  unsigned *const count)
+{
+	if (!is_small_int_mode(b->mode))
+		return false;
+	uint64_t amount = get_small_value(b);
+	if (mode_is_signed(b->mode) && amount >> 63)
+		return false;
+	unsigned const modulo = get_mode_modulo_shift(mode);
+	if (modulo != 0)
+		amount %= modulo;
+	*count = amount < 64 ? (unsigned)amount : 64;
+	return true;
+}
+
+static ir_tarval *small_shl(ir_tarval const *const a, unsigned const count)
+{
+	if (count >= 64)
+		return get_mode_null(a->mode);
+	return get_small_int_tarval(get_small_value(a) << count, a->mode);
+}
+
+static ir_tarval *small_shr(ir_tarval const *const a, unsigned const count)
+{
+	ir_mode *const mode  = a->mode;
+	uint64_t const value = extend_small_value(get_small_value(a),
+	                                          get_mode_size_bits(mode), false);
+	if (count >= 64)
+		return get_mode_null(mode);
+	return get_small_int_tarval(value >> count, mode);
+}
+
+static ir_tarval *small_shrs(ir_tarval const *const a, unsigned const count)
+{
+	ir_mode *const mode  = a->mode;
+	uint64_t const value = extend_small_value(get_small_value(a),
+	                                          get_mode_size_bits(mode), true);
+	return get_small_int_tarval(shrs_small_value(value, MIN(count, 63)), mode);
+}
+
+/**
+ * Divides two values of the small integer mode @p mode, rounding towards
+ * zero.  Stores the remainder in @p mod.
+ */
+static uint64_t small_divmod(uint64_t const a, uint64_t const b,
+                             ir_mode const *const mode, uint64_t *const mod)
+{
+	assert(b != 0);
+	if (mode_is_signed(mode)) {
+		int64_t const sa = (int64_t)a;
+		int64_t const sb = (int64_t)b;
+		/* avoid the overflow of INT64_MIN / -1 */
+		if (sb == -1) {
+			*mod = 0;
+			return -a;
+		}
+		*mod = (uint64_t)(sa % sb);
+		return (uint64_t)(sa / sb);
+	}
+	*mod = a % b;
+	return a / b;
+}
+
 static ir_tarval tarval_bad_obj;
 static ir_tarval tarval_unknown_obj;
 
@@ -206,7 +360,7 @@ ir_tarval *new_tarval_from_str(const char *str, size_t len, ir_mode *mode)
 
 	switch (get_mode_sort(mode)) {
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_val_from_str(str, len, buffer);
 		fc_cast(buffer, get_descriptor(mode), buffer);
 		return get_fp_tarval(buffer, mode);
@@ -226,6 +380,9 @@ ir_tarval *new_tarval_from_str(const char *str, size_t len, ir_mode *mode)
 ir_tarval *new_tarval_from_long(long l, ir_mode *mode)
 {
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval((uint64_t)(int64_t)l, mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_val_from_long(l, buffer);
 	return get_int_tarval(buffer, mode);
@@ -239,7 +396,7 @@ ir_tarval *new_tarval_nan(ir_mode *mode, int signaling,
 	sc_word const *sc_payload = payload != NULL ? payload->value : NULL;
 
 	assert(mode_is_float(mode));
-	fp_value                 *buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+	fp_value                 *buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 	const float_descriptor_t *desc   = get_descriptor(mode);
 	fc_get_nan(desc, buffer, signaling, sc_payload);
 	return get_fp_tarval(buffer, mode);
@@ -258,7 +415,7 @@ ir_tarval *new_tarval_from_bytes(unsigned char const *buf,
 	}
 	case irma_ieee754:
 	case irma_x86_extended_float: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_val_from_bytes(buffer, buf, get_descriptor(mode));
 		return get_fp_tarval(buffer, mode);
 	}
@@ -341,7 +498,7 @@ uint64_t get_tarval_uint64(ir_tarval const *tv)
 ir_tarval *new_tarval_from_long_double(long double d, ir_mode *mode)
 {
 	assert(mode_is_float(mode));
-	fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+	fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 	fc_val_from_ieee754(d, buffer);
 	fc_cast(buffer, get_descriptor(mode), buffer);
 	return get_fp_tarval(buffer, mode);
@@ -411,7 +568,7 @@ ir_tarval *(get_tarval_b_true)(void)
 ir_tarval *get_tarval_small(ir_mode *mode)
 {
 	assert(mode_is_float(mode));
-	fp_value                 *buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+	fp_value                 *buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 	const float_descriptor_t *desc   = get_descriptor(mode);
 	fc_get_small(desc, buffer);
 	return get_fp_tarval(buffer, mode);
@@ -420,7 +577,7 @@ ir_tarval *get_tarval_small(ir_mode *mode)
 ir_tarval *get_tarval_epsilon(ir_mode *mode)
 {
 	assert(mode_is_float(mode));
-	fp_value                 *buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+	fp_value                 *buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 	const float_descriptor_t *desc   = get_descriptor(mode);
 	fc_get_epsilon(desc, buffer);
 	return get_fp_tarval(buffer, mode);
@@ -431,7 +588,7 @@ void init_mode_values(ir_mode* mode)
 	switch (get_mode_sort(mode)) {
 	case irms_float_number: {
 		const float_descriptor_t *desc = get_descriptor(mode);
-		fp_value                 *buf  = alloca(fp_value_size);
+		fp_value                 *buf  = (fp_value*)ALLOCANZ(char, fp_value_size);
 		mode->all_one     = tarval_bad;
 		fc_get_inf(desc, buf, false);
 		mode->infinity    = get_fp_tarval(buf, mode);
@@ -583,14 +740,14 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 		switch (get_mode_sort(dst_mode)) {
 		case irms_float_number: {
 			const float_descriptor_t *desc = get_descriptor(dst_mode);
-			fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+			fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 			fc_cast((const fp_value*)src->value, desc, buffer);
 			return get_fp_tarval(buffer, dst_mode);
 		}
 
 		case irms_reference:
 		case irms_int_number: {
-			fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+			fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 			fc_int((const fp_value*) src->value, buffer);
 			sc_word *intval = ALLOCAN(sc_word, sc_value_length);
 			flt2int_result_t cres
@@ -628,8 +785,12 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 
 		case irms_reference:
 		case irms_int_number: {
+			if (wrap_on_overflow && is_small_int_mode(src->mode)
+			    && is_small_int_mode(dst_mode))
+				return get_small_int_tarval(get_small_value(src), dst_mode);
+
 			sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
-			memcpy(buffer, src->value, sc_value_length);
+			memcpy(buffer, src->value, sc_value_length * sizeof(sc_word));
 			return get_int_tarval_overflow(buffer, dst_mode);
 		}
 
@@ -643,7 +804,7 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 			int len = snprintf(buffer, 100, "%s",
 				sc_print(src->value, get_mode_size_bits(src->mode), SC_DEC, mode_is_signed(src->mode)));
 
-			fp_value *fpval = (fp_value*)ALLOCAN(char, fp_value_size);
+			fp_value *fpval = (fp_value*)ALLOCANZ(char, fp_value_size);
 			fc_val_from_str(buffer, len, fpval);
 			fc_cast(fpval, get_descriptor(dst_mode), fpval);
 			return get_fp_tarval(fpval, dst_mode);
@@ -658,7 +819,7 @@ ir_tarval *tarval_convert_to(ir_tarval const *const src,
 	case irms_reference:
 		if (get_mode_arithmetic(dst_mode) == irma_twos_complement) {
 			sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
-			memcpy(buffer, src->value, sc_value_length);
+			memcpy(buffer, src->value, sc_value_length * sizeof(sc_word));
 			unsigned bits = get_mode_size_bits(src->mode);
 			if (mode_is_signed(src->mode)) {
 				sc_sign_extend(buffer, bits);
@@ -699,6 +860,9 @@ ir_tarval *tarval_not(ir_tarval const *const a)
 		return a == tarval_b_true ? tarval_b_false : tarval_b_true;
 
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(~get_small_value(a), mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_not(a->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -710,13 +874,16 @@ ir_tarval *tarval_neg(ir_tarval const *const a)
 	switch (get_mode_sort(mode)) {
 	case irms_int_number:
 	case irms_reference: {
+		if (wrap_on_overflow && is_small_int_mode(mode))
+			return get_small_int_tarval(-get_small_value(a), mode);
+
 		sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 		sc_neg(a->value, buffer);
 		return get_int_tarval_overflow(buffer, mode);
 	}
 
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_neg((const fp_value*)a->value, buffer);
 		return get_fp_tarval(buffer, mode);
 	}
@@ -745,13 +912,17 @@ ir_tarval *tarval_add(ir_tarval const *a, ir_tarval const *b)
 	case irms_int_number: {
 		/* modes of a,b are equal, so result has mode of a as this might be the
 		 * character */
+		if (wrap_on_overflow && is_small_int_mode(mode))
+			return get_small_int_tarval(get_small_value(a) + get_small_value(b),
+			                            mode);
+
 		sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 		sc_add(a->value, b->value, buffer);
 		return get_int_tarval_overflow(buffer, mode);
 	}
 
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_add((const fp_value*)a->value, (const fp_value*)b->value, buffer);
 		return get_fp_tarval(buffer, mode);
 	}
@@ -786,13 +957,17 @@ ir_tarval *tarval_sub(ir_tarval const *a, ir_tarval const *b)
 	case irms_int_number: {
 		/* modes of a,b are equal, so result has mode of a as this might be the
 		 * character */
+		if (wrap_on_overflow && is_small_int_mode(dst_mode))
+			return get_small_int_tarval(get_small_value(a) - get_small_value(b),
+			                            dst_mode);
+
 		sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 		sc_sub(a->value, b->value, buffer);
 		return get_int_tarval_overflow(buffer, dst_mode);
 	}
 
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_sub((const fp_value*)a->value, (const fp_value*)b->value, buffer);
 		return get_fp_tarval(buffer, dst_mode);
 	}
@@ -814,13 +989,17 @@ ir_tarval *tarval_mul(ir_tarval const *const a, ir_tarval const *const b)
 	case irms_int_number:
 	case irms_reference: {
 		/* modes of a,b are equal */
+		if (wrap_on_overflow && is_small_int_mode(mode))
+			return get_small_int_tarval(get_small_value(a) * get_small_value(b),
+			                            mode);
+
 		sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 		sc_mul(a->value, b->value, buffer);
 		return get_int_tarval_overflow(buffer, mode);
 	}
 
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_mul((const fp_value*)a->value, (const fp_value*)b->value, buffer);
 		return get_fp_tarval(buffer, mode);
 	}
@@ -845,13 +1024,20 @@ ir_tarval *tarval_div(ir_tarval const *const a, ir_tarval const *const b)
 		if (b == get_mode_null(mode))
 			return tarval_bad;
 
+		if (is_small_int_mode(mode)) {
+			uint64_t mod;
+			uint64_t quot = small_divmod(get_small_value(a),
+			                             get_small_value(b), mode, &mod);
+			return get_small_int_tarval(quot, mode);
+		}
+
 		sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 		sc_div(a->value, b->value, buffer);
 		return get_int_tarval(buffer, mode);
 	}
 
 	case irms_float_number: {
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_div((const fp_value*)a->value, (const fp_value*)b->value, buffer);
 		return get_fp_tarval(buffer, mode);
 	}
@@ -873,6 +1059,12 @@ ir_tarval *tarval_mod(ir_tarval const *const a, ir_tarval const *const b)
 	/* x/0 error */
 	if (b == get_mode_null(mode))
 		return tarval_bad;
+	if (is_small_int_mode(mode)) {
+		uint64_t mod;
+		small_divmod(get_small_value(a), get_small_value(b), mode, &mod);
+		return get_small_int_tarval(mod, mode);
+	}
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_mod(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -885,12 +1077,19 @@ ir_tarval *tarval_divmod(ir_tarval const *const a, ir_tarval const *const b,
 	assert(b->mode == mode);
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
 
-	sc_word *const div_res = ALLOCAN(sc_word, sc_value_length);
-	sc_word *const mod_res = ALLOCAN(sc_word, sc_value_length);
-
 	/* x/0 error */
 	if (b == get_mode_null(mode))
 		return tarval_bad;
+	if (is_small_int_mode(mode)) {
+		uint64_t mod_val;
+		uint64_t div_val = small_divmod(get_small_value(a),
+		                                get_small_value(b), mode, &mod_val);
+		*mod = get_small_int_tarval(mod_val, mode);
+		return get_small_int_tarval(div_val, mode);
+	}
+
+	sc_word *const div_res = ALLOCAN(sc_word, sc_value_length);
+	sc_word *const mod_res = ALLOCAN(sc_word, sc_value_length);
 	sc_divmod(a->value, b->value, div_res, mod_res);
 	*mod = get_int_tarval(mod_res, mode);
 	return get_int_tarval(div_res, mode);
@@ -911,6 +1110,10 @@ ir_tarval *tarval_and(ir_tarval const *const a, ir_tarval const *const b)
 		return a == tarval_b_false ? (ir_tarval*)a : (ir_tarval*)b;
 
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(get_small_value(a) & get_small_value(b),
+		                            mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_and(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -924,6 +1127,10 @@ ir_tarval *tarval_andnot(ir_tarval const *const a, ir_tarval const *const b)
 		return a == tarval_b_true && b == tarval_b_false ? tarval_b_true
 		                                                 : tarval_b_false;
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(get_small_value(a) & ~get_small_value(b),
+		                            mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_andnot(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -937,6 +1144,10 @@ ir_tarval *tarval_or(ir_tarval const *const a, ir_tarval const *const b)
 		return a == tarval_b_true ? (ir_tarval*)a : (ir_tarval*)b;
 
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(get_small_value(a) | get_small_value(b),
+		                            mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_or(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -950,6 +1161,10 @@ ir_tarval *tarval_ornot(ir_tarval const *const a, ir_tarval const *const b)
 		return a == tarval_b_true || b == tarval_b_false ? tarval_b_true
 		                                                 : tarval_b_false;
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(get_small_value(a) | ~get_small_value(b),
+		                            mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_ornot(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -963,6 +1178,10 @@ ir_tarval *tarval_eor(ir_tarval const *const a, ir_tarval const *const b)
 		return a == b ? tarval_b_false : tarval_b_true;
 
 	assert(get_mode_arithmetic(mode) == irma_twos_complement);
+	if (is_small_int_mode(mode))
+		return get_small_int_tarval(get_small_value(a) ^ get_small_value(b),
+		                            mode);
+
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
 	sc_xor(a->value, b->value, buffer);
 	return get_int_tarval(buffer, mode);
@@ -974,6 +1193,10 @@ ir_tarval *tarval_shl(ir_tarval const *const a, ir_tarval const *const b)
 	assert(get_mode_arithmetic(a_mode) == irma_twos_complement);
 	assert(get_mode_arithmetic(b->mode) == irma_twos_complement);
 
+	unsigned count;
+	if (is_small_int_mode(a_mode) && get_small_shift_count(b, a_mode, &count))
+		return small_shl(a, count);
+
 	sc_word *temp_val;
 	if (get_mode_modulo_shift(a_mode) != 0) {
 		temp_val = ALLOCAN(sc_word, sc_value_length);
@@ -997,6 +1220,9 @@ ir_tarval *tarval_shl_unsigned(ir_tarval const *const a, unsigned b)
 	unsigned const modulo = get_mode_modulo_shift(mode);
 	if (modulo != 0)
 		b %= modulo;
+	if (is_small_int_mode(mode))
+		return small_shl(a, MIN(b, 64));
+
 	assert((unsigned)(long)b==b);
 
 	sc_word *const buffer = ALLOCAN(sc_word, sc_value_length);
@@ -1010,6 +1236,10 @@ ir_tarval *tarval_shr(ir_tarval const *const a, ir_tarval const *const b)
 	assert(get_mode_arithmetic(a_mode) == irma_twos_complement);
 	assert(get_mode_arithmetic(b->mode) == irma_twos_complement);
 
+	unsigned count;
+	if (is_small_int_mode(a_mode) && get_small_shift_count(b, a_mode, &count))
+		return small_shr(a, count);
+
 	sc_word *temp_val;
 	if (get_mode_modulo_shift(a_mode) != 0) {
 		temp_val = ALLOCAN(sc_word, sc_value_length);
@@ -1022,7 +1252,7 @@ ir_tarval *tarval_shr(ir_tarval const *const a, ir_tarval const *const b)
 
 	sc_word *const temp = ALLOCAN(sc_word, sc_value_length);
 	/* workaround for unnecessary internal higher precision */
-	memcpy(temp, a->value, sc_value_length);
+	memcpy(temp, a->value, sc_value_length * sizeof(sc_word));
 	sc_zero_extend(temp, get_mode_size_bits(a_mode));
 	sc_shr(temp, temp_val, temp);
 	return get_int_tarval(temp, a_mode);
@@ -1036,11 +1266,14 @@ ir_tarval *tarval_shr_unsigned(ir_tarval const *const a, unsigned b)
 	unsigned const modulo = get_mode_modulo_shift(mode);
 	if (modulo != 0)
 		b %= modulo;
+	if (is_small_int_mode(mode))
+		return small_shr(a, MIN(b, 64));
+
 	assert((unsigned)(long)b==b);
 
 	sc_word *const temp = ALLOCAN(sc_word, sc_value_length);
 	/* workaround for unnecessary internal higher precision */
-	memcpy(temp, a->value, sc_value_length);
+	memcpy(temp, a->value, sc_value_length * sizeof(sc_word));
 	sc_zero_extend(temp, get_mode_size_bits(a->mode));
 	sc_shrI(temp, (long)b, temp);
 	return get_int_tarval(temp, mode);
@@ -1052,6 +1285,10 @@ ir_tarval *tarval_shrs(ir_tarval const *const a, ir_tarval const *const b)
 	assert(get_mode_arithmetic(a_mode) == irma_twos_complement);
 	assert(get_mode_arithmetic(b->mode) == irma_twos_complement);
 
+	unsigned count;
+	if (is_small_int_mode(a_mode) && get_small_shift_count(b, a_mode, &count))
+		return small_shrs(a, count);
+
 	sc_word *temp_val;
 	if (get_mode_modulo_shift(a_mode) != 0) {
 		temp_val = ALLOCAN(sc_word, sc_value_length);
@@ -1075,6 +1312,9 @@ ir_tarval *tarval_shrs_unsigned(ir_tarval const *const a, unsigned b)
 	unsigned const modulo = get_mode_modulo_shift(mode);
 	if (modulo != 0)
 		b %= modulo;
+	if (is_small_int_mode(mode))
+		return small_shrs(a, MIN(b, 64));
+
 	assert((unsigned)(long)b==b);
 
 	sc_word *const temp = ALLOCAN(sc_word, sc_value_length);
@@ -1173,7 +1413,7 @@ ir_tarval *ir_tarval_from_ascii(const char *buf, ir_mode *mode)
 			unsigned char val = hexval(buf[i*2]) | (hexval(buf[i*2+1]) << 4);
 			temp[i] = val;
 		}
-		fp_value *const buffer = (fp_value*)ALLOCAN(char, fp_value_size);
+		fp_value *const buffer = (fp_value*)ALLOCANZ(char, fp_value_size);
 		fc_val_from_bytes(buffer, temp, get_descriptor(mode));
 		return get_fp_tarval(buffer, mode);
 	}
@@ -1241,13 +1481,13 @@ unsigned get_tarval_magnitude(ir_tarval const *tv)
 	assert(get_mode_arithmetic(tv->mode) == irma_twos_complement);
 	unsigned const size = get_mode_size_bits(tv->mode);
 	unsigned const neg  = tarval_get_bit(tv, size - 1);
-	unsigned const ext  = neg ? (1U << SC_BITS) - 1 : 0;
+	unsigned const ext  = neg ? 0xFF : 0;
 
 	unsigned l = get_mode_size_bytes(tv->mode);
 	for (unsigned i = l; i-- != 0;) {
 		unsigned char const v = get_tarval_sub_bits(tv, i);
 		if (v != ext)
-			return i * SC_BITS + (32 - nlz(v ^ ext)) + 1;
+			return i * 8 + (32 - nlz(v ^ ext)) + 1;
 	}
 
 	return 1;
@@ -1319,9 +1559,10 @@ int tarval_get_wrap_on_overflow(void)
 
 static ir_tarval *make_b_tarval(unsigned char const val)
 {
-	ir_tarval *const tv = XMALLOCFZ(ir_tarval, value, sc_value_length);
-	tv->kind     = k_tarval;
-	tv->length   = sc_value_length;
+	unsigned   const size = sc_value_length * sizeof(sc_word);
+	ir_tarval *const tv   = XMALLOCFZ(ir_tarval, value, sc_value_length);
+	tv->kind   = k_tarval;
+	tv->length = size;
 	tv->value[0] = val;
 	/* mode will be set later */
 	return tv;
@@ -1360,6 +1601,7 @@ void finish_tarval(void)
 {
 	finish_strcalc();
 	del_set(tarvals); tarvals = NULL;
+	memset(small_tarval_cache, 0, sizeof(small_tarval_cache));
 }
 
 bool tarval_in_range(ir_tarval const *const min, ir_tarval const *const val, ir_tarval const *const max)
@@ -8,9 +8,84 @@ import re
 import time
 import stat
 import fileinput
+import gzip
+import struct
 import tempfile
 import optparse
 
+STATEV_MAGIC = b"FIRMEV\x00\x01"
+
+
+class BinaryReader:
+    """Decodes the binary event stream written by stat_ev_begin_binary into
+    the same records as the textual format."""
+
+    def __init__(self, name):
+        if name.endswith(".gz"):
+            f = gzip.open(name, "rb")
+        else:
+            f = open(name, "rb")
+        self.data = bytearray(f.read())
+        f.close()
+        self.pos = len(STATEV_MAGIC)
+        self.keys = dict()
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.data[self.pos]
+            self.pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                return value
+
+    def string(self):
+        length = self.varint()
+        value = bytes(self.data[self.pos:self.pos+length])
+        self.pos += length
+        return value.decode("utf-8", "replace")
+
+    def records(self):
+        while self.pos < len(self.data):
+            tag = chr(self.data[self.pos])
+            self.pos += 1
+            id = self.varint()
+            if tag == 'K':
+                self.keys[id] = self.string()
+                continue
+
+            key = self.keys[id]
+            if tag == 'P':
+                yield ['P', key, self.string()]
+            elif tag == 'O':
+                yield ['O', key]
+            elif tag == 'I':
+                value = self.varint()
+                yield ['E', key, (value >> 1) ^ -(value & 1)]
+            elif tag == 'U':
+                yield ['E', key, self.varint()]
+            elif tag == 'D':
+                data = bytes(self.data[self.pos:self.pos+8])
+                self.pos += 8
+                yield ['E', key, struct.unpack("<d", data)[0]]
+            elif tag == 'E':
+                yield ['E', key, 0.0]
+            else:
+                print("%s: invalid record '%s'" % (self.pos, tag))
+                sys.exit(1)
+
+
+def is_binary(name):
+    if name.endswith(".gz"):
+        f = gzip.open(name, "rb")
+    else:
+        f = open(name, "rb")
+    magic = f.read(len(STATEV_MAGIC))
+    f.close()
+    return magic == STATEV_MAGIC
+
 
 class DummyFilter:
     def match(self, dummy):
@@ -275,11 +350,8 @@ class Conv:
 
         self.valid_keys = set()
 
-        inp = self.input()
-
-        for line in inp:
+        for fields in self.records():
             linenr += 1
-            fields = line.strip().split(";")
             if fields[0] == 'P':
                 if (len(fields)-1) % 2 != 0:
                     print("%s: Invalid number of fields after 'P'" % linenr)
@@ -311,9 +383,16 @@ class Conv:
         self.evcols = evcols
         return (ctxlist, evlist)
 
-    def input(self):
-        return fileinput.FileInput(files=self.files,
-                                   openhook=fileinput.hook_compressed)
+    def records(self):
+        for file in self.files:
+            if is_binary(file):
+                for items in BinaryReader(file).records():
+                    yield items
+            else:
+                inp = fileinput.FileInput(files=[file],
+                                          openhook=fileinput.hook_compressed)
+                for line in inp:
+                    yield line.strip().split(';')
 
     def flush_events(self, id):
         isnull = True
@@ -345,9 +424,8 @@ class Conv:
         self.ctxvals = [None] * len(self.ctxcols)
         self.evvals = [None] * len(self.evcols)
 
-        for line in self.input():
+        for items in self.records():
             lineno += 1
-            items = line.strip().split(';')
             op = items[0]
 
             # Push context command
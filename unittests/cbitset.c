@@ -0,0 +1,160 @@
+#include "cbitset.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "raw_bitset.h"
+
+#define N_BITS 8192
+
+/* Checks that set equals the reference raw bitset ref. */
+static void check(cbitset_t const *set, unsigned const *ref)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < N_BITS; ++i) {
+		assert(cbitset_is_set(set, i) == rbitset_is_set(ref, i));
+		if (rbitset_is_set(ref, i))
+			++count;
+	}
+	assert(cbitset_popcount(set) == count);
+	assert(cbitset_is_empty(set) == (count == 0));
+
+	size_t expected = rbitset_next_max(ref, 0, N_BITS, true);
+	cbitset_foreach(set, elm) {
+		assert(elm == expected);
+		expected = rbitset_next_max(ref, elm + 1, N_BITS, true);
+	}
+	assert(expected == (size_t)-1);
+}
+
+/* Fills set and ref with a mix of sparse, dense and full chunks. */
+static void fill(cbitset_t *set, unsigned *ref, unsigned seed)
+{
+	srand(seed);
+	for (size_t chunk = 0; chunk < N_BITS / CBITSET_CHUNK_BITS; ++chunk) {
+		size_t const base = chunk * CBITSET_CHUNK_BITS;
+		int    n;
+		switch (rand() % 4) {
+		case 0:  n = 0;                      break;
+		case 1:  n = rand() % 40;            break;
+		case 2:  n = 100 + rand() % 500;     break;
+		default: n = CBITSET_CHUNK_BITS * 2; break;
+		}
+		if (n == CBITSET_CHUNK_BITS * 2) {
+			for (size_t i = 0; i < CBITSET_CHUNK_BITS; ++i) {
+				cbitset_set(set, base + i);
+				rbitset_set(ref, base + i);
+			}
+			continue;
+		}
+		for (int i = 0; i < n; ++i) {
+			size_t const bit = base + rand() % CBITSET_CHUNK_BITS;
+			cbitset_set(set, bit);
+			rbitset_set(ref, bit);
+		}
+	}
+}
+
+static void test_set_clear(void)
+{
+	cbitset_t set;
+	cbitset_init(&set);
+	unsigned *ref = rbitset_malloc(N_BITS);
+	check(&set, ref);
+	assert(cbitset_next(&set, 0) == (size_t)-1);
+
+	fill(&set, ref, 1);
+	check(&set, ref);
+
+	/* Clearing goes through the full -> dense -> sparse transitions. */
+	for (int i = 0; i < 20000; ++i) {
+		size_t const bit = rand() % N_BITS;
+		if (rand() % 3 == 0) {
+			cbitset_set(&set, bit);
+			rbitset_set(ref, bit);
+		} else {
+			cbitset_clear(&set, bit);
+			rbitset_clear(ref, bit);
+		}
+	}
+	check(&set, ref);
+
+	for (size_t i = 0; i < N_BITS; ++i)
+		cbitset_clear(&set, i);
+	rbitset_clear_all(ref, N_BITS);
+	check(&set, ref);
+
+	free(ref);
+	cbitset_free(&set);
+}
+
+static void test_bulk(unsigned seed)
+{
+	cbitset_t a;
+	cbitset_t b;
+	cbitset_t c;
+	cbitset_init(&a);
+	cbitset_init(&b);
+	cbitset_init(&c);
+	unsigned *ref_a = rbitset_malloc(N_BITS);
+	unsigned *ref_b = rbitset_malloc(N_BITS);
+	unsigned *ref_c = rbitset_malloc(N_BITS);
+	fill(&a, ref_a, seed);
+	fill(&b, ref_b, seed * 7 + 3);
+
+	assert(cbitset_intersect(&a, &b) == rbitsets_have_common(ref_a, ref_b, N_BITS));
+
+	cbitset_copy(&c, &a);
+	rbitset_copy(ref_c, ref_a, N_BITS);
+	check(&c, ref_c);
+	bool changed = cbitset_or(&c, &b);
+	assert(changed == rbitset_or_changed(ref_c, ref_b, N_BITS));
+	check(&c, ref_c);
+	assert(!cbitset_or(&c, &b));
+	assert(!cbitset_or(&c, &a));
+
+	cbitset_copy(&c, &a);
+	rbitset_copy(ref_c, ref_a, N_BITS);
+	changed = cbitset_and(&c, &b);
+	assert(changed == rbitset_and_changed(ref_c, ref_b, N_BITS));
+	check(&c, ref_c);
+	assert(!cbitset_and(&c, &b));
+	assert(!cbitset_and(&c, &a));
+	assert(cbitset_intersect(&c, &a) == !cbitset_is_empty(&c));
+
+	cbitset_clear_all(&c);
+	rbitset_clear_all(ref_c, N_BITS);
+	check(&c, ref_c);
+	assert(!cbitset_intersect(&c, &a));
+
+	free(ref_c);
+	free(ref_b);
+	free(ref_a);
+	cbitset_free(&c);
+	cbitset_free(&b);
+	cbitset_free(&a);
+}
+
+/* A contiguous range uses full chunks and little memory. */
+static void test_memory(void)
+{
+	cbitset_t set;
+	cbitset_init(&set);
+	for (size_t i = 1000; i < 1000000; ++i)
+		cbitset_set(&set, i);
+	assert(cbitset_popcount(&set) == 999000);
+	assert(cbitset_next(&set, 0) == 1000);
+	assert(cbitset_next(&set, 999999) == 999999);
+	assert(cbitset_next(&set, 1000000) == (size_t)-1);
+	assert(cbitset_get_memory(&set) < 1000000 / 32);
+	cbitset_free(&set);
+}
+
+int main(void)
+{
+	test_set_clear();
+	for (unsigned seed = 0; seed < 20; ++seed)
+		test_bulk(seed);
+	test_memory();
+	return 0;
+}
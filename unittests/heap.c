@@ -0,0 +1,118 @@
+#include "heap.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#define N_NODES 1000
+
+typedef struct node_t {
+	int          value;
+	heap_entry_t entry;
+} node_t;
+
+static node_t nodes[N_NODES];
+
+static node_t *pop(heap_t *const heap)
+{
+	node_t *const node = heap_container(heap_pop_max(heap), node_t, entry);
+	assert(!heap_contains(&node->entry));
+	return node;
+}
+
+static void test_order(void)
+{
+	heap_t heap;
+	heap_init(&heap);
+	assert(heap_empty(&heap));
+
+	for (int i = 0; i < N_NODES; ++i) {
+		node_t *const node = &nodes[i];
+		node->value = rand() % 100;
+		heap_entry_init(&node->entry);
+		assert(!heap_contains(&node->entry));
+		heap_insert(&heap, &node->entry, node->value);
+		assert(heap_contains(&node->entry));
+	}
+	assert(heap_length(&heap) == N_NODES);
+
+	int last = 100;
+	while (!heap_empty(&heap)) {
+		node_t *const node = pop(&heap);
+		assert(node->value <= last);
+		last = node->value;
+	}
+
+	heap_free(&heap);
+}
+
+static void test_set_priority(void)
+{
+	heap_t heap;
+	heap_init(&heap);
+
+	for (int i = 0; i < N_NODES; ++i) {
+		node_t *const node = &nodes[i];
+		node->value = i;
+		heap_entry_init(&node->entry);
+		heap_insert(&heap, &node->entry, node->value);
+	}
+	/* move every third node up or down */
+	for (int i = 0; i < N_NODES; i += 3) {
+		node_t *const node = &nodes[i];
+		node->value = i % 2 == 0 ? node->value + N_NODES / 2
+		                         : node->value - N_NODES / 2;
+		heap_set_priority(&heap, &node->entry, node->value);
+	}
+
+	int last = N_NODES * 2;
+	for (int i = 0; i < N_NODES; ++i) {
+		node_t *const node = pop(&heap);
+		assert(node->value <= last);
+		last = node->value;
+	}
+	assert(heap_empty(&heap));
+
+	heap_free(&heap);
+}
+
+static void test_remove(void)
+{
+	heap_t heap;
+	heap_init(&heap);
+
+	for (int i = 0; i < N_NODES; ++i) {
+		node_t *const node = &nodes[i];
+		node->value = rand() % N_NODES;
+		heap_entry_init(&node->entry);
+		heap_insert(&heap, &node->entry, node->value);
+	}
+	for (int i = 0; i < N_NODES; i += 2) {
+		heap_remove(&heap, &nodes[i].entry);
+		assert(!heap_contains(&nodes[i].entry));
+	}
+	assert(heap_length(&heap) == N_NODES / 2);
+
+	int last = N_NODES;
+	while (!heap_empty(&heap)) {
+		node_t *const node = pop(&heap);
+		assert((node - nodes) % 2 == 1);
+		assert(node->value <= last);
+		last = node->value;
+	}
+
+	/* removed entries may be queued again */
+	heap_insert(&heap, &nodes[0].entry, 1);
+	heap_insert(&heap, &nodes[2].entry, 2);
+	assert(pop(&heap) == &nodes[2]);
+	assert(pop(&heap) == &nodes[0]);
+
+	heap_free(&heap);
+}
+
+int main(void)
+{
+	test_order();
+	test_set_priority();
+	test_remove();
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include <assert.h>
+#include <stdbool.h>
+
+#include "firm.h"
+
+/* Creates a method returning its last parameter. */
+static ir_entity *new_callee(char const *const name, size_t const n_params)
+{
+	ir_type *const type_int = get_type_for_mode(mode_Is);
+	ir_type *const mtp      = new_type_method(n_params, 1, false, cc_cdecl_set, mtp_no_property);
+	for (size_t i = 0; i < n_params; ++i)
+		set_method_param_type(mtp, i, type_int);
+	set_method_res_type(mtp, 0, type_int);
+
+	ir_entity *const ent = new_entity(get_glob_type(), new_id_from_str(name), mtp);
+	ir_graph  *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+	ir_node *const res = new_Proj(get_irg_args(irg), mode_Is, n_params - 1);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_r_cur_block(irg));
+	irg_finalize_cons(irg);
+	return ent;
+}
+
+static ir_node *new_call(ir_entity *const callee, int const n_args,
+                         ir_node *const *const args)
+{
+	ir_node *const ptr  = new_Address(callee);
+	ir_node *const call = new_Call(get_store(), ptr, n_args, args, get_entity_type(callee));
+	set_store(new_Proj(call, mode_M, pn_Call_M));
+	return call;
+}
+
+/* Checks whether the method called by call was specialized and, if so,
+ * that it returns the constant c. */
+static bool check_call(ir_node *const call, long const c)
+{
+	ir_graph *const irg = get_entity_linktime_irg(get_Call_callee(call));
+	ir_node  *const ret = get_Block_cfgpred(get_irg_end_block(irg), 0);
+	ir_node  *const res = get_Return_res(ret, 0);
+	if (!is_Const(res))
+		return false;
+	assert(get_tarval_long(get_Const_tarval(res)) == c);
+	return true;
+}
+
+/* Calls of methods with different numbers of parameters from one caller
+ * must not share the buffer for the constant arguments. */
+int main(void)
+{
+	ir_init();
+
+	ir_entity *const two   = new_callee("two", 2);
+	ir_entity *const three = new_callee("three", 3);
+	ir_entity *const sp    = new_callee("sp", 3);
+
+	ir_type *const type_int = get_type_for_mode(mode_Is);
+	ir_type *const mtp      = new_type_method(1, 1, false, cc_cdecl_set, mtp_no_property);
+	set_method_param_type(mtp, 0, type_int);
+	set_method_res_type(mtp, 0, type_int);
+	ir_entity *const ent = new_entity(get_glob_type(), new_id_from_str("caller"), mtp);
+	ir_graph  *const irg = new_ir_graph(ent, 0);
+	set_current_ir_graph(irg);
+
+	ir_node *const x = new_Proj(get_irg_args(irg), mode_Is, 0);
+	ir_node *const c3 = new_Const_long(mode_Is, 3);
+	ir_node *const c4 = new_Const_long(mode_Is, 4);
+	ir_node *const c5 = new_Const_long(mode_Is, 5);
+	ir_node *const c7 = new_Const_long(mode_Is, 7);
+	ir_node *const c9 = new_Const_long(mode_Is, 9);
+
+	ir_node *const args_two[]   = { x, c5 };
+	ir_node *const args_three[] = { x, c3, c4 };
+	ir_node *const args_sp[]    = { c7, c3, c9 };
+	ir_node *const call_two1    = new_call(two, 2, args_two);
+	ir_node *const call_two2    = new_call(two, 2, args_two);
+	ir_node *const call_three   = new_call(three, 3, args_three);
+	ir_node *const call_sp      = new_call(sp, 3, args_sp);
+
+	ir_node *const res = new_Proj(new_Proj(call_sp, mode_T, pn_Call_T_result), mode_Is, 0);
+	ir_node *const ret = new_Return(get_store(), 1, &res);
+	add_immBlock_pred(get_irg_end_block(irg), ret);
+	mature_immBlock(get_r_cur_block(irg));
+	irg_finalize_cons(irg);
+
+	ipcp(0, 1000);
+
+	assert(check_call(call_two1, 5));
+	assert(check_call(call_two2, 5));
+	assert(check_call(call_three, 4));
+	assert(check_call(call_sp, 9));
+
+	ir_finish();
+	return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Compare the (possibly vectorized) PBQP cost kernels against plain loops.
+ */
+#include "num_array.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#define MAX_LEN 37
+
+static num random_costs(void)
+{
+	switch (rand() % 4) {
+	case 0:  return INF_COSTS;
+	case 1:  return 0;
+	default: return (num)(rand() % 1000);
+	}
+}
+
+static void fill(num *array, unsigned len)
+{
+	for (unsigned i = 0; i < len; ++i)
+		array[i] = random_costs();
+}
+
+static num ref_add(num x, num y)
+{
+	return x == INF_COSTS || y == INF_COSTS ? INF_COSTS : x + y;
+}
+
+static void test_add(unsigned len)
+{
+	num dst[MAX_LEN];
+	num src[MAX_LEN];
+	num expected[MAX_LEN];
+	fill(dst, len);
+	fill(src, len);
+	for (unsigned i = 0; i < len; ++i)
+		expected[i] = ref_add(dst[i], src[i]);
+
+	num_array_add(dst, src, len);
+	for (unsigned i = 0; i < len; ++i)
+		assert(dst[i] == expected[i]);
+
+	num value = random_costs();
+	for (unsigned i = 0; i < len; ++i)
+		expected[i] = ref_add(dst[i], value);
+	num_array_add_value(dst, value, len);
+	for (unsigned i = 0; i < len; ++i)
+		assert(dst[i] == expected[i]);
+}
+
+static void test_min(unsigned len)
+{
+	num src[MAX_LEN];
+	num flags[MAX_LEN];
+	fill(src, len);
+	fill(flags, len);
+
+	num      min        = INF_COSTS;
+	unsigned min_index  = 0;
+	num      fmin       = INF_COSTS;
+	unsigned fmin_index = 0;
+	for (unsigned i = 0; i < len; ++i) {
+		if (src[i] < min) {
+			min       = src[i];
+			min_index = i;
+		}
+		if (flags[i] != INF_COSTS && src[i] < fmin) {
+			fmin       = src[i];
+			fmin_index = i;
+		}
+	}
+
+	assert(num_array_min(src, len) == min);
+	assert(num_array_min_masked(src, flags, len) == fmin);
+	if (len > 0) {
+		assert(num_array_min_index(src, NULL, len) == min_index);
+		assert(num_array_min_index(src, flags, len) == fmin_index);
+	}
+}
+
+int main(void)
+{
+	num_array_init();
+
+	for (unsigned round = 0; round < 100; ++round) {
+		for (unsigned len = 0; len <= MAX_LEN; ++len) {
+			test_add(len);
+			test_min(len);
+		}
+	}
+
+	return 0;
+}
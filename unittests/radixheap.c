@@ -0,0 +1,89 @@
+#include "radixheap.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define N_ELEMS 1000
+
+static uint32_t keys[N_ELEMS];
+
+static void test_order(void)
+{
+	radixheap_t heap;
+	radixheap_init(&heap);
+	assert(radixheap_empty(&heap));
+
+	for (int i = 0; i < N_ELEMS; ++i) {
+		keys[i] = (uint32_t)rand() * 7919u;
+		radixheap_put(&heap, &keys[i], keys[i]);
+	}
+	assert(radixheap_length(&heap) == N_ELEMS);
+
+	uint32_t last = 0;
+	while (!radixheap_empty(&heap)) {
+		uint32_t const *const key = (uint32_t*)radixheap_pop_min(&heap);
+		assert(*key >= last);
+		last = *key;
+	}
+
+	radixheap_free(&heap);
+}
+
+/* Puts new keys between the pops, as a Dijkstra style worklist does. */
+static void test_monotone(void)
+{
+	radixheap_t heap;
+	radixheap_init(&heap);
+
+	int n_put = 0;
+	keys[n_put] = 5;
+	radixheap_put(&heap, &keys[n_put], keys[n_put]);
+	++n_put;
+
+	uint32_t last = 0;
+	int      n_popped = 0;
+	while (!radixheap_empty(&heap)) {
+		uint32_t const *const key = (uint32_t*)radixheap_pop_min(&heap);
+		assert(*key >= last);
+		last = *key;
+		++n_popped;
+		for (int i = 0; i < 3 && n_put < N_ELEMS; ++i, ++n_put) {
+			keys[n_put] = last + (uint32_t)(rand() % 1000);
+			radixheap_put(&heap, &keys[n_put], keys[n_put]);
+		}
+	}
+	assert(n_popped == N_ELEMS);
+
+	/* an empty heap accepts any key again */
+	radixheap_put(&heap, &keys[0], 0);
+	assert(radixheap_pop_min(&heap) == &keys[0]);
+
+	radixheap_free(&heap);
+}
+
+static void test_extreme_keys(void)
+{
+	radixheap_t heap;
+	radixheap_init(&heap);
+
+	keys[0] = UINT32_MAX;
+	keys[1] = 0;
+	keys[2] = UINT32_MAX / 2 + 1;
+	for (int i = 0; i < 3; ++i)
+		radixheap_put(&heap, &keys[i], keys[i]);
+	assert(radixheap_pop_min(&heap) == &keys[1]);
+	assert(radixheap_pop_min(&heap) == &keys[2]);
+	assert(radixheap_pop_min(&heap) == &keys[0]);
+	assert(radixheap_empty(&heap));
+
+	radixheap_free(&heap);
+}
+
+int main(void)
+{
+	test_order();
+	test_monotone();
+	test_extreme_keys();
+	return 0;
+}
@@ -1,6 +1,80 @@
 #include "raw_bitset.h"
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+static void random_fill(unsigned *bitset, size_t size)
+{
+	for (size_t i = 0; i < size; ++i) {
+		if (rand() % 3 == 0)
+			rbitset_set(bitset, i);
+	}
+}
+
+/* Compares the operations on bitsets large enough for the vectorized kernels
+ * with bitwise results. */
+static void test_bulk(size_t size)
+{
+	unsigned *a   = rbitset_malloc(size);
+	unsigned *b   = rbitset_malloc(size);
+	unsigned *tmp = rbitset_malloc(size);
+	random_fill(a, size);
+	random_fill(b, size);
+
+	unsigned n_a = 0;
+	for (size_t i = 0; i < size; ++i)
+		n_a += rbitset_is_set(a, i);
+	assert(rbitset_popcount(a, size) == n_a);
+
+	rbitset_copy(tmp, a, size);
+	rbitset_and(tmp, b, size);
+	for (size_t i = 0; i < size; ++i)
+		assert(rbitset_is_set(tmp, i) == (rbitset_is_set(a, i) && rbitset_is_set(b, i)));
+	assert(rbitsets_have_common(a, b, size) == !rbitset_is_empty(tmp, size));
+	assert(rbitset_contains(tmp, a, size));
+	assert(rbitset_contains(tmp, b, size));
+	assert(!rbitset_and_changed(tmp, a, size));
+	bool const a_changes = !rbitsets_equal(a, tmp, size);
+	assert(rbitset_and_changed(a, b, size) == a_changes);
+	assert(rbitsets_equal(a, tmp, size));
+
+	rbitset_copy(tmp, a, size);
+	rbitset_or(tmp, b, size);
+	for (size_t i = 0; i < size; ++i)
+		assert(rbitset_is_set(tmp, i) == (rbitset_is_set(a, i) || rbitset_is_set(b, i)));
+	assert(rbitset_contains(b, tmp, size));
+	assert(!rbitset_or_changed(tmp, a, size));
+	assert(!rbitset_or_changed(tmp, b, size));
+
+	rbitset_copy(tmp, b, size);
+	rbitset_andnot(tmp, a, size);
+	assert(!rbitsets_have_common(tmp, a, size));
+	rbitset_xor(tmp, b, size);
+	assert(rbitsets_equal(tmp, a, size));
+
+	/* a single bit at the end */
+	rbitset_clear_all(tmp, size);
+	assert(rbitset_is_empty(tmp, size));
+	assert(rbitset_next_max(tmp, 0, size, true) == (size_t)-1);
+	rbitset_set(tmp, size - 1);
+	assert(!rbitset_is_empty(tmp, size));
+	assert(rbitset_popcount(tmp, size) == 1);
+	assert(rbitset_next_max(tmp, 0, size, true) == size - 1);
+	bool const last_set = rbitset_is_set(a, size - 1);
+	assert(rbitset_or_changed(a, tmp, size) == !last_set);
+	assert(rbitset_is_set(a, size - 1));
+	assert(!rbitset_copy_changed(b, b, size));
+	bool const b_changes = !rbitsets_equal(b, tmp, size);
+	assert(rbitset_copy_changed(b, tmp, size) == b_changes);
+	assert(rbitsets_equal(b, tmp, size));
+	rbitset_flip_all(tmp, size);
+	assert(rbitset_next_max(tmp, 0, size, false) == size - 1);
+	assert(rbitset_next_max(tmp, 1, size, true) == 1);
+
+	free(tmp);
+	free(b);
+	free(a);
+}
 
 int main(void)
 {
@@ -72,5 +146,11 @@ int main(void)
 	assert(rbitset_popcount(null, 0) == 0);
 	assert(rbitset_is_empty(null, 0));
 
+	for (size_t size = 500; size < 1200; size += 37)
+		test_bulk(size);
+	init_rbitset();
+	for (size_t size = 500; size < 1200; size += 37)
+		test_bulk(size);
+
 	return 0;
 }
@@ -11,17 +11,21 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 
-static const unsigned precision = 72; /* some random non-po2 number (but a multiple of SC_BITS),
-                                         as strcalc rounds up to multiple of SC_BITS anyway */
+static const unsigned precision = 72; /* some random non-po2 number, strcalc
+                                         rounds up to multiple of SC_BITS */
 static unsigned buflen;
 
 static bool equal(const sc_word *v0, const sc_word *v1)
 {
-	/* use precision/SC_BITS instead of buflen for now until we don't have these
+	/* only compare the lower precision bits for now until we don't have these
 	 * strange extra precision words anymore. */
-	size_t len = precision/SC_BITS;
-	return memcmp(v0, v1, len) == 0;
+	for (unsigned i = 0; i < precision; ++i) {
+		if (sc_get_bit_at(v0, i) != sc_get_bit_at(v1, i))
+			return false;
+	}
+	return true;
 }
 
 static void test_conv_print(unsigned long v, enum base_t base,
@@ -100,6 +104,122 @@ static bool is_zero(const sc_word *val)
 	return sc_is_zero(val, precision);
 }
 
+static uint64_t random_uint64(void)
+{
+	uint64_t res = 0;
+	for (unsigned i = 0; i < 4; ++i)
+		res = (res << 16) ^ (uint64_t)rand();
+	/* produce small values and values close to the limits more often */
+	switch (rand() % 4) {
+	case 0:  return res & 0xFF;
+	case 1:  return res >> (rand() % 64);
+	default: return res;
+	}
+}
+
+static void from_int64(int64_t v, sc_word *buffer)
+{
+	sc_zero(buffer);
+	for (unsigned i = 0; i < 64; ++i) {
+		if ((uint64_t)v >> i & 1)
+			sc_set_bit_at(buffer, i);
+	}
+	sc_sign_extend(buffer, 64);
+}
+
+static int64_t to_int64(const sc_word *val)
+{
+	return (int64_t)sc_val_to_uint64(val);
+}
+
+/** Compare 64bit operations against the native ones. */
+static void check_int64(int64_t a, int64_t b)
+{
+	sc_word *va  = XMALLOCN(sc_word, buflen);
+	sc_word *vb  = XMALLOCN(sc_word, buflen);
+	sc_word *res = XMALLOCN(sc_word, buflen);
+	sc_word *rem = XMALLOCN(sc_word, buflen);
+	from_int64(a, va);
+	from_int64(b, vb);
+	uint64_t const ua = (uint64_t)a;
+	uint64_t const ub = (uint64_t)b;
+
+	sc_add(va, vb, res);
+	assert(to_int64(res) == (int64_t)(ua + ub));
+	sc_sub(va, vb, res);
+	assert(to_int64(res) == (int64_t)(ua - ub));
+	sc_mul(va, vb, res);
+	assert(to_int64(res) == (int64_t)(ua * ub));
+	sc_shlI(va, 64, res);
+	sc_shrsI(res, 64, 128, res);
+	assert(to_int64(res) == a);
+
+	if (b != 0 && !(a == INT64_MIN && b == -1)) {
+		sc_divmod(va, vb, res, rem);
+		assert(to_int64(res) == a / b);
+		assert(to_int64(rem) == a % b);
+	}
+
+	unsigned const shift = ub % 64;
+	sc_shlI(va, shift, res);
+	assert(to_int64(res) == (int64_t)(ua << shift));
+	sc_zero_extend(va, 64);
+	sc_shrI(va, shift, res);
+	assert(to_int64(res) == (int64_t)(ua >> shift));
+	sc_shrsI(va, shift, 64, res);
+	assert(to_int64(res) == (a < 0 ? ~(~a >> shift) : a >> shift));
+
+	free(va);
+	free(vb);
+	free(res);
+	free(rem);
+}
+
+static void random_value(unsigned bits, sc_word *buffer)
+{
+	sc_zero(buffer);
+	for (unsigned i = 0; i < bits; ++i) {
+		if (rand() & 1)
+			sc_set_bit_at(buffer, i);
+	}
+	sc_set_bit_at(buffer, bits - 1);
+}
+
+/** Check a multi-word multiplication and division round trip. */
+static void check_multiword(unsigned bits0, unsigned bits1)
+{
+	sc_word *v0   = XMALLOCN(sc_word, buflen);
+	sc_word *v1   = XMALLOCN(sc_word, buflen);
+	sc_word *r    = XMALLOCN(sc_word, buflen);
+	sc_word *prod = XMALLOCN(sc_word, buflen);
+	sc_word *quot = XMALLOCN(sc_word, buflen);
+	sc_word *rem  = XMALLOCN(sc_word, buflen);
+	random_value(bits0, v0);
+	random_value(bits1, v1);
+	random_value(bits1 - 1, r);
+	sc_mul(v0, v1, prod);
+	sc_add(prod, r, prod);
+	assert(sc_get_highest_set_bit(prod) < (int)(bits0 + bits1));
+
+	sc_divmod(prod, v1, quot, rem);
+	assert(sc_comp(quot, v0) == ir_relation_equal);
+	assert(sc_comp(rem, r) == ir_relation_equal);
+
+	sc_neg(prod, prod);
+	sc_divmod(prod, v1, quot, rem);
+	sc_neg(quot, quot);
+	sc_neg(rem, rem);
+	assert(sc_comp(quot, v0) == ir_relation_equal);
+	assert(sc_comp(rem, r) == ir_relation_equal);
+
+	free(v0);
+	free(v1);
+	free(r);
+	free(prod);
+	free(quot);
+	free(rem);
+}
+
 int main(void)
 {
 	init_strcalc(precision);
@@ -256,7 +376,7 @@ int main(void)
 
 		/* workaround until we don't have this stupid
 		 * calc_buffer_size*4 > precision anymore */
-		memcpy(temp, val, buflen);
+		memcpy(temp, val, buflen * sizeof(sc_word));
 		sc_zero_extend(temp, precision);
 
 		sc_shrI(temp, precision, temp);
@@ -281,7 +401,7 @@ int main(void)
 			sc_shlI(val, b, temp);
 			sc_zero_extend(temp, precision); /* higher precision workaround */
 			sc_shrI(temp, b, temp);
-			memcpy(temp1, val, buflen);
+			memcpy(temp1, val, buflen * sizeof(sc_word));
 			sc_zero_extend(temp1, precision-b);
 			assert(equal(temp, temp1));
 
@@ -289,7 +409,7 @@ int main(void)
 				sc_shlI(val, precision-b, temp);
 				sc_zero_extend(temp, precision); /* higher precision workaround */
 				sc_shrsI(temp, precision-b, precision, temp);
-				memcpy(temp1, val, buflen);
+				memcpy(temp1, val, buflen * sizeof(sc_word));
 				sc_sign_extend(temp1, b);
 				assert(equal(temp, temp1));
 			}
@@ -354,5 +474,15 @@ int main(void)
 	test_conv(LONG_MAX);
 	test_conv(LONG_MIN);
 
+	/* random tests against native arithmetic */
+	for (unsigned i = 0; i < 10000; ++i) {
+		check_int64((int64_t)random_uint64(), (int64_t)random_uint64());
+	}
+	for (unsigned bits0 = 2; bits0 < 100; bits0 += 7) {
+		for (unsigned bits1 = 2; bits1 < 120 - bits0; bits1 += 5) {
+			check_multiword(bits0, bits1);
+		}
+	}
+
 	return 0;
 }
@@ -12,6 +12,8 @@
 #include <stdio.h>
 
 static int result = 0;
+static ir_mode *wide_signed_mode;
+static ir_mode *wide_unsigned_mode;
 static unsigned n_modes;
 static ir_mode *const *modes;
 static unsigned n_tarvals;
@@ -198,6 +200,48 @@ static void test_bitcast(ir_mode *mode)
 	}
 }
 
+/* compare the results of a binop with the results in a wider mode */
+static void test_wide_binop_(binop op, const char *new_op_name, bool is_div)
+{
+	op_name = new_op_name;
+	for (unsigned a = 0; a < n_tarvals; ++a) {
+		ir_tarval *val_a  = tarvals[a];
+		ir_mode   *mode   = get_tarval_mode(val_a);
+		ir_tarval *wide_a = tarval_convert_to(val_a, wide_signed_mode);
+		for (unsigned b = 0; b < n_tarvals; ++b) {
+			ir_tarval *val_b = tarvals[b];
+			if (is_div && tarval_is_null(val_b))
+				continue;
+			ir_tarval *wide_b = tarval_convert_to(val_b, wide_signed_mode);
+			TVS_EQUAL(op(val_a, val_b),
+			          tarval_convert_to(op(wide_a, wide_b), mode));
+		}
+	}
+	op_name = "";
+}
+#define test_wide_binop(func, is_div) test_wide_binop_(func, #func, is_div)
+
+static void test_wide_shifts(ir_mode *mode)
+{
+	unsigned bits = get_mode_size_bits(mode);
+	for (unsigned i = 0; i < n_tarvals; ++i) {
+		ir_tarval *value  = tarvals[i];
+		ir_tarval *wide_s = tarval_convert_to(value, wide_signed_mode);
+		ir_tarval *wide_u = tarval_convert_to(tarval_convert_to(value,
+			find_unsigned_mode(mode)), wide_unsigned_mode);
+		for (unsigned shift = 0; shift <= bits + 1; ++shift) {
+			TVS_EQUAL(tarval_shl_unsigned(value, shift),
+			          tarval_convert_to(tarval_shl_unsigned(wide_s, shift), mode));
+			TVS_EQUAL(tarval_shr_unsigned(value, shift),
+			          tarval_convert_to(tarval_shr_unsigned(wide_u, shift), mode));
+			if (mode_is_signed(mode)) {
+				TVS_EQUAL(tarval_shrs_unsigned(value, shift),
+				          tarval_convert_to(tarval_shrs_unsigned(wide_s, shift), mode));
+			}
+		}
+	}
+}
+
 static void test_compare(ir_tarval *minus_zero, ir_tarval *zero)
 {
 	/* assumes the tarvals are in order */
@@ -398,6 +442,17 @@ static void test_int_tarvals(ir_mode *mode)
 
 	test_bitcast(mode);
 
+	/* compare against the results in a wider mode */
+	test_wide_binop(tarval_add, false);
+	test_wide_binop(tarval_sub, false);
+	test_wide_binop(tarval_mul, false);
+	test_wide_binop(tarval_div, true);
+	test_wide_binop(tarval_mod, true);
+	test_wide_binop(tarval_and, false);
+	test_wide_binop(tarval_or, false);
+	test_wide_binop(tarval_eor, false);
+	test_wide_shifts(mode);
+
 	context = "";
 }
 
@@ -585,6 +640,9 @@ int main(void)
 	init_mode();
 	init_tarval_2();
 
+	wide_signed_mode   = new_int_mode("int128", 128, true, 0);
+	wide_unsigned_mode = new_int_mode("uint128", 128, false, 0);
+
 	ir_mode *const new_modes[] = {
 		new_int_mode("uint8",  8,  false, 0),
 		new_int_mode("uint16", 16, false, 0),
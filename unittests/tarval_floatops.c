@@ -1,8 +1,11 @@
 #include "firm.h"
+#include "fltcalc.h"
 #include "tv_t.h"
 #include "util.h"
 #include <assert.h>
+#include <fenv.h>
 #include <float.h>
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,12 +48,121 @@ static void check_mode(ir_mode *mode)
 	}
 }
 
+static double random_double(ir_mode *mode)
+{
+	/* produce values close to the subnormal range more often */
+	bool     const is_float  = mode == mode_F;
+	unsigned const mant_bits = is_float ? 24 : 53;
+	int      const min_exp   = is_float ? -149 : -1074;
+	uint64_t const mantissa  = (((uint64_t)rand() << 31) ^ (uint64_t)rand())
+	                         & (((uint64_t)1 << mant_bits) - 1);
+	int exp;
+	switch (rand() % 4) {
+	case 0:  exp = min_exp + rand() % 8; break;
+	case 1:  exp = min_exp + (int)mant_bits + rand() % 8; break;
+	default: exp = rand() % 128 - 100; break;
+	}
+	double value = ldexp((double)mantissa, exp);
+	if (rand() & 1)
+		value = -value;
+	return value;
+}
+
+static ir_tarval *double_to_tarval(double value, ir_mode *mode)
+{
+	/* go through the bytes to avoid the library's own conversions */
+	unsigned char buffer[sizeof(double)];
+	if (mode == mode_F) {
+		float f = (float)value;
+		memcpy(buffer, &f, sizeof(f));
+	} else {
+		memcpy(buffer, &value, sizeof(value));
+	}
+	return new_tarval_from_bytes(buffer, mode);
+}
+
+static double native_calc(ir_mode *mode, unsigned op, double a, double b)
+{
+	volatile double x = a;
+	volatile double y = b;
+	volatile double res;
+	if (mode == mode_F) {
+		volatile float fres;
+		switch (op) {
+		case 0: fres = (float)x + (float)y; break;
+		case 1: fres = (float)x - (float)y; break;
+		case 2: fres = (float)x * (float)y; break;
+		default: fres = (float)x / (float)y; break;
+		}
+		res = fres;
+	} else {
+		switch (op) {
+		case 0: res = x + y; break;
+		case 1: res = x - y; break;
+		case 2: res = x * y; break;
+		default: res = x / y; break;
+		}
+	}
+	return res;
+}
+
+typedef ir_tarval* (*binop)(ir_tarval const *op0, ir_tarval const *op1);
+
+/* compare the tarval arithmetic against the host arithmetic in all rounding
+ * modes */
+static void check_host_arithmetic(ir_mode *mode)
+{
+	static const binop ops[] = { tarval_add, tarval_sub, tarval_mul,
+	                             tarval_div };
+	static const fc_rounding_mode_t fc_modes[] = {
+		FC_TONEAREST, FC_TOPOSITIVE, FC_TONEGATIVE, FC_TOZERO
+	};
+	static const int fe_modes[] = {
+		FE_TONEAREST, FE_UPWARD, FE_DOWNWARD, FE_TOWARDZERO
+	};
+	double const min_normal = mode == mode_F ? FLT_MIN : DBL_MIN;
+	for (unsigned r = 0; r < ARRAY_SIZE(fc_modes); ++r) {
+		fc_set_rounding_mode(fc_modes[r]);
+		for (unsigned i = 0; i < 2000; ++i) {
+			double     a    = random_double(mode);
+			double     b    = random_double(mode);
+			ir_tarval *tv_a = double_to_tarval(a, mode);
+			ir_tarval *tv_b = double_to_tarval(b, mode);
+			for (unsigned o = 0; o < ARRAY_SIZE(ops); ++o) {
+				if (o == 3 && b == 0)
+					continue;
+				fesetround(fe_modes[r]);
+				feclearexcept(FE_ALL_EXCEPT);
+				double res      = native_calc(mode, o, a, b);
+				bool   inexact  = fetestexcept(FE_INEXACT);
+				bool   overflow = fetestexcept(FE_OVERFLOW);
+				fesetround(FE_TONEAREST);
+
+				ir_tarval *tv_res = ops[o](tv_a, tv_b);
+				assert(tv_res == double_to_tarval(res, mode));
+				assert(tarval_ieee754_get_exact() == !inexact);
+
+				/* the emulation should agree for normal values */
+				if (fabs(a) < min_normal || fabs(b) < min_normal
+				    || fabs(res) < min_normal || overflow)
+					continue;
+				bool const old = fc_use_host_arithmetic(false);
+				assert(ops[o](tv_a, tv_b) == tv_res);
+				fc_use_host_arithmetic(old);
+			}
+		}
+	}
+	fc_set_rounding_mode(FC_TONEAREST);
+}
+
 int main(void)
 {
 	ir_init();
 
 	check_mode(mode_F);
 	check_mode(mode_D);
+	check_host_arithmetic(mode_F);
+	check_host_arithmetic(mode_D);
 #if LDBL_MANT_DIG == 64
 	ir_mode *mode_E = new_float_mode("E", irma_x86_extended_float, 15, 64,
 	                                 ir_overflow_min_max);